@@ -2,6 +2,7 @@
 #define BOOT_CONSTANTS_H
 
 #include "csr.h"
+#include "core/Utils/EventBus.h"
 
 static const char* deviceName = "pio-esp32-cam";
 
@@ -21,6 +22,7 @@ typedef enum {
 	SPEAKER_LOWER,
 	SPEAKER_MIDDLE,
 	SPEAKER_LOUD,
+	GPT_CHAT,
 } Commands;
 
 // for generate phonetic, run `python3 tools/multinet_g2p.py --text="new command"`
@@ -43,20 +45,21 @@ static const csr_cmd_t voice_commands[] = {
 	{Commands::SPEAKER_LOWER, "set lower sound", "SfT Lbk StND"},
 	{Commands::SPEAKER_MIDDLE, "set middle sound", "SfT MgDcL StND"},
 	{Commands::SPEAKER_LOUD, "set full sound", "SfT FwL StND"},
+	{Commands::GPT_CHAT, "talk to me", "TeK To Mm"},
 };
 
-static const char* NOTIFICATION_SPEAKER = "speaker";
-static const char* NOTIFICATION_COMMAND = "command";
+// Event bus topics and payloads, see core/Utils/EventBus.h
+using Utils::Topic;
 
 // Automation Events
-static const char* NOTIFICATION_AUTOMATION = "automation";
 namespace EVENT_AUTOMATION {
-	static const char* PAUSE = "pause";
-	static const char* RESUME = "resume";
+	enum Type : uint8_t {
+		PAUSE,
+		RESUME,
+	};
 }
 
 // Display Events
-static const char* NOTIFICATION_DISPLAY = "display";
 typedef enum  {
 	WAKEWORD,
 	FACE,
@@ -72,32 +75,41 @@ typedef enum  {
 } EVENT_DISPLAY;
 
 // SR Events
-static const char* NOTIFICATION_WAKEWORD = "wakeword";
-static const char* NOTIFICATION_SR = "sr";
 namespace EVENT_SR {
-	static const char* WAKEWORD = "sr_wakeword";
-	static const char* COMMAND = "sr_command";
-	static const char* TIMEOUT = "sr_timeout";
-	static const char* PAUSE = "pause_sr";
-	static const char* RESUME = "resume_sr";
+	enum Type : uint8_t {
+		WAKEWORD,
+		COMMAND,
+		TIMEOUT,
+		PAUSE,
+		RESUME,
+	};
 }
 
 // PicoTTS Events
-static const char* NOTIFICATION_TTS = "tts";
 namespace EVENT_TTS {
-	static const char* PAUSE = "pause_tts";
-	static const char* RESUME = "resume_tts";
+	enum Type : uint8_t {
+		PAUSE,
+		RESUME,
+	};
 }
 
 // Audio Recording Events
-static const char* NOTIFICATION_AUDIO = "audio";
 namespace EVENT_AUDIO {
-	static const char* START_RECORDING = "start_recording";
-	static const char* STOP_RECORDING = "stop_recording";
-	static const char* RECORDING_COMPLETE = "recording_complete";
+	enum Type : uint8_t {
+		START_RECORDING,
+		STOP_RECORDING,
+		RECORDING_COMPLETE,
+	};
 }
 
-// Note Music Events
-static const char* NOTIFICATION_NOTE = "note";
+// Note Music Events carry a Note::Melody, see core/Audio/Note.h
+
+namespace Utils {
+	template<> struct TopicPayload<Topic::AUTOMATION> { typedef EVENT_AUTOMATION::Type type; };
+	template<> struct TopicPayload<Topic::DISPLAY> { typedef EVENT_DISPLAY type; };
+	template<> struct TopicPayload<Topic::SR> { typedef EVENT_SR::Type type; };
+	template<> struct TopicPayload<Topic::TTS> { typedef EVENT_TTS::Type type; };
+	template<> struct TopicPayload<Topic::AUDIO> { typedef EVENT_AUDIO::Type type; };
+}
 
 #endif
\ No newline at end of file
@@ -26,8 +26,6 @@ void setup() {
 
   LittleFS.begin(false);
   setupApp();
-  setupTasksCpu0();
-  setupTasksCpu1();
 }
 
 void loop() {
@@ -13,4 +13,4 @@ void picotts_idle_callback(void);
 
 void weatherCallback(const Communication::WeatherService::WeatherData &data, bool success);
 void batteryCallback(void* arg);
-void callbackNotePlayer(void* data);
\ No newline at end of file
+void callbackNotePlayer(Note::Melody event);
\ No newline at end of file
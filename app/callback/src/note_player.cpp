@@ -2,18 +2,12 @@
 
 String noteRandomPlayerId;
 
-void callbackNotePlayer(void* data) {
-    if (!data) {
-        logger->error("Note callback: No data received");
-        return;
-    }
-    
+void callbackNotePlayer(Note::Melody event) {
     if (!notePlayer) {
         logger->error("Note callback: notePlayer is null");
         return;
     }
     
-    const Note::Melody event = (Note::Melody)(intptr_t)data;
     logger->info("Note callback received event: %d", (int)event);
 
     if (event == Note::STOP) {
@@ -72,6 +66,6 @@ void callbackNotePlayer(void* data) {
         }, "RandomMusicTask");
         
     } else {
-        logger->warning("Unknown Note event: %s", event);
+        logger->warning("Unknown Note event: %d", (int)event);
     }
 }
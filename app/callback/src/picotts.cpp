@@ -41,6 +41,10 @@ std::vector<int16_t> apply_speed_adjustment(const std::vector<int16_t>& samples)
 
 // PicoTTS output callback - called by the TTS engine with synthesized audio
 void picotts_output_callback(int16_t *samples, unsigned count) {
+    // Synthesis span runs from the first chunk until the engine goes idle
+    if (collected_audio.empty()) {
+        Utils::Trace::begin("tts.synthesize");
+    }
     
     // Convert mono to stereo and collect samples
     for (unsigned i = 0; i < count; i++) {
@@ -70,8 +74,13 @@ void picotts_error_callback(void) {
 void picotts_idle_callback(void) {
     logger->debug("PicoTTS engine is now idle");
     
+    if (!collected_audio.empty()) {
+        Utils::Trace::end("tts.synthesize");
+    }
+    
     // Play collected audio samples to speaker with speed adjustment
     if (!collected_audio.empty() && i2sSpeaker) {
+        Utils::TraceScope trace("speaker.write");
         std::vector<int16_t> speed_adjusted_audio = apply_speed_adjustment(collected_audio);
         i2sSpeaker->writeSamples(speed_adjusted_audio.data(), speed_adjusted_audio.size());
         logger->debug("Played speed-adjusted audio samples to speaker (speed: %.2f)", playback_speed);
@@ -2,20 +2,29 @@
 
 #if MICROPHONE_ENABLED
 
+// What "talk to me" asks, the robot context is added by the chat task
+static const char VOICE_CHAT_PROMPT[] =
+    "I just asked you to talk to me. Tell me in one or two short sentences how you feel and what you notice around you.";
+
 // Event callback for SR system
 void sr_event_callback(void *arg, sr_event_t event, int command_id, int phrase_id) {
     static bool automationStatus = automation->isEnabled();
     static sr_mode_t lastMode = SR_MODE_WAKEWORD;
     static bool resetScreenWhenTimeout = true;
 
+    Utils::TraceScope trace("sr_event_callback", event);
     float targetYaw = 0;
+    if (powerManager) {
+        powerManager->noteActivity();
+    }
+
     switch (event) {
         case SR_EVENT_WAKEWORD:
             sayText("whats up?");
             resetScreenWhenTimeout = true;
-            notification->send(NOTIFICATION_AUTOMATION, (void*)EVENT_AUTOMATION::PAUSE);
-            notification->send(NOTIFICATION_DISPLAY, (void*)EVENT_DISPLAY::WAKEWORD);
-            notification->send(NOTIFICATION_NOTE, (void*)Note::STOP);
+            eventBus->publish<Topic::AUTOMATION>(EVENT_AUTOMATION::PAUSE);
+            eventBus->publish<Topic::DISPLAY>(EVENT_DISPLAY::WAKEWORD);
+            eventBus->publish<Topic::NOTE>(Note::STOP);
             motors->stop();
             servos->setHand(0);
             servos->setHead(180);
@@ -34,12 +43,12 @@ void sr_event_callback(void *arg, sr_event_t event, int command_id, int phrase_i
             sayText("Call me again later!");
             logger->info("⏰ Command timeout - returning to wake word mode");
             if (resetScreenWhenTimeout)
-                notification->send(NOTIFICATION_DISPLAY, (void*)EVENT_DISPLAY::FACE);
+                eventBus->publish<Topic::DISPLAY>(EVENT_DISPLAY::FACE);
 
             lastMode = SR_MODE_WAKEWORD;
             SR::sr_set_mode(SR_MODE_WAKEWORD);
             if (automationStatus)
-                notification->send(NOTIFICATION_AUTOMATION, (void*)EVENT_AUTOMATION::RESUME);
+                eventBus->publish<Topic::AUTOMATION>(EVENT_AUTOMATION::RESUME);
             break;
             
         case SR_EVENT_COMMAND:
@@ -50,19 +59,19 @@ void sr_event_callback(void *arg, sr_event_t event, int command_id, int phrase_i
                 case Commands::AUTOMATION_ACTIVE:
                     sayText("Thankyou!");
                     automationStatus = true;
-                    notification->send(NOTIFICATION_AUTOMATION, (void*)EVENT_AUTOMATION::RESUME);
-                    notification->send(NOTIFICATION_DISPLAY, (void*)EVENT_DISPLAY::NOTHING);
+                    eventBus->publish<Topic::AUTOMATION>(EVENT_AUTOMATION::RESUME);
+                    eventBus->publish<Topic::DISPLAY>(EVENT_DISPLAY::NOTHING);
                     resetScreenWhenTimeout = true;
                     break;
                 case Commands::AUTOMATION_PAUSED:
                     sayText("Ok!");
                     servos->setHead(0);
                     automationStatus = false;
-                    notification->send(NOTIFICATION_AUTOMATION, (void*)EVENT_AUTOMATION::PAUSE);
+                    eventBus->publish<Topic::AUTOMATION>(EVENT_AUTOMATION::PAUSE);
                     resetScreenWhenTimeout = true;
                     break;
                 case Commands::WEATHER:
-                    notification->send(NOTIFICATION_DISPLAY, (void*)EVENT_DISPLAY::WEATHER_STATUS);
+                    eventBus->publish<Topic::DISPLAY>(EVENT_DISPLAY::WEATHER_STATUS);
                     sayText("Here is weather status!");
                     servos->setHead(180);
                     automationStatus = false;
@@ -74,14 +83,14 @@ void sr_event_callback(void *arg, sr_event_t event, int command_id, int phrase_i
                     ESP.restart();
                     break;
                 case Commands::ORIENTATION:
-                    notification->send(NOTIFICATION_DISPLAY, (void*)EVENT_DISPLAY::ORIENTATION_DISPLAY);
+                    eventBus->publish<Topic::DISPLAY>(EVENT_DISPLAY::ORIENTATION_DISPLAY);
                     sayText("Here is orientation display!");
                     servos->setHead(180);
                     automationStatus = false;
                     resetScreenWhenTimeout = false;
                     break;
                 case Commands::GAME_SPACE:
-                    notification->send(NOTIFICATION_DISPLAY, (void*)EVENT_DISPLAY::SPACE_GAME);
+                    eventBus->publish<Topic::DISPLAY>(EVENT_DISPLAY::SPACE_GAME);
                     servos->setHead(DEFAULT_HEAD_ANGLE);
                     sayText("Starting space game!");
                     delay(100);
@@ -97,7 +106,7 @@ void sr_event_callback(void *arg, sr_event_t event, int command_id, int phrase_i
                         if (audioRecorder->startRecording()) {
                             automationStatus = false;
                             resetScreenWhenTimeout = false;
-                            notification->send(NOTIFICATION_DISPLAY, (void*)EVENT_DISPLAY::WAKEWORD);
+                            eventBus->publish<Topic::DISPLAY>(EVENT_DISPLAY::WAKEWORD);
                             logger->info("Recording started via voice command");
                             SR::sr_set_mode(SR_MODE_WAKEWORD);
                             return;
@@ -109,29 +118,29 @@ void sr_event_callback(void *arg, sr_event_t event, int command_id, int phrase_i
                     }
                     break;
                 case Commands::SYSTEM_STATUS:
-                    notification->send(NOTIFICATION_DISPLAY, (void*)EVENT_DISPLAY::BASIC_STATUS);
+                    eventBus->publish<Topic::DISPLAY>(EVENT_DISPLAY::BASIC_STATUS);
                     servos->setHead(180);
                     sayText("Here my status!");
                     resetScreenWhenTimeout = true;
                     break;
                 case Commands::NOTE_HAPPY_BIRTHDAY:
                     servos->setHead(180);
-                    notification->send(NOTIFICATION_NOTE, (void*)Note::HAPPY_BIRTHDAY);
-                    notification->send(NOTIFICATION_DISPLAY, (void*)EVENT_DISPLAY::FACE);
+                    eventBus->publish<Topic::NOTE>(Note::HAPPY_BIRTHDAY);
+                    eventBus->publish<Topic::DISPLAY>(EVENT_DISPLAY::FACE);
                     resetScreenWhenTimeout = true;
                     SR::sr_set_mode(SR_MODE_WAKEWORD);
                     return;
                     break;
                 case Commands::NOTE_RANDOM:
                     servos->setHead(DEFAULT_HEAD_ANGLE);
-                    notification->send(NOTIFICATION_NOTE, (void*)Note::RANDOM);
+                    eventBus->publish<Topic::NOTE>(Note::RANDOM);
                     resetScreenWhenTimeout = true;
                     break;
                 case Commands::SPEAKER_LOWER:
                     notePlayer->setVolume(30);
                     servos->setHead(DEFAULT_HEAD_ANGLE);
-                    notification->send(NOTIFICATION_NOTE, (void*)Note::DOREMI_SCALE);
-                    notification->send(NOTIFICATION_DISPLAY, (void*)EVENT_DISPLAY::FACE);
+                    eventBus->publish<Topic::NOTE>(Note::DOREMI_SCALE);
+                    eventBus->publish<Topic::DISPLAY>(EVENT_DISPLAY::FACE);
 
                     resetScreenWhenTimeout = true;
                     SR::sr_set_mode(SR_MODE_WAKEWORD);
@@ -140,8 +149,8 @@ void sr_event_callback(void *arg, sr_event_t event, int command_id, int phrase_i
                 case Commands::SPEAKER_MIDDLE:
                     servos->setHead(DEFAULT_HEAD_ANGLE);
                     notePlayer->setVolume(55);
-                    notification->send(NOTIFICATION_NOTE, (void*)Note::DOREMI_SCALE);
-                    notification->send(NOTIFICATION_DISPLAY, (void*)EVENT_DISPLAY::FACE);
+                    eventBus->publish<Topic::NOTE>(Note::DOREMI_SCALE);
+                    eventBus->publish<Topic::DISPLAY>(EVENT_DISPLAY::FACE);
 
                     resetScreenWhenTimeout = true;
                     SR::sr_set_mode(SR_MODE_WAKEWORD);
@@ -150,14 +159,23 @@ void sr_event_callback(void *arg, sr_event_t event, int command_id, int phrase_i
                 case Commands::SPEAKER_LOUD:
                     servos->setHead(DEFAULT_HEAD_ANGLE);
                     notePlayer->setVolume(80);
-                    notification->send(NOTIFICATION_NOTE, (void*)Note::DOREMI_SCALE);
-                    notification->send(NOTIFICATION_DISPLAY, (void*)EVENT_DISPLAY::FACE);
+                    eventBus->publish<Topic::NOTE>(Note::DOREMI_SCALE);
+                    eventBus->publish<Topic::DISPLAY>(EVENT_DISPLAY::FACE);
 
                     resetScreenWhenTimeout = true;
                     SR::sr_set_mode(SR_MODE_WAKEWORD);
                     return;
                     break;
 
+                case Commands::GPT_CHAT:
+                    servos->setHead(DEFAULT_HEAD_ANGLE);
+                    eventBus->publish<Topic::DISPLAY>(EVENT_DISPLAY::FACE);
+                    if (!startGptChat(VOICE_CHAT_PROMPT)) {
+                        sayText("I can not think right now!");
+                    }
+                    resetScreenWhenTimeout = true;
+                    break;
+
                 default: 
                     logger->info("Unknown command ID: %d", command_id);
                     servos->setHead(DEFAULT_HEAD_ANGLE);
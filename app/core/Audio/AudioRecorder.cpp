@@ -2,9 +2,9 @@
 
 AudioRecorder::AudioRecorder(Utils::FileManager* fileManager, 
                            Utils::Logger* logger, 
-                           Notification* notification,
+                           Utils::EventBus* eventBus,
                            mic_fill_cb micCallback) 
-    : _fileManager(fileManager), _logger(logger), _notification(notification) {
+    : _fileManager(fileManager), _logger(logger), _eventBus(eventBus) {
     
     // Ensure recordings directory exists
     if (_fileManager && !_fileManager->exists(AUDIO_RECORDING_PATH)) {
@@ -51,8 +51,8 @@ bool AudioRecorder::startRecording(uint32_t durationMs) {
     if (_logger) _logger->info("Recording started with task ID: " + _currentTaskId);
     
     // Notify display about recording status
-    if (_notification) {
-        _notification->send(NOTIFICATION_DISPLAY, (void*)RECORDING_STARTED);
+    if (_eventBus) {
+        _eventBus->publish<Topic::DISPLAY>(RECORDING_STARTED);
     }
     
     return true;
@@ -83,28 +83,34 @@ Command::TaskStatus AudioRecorder::getRecordingStatus() {
 }
 
 void AudioRecorder::pauseSystemTasks() {
-    // Pause ESP-SR
-    _notification->send(NOTIFICATION_SR, (void*)EVENT_SR::PAUSE);
-    
-    // Pause Automation
-    _notification->send(NOTIFICATION_AUTOMATION, (void*)EVENT_AUTOMATION::PAUSE);
-    
-    // Pause PicoTTS
-    _notification->send(NOTIFICATION_TTS, (void*)EVENT_TTS::PAUSE);
+    if (_eventBus) {
+        // Pause ESP-SR
+        _eventBus->publish<Topic::SR>(EVENT_SR::PAUSE);
+
+        // Pause Automation
+        _eventBus->publish<Topic::AUTOMATION>(EVENT_AUTOMATION::PAUSE);
+
+        // Pause PicoTTS
+        _eventBus->publish<Topic::TTS>(EVENT_TTS::PAUSE);
+    }
     
     // Give tasks time to pause
     vTaskDelay(pdMS_TO_TICKS(500));
 }
 
 void AudioRecorder::resumeSystemTasks() {
+    if (!_eventBus) {
+        return;
+    }
+
     // Resume ESP-SR
-    _notification->send(NOTIFICATION_SR, (void*)EVENT_SR::RESUME);
+    _eventBus->publish<Topic::SR>(EVENT_SR::RESUME);
     
     // Resume Automation
-    _notification->send(NOTIFICATION_AUTOMATION, (void*)EVENT_AUTOMATION::RESUME);
+    _eventBus->publish<Topic::AUTOMATION>(EVENT_AUTOMATION::RESUME);
     
     // Resume PicoTTS
-    _notification->send(NOTIFICATION_TTS, (void*)EVENT_TTS::RESUME);
+    _eventBus->publish<Topic::TTS>(EVENT_TTS::RESUME);
 }
 
 Utils::Sstring AudioRecorder::generateFileName() {
@@ -127,9 +133,9 @@ void AudioRecorder::recordingTask() {
     resumeSystemTasks();
     
     // Notify completion
-    if (_notification) {
-        _notification->send(NOTIFICATION_AUDIO, (void*)EVENT_AUDIO::RECORDING_COMPLETE);
-        _notification->send(NOTIFICATION_DISPLAY, (void*)RECORDING_STOPPED);
+    if (_eventBus) {
+        _eventBus->publish<Topic::AUDIO>(EVENT_AUDIO::RECORDING_COMPLETE);
+        _eventBus->publish<Topic::DISPLAY>(RECORDING_STOPPED);
     }
     
     // Clear task ID
@@ -10,7 +10,7 @@
 #include "Sstring.h"
 #include "Logger.h"
 #include "SendTask.h"
-#include "Notification.h"
+#include "core/Utils/EventBus.h"
 #include "FileManager.h"
 #include "AnalogMicrophone.h"
 #include "I2SMicrophone.h"
@@ -24,7 +24,7 @@ private:
     
     Utils::FileManager* _fileManager;
     Utils::Logger* _logger;
-    Notification* _notification;
+    Utils::EventBus* _eventBus;
     mic_fill_cb _micCallback;
     
     uint32_t _recordingDurationMs = AUDIO_RECORDING_DURATION_MS;
@@ -63,7 +63,7 @@ public:
     // Constructor with dependency injection
     AudioRecorder(Utils::FileManager* fileManager, 
                   Utils::Logger* logger, 
-                  Notification* notification,
+                  Utils::EventBus* eventBus,
                   mic_fill_cb micCallback);
     ~AudioRecorder();
     
@@ -152,4 +152,8 @@ public:
     void interrupt();
 };
 
+namespace Utils {
+    template<> struct TopicPayload<Topic::NOTE> { typedef Note::Melody type; };
+}
+
 #endif
@@ -58,16 +58,21 @@ Automation::Automation(Utils::FileManager* fileManager,
     , _enabled(AUTOMATION_ENABLED)
     , _lastManualControlTime(0)
     , _behaviorIndex(0)
+    , _behaviors(AUTOMATION_MAX_BEHAVIORS, AUTOMATION_MAX_BEHAVIOR_LENGTH)
     , _timer(0)
     , _randomBehaviorOrder(false) // Add this line
     , _behaviorPrompt(BEHAVIOR_PROMPT)
     , _templatesFile("/config/templates.txt")
     , _templatesUpdateFile("/config/templates_update.txt")
+    , _behaviorsLogFile("/config/behaviors.log")
 {
     // Create a mutex for thread-safe access to behaviors
     _behaviorsMutex = xSemaphoreCreateMutex();
 
-    
+    // Only lines the mapper can run are ever stored
+    _behaviors.setValidator([this](const char* line, size_t length) {
+        return _commandMapper && _commandMapper->isValidBehavior(line, length);
+    });
 }
 
 // Destructor
@@ -109,8 +114,8 @@ void Automation::start(bool core) {
         return;
     }
 
-    // Create template update task if needed
-    if (_fileManager && !_fileManager->exists(_templatesUpdateFile)) {
+    // Create template update task if nothing was learned yet
+    if (_fileManager && _behaviors.getLearnedCount() == 0) {
         String updateTaskId = SendTask::createTaskOnCore(
             [this]() {
                 vTaskDelay(pdMS_TO_TICKS(20099));
@@ -193,25 +198,23 @@ void Automation::taskFunction(void* parameter) {
     // Run automation forever
     TickType_t lastWakeTime = xTaskGetTickCount();
     while (true) {
-        // Check at regular intervals
-        vTaskDelayUntil(&lastWakeTime, pdMS_TO_TICKS(AUTOMATION_CHECK_INTERVAL));
-
-        if (notification->has(NOTIFICATION_AUTOMATION)) {
-            const char* notif = (const char*)notification->consume(NOTIFICATION_AUTOMATION);
-            if (notif == EVENT_AUTOMATION::PAUSE){
+        // Check at regular intervals, a pause/resume event wakes us right away
+        EVENT_AUTOMATION::Type event;
+        if (eventBus->receive<Topic::AUTOMATION>(event, pdMS_TO_TICKS(AUTOMATION_CHECK_INTERVAL))) {
+            if (event == EVENT_AUTOMATION::PAUSE){
                 paused = true;
                 automation->updateManualControlTime();
             }
-            else if (notif == EVENT_AUTOMATION::RESUME){
+            else if (event == EVENT_AUTOMATION::RESUME){
                 paused = false;
                 automation->updateManualControlTime();
-                vTaskDelayUntil(&lastWakeTime, pdMS_TO_TICKS(AUTOMATION_CHECK_INTERVAL * 5));
+                vTaskDelay(pdMS_TO_TICKS(AUTOMATION_CHECK_INTERVAL * 5));
             }
         }
+        lastWakeTime = xTaskGetTickCount();
 
         if (inprogress || paused){
             if(paused) inprogress = false;
-            vTaskDelayUntil(&lastWakeTime, pdMS_TO_TICKS(AUTOMATION_CHECK_INTERVAL / 2));
             continue;
         }
 
@@ -241,16 +244,15 @@ void Automation::taskFunction(void* parameter) {
             (millis() - automation->_lastManualControlTime > AUTOMATION_INACTIVITY_TIMEOUT)) {
             
             if (xSemaphoreTake(automation->_behaviorsMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-                if (!automation->_templateBehaviors.empty()) {
-                    size_t behaviorIdx = 0;
+                if (automation->_behaviors.size() > 0) {
+                    const char* picked;
                     if (automation->_randomBehaviorOrder) {
-                        behaviorIdx = random(0, automation->_templateBehaviors.size());
+                        picked = automation->_behaviors.pick();
                     } else {
-                        behaviorIdx = automation->_behaviorIndex;
-                        automation->_behaviorIndex = (automation->_behaviorIndex + 1) % 
-                                                    automation->_templateBehaviors.size();
+                        automation->_behaviorIndex %= automation->_behaviors.size();
+                        picked = automation->_behaviors.at(automation->_behaviorIndex++);
                     }
-                    Utils::Sstring behavior = automation->_templateBehaviors[behaviorIdx];
+                    Utils::Sstring behavior = picked;
 
                     xSemaphoreGive(automation->_behaviorsMutex);
                     automation->executeBehavior(behavior);
@@ -292,45 +294,26 @@ void Automation::taskFunction(void* parameter) {
 void Automation::loadTemplateBehaviors() {
     // Take the mutex to safely modify the behaviors list
     if (xSemaphoreTake(_behaviorsMutex, portMAX_DELAY) == pdTRUE) {
-        _templateBehaviors.clear();
-        
-        // Load template behaviors from file
-        Utils::Sstring templateDefault = "";
-        if (_fileManager && _fileManager->exists(_templatesFile)) {
-            templateDefault = _fileManager->readFile(_templatesFile);
-        }
-
-        if (_fileManager && _fileManager->exists(_templatesUpdateFile)) {
-            templateDefault += _fileManager->readFile(_templatesUpdateFile);
-        }
-        
-        // Split template behaviors into an array
-        int startPos = 0;
-        int nextPos = 0;
-        while ((nextPos = templateDefault.indexOf('\n', startPos)) != -1) {
-            Utils::Sstring behavior = templateDefault.toString().substring(startPos, nextPos);
-            behavior.trim();
-            if (behavior.length() > 0) {
-                _templateBehaviors.push_back(behavior);
-            }
-            startPos = nextPos + 1;
-        }
-        
-        // Add the remaining text as the last behavior if it exists
-        Utils::Sstring lastBehavior = templateDefault.substring(startPos);
-        if (lastBehavior.length() > 0) {
-            _templateBehaviors.push_back(lastBehavior);
-        }
+        _behaviors.load(_fileManager, _templatesFile, _behaviorsLogFile, _templatesUpdateFile);
         
         // Give the mutex back
         xSemaphoreGive(_behaviorsMutex);
         
         if (_logger) {
-            _logger->info("Loaded %d template behaviors", _templateBehaviors.size());
+            _logger->info("Loaded %d template behaviors", _behaviors.size());
         }
     }
 }
 
+BehaviorStore::Stats Automation::getBehaviorStats() {
+    BehaviorStore::Stats stats = {};
+    if (xSemaphoreTake(_behaviorsMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+        stats = _behaviors.getStats();
+        xSemaphoreGive(_behaviorsMutex);
+    }
+    return stats;
+}
+
 // Execute a specific behavior
 void Automation::executeBehavior(const Utils::Sstring& behavior) {
     if (_commandMapper) {
@@ -374,78 +357,50 @@ bool Automation::fetchAndAddNewBehaviors(const Utils::Sstring& prompt) {
     SemaphoreHandle_t doneSemaphore = xSemaphoreCreateBinary();
     bool success = false;
     
-    // Build a list of existing behaviors to avoid duplicates
-    Utils::Sstring existingBehaviorsList = "";
-    int exampleCount = 0;
-    
-    // Take the mutex to safely access the behaviors list
-    if (xSemaphoreTake(_behaviorsMutex, portMAX_DELAY) == pdTRUE) {
-        // Get up to 5 random examples from existing behaviors
-        if (!_templateBehaviors.empty()) {
-            // Create a list of indices
-            std::vector<int> indices(_templateBehaviors.size());
-            for (size_t i = 0; i < indices.size(); ++i) {
-                indices[i] = static_cast<int>(i);
-            }
-            
-            // Shuffle to get random behaviors
-            for (size_t i = 0; i < indices.size(); ++i) {
-                size_t j = random(0, indices.size());
-                std::swap(indices[i], indices[j]);
-            }
-            
-            // Get up to 5 examples
-            for (size_t i = 0; i < std::min(static_cast<size_t>(5), _templateBehaviors.size()); ++i) {
-                existingBehaviorsList += "Example ";
-                existingBehaviorsList += Utils::Sstring(exampleCount + 1) + ": " + 
-                                         _templateBehaviors[indices[i]].toString() + "\n";
-                exampleCount++;
-            }
-        }
-        
-        // Release the mutex
-        xSemaphoreGive(_behaviorsMutex);
-    }
-        
     // Store a pointer to this for use in the lambda
     Automation* self = this;
         
-    // Send the prompt to GPT using sendPromptWithCustomSystem for better memory management
-    ::gptAdapter->sendPromptWithCustomSystem(prompt, _behaviorPrompt, 
+    // Up to 5 existing behaviors go into the request body as examples to
+    // avoid duplicates, written from the store without a copy in between
+    auto examples = [self](Communication::PromptWriter& out) {
+        if (xSemaphoreTake(self->_behaviorsMutex, portMAX_DELAY) != pdTRUE) {
+            return;
+        }
+        size_t count = self->_behaviors.size();
+        if (count > 0) {
+            out.text("\nExisting behaviors, do not repeat them:\n");
+            size_t first = random(0, count);
+            for (size_t i = 0; i < std::min(static_cast<size_t>(5), count); ++i) {
+                out.text("Example ").number((long)(i + 1)).text(": ")
+                   .text(self->_behaviors.at((first + i) % count)).text("\n");
+            }
+        }
+        xSemaphoreGive(self->_behaviorsMutex);
+    };
+
+    ::gptAdapter->sendPromptWithCustomSystem(prompt, _behaviorPrompt, examples,
         [self, doneSemaphore, &success](const Utils::Sstring& response) {
         if (self->_logger) {
             self->_logger->info("GPT Response received");
             self->_logger->info("%s", response.c_str());
         }
 
-        if (self->_templateBehaviors.size() > 100) {
-            self->_templateBehaviors.erase(self->_templateBehaviors.begin(), 
-                self->_templateBehaviors.begin() + 50);
-        }
-
-        int nextPos = 0;
-        int startPos = 0;
+        // Invalid and duplicate lines are dropped, accepted ones are logged
         int total = 0;
-        while ((nextPos = response.indexOf('\n', startPos)) != -1) {
-            Utils::Sstring behavior = response.toString().substring(startPos, nextPos);
-            behavior.trim();
-            if (behavior.length() > 0) {
-                self->_templateBehaviors.push_back(behavior);
-                total++;
-            }
-            startPos = nextPos + 1;
+        BehaviorStore::Stats stats = {};
+        if (xSemaphoreTake(self->_behaviorsMutex, portMAX_DELAY) == pdTRUE) {
+            total = self->_behaviors.ingest(response.c_str(), response.length());
+            stats = self->_behaviors.getStats();
+            xSemaphoreGive(self->_behaviorsMutex);
         }
         
         // Set success flag if we added at least one behavior
-        success = (startPos > 0);
+        success = total > 0;
         
         if (self->_logger) {
             if (success) {
-                self->_fileManager->writeFile(
-                    self->_templatesUpdateFile, 
-                    response.c_str()
-                );
-                self->_logger->info("Added %d new behaviors from GPT", total);
+                self->_logger->info("Added %d new behaviors from GPT, %d stored, %d rejected so far",
+                                    total, stats.size, stats.invalid + stats.tooLong);
             } else {
                 self->_logger->warning("No valid behaviors found in GPT response");
             }
@@ -9,6 +9,7 @@
 #include "FileManager.h"
 #include "core/Utils/CommandMapper.h"
 #include "core/Communication/GPTAdapter.h"
+#include "BehaviorStore.h"
 
 namespace Automation {
 
@@ -28,6 +29,7 @@ public:
     bool isRandomBehaviorOrder() const;
     void setRandomBehaviorOrder(bool randomOrder = true);
     bool fetchAndAddNewBehaviors(const Utils::Sstring& prompt = "Generate new robot behaviors");
+    BehaviorStore::Stats getBehaviorStats();
     
     static void taskFunction(void* parameter);
 
@@ -41,7 +43,7 @@ private:
     bool _randomBehaviorOrder;
     unsigned long _lastManualControlTime;
     int _behaviorIndex;
-    std::vector<Utils::Sstring> _templateBehaviors;
+    BehaviorStore _behaviors;
     SemaphoreHandle_t _behaviorsMutex;
 
     long _timer;
@@ -51,7 +53,8 @@ private:
 
     const Utils::Sstring _behaviorPrompt;
     const char* _templatesFile;
-    const char* _templatesUpdateFile;
+    const char* _templatesUpdateFile;     // Legacy learned behaviors, migrated into the log
+    const char* _behaviorsLogFile;
 };
 
 } // namespace Automation
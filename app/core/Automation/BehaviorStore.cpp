@@ -0,0 +1,423 @@
+#include "BehaviorStore.h"
+#include <LittleFS.h>
+#include <esp_log.h>
+#include "core/Utils/SpiAllocator.h"
+
+namespace Automation {
+
+BehaviorStore::BehaviorStore(size_t capacity, size_t maxLength)
+    : TAG("BehaviorStore"),
+      _capacity(capacity < EMPTY ? capacity : EMPTY - 1),
+      _maxLength(maxLength),
+      _slotSize(maxLength + 1),
+      _pool(nullptr),
+      _lengths(nullptr),
+      _hashes(nullptr),
+      _index(nullptr),
+      _indexMask(0),
+      _size(0),
+      _pinned(0),
+      _cursor(0),
+      _fileManager(nullptr),
+      _logPath(nullptr),
+      _stats{}
+{
+}
+
+BehaviorStore::~BehaviorStore() {
+    Utils::SpiRamAllocator* allocator = Utils::SpiRamAllocator::instance();
+    allocator->deallocate(_pool);
+    allocator->deallocate(_lengths);
+    allocator->deallocate(_hashes);
+    allocator->deallocate(_index);
+}
+
+bool BehaviorStore::allocate() {
+    if (_pool) {
+        return true;
+    }
+
+    // Twice the slots keeps the linear probes short
+    size_t indexSize = 1;
+    while (indexSize < _capacity * 2) {
+        indexSize <<= 1;
+    }
+
+    Utils::SpiRamAllocator* allocator = Utils::SpiRamAllocator::instance();
+    _pool = static_cast<char*>(allocator->allocate(_capacity * _slotSize));
+    _lengths = static_cast<uint16_t*>(allocator->allocate(_capacity * sizeof(uint16_t)));
+    _hashes = static_cast<uint32_t*>(allocator->allocate(_capacity * sizeof(uint32_t)));
+    _index = static_cast<uint16_t*>(allocator->allocate(indexSize * sizeof(uint16_t)));
+    if (!_pool || !_lengths || !_hashes || !_index) {
+        allocator->deallocate(_pool);
+        allocator->deallocate(_lengths);
+        allocator->deallocate(_hashes);
+        allocator->deallocate(_index);
+        _pool = nullptr;
+        _lengths = nullptr;
+        _hashes = nullptr;
+        _index = nullptr;
+        return false;
+    }
+    _indexMask = indexSize - 1;
+    return true;
+}
+
+void BehaviorStore::clear() {
+    _size = 0;
+    _pinned = 0;
+    _cursor = 0;
+    if (_index) {
+        memset(_index, 0xFF, (_indexMask + 1) * sizeof(uint16_t));
+    }
+}
+
+bool BehaviorStore::load(Utils::FileManager* fileManager, const char* defaultsPath, const char* logPath,
+                         const char* legacyPath) {
+    if (!allocate()) {
+        ESP_LOGE(TAG, "Could not allocate %u behavior slots", (unsigned)_capacity);
+        return false;
+    }
+    clear();
+    _fileManager = fileManager;
+    _logPath = logPath;
+    if (!_fileManager) {
+        return true;
+    }
+
+    if (defaultsPath && _fileManager->exists(defaultsPath)) {
+        readLines(defaultsPath, [this](const char* line, size_t length) {
+            add(line, length, true);
+        });
+    }
+
+    // A compaction cut short by a reset left the old log in place
+    String tmpPath = String(_logPath) + ".tmp";
+    if (_fileManager->exists(tmpPath)) {
+        if (_fileManager->exists(_logPath)) {
+            _fileManager->deleteFile(tmpPath);
+        } else {
+            LittleFS.rename(tmpPath, _logPath);
+        }
+    }
+
+    if (_fileManager->exists(_logPath)) {
+        _stats.logRecords = readLines(_logPath, [this](const char* line, size_t length) {
+            add(line, length);
+        });
+    } else if (legacyPath && _fileManager->exists(legacyPath)) {
+        readLines(legacyPath, [this](const char* line, size_t length) {
+            if (add(line, length) == AddResult::ADDED) {
+                appendLog(line, length);
+            }
+        });
+        _fileManager->deleteFile(legacyPath);
+    }
+
+    if (_stats.logRecords > 2 * (_capacity - _pinned)) {
+        compact();
+    }
+
+    ESP_LOGI(TAG, "Loaded %u behaviors, %u pinned, %u log records",
+             (unsigned)_size, (unsigned)_pinned, (unsigned)_stats.logRecords);
+    return true;
+}
+
+void BehaviorStore::normalize(const char*& line, size_t& length) {
+    while (length > 0 && isspace((unsigned char)line[0])) {
+        line++;
+        length--;
+    }
+    while (length > 0 && isspace((unsigned char)line[length - 1])) {
+        length--;
+    }
+
+    // List markers GPT sometimes adds despite the prompt: "1. ", "2) ", "- "
+    size_t digits = 0;
+    while (digits < length && isdigit((unsigned char)line[digits])) {
+        digits++;
+    }
+    size_t marker = 0;
+    if (digits > 0 && digits + 1 < length && (line[digits] == '.' || line[digits] == ')')) {
+        marker = digits + 1;
+    } else if (length > 1 && line[0] == '-') {
+        marker = 1;
+    }
+    if (marker > 0) {
+        line += marker;
+        length -= marker;
+        while (length > 0 && isspace((unsigned char)line[0])) {
+            line++;
+            length--;
+        }
+    }
+}
+
+uint32_t BehaviorStore::hash(const char* line, size_t length) {
+    // FNV-1a
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        h ^= (uint8_t)line[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+BehaviorStore::AddResult BehaviorStore::add(const char* line, size_t length, bool pinned) {
+    normalize(line, length);
+    if (length == 0) {
+        return AddResult::INVALID;
+    }
+    if (length > _maxLength) {
+        _stats.tooLong++;
+        return AddResult::TOO_LONG;
+    }
+    if (!_pool || (_validator && !_validator(line, length))) {
+        _stats.invalid++;
+        return AddResult::INVALID;
+    }
+
+    bool evicted = false;
+    AddResult result = store(line, length, pinned, evicted);
+    if (result == AddResult::DUPLICATE) {
+        _stats.duplicates++;
+    } else if (result == AddResult::ADDED) {
+        _stats.added++;
+        if (evicted) {
+            _stats.evicted++;
+        }
+    }
+    return result;
+}
+
+BehaviorStore::AddResult BehaviorStore::store(const char* line, size_t length, bool pinned, bool& evicted) {
+    uint32_t h = hash(line, length);
+    if (findSlot(h, line, length) >= 0) {
+        return AddResult::DUPLICATE;
+    }
+
+    // Pinned lines only come before the learned ones
+    pinned = pinned && _size == _pinned;
+
+    size_t slot;
+    if (_size < _capacity) {
+        slot = _size++;
+        if (pinned) {
+            _pinned++;
+        }
+        if (_size == _capacity) {
+            _cursor = _pinned;
+        }
+    } else if (!pinned && _pinned < _capacity) {
+        slot = _cursor;
+        indexRemove(slot);
+        evicted = true;
+        _cursor = _cursor + 1 < _capacity ? _cursor + 1 : _pinned;
+    } else {
+        return AddResult::FULL;
+    }
+
+    char* target = _pool + slot * _slotSize;
+    memcpy(target, line, length);
+    target[length] = '\0';
+    _lengths[slot] = length;
+    _hashes[slot] = h;
+    indexInsert(slot);
+    return AddResult::ADDED;
+}
+
+int BehaviorStore::findSlot(uint32_t h, const char* line, size_t length) const {
+    if (!_index) {
+        return -1;
+    }
+    for (size_t i = h & _indexMask; _index[i] != EMPTY; i = (i + 1) & _indexMask) {
+        uint16_t slot = _index[i];
+        if (_hashes[slot] == h && _lengths[slot] == length && memcmp(_pool + slot * _slotSize, line, length) == 0) {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+void BehaviorStore::indexInsert(uint16_t slot) {
+    size_t i = _hashes[slot] & _indexMask;
+    while (_index[i] != EMPTY) {
+        i = (i + 1) & _indexMask;
+    }
+    _index[i] = slot;
+}
+
+void BehaviorStore::indexRemove(uint16_t slot) {
+    size_t i = _hashes[slot] & _indexMask;
+    while (_index[i] != slot) {
+        if (_index[i] == EMPTY) {
+            return;
+        }
+        i = (i + 1) & _indexMask;
+    }
+
+    // Shift later entries of the probe run back so lookups still find them
+    size_t j = i;
+    while (true) {
+        j = (j + 1) & _indexMask;
+        if (_index[j] == EMPTY) {
+            break;
+        }
+        size_t home = _hashes[_index[j]] & _indexMask;
+        bool between = i <= j ? (home > i && home <= j) : (home > i || home <= j);
+        if (!between) {
+            _index[i] = _index[j];
+            i = j;
+        }
+    }
+    _index[i] = EMPTY;
+}
+
+int BehaviorStore::ingest(const char* text, size_t length) {
+    int added = 0;
+    File log;
+    if (_fileManager && _logPath) {
+        log = _fileManager->openFileForAppend(_logPath);
+    }
+
+    size_t start = 0;
+    while (start < length) {
+        const char* end = static_cast<const char*>(memchr(text + start, '\n', length - start));
+        size_t lineLength = end ? end - (text + start) : length - start;
+        const char* line = text + start;
+        normalize(line, lineLength);
+
+        if (add(line, lineLength) == AddResult::ADDED) {
+            added++;
+            if (log) {
+                log.write((const uint8_t*)line, lineLength);
+                log.write('\n');
+                _stats.logRecords++;
+            }
+        }
+        start = end ? end - text + 1 : length;
+    }
+
+    if (log) {
+        log.close();
+    }
+    if (_stats.logRecords > 2 * (_capacity - _pinned)) {
+        compact();
+    }
+    return added;
+}
+
+bool BehaviorStore::appendLog(const char* line, size_t length) {
+    File log = _fileManager->openFileForAppend(_logPath);
+    if (!log) {
+        return false;
+    }
+    log.write((const uint8_t*)line, length);
+    log.write('\n');
+    log.close();
+    _stats.logRecords++;
+    return true;
+}
+
+bool BehaviorStore::compact() {
+    if (!_fileManager || !_logPath) {
+        return false;
+    }
+
+    String tmpPath = String(_logPath) + ".tmp";
+    File tmp = _fileManager->openFileForWriting(tmpPath);
+    if (!tmp) {
+        ESP_LOGE(TAG, "Could not open %s for compaction", tmpPath.c_str());
+        return false;
+    }
+
+    // Oldest first, so a replay evicts in the same order
+    size_t learned = _size - _pinned;
+    size_t first = _size == _capacity ? _cursor : _pinned;
+    for (size_t n = 0; n < learned; n++) {
+        size_t slot = _pinned + (first - _pinned + n) % (_capacity - _pinned);
+        tmp.write((const uint8_t*)(_pool + slot * _slotSize), _lengths[slot]);
+        tmp.write('\n');
+    }
+    tmp.close();
+
+    if (!LittleFS.rename(tmpPath, _logPath)) {
+        ESP_LOGE(TAG, "Could not replace %s", _logPath);
+        _fileManager->deleteFile(tmpPath);
+        return false;
+    }
+
+    _stats.logRecords = learned;
+    _stats.compactions++;
+    return true;
+}
+
+int BehaviorStore::readLines(const char* path, const std::function<void(const char* line, size_t length)>& handler) {
+    File file = _fileManager->openFileForReading(path);
+    if (!file) {
+        return 0;
+    }
+
+    char* line = static_cast<char*>(malloc(_slotSize));
+    if (!line) {
+        file.close();
+        return 0;
+    }
+
+    int lines = 0;
+    size_t length = 0;
+    bool overflow = false;
+    uint8_t chunk[128];
+    size_t read;
+    while ((read = file.read(chunk, sizeof(chunk))) > 0) {
+        for (size_t i = 0; i < read; i++) {
+            char c = (char)chunk[i];
+            if (c == '\n') {
+                if (overflow) {
+                    _stats.tooLong++;
+                } else {
+                    handler(line, length);
+                }
+                lines++;
+                length = 0;
+                overflow = false;
+            } else if (length < _maxLength) {
+                line[length++] = c;
+            } else {
+                overflow = true;
+            }
+        }
+    }
+    if (length > 0 && !overflow) {
+        handler(line, length);
+        lines++;
+    }
+
+    free(line);
+    file.close();
+    return lines;
+}
+
+const char* BehaviorStore::at(size_t index) const {
+    if (index >= _size) {
+        return nullptr;
+    }
+    return _pool + index * _slotSize;
+}
+
+const char* BehaviorStore::pick() const {
+    if (_size == 0) {
+        return nullptr;
+    }
+    return at(random(0, _size));
+}
+
+BehaviorStore::Stats BehaviorStore::getStats() const {
+    Stats stats = _stats;
+    stats.size = _size;
+    stats.pinned = _pinned;
+    stats.capacity = _capacity;
+    return stats;
+}
+
+} // namespace Automation
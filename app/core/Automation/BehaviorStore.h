@@ -0,0 +1,137 @@
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+#include "FileManager.h"
+
+namespace Automation {
+
+/**
+ * Bounded corpus of automation behaviors
+ *
+ * Every line is normalized and checked by the validator before it is
+ * stored, so only lines the CommandMapper can run end up in the pool.
+ * Lines live in fixed slots of one PSRAM block, with a hash index for
+ * duplicate checks and O(1) pick by index.
+ *
+ * Defaults from the templates file are pinned. Learned lines fill the
+ * remaining slots and replace the oldest learned line once the pool is
+ * full, so memory stays the same however many refreshes come in.
+ *
+ * Learned lines are persisted to an append-only log, one line per
+ * record. Replaying the log through the same rules rebuilds the same
+ * pool, so evictions need no records of their own. A torn last record
+ * fails validation on replay and is dropped. Once the log holds twice
+ * as many records as there are learned slots, it is compacted to the
+ * live lines: a temporary file is written and then renamed over the log.
+ */
+class BehaviorStore {
+public:
+    typedef std::function<bool(const char* line, size_t length)> Validator;
+
+    enum class AddResult : uint8_t {
+        ADDED,
+        DUPLICATE,
+        INVALID,
+        TOO_LONG,
+        FULL            // Every slot is pinned
+    };
+
+    struct Stats {
+        uint32_t size;
+        uint32_t pinned;
+        uint32_t capacity;
+        uint32_t added;
+        uint32_t duplicates;
+        uint32_t invalid;
+        uint32_t tooLong;
+        uint32_t evicted;
+        uint32_t logRecords;
+        uint32_t compactions;
+    };
+
+    /**
+     * @param capacity Slots in the pool, pinned and learned
+     * @param maxLength Longest line kept, longer ones are rejected
+     */
+    BehaviorStore(size_t capacity, size_t maxLength);
+    ~BehaviorStore();
+
+    void setValidator(Validator validator) { _validator = validator; }
+
+    /**
+     * Allocate the pool and fill it from the defaults file and the log,
+     * migrating a legacy update file into the log if there is no log yet
+     * @return false if the pool could not be allocated
+     */
+    bool load(Utils::FileManager* fileManager, const char* defaultsPath, const char* logPath,
+              const char* legacyPath = nullptr);
+
+    /**
+     * Add one line without persisting it
+     */
+    AddResult add(const char* line, size_t length, bool pinned = false);
+
+    /**
+     * Add every line of a text, e.g. a GPT reply, and append the accepted
+     * ones to the log
+     * @return Lines added
+     */
+    int ingest(const char* text, size_t length);
+
+    size_t size() const { return _size; }
+    size_t getLearnedCount() const { return _size - _pinned; }
+
+    /**
+     * Line in a slot, valid until the next add
+     */
+    const char* at(size_t index) const;
+
+    /**
+     * Random line, nullptr when empty
+     */
+    const char* pick() const;
+
+    Stats getStats() const;
+
+private:
+    static const uint16_t EMPTY = 0xFFFF;
+
+    const char* TAG;
+    size_t _capacity;
+    size_t _maxLength;
+    size_t _slotSize;
+    char* _pool;
+    uint16_t* _lengths;
+    uint32_t* _hashes;
+    uint16_t* _index;
+    size_t _indexMask;
+    size_t _size;
+    size_t _pinned;
+    size_t _cursor;         // Oldest learned slot once the pool is full
+    Validator _validator;
+    Utils::FileManager* _fileManager;
+    const char* _logPath;
+    Stats _stats;
+
+    bool allocate();
+    void clear();
+    AddResult store(const char* line, size_t length, bool pinned, bool& evicted);
+
+    int findSlot(uint32_t hash, const char* line, size_t length) const;
+    void indexInsert(uint16_t slot);
+    void indexRemove(uint16_t slot);
+
+    /**
+     * Read a file line by line into a stack buffer
+     * @return Lines read
+     */
+    int readLines(const char* path, const std::function<void(const char* line, size_t length)>& handler);
+    bool appendLog(const char* line, size_t length);
+    bool compact();
+
+    static void normalize(const char*& line, size_t& length);
+    static uint32_t hash(const char* line, size_t length);
+};
+
+} // namespace Automation
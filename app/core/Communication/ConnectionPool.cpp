@@ -0,0 +1,275 @@
+#include "ConnectionPool.h"
+#include <esp_log.h>
+
+namespace Communication {
+
+ConnectionPool::ConnectionPool(uint32_t idleTimeoutMs, uint32_t timeoutMs)
+    : TAG("ConnectionPool"),
+      _idleTimeoutMs(idleTimeoutMs),
+      _timeoutMs(timeoutMs),
+      _rootCA(nullptr),
+      _slots{},
+      _mux(portMUX_INITIALIZER_UNLOCKED),
+      _stats{}
+{
+}
+
+ConnectionPool::~ConnectionPool() {
+    for (int i = 0; i < MAX_HOSTS; i++) {
+        if (_slots[i].client) {
+            _slots[i].client->stop();
+            delete _slots[i].client;
+        }
+    }
+}
+
+bool ConnectionPool::parseUrl(const String& url, String& host, uint16_t& port, bool& secure) {
+    int start;
+    if (url.startsWith("https://")) {
+        secure = true;
+        port = 443;
+        start = 8;
+    } else if (url.startsWith("http://")) {
+        secure = false;
+        port = 80;
+        start = 7;
+    } else {
+        return false;
+    }
+
+    int end = url.indexOf('/', start);
+    if (end < 0) {
+        end = url.length();
+    }
+    host = url.substring(start, end);
+
+    int colon = host.indexOf(':');
+    if (colon >= 0) {
+        port = host.substring(colon + 1).toInt();
+        host = host.substring(0, colon);
+    }
+    return host.length() > 0 && host.length() <= (int)MAX_HOST_LENGTH && port > 0;
+}
+
+WiFiClient* ConnectionPool::createClient(bool secure) {
+    if (!secure) {
+        return new WiFiClient();
+    }
+
+    WiFiClientSecure* client = new WiFiClientSecure();
+    if (_rootCA) {
+        client->setCACert(_rootCA);
+    } else {
+        client->setInsecure();
+    }
+    client->setHandshakeTimeout((_timeoutMs + 999) / 1000);
+    return client;
+}
+
+bool ConnectionPool::begin(HTTPClient& http, const String& url, Lease& lease) {
+    lease.slot = -1;
+    lease.client = nullptr;
+    lease.reused = false;
+
+    String host;
+    uint16_t port;
+    bool secure;
+    if (!parseUrl(url, host, port, secure)) {
+        ESP_LOGE(TAG, "Unsupported URL %s", url.c_str());
+        return false;
+    }
+
+    // Pick this host's slot, a free one, or the least recently used idle one
+    WiFiClient* evicted = nullptr;
+    int slot = -1;
+    portENTER_CRITICAL(&_mux);
+    _stats.requests++;
+    int empty = -1;
+    int oldest = -1;
+    bool hostLeased = false;
+    for (int i = 0; i < MAX_HOSTS; i++) {
+        Slot& s = _slots[i];
+        if (s.host[0] == '\0') {
+            if (empty < 0) empty = i;
+            continue;
+        }
+        if (s.port == port && s.secure == secure && host.equalsIgnoreCase(s.host)) {
+            hostLeased = s.leased;
+            if (!s.leased) slot = i;
+            break;
+        }
+        if (!s.leased && (oldest < 0 || (int32_t)(s.lastUseMs - _slots[oldest].lastUseMs) < 0)) {
+            oldest = i;
+        }
+    }
+    if (slot < 0 && !hostLeased) {
+        slot = empty >= 0 ? empty : oldest;
+        if (slot >= 0) {
+            Slot& s = _slots[slot];
+            evicted = s.client;
+            s.client = nullptr;
+            s.open = false;
+            strncpy(s.host, host.c_str(), MAX_HOST_LENGTH);
+            s.host[MAX_HOST_LENGTH] = '\0';
+            s.port = port;
+            s.secure = secure;
+        }
+    }
+    if (slot >= 0) {
+        _slots[slot].leased = true;
+    } else {
+        _stats.oneOff++;
+    }
+    portEXIT_CRITICAL(&_mux);
+
+    if (evicted) {
+        evicted->stop();
+        delete evicted;
+    }
+
+    WiFiClient* client;
+    if (slot >= 0) {
+        if (!_slots[slot].client) {
+            _slots[slot].client = createClient(secure);
+        }
+        client = _slots[slot].client;
+    } else {
+        client = createClient(secure);
+    }
+    lease.slot = slot;
+    lease.client = client;
+
+    if (client->connected()) {
+        lease.reused = true;
+    } else {
+        uint32_t startMs = millis();
+        bool connected = client->connect(host.c_str(), port, _timeoutMs);
+        uint32_t handshakeMs = millis() - startMs;
+
+        portENTER_CRITICAL(&_mux);
+        if (connected) {
+            _stats.handshakes++;
+            _stats.lastHandshakeMs = handshakeMs;
+            _stats.totalHandshakeMs += handshakeMs;
+            if (handshakeMs > _stats.maxHandshakeMs) {
+                _stats.maxHandshakeMs = handshakeMs;
+            }
+        } else {
+            _stats.handshakeFailures++;
+        }
+        portEXIT_CRITICAL(&_mux);
+
+        if (!connected) {
+            ESP_LOGE(TAG, "Connecting to %s:%u failed after %u ms", host.c_str(), port, handshakeMs);
+            end(http, lease, HTTPC_ERROR_CONNECTION_REFUSED);
+            return false;
+        }
+    }
+
+    if (slot >= 0) {
+        _slots[slot].open = true;
+    }
+
+    if (!http.begin(*client, url)) {
+        end(http, lease, HTTPC_ERROR_CONNECTION_REFUSED);
+        return false;
+    }
+    http.setReuse(true);
+    http.setTimeout(_timeoutMs);
+
+    if (lease.reused) {
+        portENTER_CRITICAL(&_mux);
+        _stats.reused++;
+        portEXIT_CRITICAL(&_mux);
+    }
+    return true;
+}
+
+void ConnectionPool::end(HTTPClient& http, Lease& lease, int httpCode) {
+    if (!lease.client) {
+        return;
+    }
+
+    // Keeps the socket open when the server allowed keep-alive
+    http.end();
+
+    bool broken = httpCode < 0;
+    if (broken) {
+        lease.client->stop();
+    }
+    bool open = !broken && lease.client->connected();
+
+    if (lease.slot < 0) {
+        lease.client->stop();
+        delete lease.client;
+    } else {
+        portENTER_CRITICAL(&_mux);
+        Slot& s = _slots[lease.slot];
+        s.open = open;
+        s.lastUseMs = millis();
+        s.leased = false;
+        if (broken && lease.reused) {
+            _stats.dropped++;
+        }
+        portEXIT_CRITICAL(&_mux);
+    }
+
+    lease.client = nullptr;
+}
+
+bool ConnectionPool::shouldRetry(const Lease& lease, int httpCode) {
+    if (!lease.reused) {
+        return false;
+    }
+    // Failed before the server could have acted on the request
+    return httpCode == HTTPC_ERROR_SEND_HEADER_FAILED ||
+           httpCode == HTTPC_ERROR_SEND_PAYLOAD_FAILED ||
+           httpCode == HTTPC_ERROR_NOT_CONNECTED ||
+           httpCode == HTTPC_ERROR_CONNECTION_LOST;
+}
+
+int ConnectionPool::closeIdle() {
+    int closing[MAX_HOSTS];
+    int count = 0;
+    uint32_t now = millis();
+
+    // Lease idle connections so nobody picks them up while they close
+    portENTER_CRITICAL(&_mux);
+    for (int i = 0; i < MAX_HOSTS; i++) {
+        Slot& s = _slots[i];
+        if (s.client && s.open && !s.leased && now - s.lastUseMs >= _idleTimeoutMs) {
+            s.leased = true;
+            closing[count++] = i;
+        }
+    }
+    portEXIT_CRITICAL(&_mux);
+
+    for (int i = 0; i < count; i++) {
+        _slots[closing[i]].client->stop();
+    }
+
+    portENTER_CRITICAL(&_mux);
+    for (int i = 0; i < count; i++) {
+        _slots[closing[i]].open = false;
+        _slots[closing[i]].leased = false;
+    }
+    _stats.idleCloses += count;
+    portEXIT_CRITICAL(&_mux);
+
+    return count;
+}
+
+ConnectionPool::Stats ConnectionPool::getStats() const {
+    portENTER_CRITICAL(&_mux);
+    Stats stats = _stats;
+    stats.open = 0;
+    for (int i = 0; i < MAX_HOSTS; i++) {
+        if (_slots[i].open) {
+            stats.open++;
+        }
+    }
+    portEXIT_CRITICAL(&_mux);
+    return stats;
+}
+
+} // namespace Communication
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <Arduino.h>
+#include <WiFiClient.h>
+#include <WiFiClientSecure.h>
+#include <HTTPClient.h>
+#include "freertos/FreeRTOS.h"
+
+namespace Communication {
+
+/**
+ * Shared keep-alive connections for outbound HTTP(S)
+ *
+ * Keeps one client per host:port open between requests, so GPT and weather
+ * requests to a host that allows keep-alive skip the TCP connect and TLS
+ * handshake after the first one. A connection unused for the idle timeout
+ * is closed by closeIdle(), which frees its TLS buffers. A request to a
+ * host whose connection is leased by another task gets a one-off client
+ * instead of waiting.
+ *
+ * Usage:
+ *   ConnectionPool::Lease lease;
+ *   if (pool->begin(http, url, lease)) {
+ *       int code = http.GET();
+ *       ...
+ *       pool->end(http, lease, code);
+ *   }
+ */
+class ConnectionPool {
+public:
+    static const int MAX_HOSTS = 4;
+    static const size_t MAX_HOST_LENGTH = 64;
+
+    struct Lease {
+        int slot;               // -1 for a one-off client
+        WiFiClient* client;
+        bool reused;            // Connection was already open
+    };
+
+    struct Stats {
+        uint32_t requests;
+        uint32_t reused;            // Requests sent on an open connection
+        uint32_t handshakes;        // New connections, TCP connect plus TLS handshake
+        uint32_t handshakeFailures;
+        uint32_t lastHandshakeMs;
+        uint32_t maxHandshakeMs;
+        uint32_t totalHandshakeMs;
+        uint32_t oneOff;            // Requests that found their host's connection leased
+        uint32_t dropped;           // Open connections that failed on use
+        uint32_t idleCloses;
+        uint32_t open;              // Connections open now
+    };
+
+    /**
+     * @param idleTimeoutMs Unused time before a connection is closed
+     * @param timeoutMs Connect and read timeout
+     */
+    ConnectionPool(uint32_t idleTimeoutMs = 30000, uint32_t timeoutMs = 10000);
+    ~ConnectionPool();
+
+    /**
+     * Set the CA certificate for TLS hosts, without one the server is not verified
+     * @param rootCA PEM certificate or bundle, must stay valid; set before the first request
+     */
+    void setCACert(const char* rootCA) { _rootCA = rootCA; }
+
+    /**
+     * Lease the connection for a URL, opening it if needed, and begin the request
+     * @return false if the URL is invalid or the connection failed
+     */
+    bool begin(HTTPClient& http, const String& url, Lease& lease);
+
+    /**
+     * End the request and return the connection
+     * @param httpCode Result of the request, a transport error closes the connection
+     */
+    void end(HTTPClient& http, Lease& lease, int httpCode);
+
+    /**
+     * Whether a failed request is worth sending again: the connection was
+     * reused and the server had closed it meanwhile
+     */
+    static bool shouldRetry(const Lease& lease, int httpCode);
+
+    /**
+     * Close connections unused for longer than the idle timeout, called periodically
+     * @return Connections closed
+     */
+    int closeIdle();
+
+    Stats getStats() const;
+
+private:
+    struct Slot {
+        char host[MAX_HOST_LENGTH + 1];
+        uint16_t port;
+        bool secure;
+        bool leased;            // In use, or being closed
+        bool open;              // Connected after its last use
+        uint32_t lastUseMs;
+        WiFiClient* client;
+    };
+
+    const char* TAG;
+    uint32_t _idleTimeoutMs;
+    uint32_t _timeoutMs;
+    const char* _rootCA;
+    Slot _slots[MAX_HOSTS];
+    mutable portMUX_TYPE _mux;
+    Stats _stats;
+
+    WiFiClient* createClient(bool secure);
+    static bool parseUrl(const String& url, String& host, uint16_t& port, bool& secure);
+};
+
+} // namespace Communication
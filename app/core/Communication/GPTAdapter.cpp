@@ -4,9 +4,35 @@
 
 namespace Communication {
 
-GPTAdapter::GPTAdapter() : _model("gpt-4.1-nano-2025-04-14"), 
-                           _maxTokens(1024), _temperature(0.7), _initialized(false) {
-    _systemMessage = Utils::Sstring(R"===(
+namespace {
+
+/**
+ * Hands body bytes to the parser as HTTPClient reads them, after the
+ * chunked transfer encoding is removed
+ */
+class ParserStream : public Stream {
+public:
+    explicit ParserStream(GptStreamParser& parser) : _parser(parser) {}
+
+    size_t write(uint8_t c) override {
+        _parser.feed((const char*)&c, 1);
+        return 1;
+    }
+
+    size_t write(const uint8_t* buffer, size_t size) override {
+        _parser.feed((const char*)buffer, size);
+        return size;
+    }
+
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+
+private:
+    GptStreamParser& _parser;
+};
+
+const char DEFAULT_SYSTEM_MESSAGE[] = R"===(
 You are a digital pet named Cozmo running inside an ESP32-CAM system.
 You have a mind like a dog — simple, cute, and friendly.
 You do not ask questions back; you only respond to the user's requests.
@@ -69,11 +95,23 @@ Examples of invalid responses (do not produce):
 - Any text outside of commands when responding to system status messages
 
 Follow these rules strictly. Your goal is to act as a cute, simple digital pet named Cozmo, responding naturally but always embedding your face expression commands in the exact format above.
-			)===");
+			)===";
+
+} // namespace
+
+GPTAdapter::GPTAdapter() : _endpoint("https://api.openai.com/v1/chat/completions"), _pool(nullptr),
+                           _model("gpt-4.1-nano-2025-04-14"), 
+                           _maxTokens(1024), _temperature(0.7), _initialized(false),
+                           _streaming(false), _statsMux(portMUX_INITIALIZER_UNLOCKED),
+                           _streamStats{} {
+    _systemMutex = xSemaphoreCreateMutex();
+    _systemTemplate.compile(DEFAULT_SYSTEM_MESSAGE);
 }
 
 GPTAdapter::~GPTAdapter() {
-    // Clean up resources if needed
+    if (_systemMutex) {
+        vSemaphoreDelete(_systemMutex);
+    }
 }
 
 bool GPTAdapter::init(const Utils::Sstring& apiKey) {
@@ -87,44 +125,46 @@ void GPTAdapter::sendPrompt(const Utils::Sstring& prompt, ResponseCallback callb
 }
 
 void GPTAdapter::sendPrompt(const Utils::Sstring& prompt, const Utils::Sstring& additionalCommand, ResponseCallback callback) {
-    Utils::Sstring msg = _systemMessage;
-    msg.replace("--*additional command*--", additionalCommand);
-    sendPromptWithCustomSystem(prompt, msg.toString(), callback);
+    size_t length = 0;
+    char* payload = buildTemplatedPayload(prompt, [&](PromptWriter& out) {
+        out.text(additionalCommand.c_str(), additionalCommand.length());
+    }, PromptWriter::escapedLength(additionalCommand.c_str(), additionalCommand.length()), false, length);
+    sendPayload(payload, length, callback);
 }
 
 void GPTAdapter::sendPromptWithCustomSystem(const Utils::Sstring& prompt, const Utils::Sstring& systemCommand, ResponseCallback callback) {
-    if (!_initialized) {
+    size_t length = 0;
+    char* payload = buildPayload(prompt, [&](PromptWriter& out) {
+        out.text(systemCommand.c_str(), systemCommand.length());
+    }, PromptWriter::escapedLength(systemCommand.c_str(), systemCommand.length()), false, length);
+    sendPayload(payload, length, callback);
+}
+
+void GPTAdapter::sendPromptWithCustomSystem(const Utils::Sstring& prompt, const Utils::Sstring& systemCommand,
+                                            const ContextWriter& context, ResponseCallback callback) {
+    size_t length = 0;
+    char* payload = buildPayload(prompt, [&](PromptWriter& out) {
+        out.text(systemCommand.c_str(), systemCommand.length());
+        if (context) {
+            context(out);
+        }
+    }, PromptWriter::escapedLength(systemCommand.c_str(), systemCommand.length()) + CONTEXT_CAPACITY, false, length);
+    sendPayload(payload, length, callback);
+}
+
+void GPTAdapter::sendPayload(char* payload, size_t length, ResponseCallback callback) {
+    if (!_initialized || !payload) {
+        Utils::SpiRamAllocator::instance()->deallocate(payload);
         if (callback) {
-            callback("Error: GPT adapter not initialized");
+            callback(_initialized ? "Error: Could not build the request" : "Error: GPT adapter not initialized");
         }
         return;
     }
     
     HTTPClient http;
-    http.begin("https://api.openai.com/v1/chat/completions");
-    http.addHeader("Content-Type", "application/json");
-    http.addHeader("Authorization", "Bearer " + _apiKey.toString());
-    http.setReuse(true);
-    http.setTimeout(15000);
-    
-    // Prepare JSON payload
-    Utils::SpiJsonDocument doc;
-    doc["model"] = _model;
-    doc["temperature"] = _temperature;
-    doc["max_tokens"] = _maxTokens;
-    
-    // System message
-    doc["messages"][0]["role"] = "system";
-    doc["messages"][0]["content"] = systemCommand;
-    
-    // User message
-    doc["messages"][1]["role"] = "user";
-    doc["messages"][1]["content"] = prompt;
-    
-    String payload;
-    serializeJson(doc, payload);
-    
-    int httpCode = http.POST(payload.c_str());
+    ConnectionPool::Lease lease;
+    int httpCode = post(http, lease, payload, length, false);
+    Utils::SpiRamAllocator::instance()->deallocate(payload);
     
     if (httpCode > 0) {
         Utils::Sstring response = http.getString();
@@ -135,7 +175,271 @@ void GPTAdapter::sendPromptWithCustomSystem(const Utils::Sstring& prompt, const
         }
     }
     
-    http.end();
+    endRequest(http, lease, httpCode);
+}
+
+bool GPTAdapter::beginRequest(HTTPClient& http, ConnectionPool::Lease& lease) {
+    if (_pool) {
+        return _pool->begin(http, _endpoint.toString(), lease);
+    }
+    lease = {-1, nullptr, false};
+    return http.begin(_endpoint.c_str());
+}
+
+void GPTAdapter::endRequest(HTTPClient& http, ConnectionPool::Lease& lease, int httpCode) {
+    if (_pool) {
+        _pool->end(http, lease, httpCode);
+    } else {
+        http.end();
+    }
+}
+
+int GPTAdapter::post(HTTPClient& http, ConnectionPool::Lease& lease, const char* payload, size_t length, bool stream) {
+    int httpCode = HTTPC_ERROR_CONNECTION_REFUSED;
+
+    // A kept-alive connection the server closed meanwhile gets one more try
+    for (int attempt = 0; attempt < 2; attempt++) {
+        if (!beginRequest(http, lease)) {
+            return HTTPC_ERROR_CONNECTION_REFUSED;
+        }
+        http.addHeader("Content-Type", "application/json");
+        if (stream) {
+            http.addHeader("Accept", "text/event-stream");
+        }
+        http.addHeader("Authorization", "Bearer " + _apiKey.toString());
+        http.setReuse(true);
+        http.setTimeout(stream ? STREAM_TIMEOUT_MS : 15000);
+
+        httpCode = http.POST((uint8_t*)payload, length);
+        if (attempt > 0 || !ConnectionPool::shouldRetry(lease, httpCode)) {
+            break;
+        }
+        endRequest(http, lease, httpCode);
+    }
+    return httpCode;
+}
+
+char* GPTAdapter::buildPayload(const Utils::Sstring& prompt, const SystemWriter& system, size_t systemCapacity,
+                                bool stream, size_t& length) {
+    uint32_t startUs = micros();
+
+    // Sized up front, the body is written once and never grows
+    size_t capacity = PAYLOAD_OVERHEAD + systemCapacity +
+                      PromptWriter::escapedLength(_model.c_str(), _model.length()) +
+                      PromptWriter::escapedLength(prompt.c_str(), prompt.length()) + 1;
+    char* buffer = static_cast<char*>(Utils::SpiRamAllocator::instance()->allocate(capacity));
+    if (!buffer) {
+        return nullptr;
+    }
+
+    PromptWriter out(buffer, capacity);
+    out.raw("{\"model\":\"").text(_model.c_str(), _model.length())
+       .raw("\",\"temperature\":").number(_temperature, 2)
+       .raw(",\"max_tokens\":").number((long)_maxTokens);
+    if (stream) {
+        out.raw(",\"stream\":true");
+    }
+    out.raw(",\"messages\":[{\"role\":\"system\",\"content\":\"");
+    system(out);
+    out.raw("\"},{\"role\":\"user\",\"content\":\"").text(prompt.c_str(), prompt.length()).raw("\"}]}");
+
+    uint32_t buildUs = micros() - startUs;
+    portENTER_CRITICAL(&_statsMux);
+    _streamStats.lastPayloadBytes = out.length();
+    _streamStats.lastAllocatedBytes = capacity;
+    _streamStats.lastBuildUs = buildUs;
+    if (out.overflowed()) {
+        _streamStats.payloadOverflows++;
+    }
+    portEXIT_CRITICAL(&_statsMux);
+
+    if (out.overflowed()) {
+        ESP_LOGE("GPTAdapter", "Prompt does not fit in %u bytes", (unsigned)capacity);
+        Utils::SpiRamAllocator::instance()->deallocate(buffer);
+        return nullptr;
+    }
+    length = out.length();
+    return buffer;
+}
+
+char* GPTAdapter::buildTemplatedPayload(const Utils::Sstring& prompt, const SystemWriter& inner, size_t innerCapacity,
+                                        bool stream, size_t& length) {
+    if (xSemaphoreTake(_systemMutex, portMAX_DELAY) != pdTRUE) {
+        return nullptr;
+    }
+    char* payload = buildPayload(prompt, [&](PromptWriter& out) {
+        _systemTemplate.writePrefix(out);
+        inner(out);
+        _systemTemplate.writeSuffix(out);
+    }, _systemTemplate.length() + innerCapacity, stream, length);
+    xSemaphoreGive(_systemMutex);
+    return payload;
+}
+
+bool GPTAdapter::streamPrompt(const Utils::Sstring& prompt, const Utils::Sstring& additionalCommand, const StreamHandlers& handlers) {
+    if (!claimStream()) {
+        return false;
+    }
+    size_t length = 0;
+    char* payload = buildTemplatedPayload(prompt, [&](PromptWriter& out) {
+        out.text(additionalCommand.c_str(), additionalCommand.length());
+    }, PromptWriter::escapedLength(additionalCommand.c_str(), additionalCommand.length()), true, length);
+    return startStream(payload, length, handlers);
+}
+
+bool GPTAdapter::streamPrompt(const Utils::Sstring& prompt, const ContextWriter& context, const StreamHandlers& handlers) {
+    if (!claimStream()) {
+        return false;
+    }
+    size_t length = 0;
+    char* payload = buildTemplatedPayload(prompt, [&](PromptWriter& out) {
+        if (context) {
+            context(out);
+        }
+    }, CONTEXT_CAPACITY, true, length);
+    return startStream(payload, length, handlers);
+}
+
+bool GPTAdapter::streamPromptWithCustomSystem(const Utils::Sstring& prompt, const Utils::Sstring& systemCommand, const StreamHandlers& handlers) {
+    if (!claimStream()) {
+        return false;
+    }
+    size_t length = 0;
+    char* payload = buildPayload(prompt, [&](PromptWriter& out) {
+        out.text(systemCommand.c_str(), systemCommand.length());
+    }, PromptWriter::escapedLength(systemCommand.c_str(), systemCommand.length()), true, length);
+    return startStream(payload, length, handlers);
+}
+
+bool GPTAdapter::claimStream() {
+    if (!_initialized) {
+        return false;
+    }
+
+    // One stream at a time, a second reply would talk over the first
+    portENTER_CRITICAL(&_statsMux);
+    bool busy = _streaming;
+    if (busy) {
+        _streamStats.busy++;
+    } else {
+        _streaming = true;
+    }
+    portEXIT_CRITICAL(&_statsMux);
+    return !busy;
+}
+
+bool GPTAdapter::startStream(char* payload, size_t length, const StreamHandlers& handlers) {
+    if (!payload) {
+        _streaming = false;
+        return false;
+    }
+
+    StreamRequest* request = new StreamRequest();
+    request->adapter = this;
+    request->payload = payload;
+    request->length = length;
+    request->handlers = handlers;
+
+    if (xTaskCreatePinnedToCore(streamTaskFunction, "gpt_stream", STREAM_STACK_SIZE, request,
+                                1, nullptr, tskNO_AFFINITY) != pdPASS) {
+        Utils::SpiRamAllocator::instance()->deallocate(payload);
+        delete request;
+        _streaming = false;
+        return false;
+    }
+    return true;
+}
+
+void GPTAdapter::streamTaskFunction(void* parameter) {
+    StreamRequest* request = static_cast<StreamRequest*>(parameter);
+    GPTAdapter* self = request->adapter;
+
+    self->runStream(request);
+
+    delete request;
+    self->_streaming = false;
+    vTaskDelete(NULL);
+}
+
+void GPTAdapter::runStream(StreamRequest* request) {
+    uint32_t startMs = millis();
+    uint32_t firstTokenMs = 0;
+    Utils::Sstring text;
+    Utils::Sstring error;
+
+    GptStreamParser* parser = new GptStreamParser();
+    parser->onCommand(request->handlers.onCommand);
+    parser->onSentence(request->handlers.onSentence);
+    parser->onToken([&](const char* token, size_t length) {
+        if (firstTokenMs == 0) {
+            firstTokenMs = millis() - startMs;
+        }
+        text += token;
+    });
+
+    HTTPClient http;
+    ConnectionPool::Lease lease;
+    int httpCode = post(http, lease, request->payload, request->length, true);
+    Utils::SpiRamAllocator::instance()->deallocate(request->payload);     // Not needed while the reply streams in
+    request->payload = nullptr;
+    int endCode = httpCode;
+
+    if (httpCode == HTTP_CODE_OK) {
+        ParserStream sink(*parser);
+        int written = http.writeToStream(&sink);
+        parser->finish();
+        if (written < 0) {
+            endCode = written;      // Body not read to the end, the connection can't be reused
+        }
+        if (parser->hasError()) {
+            error = Utils::Sstring("API Error: ") + parser->getError();
+        } else if (written < 0 && !parser->isDone()) {
+            error = "Error: " + http.errorToString(written);
+        }
+    } else if (httpCode > 0) {
+        // Errors come back as a plain JSON body, not as events
+        Utils::SpiJsonDocument doc;
+        if (!deserializeJson(doc, http.getString()) && !doc["error"].isUnbound()) {
+            error = Utils::Sstring("API Error: ") + doc["error"]["message"].as<String>();
+        } else {
+            error = Utils::Sstring("Error: HTTP ") + Utils::Sstring(httpCode);
+        }
+    } else {
+        error = "Error: " + http.errorToString(httpCode);
+    }
+    endRequest(http, lease, endCode);
+
+    uint32_t totalMs = millis() - startMs;
+    portENTER_CRITICAL(&_statsMux);
+    _streamStats.requests++;
+    if (error.length() > 0) {
+        _streamStats.failures++;
+    }
+    _streamStats.bytes += parser->getStats().bytes;
+    _streamStats.lastTotalMs = totalMs;
+    if (firstTokenMs > 0) {
+        _streamStats.lastFirstTokenMs = firstTokenMs;
+        if (firstTokenMs > _streamStats.maxFirstTokenMs) {
+            _streamStats.maxFirstTokenMs = firstTokenMs;
+        }
+    }
+    portEXIT_CRITICAL(&_statsMux);
+    delete parser;
+
+    if (request->handlers.onDone) {
+        request->handlers.onDone(text, error);
+    }
+}
+
+GPTAdapter::StreamStats GPTAdapter::getStreamStats() const {
+    portENTER_CRITICAL(&_statsMux);
+    StreamStats stats = _streamStats;
+    portEXIT_CRITICAL(&_statsMux);
+    return stats;
+}
+
+void GPTAdapter::setEndpoint(const Utils::Sstring& url) {
+    _endpoint = url;
 }
 
 void GPTAdapter::setModel(const Utils::Sstring& model) {
@@ -143,7 +447,12 @@ void GPTAdapter::setModel(const Utils::Sstring& model) {
 }
 
 void GPTAdapter::setSystemMessage(const Utils::Sstring& message) {
+    if (xSemaphoreTake(_systemMutex, portMAX_DELAY) != pdTRUE) {
+        return;
+    }
     _systemMessage = message;
+    _systemTemplate.compile(_systemMessage.c_str());
+    xSemaphoreGive(_systemMutex);
 }
 
 void GPTAdapter::setMaxTokens(int maxTokens) {
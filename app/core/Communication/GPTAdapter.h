@@ -3,15 +3,53 @@
 #include <Arduino.h>
 #include <ArduinoJson.h>
 #include <functional>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
 #include "Sstring.h"
+#include "GptStreamParser.h"
+#include "ConnectionPool.h"
+#include "PromptBuilder.h"
 
 namespace Communication {
 
 class GPTAdapter {
 public:
+    static const uint32_t STREAM_STACK_SIZE = 10 * 1024;   // TLS and the parser buffers
+    static const uint32_t STREAM_TIMEOUT_MS = 15000;        // Longest silence between two reads
+    static const size_t CONTEXT_CAPACITY = 4 * 1024;        // Room for a context written by a ContextWriter
     // Callback type for GPT responses
     using ResponseCallback = std::function<void(const Utils::Sstring& response)>;
 
+    /**
+     * Callbacks of a streamed prompt, all called from the stream task
+     */
+    /**
+     * Writes the context of a prompt straight into the request body, in
+     * place of the marker in the system message
+     */
+    using ContextWriter = std::function<void(PromptWriter& out)>;
+
+    struct StreamHandlers {
+        GptStreamParser::CommandHandler onCommand;      // Each [COMMAND] as soon as it is complete
+        GptStreamParser::SentenceHandler onSentence;    // Each spoken sentence as soon as it ends
+        std::function<void(const Utils::Sstring& text, const Utils::Sstring& error)> onDone;  // Full reply, error empty on success
+    };
+
+    struct StreamStats {
+        uint32_t requests;
+        uint32_t failures;
+        uint32_t busy;              // Refused while another stream was running
+        uint32_t lastFirstTokenMs;  // Request start to first token
+        uint32_t lastTotalMs;       // Request start to end of stream
+        uint32_t maxFirstTokenMs;
+        uint32_t bytes;
+        uint32_t lastPayloadBytes;      // Request body of the last prompt, streamed or not
+        uint32_t lastAllocatedBytes;    // Allocated to build it, a single buffer
+        uint32_t lastBuildUs;
+        uint32_t payloadOverflows;      // Prompts dropped for outgrowing their buffer
+    };
+
     GPTAdapter();
     ~GPTAdapter();
 
@@ -37,6 +75,44 @@ public:
     void sendPrompt(const Utils::Sstring& prompt, const Utils::Sstring& additionalCommand, ResponseCallback callback);
     void sendPromptWithCustomSystem(const Utils::Sstring& prompt, const Utils::Sstring& systemCommand, ResponseCallback callback);
 
+    /**
+     * Send a prompt whose system message is followed by a context written
+     * by a callback into the request body, up to CONTEXT_CAPACITY bytes
+     * once escaped
+     */
+    void sendPromptWithCustomSystem(const Utils::Sstring& prompt, const Utils::Sstring& systemCommand,
+                                    const ContextWriter& context, ResponseCallback callback);
+
+    /**
+     * Send a prompt with `stream: true` and return at once; the reply is
+     * parsed while it arrives on a task of its own, so the first command
+     * and sentence are handled after the first tokens, not the whole reply
+     * @return false if not initialized, another stream is running or the
+     *         task could not be created; onDone is not called then
+     */
+    bool streamPrompt(const Utils::Sstring& prompt, const Utils::Sstring& additionalCommand, const StreamHandlers& handlers);
+
+    /**
+     * Stream a prompt whose context is written by a callback into the
+     * request body, up to CONTEXT_CAPACITY bytes once escaped
+     */
+    bool streamPrompt(const Utils::Sstring& prompt, const ContextWriter& context, const StreamHandlers& handlers);
+    bool streamPromptWithCustomSystem(const Utils::Sstring& prompt, const Utils::Sstring& systemCommand, const StreamHandlers& handlers);
+
+    bool isStreaming() const { return _streaming; }
+    StreamStats getStreamStats() const;
+
+    /**
+     * Set the chat completions URL, e.g. a local mock server
+     */
+    void setEndpoint(const Utils::Sstring& url);
+
+    /**
+     * Send requests over shared keep-alive connections instead of a new
+     * connection each time; without a pool every request connects anew
+     */
+    void setConnectionPool(ConnectionPool* pool) { _pool = pool; }
+
     /**
      * Set the model to use
      * @param model The model name (e.g., "gpt-3.5-turbo", "gpt-4")
@@ -44,7 +120,8 @@ public:
     void setModel(const Utils::Sstring& model);
 
     /**
-     * Set the system message
+     * Set the system message, waits for a request being built from the
+     * current one
      * @param message The system message to use
      */
     void setSystemMessage(const Utils::Sstring& message);
@@ -62,15 +139,56 @@ public:
     void setTemperature(float temperature);
 
 private:
+    static const size_t PAYLOAD_OVERHEAD = 192;     // JSON around the messages, numbers included
+
+    using SystemWriter = std::function<void(PromptWriter& out)>;
+
+    struct StreamRequest {
+        GPTAdapter* adapter;
+        char* payload;
+        size_t length;
+        StreamHandlers handlers;
+    };
+
     Utils::Sstring _apiKey;
+    Utils::Sstring _endpoint;
+    ConnectionPool* _pool;
     Utils::Sstring _model;
-    Utils::Sstring _systemMessage;
+    Utils::Sstring _systemMessage;      // Text a custom _systemTemplate points into
+    PromptTemplate _systemTemplate;
+    SemaphoreHandle_t _systemMutex;     // Held while _systemTemplate is written or changed
     int _maxTokens;
     float _temperature;
     bool _initialized;
+    volatile bool _streaming;
+    mutable portMUX_TYPE _statsMux;
+    StreamStats _streamStats;
     
     // Process the HTTP response
     void processResponse(const Utils::Sstring& response, ResponseCallback callback);
+
+    bool beginRequest(HTTPClient& http, ConnectionPool::Lease& lease);
+    void endRequest(HTTPClient& http, ConnectionPool::Lease& lease, int httpCode);
+    int post(HTTPClient& http, ConnectionPool::Lease& lease, const char* payload, size_t length, bool stream);
+    void sendPayload(char* payload, size_t length, ResponseCallback callback);
+
+    /**
+     * Write the request body into one buffer sized for the system content
+     * @return Body to free with SpiRamAllocator, nullptr if it did not fit
+     */
+    char* buildPayload(const Utils::Sstring& prompt, const SystemWriter& system, size_t systemCapacity,
+                       bool stream, size_t& length);
+
+    /**
+     * buildPayload() with the system template around what inner writes,
+     * holding the template so setSystemMessage() cannot change it midway
+     */
+    char* buildTemplatedPayload(const Utils::Sstring& prompt, const SystemWriter& inner, size_t innerCapacity,
+                                bool stream, size_t& length);
+    bool claimStream();
+    bool startStream(char* payload, size_t length, const StreamHandlers& handlers);
+    void runStream(StreamRequest* request);
+    static void streamTaskFunction(void* parameter);
 };
 
 } // namespace Communication
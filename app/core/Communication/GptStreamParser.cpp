@@ -0,0 +1,361 @@
+#include "GptStreamParser.h"
+#include <string.h>
+
+namespace Communication {
+
+GptStreamParser::GptStreamParser() {
+    reset();
+}
+
+void GptStreamParser::reset() {
+    _lineLength = 0;
+    _lineOverflow = false;
+    _sentenceLength = 0;
+    _sentenceEnding = false;
+    _commandLength = 0;
+    _route = ROUTE_TEXT;
+    _tokenLength = 0;
+    _error[0] = '\0';
+    _done = false;
+    _stats = {};
+}
+
+void GptStreamParser::feed(const char* data, size_t length) {
+    _stats.bytes += length;
+
+    for (size_t i = 0; i < length; i++) {
+        char c = data[i];
+        if (c == '\n') {
+            if (_lineOverflow) {
+                _stats.malformed++;
+            } else {
+                _line[_lineLength] = '\0';
+                handleLine(_line, _lineLength);
+            }
+            _lineLength = 0;
+            _lineOverflow = false;
+        } else if (c == '\r') {
+            continue;
+        } else if (_lineLength < MAX_LINE) {
+            _line[_lineLength++] = c;
+        } else {
+            _lineOverflow = true;
+        }
+    }
+}
+
+void GptStreamParser::finish() {
+    if (_lineLength > 0 && !_lineOverflow) {
+        _line[_lineLength] = '\0';
+        handleLine(_line, _lineLength);
+    }
+    _lineLength = 0;
+    _lineOverflow = false;
+
+    if (_route == ROUTE_COMMAND) {
+        flushCommandAsSpeech();
+        _route = ROUTE_TEXT;
+    }
+    flushSentence();
+}
+
+void GptStreamParser::handleLine(const char* line, size_t length) {
+    // Only data lines carry anything, event names, ids and comments do not
+    if (length < 5 || strncmp(line, "data:", 5) != 0) {
+        return;
+    }
+    size_t start = 5;
+    if (start < length && line[start] == ' ') {
+        start++;
+    }
+    _stats.events++;
+    handleEvent(line + start, length - start);
+}
+
+void GptStreamParser::handleEvent(const char* payload, size_t length) {
+    if (length == 6 && strncmp(payload, "[DONE]", 6) == 0) {
+        _done = true;
+        return;
+    }
+
+    size_t pos;
+    if (findKey(payload, length, 0, "error", pos) && pos < length && payload[pos] == '{') {
+        size_t messagePos;
+        size_t errorLength = 0;
+        if (findKey(payload, length, pos, "message", messagePos) &&
+            decodeString(payload, length, messagePos, _error, MAX_ERROR, errorLength)) {
+            _error[errorLength] = '\0';
+        } else {
+            strncpy(_error, "Unreadable error event", MAX_ERROR);
+            _error[MAX_ERROR] = '\0';
+        }
+        return;
+    }
+
+    size_t deltaPos;
+    if (!findKey(payload, length, 0, "delta", deltaPos)) {
+        _stats.malformed++;
+        return;
+    }
+
+    // The last delta is empty and the first one only names the role
+    size_t contentPos;
+    if (!findKey(payload, length, deltaPos, "content", contentPos) || payload[contentPos] != '"') {
+        return;
+    }
+
+    if (!decodeString(payload, length, contentPos, _token, MAX_LINE, _tokenLength)) {
+        _stats.malformed++;
+        return;
+    }
+    if (_tokenLength == 0) {
+        return;
+    }
+    _token[_tokenLength] = '\0';
+    _stats.tokens++;
+
+    if (_onToken) {
+        _onToken(_token, _tokenLength);
+    }
+    routeContent(_token, _tokenLength);
+}
+
+const char* GptStreamParser::findKey(const char* json, size_t length, size_t from, const char* key, size_t& valuePos) {
+    size_t keyLength = strlen(key);
+
+    for (size_t i = from; i + keyLength + 2 <= length; i++) {
+        if (json[i] != '"' || json[i + keyLength + 1] != '"' || strncmp(json + i + 1, key, keyLength) != 0) {
+            continue;
+        }
+
+        size_t p = i + keyLength + 2;
+        while (p < length && (json[p] == ' ' || json[p] == '\t')) p++;
+        if (p >= length || json[p] != ':') {
+            continue;   // A string value that happens to equal the key
+        }
+        p++;
+        while (p < length && (json[p] == ' ' || json[p] == '\t')) p++;
+        if (p >= length) {
+            return nullptr;
+        }
+        valuePos = p;
+        return json + i;
+    }
+    return nullptr;
+}
+
+bool GptStreamParser::decodeString(const char* json, size_t length, size_t& pos, char* out, size_t capacity, size_t& outLength) {
+    outLength = 0;
+    if (pos >= length || json[pos] != '"') {
+        return false;
+    }
+
+    // Characters past the capacity are dropped, the string is still consumed
+    auto put = [&](char c) {
+        if (outLength < capacity) out[outLength++] = c;
+    };
+
+    size_t p = pos + 1;
+    while (p < length) {
+        char c = json[p++];
+        if (c == '"') {
+            pos = p;
+            return true;
+        }
+        if (c != '\\') {
+            put(c);
+            continue;
+        }
+        if (p >= length) {
+            return false;
+        }
+
+        char escape = json[p++];
+        switch (escape) {
+            case 'n': put('\n'); break;
+            case 'r': put('\r'); break;
+            case 't': put('\t'); break;
+            case 'b': put('\b'); break;
+            case 'f': put('\f'); break;
+            case 'u': {
+                auto hex = [&](size_t at, uint32_t& value) -> bool {
+                    if (at + 4 > length) return false;
+                    value = 0;
+                    for (size_t k = at; k < at + 4; k++) {
+                        char h = json[k];
+                        value <<= 4;
+                        if (h >= '0' && h <= '9') value |= h - '0';
+                        else if (h >= 'a' && h <= 'f') value |= h - 'a' + 10;
+                        else if (h >= 'A' && h <= 'F') value |= h - 'A' + 10;
+                        else return false;
+                    }
+                    return true;
+                };
+
+                uint32_t code;
+                if (!hex(p, code)) {
+                    return false;
+                }
+                p += 4;
+
+                // Surrogate pair, characters outside the basic plane such as emoji
+                uint32_t low;
+                if (code >= 0xD800 && code <= 0xDBFF && p + 6 <= length &&
+                    json[p] == '\\' && json[p + 1] == 'u' && hex(p + 2, low) &&
+                    low >= 0xDC00 && low <= 0xDFFF) {
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    p += 6;
+                }
+
+                if (code < 0x80) {
+                    put((char)code);
+                } else if (code < 0x800) {
+                    put((char)(0xC0 | (code >> 6)));
+                    put((char)(0x80 | (code & 0x3F)));
+                } else if (code < 0x10000) {
+                    put((char)(0xE0 | (code >> 12)));
+                    put((char)(0x80 | ((code >> 6) & 0x3F)));
+                    put((char)(0x80 | (code & 0x3F)));
+                } else {
+                    put((char)(0xF0 | (code >> 18)));
+                    put((char)(0x80 | ((code >> 12) & 0x3F)));
+                    put((char)(0x80 | ((code >> 6) & 0x3F)));
+                    put((char)(0x80 | (code & 0x3F)));
+                }
+                break;
+            }
+            default:
+                // \" \\ \/
+                put(escape);
+                break;
+        }
+    }
+    return false;
+}
+
+void GptStreamParser::routeContent(const char* text, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        routeChar(text[i]);
+    }
+}
+
+bool GptStreamParser::isCommandChar(char c, bool inParameter) {
+    if (inParameter) {
+        return (c >= '0' && c <= '9') || c == 'm' || c == 's' || c == 'h';
+    }
+    return (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+void GptStreamParser::routeChar(char c) {
+    if (_route == ROUTE_COMMAND) {
+        bool inParameter = memchr(_command, '=', _commandLength) != nullptr;
+
+        if (c == ']') {
+            char last = _command[_commandLength - 1];
+            bool valid = _commandLength >= 2 && last != '=' && last != '[';
+            _command[_commandLength++] = c;
+            if (valid) {
+                _command[_commandLength] = '\0';
+                _stats.commands++;
+                if (_onCommand) {
+                    _onCommand(_command, _commandLength);
+                }
+                _commandLength = 0;
+            } else {
+                flushCommandAsSpeech();
+            }
+            _route = ROUTE_TEXT;
+            return;
+        }
+
+        bool fits = _commandLength < MAX_COMMAND - 1;
+        bool startsParameter = c == '=' && !inParameter && _commandLength > 1;
+        if (fits && (isCommandChar(c, inParameter) || startsParameter)) {
+            _command[_commandLength++] = c;
+            return;
+        }
+
+        // Not a command after all, e.g. "[sic]", speak it
+        flushCommandAsSpeech();
+        _route = ROUTE_TEXT;
+    }
+
+    if (c == '[') {
+        _command[0] = c;
+        _commandLength = 1;
+        _route = ROUTE_COMMAND;
+        return;
+    }
+
+    appendSpeech(c);
+}
+
+void GptStreamParser::appendSpeech(char c) {
+    // Asterisks only mark the spoken part of a reply
+    if (c == '*') {
+        return;
+    }
+    if (c == '\n' || c == '\r') {
+        flushSentence();
+        return;
+    }
+
+    bool space = c == ' ' || c == '\t';
+    if (_sentenceEnding) {
+        if (space) {
+            flushSentence();
+            return;
+        }
+        // "3.5" or "Hey!!" keep the sentence open; closing quotes do not
+        if (c != '.' && c != '!' && c != '?' && c != '"' && c != ')') {
+            _sentenceEnding = false;
+        }
+    }
+
+    if (_sentenceLength == 0 && space) {
+        return;
+    }
+
+    _sentence[_sentenceLength++] = c;
+    if (c == '.' || c == '!' || c == '?') {
+        _sentenceEnding = true;
+    }
+    if (_sentenceLength >= MAX_SENTENCE) {
+        flushSentence();
+    }
+}
+
+void GptStreamParser::flushCommandAsSpeech() {
+    size_t length = _commandLength;
+    _commandLength = 0;
+    for (size_t i = 0; i < length; i++) {
+        appendSpeech(_command[i]);
+    }
+}
+
+void GptStreamParser::flushSentence() {
+    while (_sentenceLength > 0 &&
+           (_sentence[_sentenceLength - 1] == ' ' || _sentence[_sentenceLength - 1] == '\t')) {
+        _sentenceLength--;
+    }
+
+    // Punctuation or leftovers between commands are not worth speaking
+    bool speakable = false;
+    for (size_t i = 0; i < _sentenceLength && !speakable; i++) {
+        unsigned char c = (unsigned char)_sentence[i];
+        speakable = (c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || c >= 0x80;
+    }
+
+    if (speakable) {
+        _sentence[_sentenceLength] = '\0';
+        _stats.sentences++;
+        if (_onSentence) {
+            _onSentence(_sentence, _sentenceLength);
+        }
+    }
+
+    _sentenceLength = 0;
+    _sentenceEnding = false;
+}
+
+} // namespace Communication
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+
+namespace Communication {
+
+/**
+ * Incremental parser for streamed chat completions
+ *
+ * Takes the server-sent event body of a `stream: true` chat completion in
+ * pieces of any size, as they come off the socket, and splits the
+ * `choices[0].delta.content` tokens into two outputs as early as possible:
+ *
+ *   [COMMAND] / [COMMAND=PARAM]  as soon as the closing bracket arrives
+ *   spoken text                  one sentence at a time, `*` markers removed
+ *
+ * Only needs the C++ standard library, so it builds and runs the same on
+ * the robot and on a Linux host fed from a mock server.
+ */
+class GptStreamParser {
+public:
+    static const size_t MAX_LINE = 2048;        // Longest SSE line kept, longer ones are dropped
+    static const size_t MAX_SENTENCE = 256;     // A sentence this long is flushed as is
+    static const size_t MAX_COMMAND = 48;       // Longer bracket text is treated as speech
+    static const size_t MAX_ERROR = 128;
+
+    /**
+     * Receives a complete command including its brackets, NUL terminated
+     */
+    typedef std::function<void(const char* command, size_t length)> CommandHandler;
+
+    /**
+     * Receives one sentence of speech, trimmed and NUL terminated
+     */
+    typedef std::function<void(const char* sentence, size_t length)> SentenceHandler;
+
+    /**
+     * Receives the raw content of every delta, NUL terminated
+     */
+    typedef std::function<void(const char* token, size_t length)> TokenHandler;
+
+    struct Stats {
+        uint32_t bytes;         // Body bytes fed
+        uint32_t events;        // data: lines handled
+        uint32_t tokens;        // Deltas with content
+        uint32_t commands;
+        uint32_t sentences;
+        uint32_t malformed;     // Overlong lines and events without a readable delta
+    };
+
+    GptStreamParser();
+
+    void onCommand(CommandHandler handler) { _onCommand = handler; }
+    void onSentence(SentenceHandler handler) { _onSentence = handler; }
+    void onToken(TokenHandler handler) { _onToken = handler; }
+
+    /**
+     * Forget everything parsed, keeps the handlers
+     */
+    void reset();
+
+    /**
+     * Parse the next piece of the response body
+     */
+    void feed(const char* data, size_t length);
+
+    /**
+     * End of body: handle an unterminated last line and flush pending speech
+     */
+    void finish();
+
+    /**
+     * The stream sent its [DONE] marker
+     */
+    bool isDone() const { return _done; }
+
+    /**
+     * Error message the server streamed instead of tokens, empty if none
+     */
+    const char* getError() const { return _error; }
+    bool hasError() const { return _error[0] != '\0'; }
+
+    const Stats& getStats() const { return _stats; }
+
+private:
+    enum RouteState : uint8_t {
+        ROUTE_TEXT,
+        ROUTE_COMMAND
+    };
+
+    CommandHandler _onCommand;
+    SentenceHandler _onSentence;
+    TokenHandler _onToken;
+
+    char _line[MAX_LINE + 1];
+    size_t _lineLength;
+    bool _lineOverflow;
+
+    char _sentence[MAX_SENTENCE + 1];
+    size_t _sentenceLength;
+    bool _sentenceEnding;       // Last char closed a sentence, waiting for a space
+
+    char _command[MAX_COMMAND + 1];
+    size_t _commandLength;
+    RouteState _route;
+
+    char _token[MAX_LINE + 1];
+    size_t _tokenLength;
+
+    char _error[MAX_ERROR + 1];
+    bool _done;
+    Stats _stats;
+
+    void handleLine(const char* line, size_t length);
+    void handleEvent(const char* payload, size_t length);
+    bool decodeString(const char* json, size_t length, size_t& pos, char* out, size_t capacity, size_t& outLength);
+    void routeContent(const char* text, size_t length);
+    void routeChar(char c);
+    void appendSpeech(char c);
+    void flushCommandAsSpeech();
+    void flushSentence();
+
+    static const char* findKey(const char* json, size_t length, size_t from, const char* key, size_t& valuePos);
+    static bool isCommandChar(char c, bool inParameter);
+};
+
+} // namespace Communication
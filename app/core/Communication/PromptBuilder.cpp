@@ -0,0 +1,131 @@
+#include "PromptBuilder.h"
+#include <stdio.h>
+#include <string.h>
+
+namespace Communication {
+
+const char* const PromptTemplate::CONTEXT_MARKER = "--*additional command*--";
+
+PromptWriter::PromptWriter(char* buffer, size_t capacity)
+    : _buffer(buffer), _capacity(capacity), _length(0), _overflow(capacity == 0) {
+    if (capacity > 0) {
+        _buffer[0] = '\0';
+    }
+}
+
+PromptWriter& PromptWriter::raw(const char* data, size_t length) {
+    if (_overflow) {
+        return *this;
+    }
+    if (_length + length >= _capacity) {
+        _overflow = true;
+        return *this;
+    }
+    memcpy(_buffer + _length, data, length);
+    _length += length;
+    _buffer[_length] = '\0';
+    return *this;
+}
+
+PromptWriter& PromptWriter::raw(const char* data) {
+    return raw(data, strlen(data));
+}
+
+PromptWriter& PromptWriter::text(const char* data, size_t length) {
+    if (_overflow) {
+        return *this;
+    }
+    if (_length + escapedLength(data, length) >= _capacity) {
+        _overflow = true;
+        return *this;
+    }
+    _length += escape(data, length, _buffer + _length);
+    _buffer[_length] = '\0';
+    return *this;
+}
+
+PromptWriter& PromptWriter::text(const char* data) {
+    return text(data, strlen(data));
+}
+
+PromptWriter& PromptWriter::number(long value) {
+    char digits[24];
+    int length = snprintf(digits, sizeof(digits), "%ld", value);
+    return raw(digits, length);
+}
+
+PromptWriter& PromptWriter::number(float value, int decimals) {
+    char digits[32];
+    int length = snprintf(digits, sizeof(digits), "%.*f", decimals, value);
+    return raw(digits, length > 0 && length < (int)sizeof(digits) ? length : 0);
+}
+
+size_t PromptWriter::escapedLength(const char* data, size_t length) {
+    size_t escaped = 0;
+    for (size_t i = 0; i < length; i++) {
+        unsigned char c = (unsigned char)data[i];
+        if (c == '"' || c == '\\' || c == '\n' || c == '\r' || c == '\t') {
+            escaped += 2;
+        } else if (c < 0x20) {
+            escaped += 6;
+        } else {
+            escaped += 1;
+        }
+    }
+    return escaped;
+}
+
+size_t PromptWriter::escape(const char* data, size_t length, char* out) {
+    static const char HEX[] = "0123456789abcdef";
+    char* p = out;
+    for (size_t i = 0; i < length; i++) {
+        unsigned char c = (unsigned char)data[i];
+        switch (c) {
+            case '"':  *p++ = '\\'; *p++ = '"'; break;
+            case '\\': *p++ = '\\'; *p++ = '\\'; break;
+            case '\n': *p++ = '\\'; *p++ = 'n'; break;
+            case '\r': *p++ = '\\'; *p++ = 'r'; break;
+            case '\t': *p++ = '\\'; *p++ = 't'; break;
+            default:
+                if (c < 0x20) {
+                    memcpy(p, "\\u00", 4);
+                    p[4] = HEX[c >> 4];
+                    p[5] = HEX[c & 0x0F];
+                    p += 6;
+                } else {
+                    *p++ = (char)c;
+                }
+                break;
+        }
+    }
+    return p - out;
+}
+
+PromptTemplate::PromptTemplate()
+    : _prefix(nullptr), _prefixLength(0), _suffix(nullptr), _suffixLength(0), _escapedLength(0) {
+}
+
+void PromptTemplate::compile(const char* text) {
+    size_t length = strlen(text);
+    const char* marker = strstr(text, CONTEXT_MARKER);
+    _prefix = text;
+    _prefixLength = marker ? marker - text : length;
+    _suffix = marker ? marker + strlen(CONTEXT_MARKER) : text + length;
+    _suffixLength = text + length - _suffix;
+    _escapedLength = PromptWriter::escapedLength(_prefix, _prefixLength) +
+                     PromptWriter::escapedLength(_suffix, _suffixLength);
+}
+
+void PromptTemplate::writePrefix(PromptWriter& out) const {
+    if (_prefix) {
+        out.text(_prefix, _prefixLength);
+    }
+}
+
+void PromptTemplate::writeSuffix(PromptWriter& out) const {
+    if (_suffix) {
+        out.text(_suffix, _suffixLength);
+    }
+}
+
+} // namespace Communication
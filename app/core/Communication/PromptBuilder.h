@@ -0,0 +1,105 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace Communication {
+
+/**
+ * Writes a chat request body into one caller sized buffer
+ *
+ * text() escapes as a JSON string on the way in, so prompt fragments go
+ * from flash or from a sensor reading straight into the request body
+ * without a String in between. Writes past the capacity are dropped and
+ * flag the writer as overflowed, the content written so far stays valid.
+ *
+ * Usage:
+ *   out.text("Distance: ").number(distance, 1).text(" cm\n");
+ */
+class PromptWriter {
+public:
+    /**
+     * @param buffer Destination, NUL terminated after every write
+     * @param capacity Size of the buffer including the terminator
+     */
+    PromptWriter(char* buffer, size_t capacity);
+
+    /**
+     * Append bytes as they are, for JSON syntax and precompiled fragments
+     */
+    PromptWriter& raw(const char* data, size_t length);
+    PromptWriter& raw(const char* data);
+
+    /**
+     * Append text escaped for the inside of a JSON string
+     */
+    PromptWriter& text(const char* data, size_t length);
+    PromptWriter& text(const char* data);
+
+    PromptWriter& number(long value);
+    PromptWriter& number(float value, int decimals = 2);
+
+    const char* data() const { return _buffer; }
+    size_t length() const { return _length; }
+    bool overflowed() const { return _overflow; }
+
+    /**
+     * Bytes text() would write for the same input
+     */
+    static size_t escapedLength(const char* data, size_t length);
+
+    /**
+     * Escape into out, which must hold escapedLength() bytes
+     * @return Bytes written
+     */
+    static size_t escape(const char* data, size_t length, char* out);
+
+private:
+    char* _buffer;
+    size_t _capacity;
+    size_t _length;
+    bool _overflow;
+};
+
+/**
+ * A system prompt split around its context marker
+ *
+ * The prefix and suffix point into the text itself, usually a literal in
+ * flash, and are escaped as they are written into the request body, so
+ * compiling neither copies nor allocates. The text must outlive the
+ * template or the next compile().
+ */
+class PromptTemplate {
+public:
+    static const char* const CONTEXT_MARKER;
+
+    PromptTemplate();
+
+    PromptTemplate(const PromptTemplate&) = delete;
+    PromptTemplate& operator=(const PromptTemplate&) = delete;
+
+    /**
+     * Split a system prompt, the context goes where CONTEXT_MARKER is or
+     * at the end without one
+     */
+    void compile(const char* text);
+
+    bool isCompiled() const { return _prefix != nullptr; }
+
+    /**
+     * Escaped bytes of the prompt without the marker
+     */
+    size_t length() const { return _escapedLength; }
+
+    void writePrefix(PromptWriter& out) const;
+    void writeSuffix(PromptWriter& out) const;
+
+private:
+    const char* _prefix;
+    size_t _prefixLength;
+    const char* _suffix;
+    size_t _suffixLength;
+    size_t _escapedLength;
+};
+
+} // namespace Communication
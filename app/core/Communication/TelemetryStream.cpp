@@ -0,0 +1,221 @@
+#include "TelemetryStream.h"
+#include <esp_timer.h>
+#include <string.h>
+
+namespace Communication {
+
+TelemetryStream::TelemetryStream(uint16_t maxRateHz, uint32_t keyframeIntervalMs)
+    : TAG("TelemetryStream"),
+      _maxRateHz(maxRateHz > 0 ? maxRateHz : 1),
+      _keyframeIntervalMs(keyframeIntervalMs),
+      _mutex(xSemaphoreCreateMutex()),
+      _subscribers{},
+      _subscriberCount(0),
+      _statsMux(portMUX_INITIALIZER_UNLOCKED),
+      _stats{}
+{
+}
+
+TelemetryStream::~TelemetryStream() {
+    if (_mutex) {
+        vSemaphoreDelete(_mutex);
+    }
+}
+
+uint16_t TelemetryStream::subscribe(uint32_t clientId, uint16_t rateHz) {
+    if (rateHz == 0) {
+        unsubscribe(clientId);
+        return 0;
+    }
+    if (rateHz > _maxRateHz) {
+        rateHz = _maxRateHz;
+    }
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    Subscriber* slot = nullptr;
+    for (int i = 0; i < MAX_SUBSCRIBERS; i++) {
+        if (_subscribers[i].active && _subscribers[i].clientId == clientId) {
+            slot = &_subscribers[i];
+            break;
+        }
+        if (!_subscribers[i].active && slot == nullptr) {
+            slot = &_subscribers[i];
+        }
+    }
+
+    if (slot == nullptr) {
+        xSemaphoreGive(_mutex);
+        return 0;
+    }
+
+    if (!slot->active) {
+        memset(slot, 0, sizeof(Subscriber));
+        slot->clientId = clientId;
+        slot->active = true;
+        _subscriberCount++;
+    }
+    slot->keyframe = true;
+    slot->periodMs = 1000 / rateHz;
+    slot->nextDueMs = millis();
+    int count = _subscriberCount;
+    xSemaphoreGive(_mutex);
+
+    portENTER_CRITICAL(&_statsMux);
+    _stats.subscribers = count;
+    portEXIT_CRITICAL(&_statsMux);
+    return rateHz;
+}
+
+void TelemetryStream::unsubscribe(uint32_t clientId) {
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    for (int i = 0; i < MAX_SUBSCRIBERS; i++) {
+        if (_subscribers[i].active && _subscribers[i].clientId == clientId) {
+            _subscribers[i].active = false;
+            _subscriberCount--;
+        }
+    }
+    int count = _subscriberCount;
+    xSemaphoreGive(_mutex);
+
+    portENTER_CRITICAL(&_statsMux);
+    _stats.subscribers = count;
+    portEXIT_CRITICAL(&_statsMux);
+}
+
+void TelemetryStream::tick() {
+    if (_subscriberCount == 0 || !_source || !_sink) {
+        return;
+    }
+
+    int64_t startUs = esp_timer_get_time();
+    uint32_t now = millis();
+
+    Sample sample;
+    memset(&sample, 0, sizeof(sample));
+    _source(sample);
+
+    // Encode under the lock, send outside it: the transport takes its own
+    // lock and its callbacks may subscribe or unsubscribe
+    struct Pending {
+        uint32_t clientId;
+        size_t length;
+        bool keyframe;
+        uint8_t frame[MAX_FRAME_SIZE];
+    };
+    Pending pending[MAX_SUBSCRIBERS];
+    int pendingCount = 0;
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    for (int i = 0; i < MAX_SUBSCRIBERS; i++) {
+        Subscriber& subscriber = _subscribers[i];
+        if (!subscriber.active || (int32_t)(now - subscriber.nextDueMs) < 0) {
+            continue;
+        }
+
+        subscriber.nextDueMs += subscriber.periodMs;
+        if ((int32_t)(now - subscriber.nextDueMs) >= 0) {
+            // Fell behind, skip the missed frames instead of bursting
+            subscriber.nextDueMs = now + subscriber.periodMs;
+        }
+
+        bool keyframe = subscriber.keyframe || now - subscriber.lastKeyframeMs >= _keyframeIntervalMs;
+        uint16_t mask = 0;
+        for (int field = 0; field < FIELD_COUNT; field++) {
+            if (keyframe || sample.values[field] != subscriber.last.values[field]) {
+                mask |= 1 << field;
+            }
+        }
+        if (mask == 0) {
+            continue;
+        }
+
+        Pending& out = pending[pendingCount++];
+        out.clientId = subscriber.clientId;
+        out.keyframe = keyframe;
+        out.length = encode(out.frame, subscriber.sequence++, now, sample, mask);
+
+        subscriber.last = sample;
+        if (keyframe) {
+            subscriber.keyframe = false;
+            subscriber.lastKeyframeMs = now;
+        }
+    }
+    xSemaphoreGive(_mutex);
+
+    uint32_t frames = 0;
+    uint32_t keyframes = 0;
+    uint32_t bytes = 0;
+    uint32_t dropped = 0;
+    for (int i = 0; i < pendingCount; i++) {
+        if (_sink(pending[i].clientId, pending[i].frame, pending[i].length)) {
+            frames++;
+            keyframes += pending[i].keyframe ? 1 : 0;
+            bytes += pending[i].length;
+            continue;
+        }
+
+        // The client missed a delta, resend everything next time
+        dropped++;
+        xSemaphoreTake(_mutex, portMAX_DELAY);
+        for (int j = 0; j < MAX_SUBSCRIBERS; j++) {
+            if (_subscribers[j].active && _subscribers[j].clientId == pending[i].clientId) {
+                _subscribers[j].keyframe = true;
+            }
+        }
+        xSemaphoreGive(_mutex);
+    }
+
+    uint32_t elapsedUs = (uint32_t)(esp_timer_get_time() - startUs);
+    portENTER_CRITICAL(&_statsMux);
+    _stats.samples++;
+    _stats.frames += frames;
+    _stats.keyframes += keyframes;
+    _stats.bytes += bytes;
+    _stats.dropped += dropped;
+    if (elapsedUs > _stats.maxTickUs) {
+        _stats.maxTickUs = elapsedUs;
+    }
+    portEXIT_CRITICAL(&_statsMux);
+}
+
+TelemetryStream::Stats TelemetryStream::getStats() const {
+    portENTER_CRITICAL(&_statsMux);
+    Stats stats = _stats;
+    portEXIT_CRITICAL(&_statsMux);
+    return stats;
+}
+
+size_t TelemetryStream::encode(uint8_t* out, uint16_t sequence, uint32_t timestamp, const Sample& sample, uint16_t mask) {
+    size_t length = 0;
+    out[length++] = FRAME_MAGIC;
+    out[length++] = FRAME_VERSION;
+    out[length++] = sequence & 0xFF;
+    out[length++] = sequence >> 8;
+    out[length++] = timestamp & 0xFF;
+    out[length++] = (timestamp >> 8) & 0xFF;
+    out[length++] = (timestamp >> 16) & 0xFF;
+    out[length++] = timestamp >> 24;
+    out[length++] = mask & 0xFF;
+    out[length++] = mask >> 8;
+
+    for (int field = 0; field < FIELD_COUNT; field++) {
+        if (mask & (1 << field)) {
+            uint16_t value = (uint16_t)sample.values[field];
+            out[length++] = value & 0xFF;
+            out[length++] = value >> 8;
+        }
+    }
+    return length;
+}
+
+int16_t TelemetryStream::clamp(float value) {
+    if (value >= 32767.0f) {
+        return 32767;
+    }
+    if (value <= -32768.0f) {
+        return -32768;
+    }
+    return (int16_t)lroundf(value);
+}
+
+} // namespace Communication
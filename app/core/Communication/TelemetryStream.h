@@ -0,0 +1,150 @@
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+namespace Communication {
+
+/**
+ * Binary telemetry frames for WebSocket subscribers
+ *
+ * Every tick samples the robot state once, quantized to 16 bit fields, and
+ * sends each subscriber whose period is due only the fields that changed
+ * since the last frame it received. A full frame goes out on subscribe,
+ * every keyframe interval and after a send the transport refused, so a
+ * client can always resynchronize. Nothing is sampled or encoded while
+ * nobody is subscribed.
+ *
+ * Frame layout, little endian:
+ *   uint8  magic 'T'
+ *   uint8  version
+ *   uint16 sequence     Per subscriber, a gap means a lost frame
+ *   uint32 timestamp    millis() at sampling
+ *   uint16 mask         Bit n set: field n follows
+ *   int16  values[]     Changed fields in field order
+ */
+class TelemetryStream {
+public:
+    static const int MAX_SUBSCRIBERS = 4;
+    static const uint8_t FRAME_MAGIC = 'T';
+    static const uint8_t FRAME_VERSION = 2;
+    static const size_t HEADER_SIZE = 10;
+
+    enum Field : uint8_t {
+        ROLL,               // 0.1 degree
+        PITCH,              // 0.1 degree
+        YAW,                // 0.1 degree
+        DISTANCE,           // Millimeters, -1 unknown
+        FLAGS,              // Flag bits below
+        BATTERY_MV,
+        BATTERY_LEVEL,      // Percent
+        MOTOR_DIRECTION,    // Motors::MotorControl::Direction
+        HEAD_ANGLE,         // Degrees
+        HAND_ANGLE,         // Degrees
+        MIC_LEVEL,
+        TELEOP_SEQUENCE,    // Last applied teleop command
+        TELEOP_LATENCY,     // Its receive to motor latency, 0.1 ms
+        FIELD_COUNT
+    };
+
+    enum Flag : uint16_t {
+        FLAG_CLIFF_LEFT = 1 << 0,
+        FLAG_CLIFF_RIGHT = 1 << 1,
+        FLAG_TOUCH = 1 << 2,
+        FLAG_CHARGING = 1 << 3,
+        FLAG_STATIONARY = 1 << 4,
+        FLAG_OBSTACLE = 1 << 5
+    };
+
+    static const size_t MAX_FRAME_SIZE = HEADER_SIZE + FIELD_COUNT * sizeof(int16_t);
+
+    struct Sample {
+        int16_t values[FIELD_COUNT];
+    };
+
+    struct Stats {
+        uint32_t subscribers;
+        uint32_t samples;       // Ticks that sampled, ticks without subscribers are free
+        uint32_t frames;
+        uint32_t keyframes;
+        uint32_t bytes;
+        uint32_t dropped;       // Frames the transport refused
+        uint32_t maxTickUs;     // Longest sample, encode and send pass
+    };
+
+    /**
+     * Fills a sample from the sensors, called once per tick with subscribers
+     */
+    typedef std::function<void(Sample& sample)> SampleSource;
+
+    /**
+     * Sends one frame to a client, false when its queue is full
+     */
+    typedef std::function<bool(uint32_t clientId, const uint8_t* data, size_t length)> FrameSink;
+
+    /**
+     * @param maxRateHz Highest rate a client may ask for
+     * @param keyframeIntervalMs Period of full frames per subscriber
+     */
+    TelemetryStream(uint16_t maxRateHz = 50, uint32_t keyframeIntervalMs = 1000);
+    ~TelemetryStream();
+
+    void setSource(SampleSource source) { _source = source; }
+    void setSink(FrameSink sink) { _sink = sink; }
+
+    /**
+     * Subscribe a client or change its rate, the next frame is a full frame
+     * @param rateHz Frames per second, clamped to 1..maxRateHz, 0 unsubscribes
+     * @return Rate applied, 0 if unsubscribed or the table is full
+     */
+    uint16_t subscribe(uint32_t clientId, uint16_t rateHz);
+    void unsubscribe(uint32_t clientId);
+    bool hasSubscribers() const { return _subscriberCount > 0; }
+
+    /**
+     * Sample, encode and send what is due, called periodically by the scheduler
+     */
+    void tick();
+
+    Stats getStats() const;
+
+    /**
+     * Encode the fields of a sample that differ from the previous one
+     * @param mask Fields to write
+     * @return Frame length, at most MAX_FRAME_SIZE
+     */
+    static size_t encode(uint8_t* out, uint16_t sequence, uint32_t timestamp, const Sample& sample, uint16_t mask);
+
+    /**
+     * Quantize a value into a field, saturating at the int16 range
+     */
+    static int16_t clamp(float value);
+
+private:
+    struct Subscriber {
+        uint32_t clientId;
+        bool active;
+        bool keyframe;          // Next frame carries every field
+        uint16_t sequence;
+        uint32_t periodMs;
+        uint32_t nextDueMs;
+        uint32_t lastKeyframeMs;
+        Sample last;            // Values the client holds
+    };
+
+    const char* TAG;
+    uint16_t _maxRateHz;
+    uint32_t _keyframeIntervalMs;
+    SampleSource _source;
+    FrameSink _sink;
+    SemaphoreHandle_t _mutex;
+    Subscriber _subscribers[MAX_SUBSCRIBERS];
+    volatile int _subscriberCount;
+
+    mutable portMUX_TYPE _statsMux;
+    Stats _stats;
+};
+
+} // namespace Communication
@@ -1,14 +1,138 @@
 #include "WeatherService.h"
 #include <HTTPClient.h>
+#include <esp_rom_crc.h>
 #include "core/Utils/SpiAllocator.h"
 
 namespace Communication {
 
-const char* WeatherService::CACHE_FILE_PATH = "/cache/weather_cache.json";
+namespace {
+
+/**
+ * Hands body bytes to the parser as HTTPClient reads them, after the
+ * chunked transfer encoding is removed
+ */
+class ParserStream : public Stream {
+public:
+    explicit ParserStream(WeatherStreamParser& parser) : _parser(parser) {}
+
+    size_t write(uint8_t c) override {
+        _parser.feed((const char*)&c, 1);
+        return 1;
+    }
+
+    size_t write(const uint8_t* buffer, size_t size) override {
+        _parser.feed((const char*)buffer, size);
+        return size;
+    }
+
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+
+private:
+    WeatherStreamParser& _parser;
+};
+
+const uint32_t CACHE_MAGIC = 0x52485457;    // "WTHR"
+const uint16_t CACHE_VERSION = 2;
+const uint32_t DAY_MS = 24UL * 60 * 60 * 1000;
+const char* HEADER_KEYS[] = {"ETag", "Last-Modified", "Date"};
+
+/**
+ * Cache file layout, written and read in one piece. The CRC covers
+ * everything before it; a record of another version or size is ignored.
+ */
+struct CacheRecord {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;
+    char adm4[16];
+    char location[200];
+    char description[48];
+    char windDirection[8];
+    char lastUpdated[24];
+    char imageUrl[128];
+    char timezone[32];
+    float longitude;
+    float latitude;
+    int16_t temperature;
+    int16_t humidity;
+    int16_t windSpeed;
+    uint8_t condition;
+    uint8_t reserved;
+    char etag[64];              // Validators of this data for conditional requests
+    char lastModified[40];
+    uint32_t nextSlotEpoch;
+    uint32_t crc;
+};
+
+template <size_t N>
+void copyText(char (&target)[N], const char* value) {
+    strncpy(target, value, N - 1);
+    target[N - 1] = '\0';
+}
+
+template <size_t N>
+void copyText(char (&target)[N], const Utils::Sstring& value) {
+    copyText(target, value.c_str());
+}
+
+uint32_t recordCrc(const CacheRecord& record) {
+    return esp_rom_crc32_le(0, (const uint8_t*)&record, offsetof(CacheRecord, crc));
+}
+
+// Days since 1970-01-01 of a proleptic Gregorian date
+int32_t daysFromCivil(int year, int month, int day) {
+    year -= month <= 2;
+    int era = (year >= 0 ? year : year - 399) / 400;
+    int yearOfEra = year - era * 400;
+    int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+uint32_t toEpoch(int year, int month, int day, int hour, int minute, int second) {
+    if (year < 1970 || month < 1 || month > 12 || day < 1 || day > 31) {
+        return 0;
+    }
+    return (uint32_t)daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+}
+
+// BMKG utc_datetime, "2025-09-05 06:00:00"
+uint32_t parseUtcDatetime(const char* text) {
+    int year, month, day, hour, minute, second;
+    if (sscanf(text, "%d-%d-%d%*c%d:%d:%d", &year, &month, &day, &hour, &minute, &second) != 6) {
+        return 0;
+    }
+    return toEpoch(year, month, day, hour, minute, second);
+}
+
+// HTTP Date header, "Fri, 05 Sep 2025 06:12:31 GMT"
+uint32_t parseHttpDate(const String& text) {
+    static const char MONTHS[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+    int year, day, hour, minute, second;
+    char month[4];
+    if (sscanf(text.c_str(), "%*[^,], %d %3s %d %d:%d:%d", &day, month, &year, &hour, &minute, &second) != 6) {
+        return 0;
+    }
+    const char* found = strstr(MONTHS, month);
+    if (!found || strlen(month) != 3 || (found - MONTHS) % 3 != 0) {
+        return 0;
+    }
+    return toEpoch(year, (found - MONTHS) / 3 + 1, day, hour, minute, second);
+}
+
+} // namespace
+
+const char* WeatherService::CACHE_FILE_PATH = "/cache/weather.bin";
+const char* WeatherService::LEGACY_CACHE_FILE_PATH = "/cache/weather_cache.json";
 
 WeatherService::WeatherService(Utils::FileManager* fileManager) 
-    : _lastCacheTime(0), _initialized(false), _fileManager(fileManager),
-    _tag("WeatherService") {
+    : _lastCacheTime(0), _initialized(false), _fileManager(fileManager), _pool(nullptr),
+    _nextRefreshMs(0), _lastRequestMs(0), _nextSlotEpoch(0), _stats{}, _dayStartMs(0),
+    _mux(portMUX_INITIALIZER_UNLOCKED), _tag("WeatherService") {
+    _etag[0] = '\0';
+    _lastModified[0] = '\0';
 }
 
 WeatherService::~WeatherService() {
@@ -22,7 +146,12 @@ bool WeatherService::init(const WeatherConfig& config) {
 
     _config = config;
     _initialized = true;
+    _dayStartMs = millis();
     
+    if (_fileManager->exists(LEGACY_CACHE_FILE_PATH)) {
+        _fileManager->deleteFile(LEGACY_CACHE_FILE_PATH);
+    }
+
     // Try to load existing cache
     loadCache();
     
@@ -50,6 +179,32 @@ void WeatherService::getCurrentWeather(WeatherCallback callback, bool forceRefre
     fetchFromAPI(callback);
 }
 
+bool WeatherService::refreshIfDue(WeatherCallback callback) {
+    if (!_initialized) {
+        return false;
+    }
+
+    uint32_t now = millis();
+    bool due = _nextRefreshMs == 0 || (int32_t)(now - _nextRefreshMs) >= 0;
+
+    // Share the radio with other requests instead of waking it again later
+    bool early = !due && _pool && _stats.consecutiveFailures == 0 &&
+                 (int32_t)(_nextRefreshMs - now) <= (int32_t)_config.coalesceWindowMs &&
+                 now - _lastRequestMs >= _config.minRefreshMs &&
+                 _pool->getStats().open > 0;
+    if (!due && !early) {
+        return false;
+    }
+
+    if (early) {
+        portENTER_CRITICAL(&_mux);
+        _stats.coalesced++;
+        portEXIT_CRITICAL(&_mux);
+    }
+    fetchFromAPI(callback);
+    return true;
+}
+
 void WeatherService::setLocation(const Utils::Sstring& adm4Code) {
     _config.adm4Code = adm4Code;
     
@@ -71,6 +226,10 @@ void WeatherService::setCacheExpiry(uint32_t minutes) {
 void WeatherService::clearCache() {
     _cachedData = WeatherData();
     _lastCacheTime = 0;
+    _nextRefreshMs = 0;
+    _nextSlotEpoch = 0;
+    _etag[0] = '\0';
+    _lastModified[0] = '\0';
     
     // Remove cache file
     if (_fileManager && _fileManager->exists(CACHE_FILE_PATH)) {
@@ -92,169 +251,287 @@ bool WeatherService::isCacheValid() const {
 void WeatherService::fetchFromAPI(WeatherCallback callback) {
     HTTPClient http;
     Utils::Sstring url = buildAPIUrl();
+    ConnectionPool::Lease lease = {-1, nullptr, false};
+    int httpCode = HTTPC_ERROR_CONNECTION_REFUSED;
+    uint32_t startMs = millis();
+    _lastRequestMs = startMs;
+
+    // With validators of the cached data the server can answer 304 without a body
+    auto send = [&]() {
+        http.collectHeaders(HEADER_KEYS, 3);
+        if (_cachedData.isValid && _etag[0]) {
+            http.addHeader("If-None-Match", _etag);
+        }
+        if (_cachedData.isValid && _lastModified[0]) {
+            http.addHeader("If-Modified-Since", _lastModified);
+        }
+        return http.GET();
+    };
     
-    http.begin(url.toString());
-    http.setReuse(true);
-    http.setFollowRedirects(HTTPC_FORCE_FOLLOW_REDIRECTS);
-    http.setTimeout(10000); // 10 second timeout
+    // A kept-alive connection the server closed meanwhile gets one more try
+    for (int attempt = 0; _pool && attempt < 2; attempt++) {
+        if (!_pool->begin(http, url.toString(), lease)) {
+            break;
+        }
+        httpCode = send();
+        if (attempt > 0 || !ConnectionPool::shouldRetry(lease, httpCode)) {
+            break;
+        }
+        _pool->end(http, lease, httpCode);
+    }
     
-    int httpCode = http.GET();
+    // A redirect may point at another host, so it is followed on a connection of its own
+    if (!_pool || (httpCode >= 300 && httpCode < 400 && httpCode != HTTP_CODE_NOT_MODIFIED)) {
+        if (lease.client) {
+            _pool->end(http, lease, httpCode);
+        }
+        http.begin(url.toString());
+        http.setReuse(true);
+        http.setFollowRedirects(HTTPC_FORCE_FOLLOW_REDIRECTS);
+        http.setTimeout(10000); // 10 second timeout
+        httpCode = send();
+    }
     
+    bool success = false;
+    size_t bytes = 0;
     if (httpCode == HTTP_CODE_OK) {
-        Utils::Sstring response = http.getString();
-        processAPIResponse(response, callback);
+        // Validators and schedule belong to the new data, or to nothing if it doesn't parse
+        copyText(_etag, http.header("ETag").c_str());
+        copyText(_lastModified, http.header("Last-Modified").c_str());
+
+        // Only the fields in WeatherData are kept while the body streams in
+        WeatherStreamParser* parser = new WeatherStreamParser();
+        ParserStream sink(*parser);
+        int written = http.writeToStream(&sink);
+        parser->finish();
+        bytes = parser->getBytes();
+        if (written < 0) {
+            // A partial forecast is neither cached nor reported, the failure backoff applies
+            ESP_LOGW(_tag, "Body cut short: [%d] %s", written, http.errorToString(written).c_str());
+            httpCode = written;     // Body not read to the end, the connection can't be reused
+            if (callback) {
+                WeatherData errorData;
+                callback(errorData, false);
+            }
+        } else {
+            _nextSlotEpoch = parseUtcDatetime(parser->getResult().nextUtcDatetime);
+            success = processAPIResponse(*parser, callback);
+        }
+        delete parser;
+        if (!success) {
+            _etag[0] = '\0';
+            _lastModified[0] = '\0';
+        }
+    } else if (httpCode == HTTP_CODE_NOT_MODIFIED && _cachedData.isValid) {
+        ESP_LOGI(_tag, "Weather unchanged since %s", _cachedData.lastUpdated.c_str());
+        _lastCacheTime = getCurrentTimestamp();
+        success = true;
+        if (callback) {
+            callback(_cachedData, true);
+        }
     } else {
-        ESP_LOGE(_tag, "Error: [%d] %s", httpCode, http.errorToString(httpCode));
+        ESP_LOGE(_tag, "Error: [%d] %s", httpCode, http.errorToString(httpCode).c_str());
         if (callback) {
             WeatherData errorData;
             callback(errorData, false);
         }
     }
+    uint32_t serverEpoch = parseHttpDate(http.header("Date"));
     
-    http.end();
+    if (lease.client) {
+        _pool->end(http, lease, httpCode);
+    } else {
+        http.end();
+    }
+
+    countRequest(httpCode, success, bytes, millis() - startMs);
+    scheduleNext(success, serverEpoch);
 }
 
-void WeatherService::processAPIResponse(const Utils::Sstring& response, WeatherCallback callback) {
-    if (!callback) {
-        ESP_LOGW(_tag, "No callback provided for API response");
-        return;
+void WeatherService::scheduleNext(bool success, uint32_t serverEpoch) {
+    uint64_t delayMs;
+    portENTER_CRITICAL(&_mux);
+    if (success) {
+        _stats.consecutiveFailures = 0;
+        portEXIT_CRITICAL(&_mux);
+
+        // Until the forecast's next entry starts, within the refresh bounds
+        delayMs = (uint64_t)_config.cacheExpiryMinutes * 60 * 1000;
+        if (serverEpoch && _nextSlotEpoch) {
+            uint64_t untilSlotMs = _nextSlotEpoch > serverEpoch ? (uint64_t)(_nextSlotEpoch - serverEpoch) * 1000 : 0;
+            if (untilSlotMs < delayMs) {
+                delayMs = untilSlotMs;
+            }
+        }
+        if (delayMs < _config.minRefreshMs) {
+            delayMs = _config.minRefreshMs;
+        }
+    } else {
+        uint32_t failures = ++_stats.consecutiveFailures;
+        portEXIT_CRITICAL(&_mux);
+
+        delayMs = (uint64_t)_config.retryMinMs << (failures - 1 < 16 ? failures - 1 : 16);
+        if (delayMs > _config.retryMaxMs) {
+            delayMs = _config.retryMaxMs;
+        }
     }
 
-    ESP_LOGI(_tag, "Processing API response");
+    // Spread refreshes so they don't line up with other periodic work or other robots
+    uint32_t jitterMs = _config.refreshJitterMs < delayMs / 2 ? _config.refreshJitterMs : delayMs / 2;
+    if (jitterMs > 0) {
+        delayMs += random(0, jitterMs);
+    }
 
-    Utils::SpiJsonDocument doc;
-    DeserializationError error = deserializeJson(doc, response.c_str());
-    
-    if (error) {
-        ESP_LOGE(_tag, "JSON parsing failed: %s. Value: %s", error.c_str(), response.c_str());
-        WeatherData errorData;
-        callback(errorData, false);
-        return;
+    _nextRefreshMs = millis() + (uint32_t)delayMs;
+    if (_nextRefreshMs == 0) {
+        _nextRefreshMs = 1;
     }
+    ESP_LOGI(_tag, "Next weather refresh in %u s", (unsigned)(delayMs / 1000));
+}
+
+void WeatherService::countRequest(int httpCode, bool success, size_t bytes, uint32_t durationMs) {
+    uint32_t now = millis();
+    portENTER_CRITICAL(&_mux);
+    if (now - _dayStartMs >= DAY_MS) {
+        bool skipped = now - _dayStartMs >= 2 * DAY_MS;
+        _stats.requestsPrevDay = skipped ? 0 : _stats.requestsDay;
+        _stats.bytesPrevDay = skipped ? 0 : _stats.bytesDay;
+        _stats.requestsDay = 0;
+        _stats.bytesDay = 0;
+        _dayStartMs += (now - _dayStartMs) / DAY_MS * DAY_MS;
+    }
+    _stats.requests++;
+    _stats.requestsDay++;
+    _stats.bytes += bytes;
+    _stats.bytesDay += bytes;
+    _stats.lastFetchMs = durationMs;
+    if (!success) {
+        _stats.failures++;
+    } else if (httpCode == HTTP_CODE_NOT_MODIFIED) {
+        _stats.notModified++;
+    } else {
+        _stats.updated++;
+    }
+    portEXIT_CRITICAL(&_mux);
+}
+
+WeatherService::Stats WeatherService::getStats() const {
+    uint32_t now = millis();
+    portENTER_CRITICAL(&_mux);
+    Stats stats = _stats;
+    portEXIT_CRITICAL(&_mux);
+    uint32_t next = _nextRefreshMs;
+    stats.nextRefreshInMs = next == 0 || (int32_t)(next - now) <= 0 ? 0 : next - now;
+    return stats;
+}
+
+bool WeatherService::processAPIResponse(const WeatherStreamParser& parser, WeatherCallback callback) {
+    ESP_LOGI(_tag, "Processing API response, %u bytes", (unsigned)parser.getBytes());
 
     WeatherData data;
-    
-    try {
-        // Navigate through new BMKG API structure
-        // New BMKG structure: {"lokasi": {...}, "data": [{...}]}
-        if (doc["lokasi"].isUnbound()) {
-            ESP_LOGE(_tag, "No lokasi found in response");
+    if (parser.hasError()) {
+        ESP_LOGE(_tag, "JSON parsing failed after %u bytes", (unsigned)parser.getBytes());
+        if (callback) {
             callback(data, false);
-            return;
         }
+        return false;
+    }
 
-        auto lokasi = doc["lokasi"];
-        data.location = String(lokasi["provinsi"].as<String>()) + ", " + 
-                       String(lokasi["kotkab"].as<String>()) + ", " + 
-                       String(lokasi["kecamatan"].as<String>()) + ", " + 
-                       String(lokasi["desa"].as<String>());
-        data.longitude = lokasi["lon"].as<float>();
-        data.latitude = lokasi["lat"].as<float>();
-        data.timezone = lokasi["timezone"].as<String>();
-        
-        ESP_LOGI(_tag, "Location: %s (Lat: %.6f, Lon: %.6f)", data.location.c_str(), data.latitude, data.longitude);
-
-        if (doc["data"].isUnbound() || doc["data"].size() == 0) {
-            ESP_LOGE(_tag, "No data array found in response");
+    // New BMKG structure: {"lokasi": {...}, "data": [{"cuaca": [[{...}]]}]}
+    const WeatherStreamParser::Result& result = parser.getResult();
+    if (!parser.hasLocation()) {
+        ESP_LOGE(_tag, "No lokasi found in response");
+        if (callback) {
             callback(data, false);
-            return;
         }
+        return false;
+    }
 
-        auto dataArray = doc["data"];
-        if (dataArray.size() == 0) {
-            ESP_LOGE(_tag, "Empty data array in response");
-            callback(data, false);
-            return;
-        }
+    data.location = Utils::Sstring(result.provinsi) + ", " + result.kotkab + ", " + result.kecamatan + ", " + result.desa;
+    data.longitude = result.longitude;
+    data.latitude = result.latitude;
+    data.timezone = result.timezone;
+    
+    ESP_LOGI(_tag, "Location: %s (Lat: %.6f, Lon: %.6f)", data.location.c_str(), data.latitude, data.longitude);
 
-        // Get the first location data
-        auto locationData = dataArray[0];
-        if (locationData["cuaca"].isUnbound() || locationData["cuaca"].size() == 0) {
-            ESP_LOGE(_tag, "No cuaca (weather) data found");
+    // Current weather is the first entry of the first time period
+    if (!parser.hasWeather()) {
+        ESP_LOGE(_tag, "No current weather data found");
+        if (callback) {
             callback(data, false);
-            return;
         }
+        return false;
+    }
 
-        // Get current weather (first entry in the first time period)
-        auto cuacaArray = locationData["cuaca"];
-        if (cuacaArray.size() == 0 || cuacaArray[0].size() == 0) {
-            ESP_LOGE(_tag, "No current weather data found");
-            callback(data, false);
-            return;
-        }
+    data.temperature = result.temperature;
+    data.humidity = result.humidity;
+    data.windSpeed = (int)(result.windSpeed * 3.6); // Convert m/s to km/h
+    data.windDirection = result.windDirection;
+    data.description = result.description;
+    data.imageUrl = result.imageUrl;
+    data.lastUpdated = result.localDatetime;
+    data.condition = getConditionFromCode(result.weatherCode);
+    
+    ESP_LOGI(_tag, "Weather: %s (Code: %d)", data.description.c_str(), result.weatherCode);
+    ESP_LOGI(_tag, "Temperature: %d°C, Humidity: %d%%, Wind: %d km/h %s", 
+             data.temperature, data.humidity, data.windSpeed, data.windDirection.c_str());
 
-        auto currentWeather = cuacaArray[0][0]; // First time period, first entry
-        
-        // Parse weather data from new API format
-        data.temperature = currentWeather["t"].as<int>();
-        data.humidity = currentWeather["hu"].as<int>();
-        data.windSpeed = (int)(currentWeather["ws"].as<float>() * 3.6); // Convert m/s to km/h
-        data.windDirection = currentWeather["wd"].as<String>();
-        data.description = currentWeather["weather_desc"].as<String>();
-        data.imageUrl = currentWeather["image"].as<String>();
-        data.lastUpdated = currentWeather["local_datetime"].as<String>();
-        
-        // Convert weather code to condition
-        int weatherCode = currentWeather["weather"].as<int>();
-        data.condition = getConditionFromCode(weatherCode);
-        
-        ESP_LOGI(_tag, "Weather: %s (Code: %d)", data.description.c_str(), weatherCode);
-        ESP_LOGI(_tag, "Temperature: %d°C, Humidity: %d%%, Wind: %d km/h %s", 
-                 data.temperature, data.humidity, data.windSpeed, data.windDirection.c_str());
-
-        data.isValid = true;
-        
-        ESP_LOGI(_tag, "Weather data parsed successfully for %s", data.location.c_str());
-        
-        // Cache the data
-        _cachedData = data;
-        _lastCacheTime = getCurrentTimestamp();
-        if (saveCache(data)) {
-            ESP_LOGD(_tag, "Weather data cached successfully");
-        } else {
-            ESP_LOGW(_tag, "Failed to cache weather data");
-        }
-        
+    data.isValid = true;
+    
+    ESP_LOGI(_tag, "Weather data parsed successfully for %s", data.location.c_str());
+    
+    // Cache the data
+    _cachedData = data;
+    _lastCacheTime = getCurrentTimestamp();
+    if (saveCache(data)) {
+        ESP_LOGD(_tag, "Weather data cached successfully");
+    } else {
+        ESP_LOGW(_tag, "Failed to cache weather data");
+    }
+    
+    if (callback) {
         callback(data, true);
-        
-    } catch (...) {
-        ESP_LOGE(_tag, "Exception occurred while processing API response");
-        WeatherData errorData;
-        callback(errorData, false);
     }
+    return true;
 }
 
 bool WeatherService::loadCache() {
-    if (!_fileManager || !_fileManager->exists(CACHE_FILE_PATH)) {
+    CacheRecord record;
+    if (!_fileManager || !_fileManager->exists(CACHE_FILE_PATH) ||
+        _fileManager->readStream(CACHE_FILE_PATH, 0, sizeof(record), (uint8_t*)&record) != sizeof(record)) {
         return false;
     }
 
-    Utils::Sstring content = _fileManager->readFile(CACHE_FILE_PATH);
-    if (content.isEmpty()) {
+    if (record.magic != CACHE_MAGIC || record.version != CACHE_VERSION || record.size != sizeof(record) ||
+        record.crc != recordCrc(record)) {
+        ESP_LOGW(_tag, "Ignoring stale or damaged weather cache");
         return false;
     }
 
-    Utils::SpiJsonDocument doc;
-    DeserializationError error = deserializeJson(doc, content.c_str());
-    
-    if (error) {
+    // Strings are stored NUL terminated
+    if (strncmp(record.adm4, _config.adm4Code.c_str(), sizeof(record.adm4)) != 0) {
         return false;
     }
 
-    _cachedData.location = doc["location"].as<String>();
-    _cachedData.description = doc["description"].as<String>();
-    _cachedData.condition = static_cast<WeatherCondition>(doc["condition"].as<int>());
-    _cachedData.temperature = doc["temperature"].as<int>();
-    _cachedData.humidity = doc["humidity"].as<int>();
-    _cachedData.windSpeed = doc["windSpeed"].as<int>();
-    _cachedData.windDirection = doc["windDirection"].as<String>();
-    _cachedData.lastUpdated = doc["lastUpdated"].as<String>();
-    _cachedData.imageUrl = doc["imageUrl"].as<String>();
-    _cachedData.longitude = doc["longitude"].as<float>();
-    _cachedData.latitude = doc["latitude"].as<float>();
-    _cachedData.timezone = doc["timezone"].as<String>();
-    _cachedData.isValid = doc["isValid"].as<bool>();
-    _lastCacheTime = doc["cacheTime"].as<unsigned long>();
+    _cachedData.location = record.location;
+    _cachedData.description = record.description;
+    _cachedData.condition = static_cast<WeatherCondition>(record.condition);
+    _cachedData.temperature = record.temperature;
+    _cachedData.humidity = record.humidity;
+    _cachedData.windSpeed = record.windSpeed;
+    _cachedData.windDirection = record.windDirection;
+    _cachedData.lastUpdated = record.lastUpdated;
+    _cachedData.imageUrl = record.imageUrl;
+    _cachedData.longitude = record.longitude;
+    _cachedData.latitude = record.latitude;
+    _cachedData.timezone = record.timezone;
+    _cachedData.isValid = true;
+    copyText(_etag, record.etag);
+    copyText(_lastModified, record.lastModified);
+    _nextSlotEpoch = record.nextSlotEpoch;
+
+    // millis() restarts with every boot, so the record is shown but not trusted as fresh
+    _lastCacheTime = 0;
 
     return true;
 }
@@ -264,27 +541,36 @@ bool WeatherService::saveCache(const WeatherData& data) {
         return false;
     }
 
-    Utils::SpiJsonDocument doc;
-    
-    doc["location"] = data.location;
-    doc["description"] = data.description;
-    doc["condition"] = static_cast<int>(data.condition);
-    doc["temperature"] = data.temperature;
-    doc["humidity"] = data.humidity;
-    doc["windSpeed"] = data.windSpeed;
-    doc["windDirection"] = data.windDirection;
-    doc["lastUpdated"] = data.lastUpdated;
-    doc["imageUrl"] = data.imageUrl;
-    doc["longitude"] = data.longitude;
-    doc["latitude"] = data.latitude;
-    doc["timezone"] = data.timezone;
-    doc["isValid"] = data.isValid;
-    doc["cacheTime"] = getCurrentTimestamp();
-
-    String jsonString;
-    serializeJson(doc, jsonString);
-
-    return _fileManager->writeFile(CACHE_FILE_PATH, jsonString.c_str());
+    CacheRecord record;
+    memset(&record, 0, sizeof(record));
+    record.magic = CACHE_MAGIC;
+    record.version = CACHE_VERSION;
+    record.size = sizeof(record);
+    copyText(record.adm4, _config.adm4Code);
+    copyText(record.location, data.location);
+    copyText(record.description, data.description);
+    copyText(record.windDirection, data.windDirection);
+    copyText(record.lastUpdated, data.lastUpdated);
+    copyText(record.imageUrl, data.imageUrl);
+    copyText(record.timezone, data.timezone);
+    record.longitude = data.longitude;
+    record.latitude = data.latitude;
+    record.temperature = data.temperature;
+    record.humidity = data.humidity;
+    record.windSpeed = data.windSpeed;
+    record.condition = static_cast<uint8_t>(data.condition);
+    copyText(record.etag, _etag);
+    copyText(record.lastModified, _lastModified);
+    record.nextSlotEpoch = _nextSlotEpoch;
+    record.crc = recordCrc(record);
+
+    File file = _fileManager->openFileForWriting(CACHE_FILE_PATH);
+    if (!file) {
+        return false;
+    }
+    size_t written = file.write((const uint8_t*)&record, sizeof(record));
+    file.close();
+    return written == sizeof(record);
 }
 
 Utils::Sstring WeatherService::buildAPIUrl() const {
@@ -3,8 +3,11 @@
 #include <Arduino.h>
 #include <ArduinoJson.h>
 #include <functional>
+#include "freertos/FreeRTOS.h"
 #include "Sstring.h"
 #include "FileManager.h"
+#include "ConnectionPool.h"
+#include "WeatherStreamParser.h"
 #include "repository/AdministrativeRegion.h"
 
 namespace Communication {
@@ -163,9 +166,32 @@ public:
 
     struct WeatherConfig {
         Utils::Sstring adm4Code;        // Administrative level 4 code (village/kelurahan)
-        uint32_t cacheExpiryMinutes;    // Cache expiry time in minutes
+        uint32_t cacheExpiryMinutes;    // Cache expiry time in minutes, also the longest time between refreshes
+        uint32_t minRefreshMs;          // Shortest time between successful refreshes
+        uint32_t refreshJitterMs;       // Random delay added to every scheduled refresh
+        uint32_t coalesceWindowMs;      // A refresh due this soon runs early when a connection is already open
+        uint32_t retryMinMs;            // First retry after a failure, doubled per failure
+        uint32_t retryMaxMs;
         
-        WeatherConfig() : adm4Code("31.71.03.1001"), cacheExpiryMinutes(60) {}
+        WeatherConfig() : adm4Code("31.71.03.1001"), cacheExpiryMinutes(60), minRefreshMs(600000),
+                          refreshJitterMs(300000), coalesceWindowMs(900000), retryMinMs(30000),
+                          retryMaxMs(1800000) {}
+    };
+
+    struct Stats {
+        uint32_t requests;              // Requests sent
+        uint32_t updated;               // Responses with new data
+        uint32_t notModified;           // Conditional requests answered with 304
+        uint32_t failures;
+        uint32_t consecutiveFailures;
+        uint32_t coalesced;             // Refreshes run early on an open connection
+        uint32_t bytes;                 // Response body bytes
+        uint32_t requestsDay;           // Current 24 hour window since boot
+        uint32_t bytesDay;
+        uint32_t requestsPrevDay;       // The window before it
+        uint32_t bytesPrevDay;
+        uint32_t lastFetchMs;           // Duration of the last request
+        uint32_t nextRefreshInMs;
     };
 
     // Callback type for weather responses
@@ -194,6 +220,21 @@ public:
      */
     void getCurrentWeather(WeatherCallback callback, bool forceRefresh = false);
 
+    /**
+     * Refresh if the schedule says so, called periodically without network cost otherwise
+     *
+     * The next refresh is set after every request: at the start of the
+     * forecast's next entry when the response says when that is, between
+     * minRefreshMs and the cache expiry, plus jitter. Failures retry with
+     * exponential backoff. A refresh due within the coalesce window runs
+     * early when the connection pool has a connection open, so the radio
+     * wakes once for both.
+     * @return true if a request was sent
+     */
+    bool refreshIfDue(WeatherCallback callback);
+
+    Stats getStats() const;
+
     /**
      * Set the location by administrative region code
      * @param adm4Code Administrative level 4 code (village/kelurahan)
@@ -206,6 +247,12 @@ public:
      */
     void setLocation(const IModel::AdministrativeRegion& region);
 
+    /**
+     * Fetch over shared keep-alive connections instead of a new connection each time
+     * @param pool Connection pool, nullptr to connect per request
+     */
+    void setConnectionPool(ConnectionPool* pool) { _pool = pool; }
+
     /**
      * Set cache expiry time
      * @param minutes Cache expiry time in minutes
@@ -290,9 +337,21 @@ private:
     unsigned long _lastCacheTime;
     bool _initialized;
     Utils::FileManager* _fileManager;
-
-    // Cache file path
+    ConnectionPool* _pool;
+
+    // Refresh schedule and validators for conditional requests
+    uint32_t _nextRefreshMs;        // 0 when due now
+    uint32_t _lastRequestMs;
+    uint32_t _nextSlotEpoch;        // UTC start of the forecast's next entry, 0 if unknown
+    char _etag[64];
+    char _lastModified[40];
+    Stats _stats;
+    uint32_t _dayStartMs;
+    mutable portMUX_TYPE _mux;
+
+    // Cache file path, one fixed-layout record
     static const char* CACHE_FILE_PATH;
+    static const char* LEGACY_CACHE_FILE_PATH;
 
     /**
      * Fetch weather data from BMKG API
@@ -301,15 +360,28 @@ private:
     void fetchFromAPI(WeatherCallback callback);
 
     /**
-     * Process the HTTP response from BMKG API
-     * @param response Raw HTTP response
+     * Turn the fields filtered from the BMKG response into weather data
+     * @param parser Parser the response body was fed to
      * @param callback Callback function for processed data
+     * @return true if the response held weather data
+     */
+    bool processAPIResponse(const WeatherStreamParser& parser, WeatherCallback callback);
+
+    /**
+     * Set the next refresh after a request
+     * @param success Data was updated or confirmed unchanged
+     * @param serverEpoch Server time from the Date header, 0 if unknown
+     */
+    void scheduleNext(bool success, uint32_t serverEpoch);
+
+    /**
+     * Count a request in the stats and roll the daily window
      */
-    void processAPIResponse(const Utils::Sstring& response, WeatherCallback callback);
+    void countRequest(int httpCode, bool success, size_t bytes, uint32_t durationMs);
 
     /**
-     * Load cached weather data from file
-     * @return true if cache was loaded successfully, false otherwise
+     * Load cached weather data from file in a single read
+     * @return true if a valid record for the current location was loaded, false otherwise
      */
     bool loadCache();
 
@@ -0,0 +1,337 @@
+#include "WeatherStreamParser.h"
+#include <stdlib.h>
+#include <string.h>
+
+namespace Communication {
+
+namespace {
+
+struct FieldKey {
+    const char* key;
+    WeatherStreamParser::Field field;
+};
+
+// Keys of the lokasi object
+const FieldKey LOCATION_KEYS[] = {
+    {"provinsi", WeatherStreamParser::PROVINSI},
+    {"kotkab", WeatherStreamParser::KOTKAB},
+    {"kecamatan", WeatherStreamParser::KECAMATAN},
+    {"desa", WeatherStreamParser::DESA},
+    {"lon", WeatherStreamParser::LONGITUDE},
+    {"lat", WeatherStreamParser::LATITUDE},
+    {"timezone", WeatherStreamParser::TIMEZONE},
+};
+
+// Keys of the first forecast entry
+const FieldKey WEATHER_KEYS[] = {
+    {"t", WeatherStreamParser::TEMPERATURE},
+    {"hu", WeatherStreamParser::HUMIDITY},
+    {"ws", WeatherStreamParser::WIND_SPEED},
+    {"wd", WeatherStreamParser::WIND_DIRECTION},
+    {"weather", WeatherStreamParser::WEATHER_CODE},
+    {"weather_desc", WeatherStreamParser::DESCRIPTION},
+    {"image", WeatherStreamParser::IMAGE_URL},
+    {"local_datetime", WeatherStreamParser::LOCAL_DATETIME},
+};
+
+template <size_t N>
+uint8_t lookup(const FieldKey (&keys)[N], const char* key) {
+    for (size_t i = 0; i < N; i++) {
+        if (strcmp(keys[i].key, key) == 0) {
+            return keys[i].field;
+        }
+    }
+    return WeatherStreamParser::NONE;
+}
+
+template <size_t N>
+void copyText(char (&target)[N], const char* value) {
+    strncpy(target, value, N - 1);
+    target[N - 1] = '\0';
+}
+
+} // namespace
+
+WeatherStreamParser::WeatherStreamParser() {
+    reset();
+}
+
+void WeatherStreamParser::reset() {
+    _depth = 0;
+    _state = STATE_VALUE;
+    _stringIsKey = false;
+    _field = NONE;
+    _valueLength = 0;
+    _unicode = 0;
+    _unicodeDigits = 0;
+    _bytes = 0;
+    memset(&_result, 0, sizeof(_result));
+}
+
+void WeatherStreamParser::feed(const char* data, size_t length) {
+    _bytes += length;
+    for (size_t i = 0; i < length && _state != STATE_ERROR; i++) {
+        handle(data[i]);
+    }
+}
+
+void WeatherStreamParser::finish() {
+    if (_state == STATE_LITERAL) {
+        endValue();
+    }
+}
+
+void WeatherStreamParser::handle(char c) {
+    switch (_state) {
+        case STATE_STRING:
+            if (c == '"') {
+                if (_stringIsKey) {
+                    _state = STATE_COLON;
+                } else {
+                    endValue();
+                }
+            } else if (c == '\\') {
+                _state = STATE_ESCAPE;
+            } else {
+                append(c);
+            }
+            return;
+
+        case STATE_ESCAPE:
+            _state = STATE_STRING;
+            switch (c) {
+                case 'n': append('\n'); break;
+                case 't': append('\t'); break;
+                case 'r': append('\r'); break;
+                case 'b': append('\b'); break;
+                case 'f': append('\f'); break;
+                case 'u':
+                    _unicode = 0;
+                    _unicodeDigits = 0;
+                    _state = STATE_UNICODE;
+                    break;
+                default: append(c); break;     // \" \\ \/
+            }
+            return;
+
+        case STATE_UNICODE: {
+            int digit = c >= '0' && c <= '9' ? c - '0'
+                      : c >= 'a' && c <= 'f' ? c - 'a' + 10
+                      : c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+            if (digit < 0) {
+                _state = STATE_ERROR;
+                return;
+            }
+            _unicode = (_unicode << 4) | digit;
+            if (++_unicodeDigits == 4) {
+                appendCodepoint(_unicode);
+                _state = STATE_STRING;
+            }
+            return;
+        }
+
+        case STATE_LITERAL:
+            if (c == ',' || c == '}' || c == ']' || c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+                endValue();
+                handle(c);
+            } else {
+                append(c);
+            }
+            return;
+
+        case STATE_DONE:
+        case STATE_ERROR:
+            return;
+
+        default:
+            break;
+    }
+
+    if (c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+        return;
+    }
+
+    switch (_state) {
+        case STATE_VALUE:
+            if (c == '{') {
+                push(false);
+            } else if (c == '[') {
+                push(true);
+            } else if (c == ']' && _depth > 0 && _frames[_depth - 1].array && _frames[_depth - 1].index == 0) {
+                pop(true);      // Empty array
+            } else if (c == '"') {
+                startValue();
+                _state = STATE_STRING;
+            } else if (c == ',' || c == ':' || c == '}' || c == ']') {
+                _state = STATE_ERROR;
+            } else {
+                startValue();
+                append(c);
+                _state = STATE_LITERAL;
+            }
+            break;
+
+        case STATE_KEY:
+            if (c == '"') {
+                Frame& frame = _frames[_depth - 1];
+                frame.keyLength = 0;
+                frame.key[0] = '\0';
+                _stringIsKey = true;
+                _state = STATE_STRING;
+            } else if (c == '}') {
+                pop(false);
+            } else {
+                _state = STATE_ERROR;
+            }
+            break;
+
+        case STATE_COLON:
+            _state = c == ':' ? STATE_VALUE : STATE_ERROR;
+            break;
+
+        case STATE_AFTER:
+            if (_depth == 0) {
+                _state = STATE_ERROR;
+            } else if (c == ',') {
+                Frame& frame = _frames[_depth - 1];
+                if (frame.array) {
+                    frame.index++;
+                    _state = STATE_VALUE;
+                } else {
+                    _state = STATE_KEY;
+                }
+            } else if (c == '}' || c == ']') {
+                pop(c == ']');
+            } else {
+                _state = STATE_ERROR;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+void WeatherStreamParser::push(bool array) {
+    if (_depth == MAX_DEPTH) {
+        _state = STATE_ERROR;
+        return;
+    }
+    Frame& frame = _frames[_depth++];
+    frame.array = array;
+    frame.index = 0;
+    frame.keyLength = 0;
+    frame.key[0] = '\0';
+    _state = array ? STATE_VALUE : STATE_KEY;
+}
+
+void WeatherStreamParser::pop(bool array) {
+    if (_depth == 0 || _frames[_depth - 1].array != array) {
+        _state = STATE_ERROR;
+        return;
+    }
+    _depth--;
+    _state = _depth == 0 ? STATE_DONE : STATE_AFTER;
+}
+
+void WeatherStreamParser::startValue() {
+    _stringIsKey = false;
+    _field = match();
+    _valueLength = 0;
+}
+
+void WeatherStreamParser::endValue() {
+    if (_field != NONE) {
+        _value[_valueLength] = '\0';
+        store(_field);
+        _field = NONE;
+    }
+    _state = _depth == 0 ? STATE_DONE : STATE_AFTER;
+}
+
+void WeatherStreamParser::append(char c) {
+    if (_stringIsKey) {
+        Frame& frame = _frames[_depth - 1];
+        if (frame.keyLength < MAX_KEY) {
+            frame.key[frame.keyLength++] = c;
+            frame.key[frame.keyLength] = '\0';
+        } else {
+            frame.keyLength = MAX_KEY + 1;
+        }
+        return;
+    }
+    if (_field != NONE && _valueLength < MAX_VALUE) {
+        _value[_valueLength++] = c;
+    }
+}
+
+void WeatherStreamParser::appendCodepoint(uint16_t codepoint) {
+    // Surrogate halves are not combined, they come out as '?'
+    if (codepoint < 0x80) {
+        append((char)codepoint);
+    } else if (codepoint < 0x800) {
+        append((char)(0xC0 | (codepoint >> 6)));
+        append((char)(0x80 | (codepoint & 0x3F)));
+    } else if (codepoint >= 0xD800 && codepoint <= 0xDFFF) {
+        append('?');
+    } else {
+        append((char)(0xE0 | (codepoint >> 12)));
+        append((char)(0x80 | ((codepoint >> 6) & 0x3F)));
+        append((char)(0x80 | (codepoint & 0x3F)));
+    }
+}
+
+bool WeatherStreamParser::keyIs(size_t frame, const char* key) const {
+    return !_frames[frame].array && _frames[frame].keyLength <= MAX_KEY && strcmp(_frames[frame].key, key) == 0;
+}
+
+uint8_t WeatherStreamParser::match() const {
+    // lokasi.<key>
+    if (_depth == 2 && keyIs(0, "lokasi") && !_frames[1].array && _frames[1].keyLength <= MAX_KEY) {
+        return lookup(LOCATION_KEYS, _frames[1].key);
+    }
+
+    // data[0].cuaca[day][entry].<key>
+    if (_depth != 6 || !keyIs(0, "data") || !_frames[1].array || _frames[1].index != 0 ||
+        !keyIs(2, "cuaca") || !_frames[3].array || !_frames[4].array ||
+        _frames[5].array || _frames[5].keyLength > MAX_KEY) {
+        return NONE;
+    }
+    uint16_t day = _frames[3].index;
+    uint16_t entry = _frames[4].index;
+    if (day == 0 && entry == 0) {
+        return lookup(WEATHER_KEYS, _frames[5].key);
+    }
+
+    // The next entry is the second of the first day, or the first of the second
+    if (((day == 0 && entry == 1) || (day == 1 && entry == 0)) && !has(NEXT_DATETIME) &&
+        strcmp(_frames[5].key, "utc_datetime") == 0) {
+        return NEXT_DATETIME;
+    }
+    return NONE;
+}
+
+void WeatherStreamParser::store(uint8_t field) {
+    switch (field) {
+        case PROVINSI: copyText(_result.provinsi, _value); break;
+        case KOTKAB: copyText(_result.kotkab, _value); break;
+        case KECAMATAN: copyText(_result.kecamatan, _value); break;
+        case DESA: copyText(_result.desa, _value); break;
+        case TIMEZONE: copyText(_result.timezone, _value); break;
+        case LONGITUDE: _result.longitude = strtof(_value, nullptr); break;
+        case LATITUDE: _result.latitude = strtof(_value, nullptr); break;
+        case TEMPERATURE: _result.temperature = atoi(_value); break;
+        case HUMIDITY: _result.humidity = atoi(_value); break;
+        case WIND_SPEED: _result.windSpeed = strtof(_value, nullptr); break;
+        case WIND_DIRECTION: copyText(_result.windDirection, _value); break;
+        case WEATHER_CODE: _result.weatherCode = atoi(_value); break;
+        case DESCRIPTION: copyText(_result.description, _value); break;
+        case IMAGE_URL: copyText(_result.imageUrl, _value); break;
+        case LOCAL_DATETIME: copyText(_result.localDatetime, _value); break;
+        case NEXT_DATETIME: copyText(_result.nextUtcDatetime, _value); break;
+        default: return;
+    }
+    _result.found |= 1u << field;
+}
+
+} // namespace Communication
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace Communication {
+
+/**
+ * Incremental filter for the BMKG forecast response
+ *
+ * Takes the JSON body in pieces of any size, as they come off the socket,
+ * and keeps only the fields the weather service uses:
+ *
+ *   lokasi.{provinsi, kotkab, kecamatan, desa, lon, lat, timezone}
+ *   data[0].cuaca[0][0].{t, hu, ws, wd, weather, weather_desc, image, local_datetime}
+ *   utc_datetime of the forecast entry after that one
+ *
+ * Everything else is skipped without being stored, so memory stays the
+ * size of this object however long the forecast is. Values longer than
+ * their field are truncated.
+ *
+ * Only needs the C++ standard library, so it builds and runs the same on
+ * the robot and on a Linux host.
+ */
+class WeatherStreamParser {
+public:
+    static const size_t MAX_DEPTH = 16;     // Deeper documents are rejected
+    static const size_t MAX_KEY = 15;       // Longer keys never match
+    static const size_t MAX_VALUE = 160;    // Longest value captured, longer ones are truncated
+
+    enum Field : uint8_t {
+        PROVINSI,
+        KOTKAB,
+        KECAMATAN,
+        DESA,
+        LONGITUDE,
+        LATITUDE,
+        TIMEZONE,
+        TEMPERATURE,
+        HUMIDITY,
+        WIND_SPEED,
+        WIND_DIRECTION,
+        WEATHER_CODE,
+        DESCRIPTION,
+        IMAGE_URL,
+        LOCAL_DATETIME,
+        NEXT_DATETIME,
+        FIELD_COUNT,
+        NONE = 0xFF
+    };
+
+    struct Result {
+        char provinsi[48];
+        char kotkab[48];
+        char kecamatan[48];
+        char desa[48];
+        char timezone[32];
+        float longitude;
+        float latitude;
+        int temperature;        // Celsius
+        int humidity;           // Percent
+        float windSpeed;        // m/s, as BMKG sends it
+        char windDirection[8];
+        int weatherCode;
+        char description[48];
+        char imageUrl[128];
+        char localDatetime[24];
+        char nextUtcDatetime[24];   // Start of the next forecast entry, "YYYY-MM-DD HH:MM:SS"
+        uint32_t found;         // Bit per Field
+    };
+
+    WeatherStreamParser();
+
+    /**
+     * Forget everything parsed
+     */
+    void reset();
+
+    /**
+     * Parse the next piece of the response body
+     */
+    void feed(const char* data, size_t length);
+
+    /**
+     * End of body, completes a bare top-level literal
+     */
+    void finish();
+
+    bool has(Field field) const { return _result.found & (1u << field); }
+    bool hasLocation() const { return has(PROVINSI) || has(KOTKAB) || has(KECAMATAN) || has(DESA); }
+    bool hasWeather() const { return has(TEMPERATURE); }
+
+    /**
+     * The body was not well-formed JSON
+     */
+    bool hasError() const { return _state == STATE_ERROR; }
+    size_t getBytes() const { return _bytes; }
+
+    const Result& getResult() const { return _result; }
+
+private:
+    enum State : uint8_t {
+        STATE_VALUE,            // Expecting a value
+        STATE_KEY,              // Expecting a key or the end of an object
+        STATE_COLON,
+        STATE_AFTER,            // Expecting a comma or the end of a container
+        STATE_STRING,
+        STATE_ESCAPE,
+        STATE_UNICODE,
+        STATE_LITERAL,
+        STATE_DONE,
+        STATE_ERROR
+    };
+
+    struct Frame {
+        bool array;
+        uint16_t index;
+        uint8_t keyLength;      // MAX_KEY + 1 once the key overflowed
+        char key[MAX_KEY + 1];
+    };
+
+    Frame _frames[MAX_DEPTH];
+    size_t _depth;
+    State _state;
+    bool _stringIsKey;
+    uint8_t _field;             // Field the current value goes to, NONE to skip it
+    char _value[MAX_VALUE + 1];
+    size_t _valueLength;
+    uint16_t _unicode;
+    uint8_t _unicodeDigits;
+    size_t _bytes;
+    Result _result;
+
+    void handle(char c);
+    void startValue();
+    void endValue();
+    void push(bool array);
+    void pop(bool array);
+    void append(char c);
+    void appendCodepoint(uint16_t codepoint);
+    uint8_t match() const;
+    void store(uint8_t field);
+
+    bool keyIs(size_t frame, const char* key) const;
+};
+
+} // namespace Communication
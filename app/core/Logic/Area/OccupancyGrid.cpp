@@ -0,0 +1,216 @@
+#include "OccupancyGrid.h"
+#include <esp_heap_caps.h>
+#include <esp_log.h>
+
+namespace Logic {
+
+// Half the ultrasonic cone width, in sectors (HC-SR04 is ~15 degrees)
+static const int BEAM_HALF_WIDTH = 1;
+
+OccupancyGrid::OccupancyGrid()
+    : TAG("OccupancyGrid"),
+      _cells(nullptr),
+      _mutex(xSemaphoreCreateMutex()),
+      _lastDecay(0),
+      _samples(0)
+{
+    uint32_t caps = ESP.getFreePsram() > 0 ? MALLOC_CAP_SPIRAM : MALLOC_CAP_DEFAULT;
+    _cells = static_cast<int8_t*>(heap_caps_malloc(SECTORS * BINS, caps));
+    if (!_cells) {
+        ESP_LOGE(TAG, "Failed to allocate %d byte grid", SECTORS * BINS);
+        return;
+    }
+    memset(_cells, 0, SECTORS * BINS);
+}
+
+OccupancyGrid::~OccupancyGrid() {
+    if (_cells) {
+        heap_caps_free(_cells);
+    }
+    if (_mutex) {
+        vSemaphoreDelete(_mutex);
+    }
+}
+
+float OccupancyGrid::wrapDegrees(float degrees) {
+    while (degrees > 180.0f) degrees -= 360.0f;
+    while (degrees < -180.0f) degrees += 360.0f;
+    return degrees;
+}
+
+int OccupancyGrid::sectorFor(float yawDegrees) {
+    float shifted = wrapDegrees(yawDegrees) + 180.0f;
+    int sector = (int)(shifted * SECTORS / 360.0f);
+    return sector >= SECTORS ? SECTORS - 1 : sector;
+}
+
+float OccupancyGrid::sectorHeading(int sector) {
+    return wrapDegrees((sector + 0.5f) * 360.0f / SECTORS - 180.0f);
+}
+
+static inline int8_t clampLogOdds(int value) {
+    if (value > OccupancyGrid::LOG_ODDS_MAX) return OccupancyGrid::LOG_ODDS_MAX;
+    if (value < OccupancyGrid::LOG_ODDS_MIN) return OccupancyGrid::LOG_ODDS_MIN;
+    return (int8_t)value;
+}
+
+void OccupancyGrid::applyRay(int sector, int hitBin, int lastBin) {
+    int8_t* cells = row((sector + SECTORS) % SECTORS);
+    for (int bin = 0; bin < lastBin; bin++) {
+        cells[bin] = clampLogOdds(cells[bin] + LOG_ODDS_MISS);
+    }
+    if (hitBin >= 0) {
+        cells[hitBin] = clampLogOdds(cells[hitBin] + LOG_ODDS_HIT);
+    }
+}
+
+void OccupancyGrid::addSample(float yawDegrees, float distanceCm) {
+    if (!_cells) {
+        return;
+    }
+
+    int sector = sectorFor(yawDegrees);
+    int hitBin = -1;
+    int lastBin = BINS;
+
+    // No echo: the whole beam is free up to the sensor range
+    if (distanceCm >= 0) {
+        hitBin = (int)(distanceCm / BIN_SIZE_CM);
+        if (hitBin >= BINS) {
+            hitBin = -1;
+        } else {
+            lastBin = hitBin;
+        }
+    }
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    for (int offset = -BEAM_HALF_WIDTH; offset <= BEAM_HALF_WIDTH; offset++) {
+        applyRay(sector + offset, hitBin, lastBin);
+    }
+    _samples++;
+    xSemaphoreGive(_mutex);
+
+    unsigned long now = millis();
+    if (now - _lastDecay >= DECAY_INTERVAL_MS) {
+        _lastDecay = now;
+        decay();
+    }
+}
+
+void OccupancyGrid::decay() {
+    if (!_cells) {
+        return;
+    }
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    for (int i = 0; i < SECTORS * BINS; i++) {
+        int8_t value = _cells[i];
+        // ~12% per step, but always at least one unit so cells reach zero
+        int8_t step = value / 8;
+        if (step == 0 && value != 0) {
+            step = value > 0 ? 1 : -1;
+        }
+        _cells[i] = value - step;
+    }
+    xSemaphoreGive(_mutex);
+}
+
+void OccupancyGrid::clear() {
+    if (!_cells) {
+        return;
+    }
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    memset(_cells, 0, SECTORS * BINS);
+    _samples = 0;
+    xSemaphoreGive(_mutex);
+}
+
+bool OccupancyGrid::isSectorBlocked(int sector, int bins) const {
+    const int8_t* cells = row((sector + SECTORS) % SECTORS);
+    for (int bin = 0; bin < bins; bin++) {
+        if (cells[bin] > OCCUPIED_THRESHOLD) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool OccupancyGrid::findFreeHeading(float targetDegrees, float clearanceCm, float& headingDegrees) const {
+    if (!_cells) {
+        return false;
+    }
+
+    int bins = (int)ceilf(clearanceCm / BIN_SIZE_CM);
+    bins = bins < 1 ? 1 : (bins > BINS ? BINS : bins);
+    int target = sectorFor(targetDegrees);
+    bool found = false;
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    // Walk outwards from the target, alternating sides
+    for (int distance = 0; distance <= SECTORS / 2 && !found; distance++) {
+        for (int side = 0; side < (distance == 0 ? 1 : 2) && !found; side++) {
+            int sector = target + (side == 0 ? distance : -distance);
+            if (!isSectorBlocked(sector - 1, bins) &&
+                !isSectorBlocked(sector, bins) &&
+                !isSectorBlocked(sector + 1, bins)) {
+                headingDegrees = sectorHeading((sector + SECTORS) % SECTORS);
+                found = true;
+            }
+        }
+    }
+    xSemaphoreGive(_mutex);
+
+    return found;
+}
+
+float OccupancyGrid::getObstacleDistance(float yawDegrees) const {
+    if (!_cells) {
+        return -1.0f;
+    }
+
+    float distance = -1.0f;
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    const int8_t* cells = row(sectorFor(yawDegrees));
+    for (int bin = 0; bin < BINS; bin++) {
+        if (cells[bin] > OCCUPIED_THRESHOLD) {
+            distance = (bin + 0.5f) * BIN_SIZE_CM;
+            break;
+        }
+    }
+    xSemaphoreGive(_mutex);
+
+    return distance;
+}
+
+void OccupancyGrid::toJson(JsonObject out) const {
+    static const char hex[] = "0123456789abcdef";
+
+    out["sectors"] = SECTORS;
+    out["bins"] = BINS;
+    out["bin_cm"] = BIN_SIZE_CM;
+    out["occupied_threshold"] = OCCUPIED_THRESHOLD;
+    out["free_threshold"] = FREE_THRESHOLD;
+    out["samples"] = _samples;
+
+    JsonArray rows = out["cells"].to<JsonArray>();
+    if (!_cells) {
+        return;
+    }
+
+    char line[BINS * 2 + 1];
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    for (int sector = 0; sector < SECTORS; sector++) {
+        const int8_t* cells = row(sector);
+        for (int bin = 0; bin < BINS; bin++) {
+            uint8_t value = (uint8_t)(cells[bin] + 128);
+            line[bin * 2] = hex[value >> 4];
+            line[bin * 2 + 1] = hex[value & 0x0f];
+        }
+        line[BINS * 2] = '\0';
+        rows.add(line);
+    }
+    xSemaphoreGive(_mutex);
+}
+
+} // namespace Logic
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+namespace Logic {
+
+/**
+ * Robot-centred polar occupancy grid
+ *
+ * The area around the robot is split into SECTORS headings and BINS range
+ * rings. Every cell holds a log-odds value in fixed point (1/16 nat per
+ * step, int8_t) so the whole map is a few kilobytes and lives in PSRAM.
+ * Each ultrasonic sample marks the cells along its beam as free and the
+ * cell at the echo as occupied; all cells decay back towards unknown so
+ * stale readings fade out while the robot moves.
+ *
+ * Headings are yaw angles in degrees (-180..180) as produced by ScanArea.
+ */
+class OccupancyGrid {
+public:
+    static const int SECTORS = 72;          // 5 degrees per sector
+    static const int BINS = 40;             // Range rings
+    static const int BIN_SIZE_CM = 10;      // 4 meters of range
+
+    static const int8_t LOG_ODDS_MIN = -100;
+    static const int8_t LOG_ODDS_MAX = 100;
+    static const int8_t LOG_ODDS_HIT = 14;       // ~0.85 nat
+    static const int8_t LOG_ODDS_MISS = -6;      // ~-0.4 nat
+    static const int8_t OCCUPIED_THRESHOLD = 16; // ~73% occupied
+    static const int8_t FREE_THRESHOLD = -8;     // ~38% occupied
+
+    OccupancyGrid();
+    ~OccupancyGrid();
+
+    /**
+     * Integrate one range reading
+     * @param yawDegrees Heading the sensor was pointing at
+     * @param distanceCm Measured distance, or < 0 if no echo came back
+     */
+    void addSample(float yawDegrees, float distanceCm);
+
+    /**
+     * Move every cell one step back towards unknown
+     * Called automatically from addSample() once per decay interval.
+     */
+    void decay();
+
+    /**
+     * Forget everything
+     */
+    void clear();
+
+    /**
+     * Find the heading closest to a target whose beam is not blocked
+     * A heading is usable when no cell within the clearance, in its own
+     * sector and the two neighbours (robot width), is above the occupied
+     * threshold. Unknown cells count as passable.
+     * @param targetDegrees Preferred heading
+     * @param clearanceCm Required free distance
+     * @param headingDegrees Receives the chosen heading (sector centre)
+     * @return true if a heading was found
+     */
+    bool findFreeHeading(float targetDegrees, float clearanceCm, float& headingDegrees) const;
+
+    /**
+     * Distance to the nearest occupied cell in a heading
+     * @param yawDegrees Heading to look at
+     * @return Distance in centimeters, or -1 if nothing is known to be there
+     */
+    float getObstacleDistance(float yawDegrees) const;
+
+    /**
+     * Serialize the grid for the web UI
+     * Cells are sent as one hex string per sector, two characters per
+     * bin holding the log-odds value offset by 128 (0x80 is unknown).
+     * @param out Object to fill
+     */
+    void toJson(JsonObject out) const;
+
+    /**
+     * @return Number of samples integrated since the last clear()
+     */
+    uint32_t getSampleCount() const { return _samples; }
+
+    /**
+     * Wrap an angle to -180..180 degrees
+     */
+    static float wrapDegrees(float degrees);
+
+    /**
+     * @return Sector index for a heading
+     */
+    static int sectorFor(float yawDegrees);
+
+    /**
+     * @return Centre heading of a sector in degrees
+     */
+    static float sectorHeading(int sector);
+
+private:
+    const char* TAG;
+    int8_t* _cells;          // SECTORS * BINS, row per sector
+    SemaphoreHandle_t _mutex;
+    unsigned long _lastDecay;
+    uint32_t _samples;
+
+    static const unsigned long DECAY_INTERVAL_MS = 500;
+
+    int8_t* row(int sector) const { return _cells + sector * BINS; }
+    void applyRay(int sector, int hitBin, int lastBin);
+    bool isSectorBlocked(int sector, int bins) const;
+};
+
+} // namespace Logic
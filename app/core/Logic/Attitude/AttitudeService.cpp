@@ -0,0 +1,182 @@
+#include "AttitudeService.h"
+#include <esp_timer.h>
+#include "Logger.h"
+#include "SendTask.h"
+
+namespace Logic {
+
+// Samples integrated per run at most, enough for 100ms at 200Hz
+static const int MAX_BATCH = 24;
+
+AttitudeService::AttitudeService(Sensors::OrientationSensor* sensor)
+	: TAG("AttitudeService"),
+	  _sensor(sensor),
+	  _taskHandle(nullptr),
+	  _periodMs(10),
+	  _lastSequence(0),
+	  _resetRequested(false),
+	  _publishSequence(0),
+	  _attitude{},
+	  _statsMux(portMUX_INITIALIZER_UNLOCKED),
+	  _stats{}
+{
+}
+
+AttitudeService::~AttitudeService() {
+	stop();
+}
+
+bool AttitudeService::start(uint16_t rateHz, int core, UBaseType_t priority) {
+	if (_taskHandle != nullptr) {
+		return true;
+	}
+
+	if (!_sensor) {
+		Utils::Logger::getInstance().error("AttitudeService: orientation sensor not available");
+		return false;
+	}
+
+	// Streaming: run often enough to keep up with the FIFO ring.
+	// Register reads: the task itself sets the sample rate.
+	if (rateHz == 0) rateHz = 100;
+	_periodMs = 1000 / rateHz;
+	if (_periodMs == 0) _periodMs = 1;
+
+	BaseType_t result = xTaskCreatePinnedToCore(
+		taskFunction,
+		"Attitude",
+		3 * 1024,
+		this,
+		priority,
+		&_taskHandle,
+		core
+	);
+
+	if (result != pdPASS) {
+		_taskHandle = nullptr;
+		Utils::Logger::getInstance().error("AttitudeService: failed to create task");
+		return false;
+	}
+
+	Utils::Logger::getInstance().info("AttitudeService: started, %s at %u Hz",
+		_sensor->isStreaming() ? "FIFO stream" : "register reads",
+		_sensor->isStreaming() ? _sensor->getSampleRate() : rateHz);
+	return true;
+}
+
+void AttitudeService::stop() {
+	if (_taskHandle != nullptr) {
+		vTaskDelete(_taskHandle);
+		_taskHandle = nullptr;
+	}
+}
+
+AttitudeService::Attitude AttitudeService::getAttitude() const {
+	Attitude attitude;
+	uint32_t before, after;
+	do {
+		before = _publishSequence.load(std::memory_order_acquire);
+		attitude = _attitude;
+		std::atomic_thread_fence(std::memory_order_acquire);
+		after = _publishSequence.load(std::memory_order_relaxed);
+	} while ((before & 1) || before != after);
+	return attitude;
+}
+
+AttitudeService::Stats AttitudeService::getStats() const {
+	portENTER_CRITICAL(&_statsMux);
+	Stats stats = _stats;
+	portEXIT_CRITICAL(&_statsMux);
+
+	stats.biasX = _filter.getBiasX();
+	stats.biasY = _filter.getBiasY();
+	stats.biasZ = _filter.getBiasZ();
+	return stats;
+}
+
+void AttitudeService::taskFunction(void* parameter) {
+	AttitudeService* self = static_cast<AttitudeService*>(parameter);
+	TickType_t lastWakeTime = xTaskGetTickCount();
+
+	while (true) {
+		SendTask::delayUntil(&lastWakeTime, pdMS_TO_TICKS(self->_periodMs));
+		self->run();
+	}
+}
+
+void AttitudeService::run() {
+	if (_resetRequested) {
+		_resetRequested = false;
+		_filter.reset();
+	}
+
+	if (!_sensor->isStreaming()) {
+		// No FIFO: sample the registers ourselves at the task rate
+		_sensor->update();
+		Sensors::OrientationSensor::Sample sample;
+		sample.gyroX = _sensor->getX();
+		sample.gyroY = _sensor->getY();
+		sample.gyroZ = _sensor->getZ();
+		sample.accelX = _sensor->getAccelX();
+		sample.accelY = _sensor->getAccelY();
+		sample.accelZ = _sensor->getAccelZ();
+		sample.timestamp = esp_timer_get_time();
+		sample.sequence = ++_lastSequence;
+		integrate(sample, _periodMs / 1000.0f);
+		publish(sample);
+		return;
+	}
+
+	Sensors::OrientationSensor::Sample samples[MAX_BATCH];
+	size_t count = _sensor->getSamplesSince(_lastSequence, samples, MAX_BATCH);
+	if (count == 0) {
+		return;
+	}
+
+	// FIFO samples are evenly spaced, integrate with the nominal period
+	float dt = 1.0f / _sensor->getSampleRate();
+	uint32_t missed = _lastSequence != 0 && samples[0].sequence > _lastSequence + 1 ?
+		samples[0].sequence - _lastSequence - 1 : 0;
+
+	for (size_t i = 0; i < count; i++) {
+		integrate(samples[i], dt);
+	}
+	_lastSequence = samples[count - 1].sequence;
+	publish(samples[count - 1]);
+
+	portENTER_CRITICAL(&_statsMux);
+	_stats.missed += missed;
+	if (count > _stats.maxBatch) {
+		_stats.maxBatch = count;
+	}
+	portEXIT_CRITICAL(&_statsMux);
+}
+
+void AttitudeService::integrate(const Sensors::OrientationSensor::Sample& sample, float dt) {
+	_filter.update(sample.gyroX, sample.gyroY, sample.gyroZ,
+	               sample.accelX, sample.accelY, sample.accelZ, dt);
+
+	portENTER_CRITICAL(&_statsMux);
+	_stats.updates++;
+	portEXIT_CRITICAL(&_statsMux);
+}
+
+void AttitudeService::publish(const Sensors::OrientationSensor::Sample& sample) {
+	Attitude attitude;
+	attitude.roll = _filter.getRoll();
+	attitude.pitch = _filter.getPitch();
+	attitude.yaw = _filter.getYaw();
+	attitude.rateX = sample.gyroX - _filter.getBiasX();
+	attitude.rateY = sample.gyroY - _filter.getBiasY();
+	attitude.rateZ = sample.gyroZ - _filter.getBiasZ();
+	attitude.stationary = _filter.isStationary();
+	attitude.timestamp = sample.timestamp;
+	attitude.sampleSequence = sample.sequence;
+
+	// Single writer: odd while writing, readers retry
+	_publishSequence.fetch_add(1, std::memory_order_acq_rel);
+	_attitude = attitude;
+	_publishSequence.fetch_add(1, std::memory_order_release);
+}
+
+} // namespace Logic
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include "core/Sensors/OrientationSensor.h"
+#include "MahonyFilter.h"
+
+namespace Logic {
+
+/**
+ * Shared attitude estimate
+ *
+ * A single task feeds every IMU sample through a Mahony filter at the
+ * sensor's fixed rate and publishes the result through a seqlock, so any
+ * task can read a consistent roll/pitch/yaw without touching the sensor or
+ * running its own filter.
+ *
+ * Angles are in degrees in the MPU6050 frame (see MahonyFilter). For the
+ * robot, yaw is the heading (positive turning left) and roll/pitch are the
+ * tilts about the sensor X and Y axes.
+ */
+class AttitudeService {
+public:
+	struct Attitude {
+		float roll, pitch, yaw;          // Degrees
+		float rateX, rateY, rateZ;       // Bias corrected rates, degrees per second
+		bool stationary;                 // Sensor is still, gyro bias is being learned
+		int64_t timestamp;               // Timestamp of the last integrated sample (us)
+		uint32_t sampleSequence;         // Sequence of the last integrated sample, 0 = none
+	};
+
+	struct Stats {
+		uint32_t updates;       // Samples integrated
+		uint32_t missed;        // Samples lost between two runs (ring overrun)
+		uint32_t maxBatch;      // Largest number of samples integrated in one run
+		float biasX, biasY, biasZ; // Gyro bias estimate, degrees per second
+	};
+
+	AttitudeService(Sensors::OrientationSensor* sensor);
+	~AttitudeService();
+
+	/**
+	 * Start the estimation task
+	 * @param rateHz Run rate when the sensor is not streaming (register reads)
+	 * @param core Core to pin the task to
+	 * @param priority Task priority
+	 * @return true if the task was created
+	 */
+	bool start(uint16_t rateHz = 100, int core = 0, UBaseType_t priority = 5);
+
+	/**
+	 * Stop the estimation task
+	 */
+	void stop();
+
+	/**
+	 * Consistent snapshot of the latest attitude, never blocks
+	 */
+	Attitude getAttitude() const;
+
+	/**
+	 * Snapshot of the estimator counters
+	 */
+	Stats getStats() const;
+
+	/**
+	 * Restart the filter, yaw becomes 0 at the current heading
+	 */
+	void reset() { _resetRequested = true; }
+
+private:
+	const char* TAG;
+	Sensors::OrientationSensor* _sensor;
+	MahonyFilter _filter;
+	TaskHandle_t _taskHandle;
+	uint32_t _periodMs;
+	uint32_t _lastSequence;
+	volatile bool _resetRequested;
+
+	// Seqlock protected output, odd while being written
+	std::atomic<uint32_t> _publishSequence;
+	Attitude _attitude;
+
+	mutable portMUX_TYPE _statsMux;
+	Stats _stats;
+
+	static void taskFunction(void* parameter);
+	void run();
+	void integrate(const Sensors::OrientationSensor::Sample& sample, float dt);
+	void publish(const Sensors::OrientationSensor::Sample& sample);
+};
+
+} // namespace Logic
@@ -0,0 +1,142 @@
+#include "MahonyFilter.h"
+#include <math.h>
+
+namespace Logic {
+
+static const float DEG_TO_RAD_F = 0.01745329252f;
+static const float RAD_TO_DEG_F = 57.2957795131f;
+
+MahonyFilter::MahonyFilter()
+    : _kp(1.0f), _ki(0.05f)
+{
+    reset();
+}
+
+void MahonyFilter::reset() {
+    _q[0] = 1.0f;
+    _q[1] = _q[2] = _q[3] = 0.0f;
+    for (int i = 0; i < 3; i++) {
+        _integral[i] = 0.0f;
+        _bias[i] = 0.0f;
+    }
+    _stillTime = 0.0f;
+    _initialized = false;
+    _roll = _pitch = _yaw = 0.0f;
+}
+
+float MahonyFilter::getBiasX() const { return _bias[0] * RAD_TO_DEG_F; }
+float MahonyFilter::getBiasY() const { return _bias[1] * RAD_TO_DEG_F; }
+float MahonyFilter::getBiasZ() const { return _bias[2] * RAD_TO_DEG_F; }
+
+void MahonyFilter::initFromGravity(float ax, float ay, float az) {
+    // Start level with the measured tilt so the filter does not need to converge
+    float roll = atan2f(ay, az);
+    float pitch = atan2f(-ax, sqrtf(ay * ay + az * az));
+
+    float cr = cosf(roll * 0.5f), sr = sinf(roll * 0.5f);
+    float cp = cosf(pitch * 0.5f), sp = sinf(pitch * 0.5f);
+    _q[0] = cr * cp;
+    _q[1] = sr * cp;
+    _q[2] = cr * sp;
+    _q[3] = -sr * sp;
+    _initialized = true;
+}
+
+void MahonyFilter::update(float gx, float gy, float gz, float ax, float ay, float az, float dt) {
+    if (dt <= 0.0f) {
+        return;
+    }
+
+    float accelNorm = sqrtf(ax * ax + ay * ay + az * az);
+    if (!_initialized) {
+        if (accelNorm > 0.0f) {
+            initFromGravity(ax, ay, az);
+            computeAngles();
+        }
+        return;
+    }
+
+    gx *= DEG_TO_RAD_F;
+    gy *= DEG_TO_RAD_F;
+    gz *= DEG_TO_RAD_F;
+
+    // Bias estimation: while the sensor is still every axis should read
+    // zero, including yaw which gravity cannot correct
+    float rx = gx - _bias[0], ry = gy - _bias[1], rz = gz - _bias[2];
+    bool still = fabsf(accelNorm - 1.0f) < STILL_ACCEL_TOLERANCE &&
+                 rx * rx + ry * ry + rz * rz < STILL_RATE_RAD * STILL_RATE_RAD;
+    _stillTime = still ? _stillTime + dt : 0.0f;
+    if (_stillTime >= STILL_SETTLE_S) {
+        float k = dt / BIAS_TIME_CONSTANT_S;
+        _bias[0] += (gx - _bias[0]) * k;
+        _bias[1] += (gy - _bias[1]) * k;
+        _bias[2] += (gz - _bias[2]) * k;
+    }
+    gx -= _bias[0];
+    gy -= _bias[1];
+    gz -= _bias[2];
+
+    float q0 = _q[0], q1 = _q[1], q2 = _q[2], q3 = _q[3];
+
+    // Accelerometer correction only when it measures gravity alone
+    if (accelNorm > 0.5f && accelNorm < 1.5f) {
+        float inv = 1.0f / accelNorm;
+        ax *= inv;
+        ay *= inv;
+        az *= inv;
+
+        // Gravity direction predicted by the current attitude
+        float vx = 2.0f * (q1 * q3 - q0 * q2);
+        float vy = 2.0f * (q0 * q1 + q2 * q3);
+        float vz = q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3;
+
+        // Error is the cross product between measured and predicted gravity
+        float ex = ay * vz - az * vy;
+        float ey = az * vx - ax * vz;
+        float ez = ax * vy - ay * vx;
+
+        if (_ki > 0.0f) {
+            _integral[0] += _ki * ex * dt;
+            _integral[1] += _ki * ey * dt;
+            _integral[2] += _ki * ez * dt;
+            gx += _integral[0];
+            gy += _integral[1];
+            gz += _integral[2];
+        }
+
+        gx += _kp * ex;
+        gy += _kp * ey;
+        gz += _kp * ez;
+    }
+
+    // Integrate the quaternion rate
+    float halfDt = 0.5f * dt;
+    _q[0] += (-q1 * gx - q2 * gy - q3 * gz) * halfDt;
+    _q[1] += (q0 * gx + q2 * gz - q3 * gy) * halfDt;
+    _q[2] += (q0 * gy - q1 * gz + q3 * gx) * halfDt;
+    _q[3] += (q0 * gz + q1 * gy - q2 * gx) * halfDt;
+
+    float norm = sqrtf(_q[0] * _q[0] + _q[1] * _q[1] + _q[2] * _q[2] + _q[3] * _q[3]);
+    if (norm > 0.0f) {
+        float inv = 1.0f / norm;
+        for (int i = 0; i < 4; i++) {
+            _q[i] *= inv;
+        }
+    }
+
+    computeAngles();
+}
+
+void MahonyFilter::computeAngles() {
+    float q0 = _q[0], q1 = _q[1], q2 = _q[2], q3 = _q[3];
+
+    float sinPitch = 2.0f * (q0 * q2 - q3 * q1);
+    if (sinPitch > 1.0f) sinPitch = 1.0f;
+    if (sinPitch < -1.0f) sinPitch = -1.0f;
+
+    _roll = atan2f(2.0f * (q0 * q1 + q2 * q3), 1.0f - 2.0f * (q1 * q1 + q2 * q2)) * RAD_TO_DEG_F;
+    _pitch = asinf(sinPitch) * RAD_TO_DEG_F;
+    _yaw = atan2f(2.0f * (q0 * q3 + q1 * q2), 1.0f - 2.0f * (q2 * q2 + q3 * q3)) * RAD_TO_DEG_F;
+}
+
+} // namespace Logic
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace Logic {
+
+/**
+ * Mahony attitude filter with gyro bias estimation
+ *
+ * Pure math, no Arduino or FreeRTOS dependencies, so recorded IMU logs can
+ * be replayed through it on the host (see tools/imu_replay.cpp).
+ *
+ * Input is the raw MPU6050 sensor frame (gyro in degrees per second, accel
+ * in g, +Z up when level). Output angles follow the ZYX convention: roll
+ * about X, pitch about Y, yaw about Z, all in degrees.
+ */
+class MahonyFilter {
+public:
+    MahonyFilter();
+
+    /**
+     * Integrate one sample
+     * @param gx, gy, gz Angular rate in degrees per second
+     * @param ax, ay, az Acceleration in g
+     * @param dt Time since the previous sample in seconds
+     */
+    void update(float gx, float gy, float gz, float ax, float ay, float az, float dt);
+
+    /**
+     * Forget the attitude and bias, the next sample re-initializes from gravity
+     */
+    void reset();
+
+    /**
+     * Proportional and integral feedback gains
+     * @param kp Accelerometer correction strength
+     * @param ki Bias correction strength for roll and pitch
+     */
+    void setGains(float kp, float ki) { _kp = kp; _ki = ki; }
+
+    float getRoll() const { return _roll; }
+    float getPitch() const { return _pitch; }
+    float getYaw() const { return _yaw; }
+
+    /**
+     * @return true while the sensor is still and the bias is being learned
+     */
+    bool isStationary() const { return _stillTime >= STILL_SETTLE_S; }
+
+    /**
+     * Current gyro bias estimate in degrees per second
+     */
+    float getBiasX() const;
+    float getBiasY() const;
+    float getBiasZ() const;
+
+    /**
+     * Quaternion (w, x, y, z)
+     */
+    const float* getQuaternion() const { return _q; }
+
+private:
+    static constexpr float STILL_SETTLE_S = 1.0f;      // Stillness needed before learning bias
+    static constexpr float STILL_RATE_RAD = 0.035f;    // ~2 deg/s around the bias
+    static constexpr float STILL_ACCEL_TOLERANCE = 0.05f; // |a| within 1g +- 5%
+    static constexpr float BIAS_TIME_CONSTANT_S = 2.0f;
+
+    float _q[4];
+    float _integral[3];   // Mahony integral feedback (rad/s)
+    float _bias[3];       // Stationary bias estimate (rad/s)
+    float _kp, _ki;
+    float _stillTime;
+    bool _initialized;
+    float _roll, _pitch, _yaw;
+
+    void initFromGravity(float ax, float ay, float az);
+    void computeAngles();
+};
+
+} // namespace Logic
@@ -0,0 +1,318 @@
+#include "SafetyMonitor.h"
+#include <esp_timer.h>
+#include "Logger.h"
+
+namespace Logic {
+
+SafetyMonitor::SafetyMonitor(Motors::MotorControl* motors,
+                             Sensors::DistanceSensor* distanceSensor,
+                             Sensors::CliffDetector* cliffLeft,
+                             Sensors::CliffDetector* cliffRight)
+	: TAG("SafetyMonitor"),
+	  _motors(motors),
+	  _distanceSensor(distanceSensor),
+	  _cliffLeft(cliffLeft),
+	  _cliffRight(cliffRight),
+	  _taskHandle(nullptr),
+	  _pollIntervalMs(20),
+	  _deadlineUs(20000),
+	  _extenderIntPin(-1),
+	  _stopCallback(nullptr),
+	  _stopCallbackArg(nullptr),
+	  _reversing(false),
+	  _reverseCliffs(0),
+	  _pendingSince(0),
+	  _mux(portMUX_INITIALIZER_UNLOCKED),
+	  _stats{}
+{
+}
+
+SafetyMonitor::~SafetyMonitor() {
+	stop();
+}
+
+bool SafetyMonitor::start(int core, UBaseType_t priority) {
+	if (_taskHandle != nullptr) {
+		return true;
+	}
+
+	if (!_motors) {
+		Utils::Logger::getInstance().error("SafetyMonitor: motors not available");
+		return false;
+	}
+
+	BaseType_t result = xTaskCreatePinnedToCore(
+		taskFunction,
+		"SafetyMonitor",
+		3 * 1024,
+		this,
+		priority,
+		&_taskHandle,
+		core
+	);
+
+	if (result != pdPASS) {
+		_taskHandle = nullptr;
+		Utils::Logger::getInstance().error("SafetyMonitor: failed to create task");
+		return false;
+	}
+
+	// Hook event sources only once the task can receive notifications
+	_motors->setDirectionCallback(onDirectionChange, this);
+	if (_distanceSensor) {
+		_distanceSensor->setSampleCallback(onDistanceSample, this);
+	}
+	if (_cliffLeft && !_cliffLeft->usesExtender()) {
+		_cliffLeft->enableInterrupt(onCliffChange, this);
+	}
+	if (_cliffRight && !_cliffRight->usesExtender()) {
+		_cliffRight->enableInterrupt(onCliffChange, this);
+	}
+	if (_extenderIntPin >= 0) {
+		attachInterruptArg(_extenderIntPin, onExtenderInterrupt, this, FALLING);
+	}
+
+	Utils::Logger::getInstance().info("SafetyMonitor: started on core %d, worst-case stop budget %u us",
+		core, getWorstCaseBudgetUs());
+	return true;
+}
+
+void SafetyMonitor::stop() {
+	if (_motors) {
+		_motors->setDirectionCallback(nullptr);
+	}
+	if (_distanceSensor) {
+		_distanceSensor->setSampleCallback(nullptr);
+	}
+	if (_cliffLeft) {
+		_cliffLeft->disableInterrupt();
+	}
+	if (_cliffRight) {
+		_cliffRight->disableInterrupt();
+	}
+	if (_extenderIntPin >= 0) {
+		detachInterrupt(_extenderIntPin);
+	}
+
+	if (_taskHandle != nullptr) {
+		vTaskDelete(_taskHandle);
+		_taskHandle = nullptr;
+	}
+}
+
+bool SafetyMonitor::reverse(uint32_t durationMs) {
+	// Sensors already over the edge are what we are backing away from
+	_reverseCliffs = CLIFF_ALL & ~cliffsDetected();
+	portENTER_CRITICAL(&_mux);
+	uint32_t stops = _stats.stops;
+	portEXIT_CRITICAL(&_mux);
+
+	_reversing = true;
+	_motors->move(Motors::MotorControl::BACKWARD, durationMs);
+	_reversing = false;
+
+	portENTER_CRITICAL(&_mux);
+	bool stopped = _stats.stops != stops;
+	portEXIT_CRITICAL(&_mux);
+	return !stopped;
+}
+
+bool SafetyMonitor::attachExtenderInterrupt(int pin) {
+	if (pin < 0) {
+		return false;
+	}
+
+	_extenderIntPin = pin;
+	// PCF8575 INT is open drain, active low
+	pinMode(_extenderIntPin, INPUT_PULLUP);
+
+	if (_taskHandle != nullptr) {
+		attachInterruptArg(_extenderIntPin, onExtenderInterrupt, this, FALLING);
+	}
+	return true;
+}
+
+uint32_t SafetyMonitor::getWorstCaseBudgetUs() const {
+	// Interrupt sources only pay one scheduler wake-up plus the stop itself,
+	// polled sources can additionally wait a full poll period.
+	const uint32_t wakeAndStopUs = 2000;
+	return needsCliffPolling() ? _pollIntervalMs * 1000 + wakeAndStopUs : wakeAndStopUs;
+}
+
+SafetyMonitor::Stats SafetyMonitor::getStats() const {
+	portENTER_CRITICAL(&_mux);
+	Stats stats = _stats;
+	portEXIT_CRITICAL(&_mux);
+	stats.distanceUnavailable = isDistanceUnavailable();
+	return stats;
+}
+
+uint32_t SafetyMonitor::bucketUpperBoundUs(int bucket) {
+	if (bucket >= LATENCY_BUCKETS - 1) {
+		return UINT32_MAX;
+	}
+	return 250u << bucket;
+}
+
+void SafetyMonitor::onDistanceSample(const Sensors::DistanceSensor::Sample& sample, void* arg) {
+	SafetyMonitor* self = static_cast<SafetyMonitor*>(arg);
+	// Integer compare only, this runs in the capture interrupt
+	if (sample.filteredMm > 0 && sample.filteredMm < self->_distanceSensor->getThresholdMm()) {
+		self->signal(EVENT_OBSTACLE, sample.timestamp);
+	}
+}
+
+void SafetyMonitor::onCliffChange(Sensors::CliffDetector* detector, bool detected, void* arg) {
+	if (detected) {
+		static_cast<SafetyMonitor*>(arg)->signal(EVENT_CLIFF, esp_timer_get_time());
+	}
+}
+
+void ARDUINO_ISR_ATTR SafetyMonitor::onExtenderInterrupt(void* arg) {
+	static_cast<SafetyMonitor*>(arg)->signal(EVENT_EXTENDER, esp_timer_get_time());
+}
+
+void SafetyMonitor::onDirectionChange(Motors::MotorControl::Direction direction, void* arg) {
+	SafetyMonitor* self = static_cast<SafetyMonitor*>(arg);
+	if (self->isMovingIntoHazard()) {
+		self->signal(EVENT_MOTION, esp_timer_get_time());
+	}
+}
+
+void SafetyMonitor::signal(uint32_t bits, int64_t timestamp) {
+	if (_taskHandle == nullptr) {
+		return;
+	}
+
+	portENTER_CRITICAL_SAFE(&_mux);
+	_stats.events++;
+	if (_pendingSince == 0 || timestamp < _pendingSince) {
+		_pendingSince = timestamp;
+	}
+	portEXIT_CRITICAL_SAFE(&_mux);
+
+	if (xPortInIsrContext()) {
+		BaseType_t woken = pdFALSE;
+		xTaskNotifyFromISR(_taskHandle, bits, eSetBits, &woken);
+		if (woken == pdTRUE) {
+			portYIELD_FROM_ISR();
+		}
+	} else {
+		xTaskNotify(_taskHandle, bits, eSetBits);
+	}
+}
+
+bool SafetyMonitor::needsCliffPolling() const {
+	bool leftPolled = _cliffLeft && !_cliffLeft->hasInterrupt();
+	bool rightPolled = _cliffRight && !_cliffRight->hasInterrupt();
+	return (leftPolled || rightPolled) && _extenderIntPin < 0;
+}
+
+bool SafetyMonitor::isMovingIntoHazard() const {
+	Motors::MotorControl::Direction direction = _motors->getCurrentDirection();
+	// Protect when moving forward or turning, backing up only through reverse()
+	if (direction == Motors::MotorControl::BACKWARD) {
+		return _reversing;
+	}
+	return direction != Motors::MotorControl::STOP;
+}
+
+uint8_t SafetyMonitor::cliffsDetected() const {
+	uint8_t cliffs = 0;
+	if (_cliffLeft && _cliffLeft->isCliffDetected()) {
+		cliffs |= CLIFF_LEFT;
+	}
+	if (_cliffRight && _cliffRight->isCliffDetected()) {
+		cliffs |= CLIFF_RIGHT;
+	}
+	return cliffs;
+}
+
+bool SafetyMonitor::isDistanceUnavailable() const {
+	return _distanceSensor && !_distanceSensor->isRanging();
+}
+
+void SafetyMonitor::recordStop(uint32_t latencyUs) {
+	int bucket = 0;
+	while (bucket < LATENCY_BUCKETS - 1 && latencyUs > bucketUpperBoundUs(bucket)) {
+		bucket++;
+	}
+
+	portENTER_CRITICAL(&_mux);
+	_stats.stops++;
+	_stats.histogram[bucket]++;
+	_stats.lastLatencyUs = latencyUs;
+	if (latencyUs > _stats.maxLatencyUs) {
+		_stats.maxLatencyUs = latencyUs;
+	}
+	if (latencyUs > _deadlineUs) {
+		_stats.deadlineMisses++;
+	}
+	portEXIT_CRITICAL(&_mux);
+}
+
+void SafetyMonitor::taskFunction(void* parameter) {
+	SafetyMonitor* self = static_cast<SafetyMonitor*>(parameter);
+
+	while (true) {
+		// Polled sources and motion need a timeout, a hazard present before
+		// the robot moved raises no interrupt of its own
+		uint32_t bits = 0;
+		bool polling = self->needsCliffPolling() || self->isMovingIntoHazard();
+		TickType_t timeout = polling ? pdMS_TO_TICKS(self->_pollIntervalMs) : portMAX_DELAY;
+		bool timedOut = xTaskNotifyWait(0, UINT32_MAX, &bits, timeout) != pdTRUE;
+
+		portENTER_CRITICAL(&self->_mux);
+		int64_t detectedAt = self->_pendingSince;
+		self->_pendingSince = 0;
+		portEXIT_CRITICAL(&self->_mux);
+
+		if (!self->isMovingIntoHazard()) {
+			continue;
+		}
+
+		// Extender inputs are read here, the poll itself is the detection time
+		bool pollCliffs = (bits & (EVENT_EXTENDER | EVENT_MOTION)) || timedOut || self->needsCliffPolling();
+		if (pollCliffs) {
+			if (detectedAt == 0) {
+				detectedAt = esp_timer_get_time();
+			}
+			if (self->_cliffLeft && !self->_cliffLeft->hasInterrupt()) {
+				self->_cliffLeft->update();
+			}
+			if (self->_cliffRight && !self->_cliffRight->hasInterrupt()) {
+				self->_cliffRight->update();
+			}
+		}
+
+		bool backward = self->_motors->getCurrentDirection() == Motors::MotorControl::BACKWARD;
+		bool cliff = (self->cliffsDetected() & (backward ? self->_reverseCliffs : CLIFF_ALL)) != 0;
+		// The ultrasonic sensor looks ahead, turning in place never runs into what it sees;
+		// without samples from it driving forward is blind and treated as unsafe
+		bool obstacle = self->_motors->getCurrentDirection() == Motors::MotorControl::FORWARD &&
+		                self->_distanceSensor &&
+		                (self->isDistanceUnavailable() || self->_distanceSensor->isObstacleDetected());
+
+		if (!cliff && !obstacle) {
+			continue;
+		}
+
+		if (detectedAt == 0) {
+			detectedAt = esp_timer_get_time();
+		}
+
+		self->_motors->emergencyStop();
+		uint32_t latencyUs = (uint32_t)(esp_timer_get_time() - detectedAt);
+		self->recordStop(latencyUs);
+
+		ESP_LOGI(self->TAG, "%s detected - motors stopped in %u us",
+			cliff ? "Cliff" : "Obstacle", latencyUs);
+
+		StopCallback callback = self->_stopCallback;
+		if (callback) {
+			callback(cliff ? HAZARD_CLIFF : HAZARD_OBSTACLE, self->_stopCallbackArg);
+		}
+	}
+}
+
+} // namespace Logic
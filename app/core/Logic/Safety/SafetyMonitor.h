@@ -0,0 +1,171 @@
+#pragma once
+
+#include <Arduino.h>
+#include "core/Motors/MotorControl.h"
+#include "core/Sensors/DistanceSensor.h"
+#include "core/Sensors/CliffDetector.h"
+
+namespace Logic {
+
+/**
+ * Event driven protection against cliffs and obstacles
+ *
+ * Sensor interrupts and new ultrasonic samples wake a single high priority
+ * task which cuts motor power. Sources that cannot raise interrupts (cliff
+ * pins behind an extender without INT line) are polled at a fixed period,
+ * which bounds the worst-case detection-to-stop latency. A hazard that is
+ * already there raises no edge, so every change of direction wakes the
+ * task to read the current state and it keeps polling while the robot
+ * moves. Stopped and without polled sources it sleeps until notified.
+ */
+class SafetyMonitor {
+public:
+	static const int LATENCY_BUCKETS = 10;
+
+	enum Hazard : uint8_t {
+		HAZARD_CLIFF,
+		HAZARD_OBSTACLE
+	};
+
+	/**
+	 * Called after every emergency stop.
+	 * Runs on the monitor task; hand longer work such as an escape
+	 * maneuver to another task.
+	 */
+	using StopCallback = void (*)(Hazard hazard, void* arg);
+
+	struct Stats {
+		uint32_t events;          // Wake-ups caused by sensor events
+		uint32_t stops;           // Emergency stops issued
+		uint32_t deadlineMisses;  // Stops slower than the configured deadline
+		uint32_t lastLatencyUs;   // Detection to motor stop, last stop
+		uint32_t maxLatencyUs;    // Detection to motor stop, worst case seen
+		uint32_t histogram[LATENCY_BUCKETS];
+		bool distanceUnavailable;  // Sensor produces no samples, forward motion is stopped
+	};
+
+	SafetyMonitor(Motors::MotorControl* motors,
+	              Sensors::DistanceSensor* distanceSensor,
+	              Sensors::CliffDetector* cliffLeft,
+	              Sensors::CliffDetector* cliffRight);
+	~SafetyMonitor();
+
+	/**
+	 * Hook sensor callbacks and start the monitor task
+	 * @param core Core to pin the task to
+	 * @param priority Task priority, should be above every motion task
+	 * @return true if the task was created
+	 */
+	bool start(int core = 0, UBaseType_t priority = 10);
+
+	/**
+	 * Stop the monitor task and detach sensor callbacks
+	 */
+	void stop();
+
+	/**
+	 * Period used for sources without interrupts
+	 * @param ms Poll interval in milliseconds
+	 */
+	void setPollInterval(uint32_t ms) { _pollIntervalMs = ms > 0 ? ms : 1; }
+
+	/**
+	 * Stop latency budget used for deadline miss accounting
+	 * @param us Deadline in microseconds
+	 */
+	void setDeadline(uint32_t us) { _deadlineUs = us; }
+
+	/**
+	 * Be told about every emergency stop
+	 * @param callback Called on the monitor task, nullptr to remove
+	 * @param arg Passed back to the callback
+	 */
+	void setStopCallback(StopCallback callback, void* arg = nullptr) {
+		_stopCallbackArg = arg;
+		_stopCallback = callback;
+	}
+
+	/**
+	 * Back up under cliff protection, blocks for the move
+	 * There are no rear sensors and backing up is otherwise unprotected;
+	 * meanwhile a cliff sensor that was clear when the move started and
+	 * then reports a cliff stops it at once.
+	 * @param durationMs Length of the move
+	 * @return false if a cliff cut the move short
+	 */
+	bool reverse(uint32_t durationMs);
+
+	/**
+	 * Use the PCF8575 INT line to wake the monitor on extender input changes
+	 * @param pin GPIO connected to the extender INT output, -1 to disable
+	 * @return true if the interrupt was attached
+	 */
+	bool attachExtenderInterrupt(int pin);
+
+	/**
+	 * Worst-case detection to stop budget for the current configuration
+	 * @return Microseconds
+	 */
+	uint32_t getWorstCaseBudgetUs() const;
+
+	/**
+	 * Snapshot of the stop latency statistics
+	 */
+	Stats getStats() const;
+
+	/**
+	 * Upper bound of a histogram bucket
+	 * @param bucket Bucket index
+	 * @return Upper bound in microseconds (UINT32_MAX for the last bucket)
+	 */
+	static uint32_t bucketUpperBoundUs(int bucket);
+
+private:
+	enum CliffBits : uint8_t {
+		CLIFF_LEFT = 1 << 0,
+		CLIFF_RIGHT = 1 << 1,
+		CLIFF_ALL = CLIFF_LEFT | CLIFF_RIGHT,
+	};
+
+	enum EventBits : uint32_t {
+		EVENT_CLIFF = 1 << 0,
+		EVENT_OBSTACLE = 1 << 1,
+		EVENT_EXTENDER = 1 << 2,
+		EVENT_MOTION = 1 << 3,
+	};
+
+	const char* TAG;
+	Motors::MotorControl* _motors;
+	Sensors::DistanceSensor* _distanceSensor;
+	Sensors::CliffDetector* _cliffLeft;
+	Sensors::CliffDetector* _cliffRight;
+
+	TaskHandle_t _taskHandle;
+	uint32_t _pollIntervalMs;
+	uint32_t _deadlineUs;
+	int _extenderIntPin;
+	StopCallback _stopCallback;
+	void* _stopCallbackArg;
+	volatile bool _reversing;
+	volatile uint8_t _reverseCliffs;    // Cliff sensors watched while reversing
+
+	// Timestamp of the oldest unhandled event, 0 when none pending
+	int64_t _pendingSince;
+	mutable portMUX_TYPE _mux;
+	Stats _stats;
+
+	static void taskFunction(void* parameter);
+	static void onDistanceSample(const Sensors::DistanceSensor::Sample& sample, void* arg);
+	static void onCliffChange(Sensors::CliffDetector* detector, bool detected, void* arg);
+	static void onExtenderInterrupt(void* arg);
+	static void onDirectionChange(Motors::MotorControl::Direction direction, void* arg);
+
+	void signal(uint32_t bits, int64_t timestamp);
+	bool needsCliffPolling() const;
+	bool isMovingIntoHazard() const;
+	bool isDistanceUnavailable() const;
+	uint8_t cliffsDetected() const;
+	void recordStop(uint32_t latencyUs);
+};
+
+} // namespace Logic
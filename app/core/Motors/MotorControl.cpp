@@ -1,17 +1,54 @@
 #include "MotorControl.h"
 #include "Logger.h"
+#include "SendTask.h"
 
 namespace Motors {
 
+// Commands below this magnitude count as stopped
+static const float EPSILON = 0.01f;
+// Smallest turn command during rotate(), enough to overcome friction
+static const float ROTATE_MIN_COMMAND = 0.3f;
+// rotate() slows down over this last part of the turn
+static const float ROTATE_SLOWDOWN_DEG = 30.0f;
+// Output not written yet, forces the first write
+static const int32_t UNWRITTEN = INT32_MIN;
+
+static float clampUnit(float value) {
+    return value > 1.0f ? 1.0f : (value < -1.0f ? -1.0f : value);
+}
+
+static float wrapDegrees(float degrees) {
+    degrees = fmodf(degrees + 180.0f, 360.0f);
+    if (degrees < 0) {
+        degrees += 360.0f;
+    }
+    return degrees - 180.0f;
+}
+
 MotorControl::MotorControl() : _leftMotorPin1(-1), _leftMotorPin2(-1),
                                _rightMotorPin1(-1), _rightMotorPin2(-1),
-                               _currentDirection(STOP), _initialized(false),
+                               _currentDirection(STOP), _interrupt(false), _initialized(false),
                                _useIoExtender(false), _ioExtender(nullptr),
-                               _display(nullptr), _interrupt(false), _enable(true) {
+                               _display(nullptr), _enable(true),
+                               _directionCallback(nullptr), _directionCallbackArg(nullptr),
+                               _pwm(false), _maxDuty(0), _minDuty(0),
+                               _taskHandle(nullptr), _periodMs(10), _accelPerSecond(0),
+                               _mux(portMUX_INITIALIZER_UNLOCKED),
+                               _outputMutex(xSemaphoreCreateMutex()),
+                               _targetLeft(0), _targetRight(0),
+                               _appliedLeft(0), _appliedRight(0),
+                               _moveDeadline(0),
+                               _writtenLeft(UNWRITTEN), _writtenRight(UNWRITTEN),
+                               _headingTolerance(3.0f), _rotateRemaining(0), _rotateLastYaw(0),
+                               _rotateSpeed(0), _rotateDeadline(0), _rotating(false) {
 }
 
 MotorControl::~MotorControl() {
+    stopControl();
     stop();
+    if (_outputMutex) {
+        vSemaphoreDelete(_outputMutex);
+    }
 }
 
 bool MotorControl::init(int leftMotorPin1, int leftMotorPin2, int rightMotorPin1, int rightMotorPin2) {
@@ -89,82 +126,341 @@ void MotorControl::moveLook(MotorControl::Direction direction) {
     }
 }
 
+bool MotorControl::enablePwm(uint32_t frequency, uint8_t resolutionBits, float minDuty) {
+    if (!_initialized || _useIoExtender) {
+        return false;
+    }
+
+    int pins[] = { _leftMotorPin1, _leftMotorPin2, _rightMotorPin1, _rightMotorPin2 };
+    bool attached = true;
+    for (int pin : pins) {
+        attached = ledcAttach(pin, frequency, resolutionBits) && attached;
+    }
+
+    if (!attached) {
+        // Back to plain outputs
+        for (int pin : pins) {
+            ledcDetach(pin);
+            pinMode(pin, OUTPUT);
+            digitalWrite(pin, LOW);
+        }
+        Utils::Logger::getInstance().error("MotorControl: PWM setup failed, using on/off drive");
+        return false;
+    }
+
+    xSemaphoreTake(_outputMutex, portMAX_DELAY);
+    _maxDuty = (1UL << resolutionBits) - 1;
+    _minDuty = constrain(minDuty, 0.0f, 1.0f);
+    _pwm = true;
+    _writtenLeft = UNWRITTEN;
+    _writtenRight = UNWRITTEN;
+    xSemaphoreGive(_outputMutex);
+
+    applyOutputs();
+    Utils::Logger::getInstance().info("MotorControl: PWM at %u Hz, %u bit", frequency, resolutionBits);
+    return true;
+}
+
+bool MotorControl::startControl(uint32_t periodMs, float accelPerSecond, int core, UBaseType_t priority) {
+    if (_taskHandle != nullptr) {
+        return true;
+    }
+    if (!_initialized) {
+        return false;
+    }
+
+    _periodMs = periodMs > 0 ? periodMs : 1;
+    _accelPerSecond = accelPerSecond;
+
+    BaseType_t result = xTaskCreatePinnedToCore(
+        taskFunction,
+        "motor_control",
+        3 * 1024,
+        this,
+        priority,
+        &_taskHandle,
+        core
+    );
+
+    if (result != pdPASS) {
+        _taskHandle = nullptr;
+        Utils::Logger::getInstance().error("MotorControl: failed to create control task");
+        return false;
+    }
+    return true;
+}
+
+void MotorControl::stopControl() {
+    if (_taskHandle != nullptr) {
+        vTaskDelete(_taskHandle);
+        _taskHandle = nullptr;
+    }
+}
+
 void MotorControl::move(Direction direction, unsigned long duration) {
     if (!_initialized) {
         return;
     }
 
-    if (!_enable) {
+    if (!_enable || direction == STOP) {
         stop();
         return;
     }
 
-    _currentDirection = direction;
+    float left = 0;
+    float right = 0;
+    switch (direction) {
+        case FORWARD:  left = 1.0f;  right = 1.0f;  break;
+        case BACKWARD: left = -1.0f; right = -1.0f; break;
+        case LEFT:     left = -1.0f; right = 1.0f;  break;
+        case RIGHT:    left = 1.0f;  right = -1.0f; break;
+        default: break;
+    }
+
     _interrupt = false;
+    _rotating = false;
+    setTargets(left, right);
 
-    moveLook(direction);
-    switch (direction) {
-        case FORWARD:
-            setMotorPin(_leftMotorPin1, HIGH);
-            setMotorPin(_leftMotorPin2, LOW);
-            setMotorPin(_rightMotorPin1, HIGH);
-            setMotorPin(_rightMotorPin2, LOW);
-            break;
-            
-        case BACKWARD:
-            setMotorPin(_leftMotorPin1, LOW);
-            setMotorPin(_leftMotorPin2, HIGH);
-            setMotorPin(_rightMotorPin1, LOW);
-            setMotorPin(_rightMotorPin2, HIGH);
-            break;
-            
-        case LEFT:
-            setMotorPin(_leftMotorPin1, LOW);
-            setMotorPin(_leftMotorPin2, HIGH);
-            setMotorPin(_rightMotorPin1, HIGH);
-            setMotorPin(_rightMotorPin2, LOW);
-            break;
-            
-        case RIGHT:
-            setMotorPin(_leftMotorPin1, HIGH);
-            setMotorPin(_leftMotorPin2, LOW);
-            setMotorPin(_rightMotorPin1, LOW);
-            setMotorPin(_rightMotorPin2, HIGH);
-            break;
-            
-        case STOP:
-        default:
-            stop();
-            break;
+    if (duration == 0) {
+        return;
     }
 
-    // If duration is specified, stop after the given time
-    if (duration > 0) {
-        for(int i = 0; i <= duration; i+=5) {
-            if (isInterrupt()) {
-                stop();
-                return;
-            }
-            vTaskDelay(pdMS_TO_TICKS(5));
+    // The control task ends the move at the deadline as well, in case this
+    // caller is starved
+    portENTER_CRITICAL(&_mux);
+    _moveDeadline = (millis() + duration) | 1;
+    portEXIT_CRITICAL(&_mux);
+
+    for (unsigned long waited = 0; waited < duration; waited += 5) {
+        if (isInterrupt()) {
+            stop();
+            return;
         }
-        stop();
+        vTaskDelay(pdMS_TO_TICKS(5));
+    }
+    stop();
+}
+
+void MotorControl::setVelocity(float linear, float angular) {
+    linear = clampUnit(linear);
+    angular = clampUnit(angular);
+
+    // Positive angular turns left: the right wheel runs faster
+    float left = linear - angular;
+    float right = linear + angular;
+    float largest = fmaxf(fabsf(left), fabsf(right));
+    if (largest > 1.0f) {
+        left /= largest;
+        right /= largest;
+    }
+
+    _rotating = false;
+    setTargets(left, right);
+}
+
+void MotorControl::drive(float left, float right) {
+    _rotating = false;
+    setTargets(clampUnit(left), clampUnit(right));
+}
+
+bool MotorControl::rotate(float degrees, float speed) {
+    if (!_initialized || !_enable || !_headingSource || _taskHandle == nullptr) {
+        return false;
     }
+
+    _rotateRemaining = degrees;
+    _rotateLastYaw = _headingSource();
+    _rotateSpeed = constrain(speed, ROTATE_MIN_COMMAND, 1.0f);
+    _rotateDeadline = millis() + 1000 + (unsigned long)(fabsf(degrees) * 30);
+    _interrupt = false;
+    _rotating = true;
+    return true;
+}
+
+void MotorControl::getWheelSpeeds(float& left, float& right) const {
+    portENTER_CRITICAL(&_mux);
+    left = _appliedLeft;
+    right = _appliedRight;
+    portEXIT_CRITICAL(&_mux);
 }
 
 void MotorControl::stop() {
     if (!_initialized) {
         return;
     }
-    
-    moveLook(STOP);
-    setMotorPin(_leftMotorPin1, LOW);
-    setMotorPin(_leftMotorPin2, LOW);
-    setMotorPin(_rightMotorPin1, LOW);
-    setMotorPin(_rightMotorPin2, LOW);
-    
+
+    _rotating = false;
+    setTargets(0, 0);
+}
+
+void MotorControl::emergencyStop() {
+    if (!_initialized) {
+        return;
+    }
+
+    _interrupt = true;
+    _rotating = false;
+
+    // No ramp: zero the state the control task ramps from, then the pins
+    xSemaphoreTake(_outputMutex, portMAX_DELAY);
+    portENTER_CRITICAL(&_mux);
+    _targetLeft = _targetRight = 0;
+    _appliedLeft = _appliedRight = 0;
+    _moveDeadline = 0;
+    portEXIT_CRITICAL(&_mux);
+    writeWheel(_leftMotorPin1, _leftMotorPin2, 0, _writtenLeft);
+    writeWheel(_rightMotorPin1, _rightMotorPin2, 0, _writtenRight);
+    xSemaphoreGive(_outputMutex);
+
     _currentDirection = STOP;
 }
 
+void MotorControl::setTargets(float left, float right) {
+    if (!_enable) {
+        left = right = 0;
+    }
+
+    portENTER_CRITICAL(&_mux);
+    _targetLeft = left;
+    _targetRight = right;
+    _moveDeadline = 0;
+    bool immediate = _taskHandle == nullptr;
+    if (immediate) {
+        _appliedLeft = left;
+        _appliedRight = right;
+    }
+    portEXIT_CRITICAL(&_mux);
+
+    if (immediate) {
+        applyOutputs();
+    }
+}
+
+void MotorControl::controlStep(float dt) {
+    if (_rotating) {
+        updateRotation();
+    }
+
+    portENTER_CRITICAL(&_mux);
+    if (_moveDeadline != 0 && (long)(millis() - _moveDeadline) >= 0) {
+        _moveDeadline = 0;
+        _targetLeft = _targetRight = 0;
+    }
+
+    // Ramp toward the targets, limiting current spikes and wheel slip
+    float maxStep = _accelPerSecond > 0 ? _accelPerSecond * dt : 2.0f;
+    _appliedLeft += constrain(_targetLeft - _appliedLeft, -maxStep, maxStep);
+    _appliedRight += constrain(_targetRight - _appliedRight, -maxStep, maxStep);
+    portEXIT_CRITICAL(&_mux);
+
+    applyOutputs();
+}
+
+void MotorControl::updateRotation() {
+    float yaw = _headingSource();
+    _rotateRemaining -= wrapDegrees(yaw - _rotateLastYaw);
+    _rotateLastYaw = yaw;
+
+    float remaining = _rotateRemaining;
+    if (fabsf(remaining) < _headingTolerance || (long)(millis() - _rotateDeadline) >= 0 || _interrupt) {
+        _rotating = false;
+        portENTER_CRITICAL(&_mux);
+        _targetLeft = _targetRight = 0;
+        portEXIT_CRITICAL(&_mux);
+        return;
+    }
+
+    // Slow down near the target, an overshoot reverses the turn
+    float command = _rotateSpeed * fminf(1.0f, fabsf(remaining) / ROTATE_SLOWDOWN_DEG);
+    command = fmaxf(command, ROTATE_MIN_COMMAND);
+    float turn = remaining > 0 ? command : -command;
+
+    portENTER_CRITICAL(&_mux);
+    _targetLeft = -turn;
+    _targetRight = turn;
+    portEXIT_CRITICAL(&_mux);
+}
+
+void MotorControl::applyOutputs() {
+    // Read under the output lock, so an emergency stop in between wins
+    xSemaphoreTake(_outputMutex, portMAX_DELAY);
+    portENTER_CRITICAL(&_mux);
+    float left = _appliedLeft;
+    float right = _appliedRight;
+    portEXIT_CRITICAL(&_mux);
+    writeWheel(_leftMotorPin1, _leftMotorPin2, left, _writtenLeft);
+    writeWheel(_rightMotorPin1, _rightMotorPin2, right, _writtenRight);
+    xSemaphoreGive(_outputMutex);
+
+    Direction direction = directionOf(left, right);
+    if (direction == _currentDirection) {
+        return;
+    }
+    moveLook(direction);
+    _currentDirection = direction;
+
+    DirectionCallback callback = _directionCallback;
+    if (callback) {
+        callback(direction, _directionCallbackArg);
+    }
+}
+
+void MotorControl::writeWheel(int pin1, int pin2, float command, int32_t& written) {
+    if (_pwm) {
+        int32_t duty = 0;
+        if (fabsf(command) >= EPSILON) {
+            duty = (int32_t)((_minDuty + (1.0f - _minDuty) * fabsf(command)) * _maxDuty);
+        }
+        int32_t output = command < 0 ? -duty : duty;
+        if (output == written) {
+            return;
+        }
+        ledcWrite(pin1, output > 0 ? duty : 0);
+        ledcWrite(pin2, output < 0 ? duty : 0);
+        written = output;
+        return;
+    }
+
+    // On/off drivers, extender writes go over I2C so only write changes
+    int32_t sign = command >= DRIVE_THRESHOLD ? 1 : (command <= -DRIVE_THRESHOLD ? -1 : 0);
+    if (sign == written) {
+        return;
+    }
+    setMotorPin(pin1, sign > 0 ? HIGH : LOW);
+    setMotorPin(pin2, sign < 0 ? HIGH : LOW);
+    written = sign;
+}
+
+MotorControl::Direction MotorControl::directionOf(float left, float right) {
+    int leftSign = left >= EPSILON ? 1 : (left <= -EPSILON ? -1 : 0);
+    int rightSign = right >= EPSILON ? 1 : (right <= -EPSILON ? -1 : 0);
+
+    // Closest discrete direction, the safety monitor protects all but BACKWARD
+    if (leftSign > 0 && rightSign > 0) {
+        return FORWARD;
+    }
+    if (leftSign < 0 && rightSign < 0) {
+        return BACKWARD;
+    }
+    if (leftSign < rightSign) {
+        return LEFT;
+    }
+    if (leftSign > rightSign) {
+        return RIGHT;
+    }
+    return STOP;
+}
+
+void MotorControl::taskFunction(void* parameter) {
+    MotorControl* self = static_cast<MotorControl*>(parameter);
+    TickType_t lastWakeTime = xTaskGetTickCount();
+
+    while (true) {
+        SendTask::delayUntil(&lastWakeTime, pdMS_TO_TICKS(self->_periodMs));
+        self->controlStep(self->_periodMs / 1000.0f);
+    }
+}
+
 MotorControl::Direction MotorControl::getCurrentDirection() const {
     return _currentDirection;
 }
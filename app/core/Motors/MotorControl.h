@@ -1,6 +1,9 @@
 #pragma once
 
 #include <Arduino.h>
+#include <functional>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "display/Display.h"
 #include "IOExtern.h"
 
@@ -8,6 +11,12 @@ namespace Motors {
 
 /**
  * Motor control class for robot movement
+ *
+ * Callers set wheel targets; a control task ramps the applied wheel
+ * commands toward them under an acceleration limit and writes the outputs.
+ * On native pins the speed is LEDC PWM, behind the I/O extender the wheels
+ * can only be switched on and off. Without the control task running,
+ * targets are applied immediately.
  */
 class MotorControl {
 public:
@@ -19,6 +28,14 @@ public:
         STOP
     };
 
+    static constexpr float DRIVE_THRESHOLD = 0.2f;
+
+    /**
+     * Called when the applied direction changes, from the task writing
+     * the outputs; keep it short
+     */
+    using DirectionCallback = void (*)(Direction direction, void* arg);
+
     MotorControl();
     ~MotorControl();
 
@@ -46,43 +63,159 @@ public:
                          int rightMotorPin1 = 2, int rightMotorPin2 = 3);
 
     /**
-     * Move in a specified direction
+     * Enable PWM speed control on the native pins, after init()
+     * @param frequency PWM frequency in Hz
+     * @param resolutionBits Duty resolution
+     * @param minDuty Duty fraction where the motors start turning, any
+     *                non-zero command maps above it
+     * @return true if all four pins were attached
+     */
+    bool enablePwm(uint32_t frequency = 20000, uint8_t resolutionBits = 10, float minDuty = 0.3f);
+    bool hasPwm() const { return _pwm; }
+
+    /**
+     * Start the control task
+     * @param periodMs Control period
+     * @param accelPerSecond Largest change of a wheel command per second, 0 = unlimited
+     * @param core Core to pin the task to
+     * @param priority Task priority
+     * @return true if the task was created
+     */
+    bool startControl(uint32_t periodMs = 10, float accelPerSecond = 4.0f, int core = 1, UBaseType_t priority = 6);
+    void stopControl();
+
+    /**
+     * Move in a specified direction at full speed
+     * The control task drives the motors; with a duration the caller
+     * waits until it has passed or the move is interrupted.
      * @param direction Direction to move
      * @param duration Duration of movement in milliseconds (0 = continuous)
      */
     void move(Direction direction, unsigned long duration = 0);
 
+    /**
+     * Drive with a body velocity, returns immediately
+     * @param linear Forward speed, -1 (full reverse) to 1 (full forward)
+     * @param angular Turn rate, positive turns left (counter clockwise, like yaw)
+     */
+    void setVelocity(float linear, float angular);
+
+    /**
+     * Drive each wheel on its own, returns immediately
+     * Without PWM a wheel runs in the sign of its command once the
+     * magnitude passes DRIVE_THRESHOLD and stops below it.
+     * @param left Left wheel command, -1 (full reverse) to 1 (full forward)
+     * @param right Right wheel command, -1 to 1
+     */
+    void drive(float left, float right);
+
+    /**
+     * Heading used by rotate(), usually the gyro yaw
+     * @param yaw Returns the heading in degrees, positive counter clockwise
+     * @param toleranceDeg Rotation is done within this angle
+     */
+    void setHeadingSource(std::function<float()> yaw, float toleranceDeg = 3.0f) {
+        _headingSource = yaw;
+        _headingTolerance = toleranceDeg;
+    }
+
+    /**
+     * Turn in place by an angle, closed loop on the heading source
+     * Needs the control task; returns immediately, poll isRotating()
+     * @param degrees Positive turns left
+     * @param speed Largest turn command, 0 to 1
+     * @return false without heading source or control task
+     */
+    bool rotate(float degrees, float speed = 0.6f);
+    bool isRotating() const { return _rotating; }
+
+    /**
+     * Wheel commands currently applied, after ramping
+     */
+    void getWheelSpeeds(float& left, float& right) const;
+
     void disable();
     void enable();
 
     /**
-     * Stop all motors
+     * Stop all motors, ramped down by the control task
      */
     void stop();
 
+    /**
+     * Cut motor power immediately
+     * Skips the face animation and aborts any blocking move() in progress.
+     * Used by the safety monitor where stop latency matters.
+     */
+    void emergencyStop();
+
     /**
      * Get the current direction of movement
      * @return The current direction
      */
     Direction getCurrentDirection() const;
 
+    /**
+     * Be told when motion starts, stops or changes direction
+     * @param callback nullptr to remove
+     * @param arg Passed back to the callback
+     */
+    void setDirectionCallback(DirectionCallback callback, void* arg = nullptr) {
+        _directionCallbackArg = arg;
+        _directionCallback = callback;
+    }
+
     void setDisplay(Display::Display *display);
     void interuptMotor();
 
 private:
     int _leftMotorPin1, _leftMotorPin2;
     int _rightMotorPin1, _rightMotorPin2;
-    Direction _currentDirection;
-    bool _interrupt;
+    volatile Direction _currentDirection;
+    volatile bool _interrupt;
     bool _initialized;
     bool _useIoExtender;
     Utils::IOExtern* _ioExtender;
     Display::Display *_display;
     bool _enable;
+    DirectionCallback _directionCallback;
+    void* _directionCallbackArg;
+
+    // PWM
+    bool _pwm;
+    uint32_t _maxDuty;
+    float _minDuty;
+
+    // Control task
+    TaskHandle_t _taskHandle;
+    uint32_t _periodMs;
+    float _accelPerSecond;
+    mutable portMUX_TYPE _mux;
+    SemaphoreHandle_t _outputMutex;     // Serializes pin writes with emergencyStop()
+    float _targetLeft, _targetRight;
+    float _appliedLeft, _appliedRight;
+    unsigned long _moveDeadline;        // millis() a timed move ends, 0 = none
+    int32_t _writtenLeft, _writtenRight; // Last output, skips redundant writes
+
+    // Closed loop rotation
+    std::function<float()> _headingSource;
+    float _headingTolerance;
+    float _rotateRemaining;             // Degrees still to turn, positive left
+    float _rotateLastYaw;
+    float _rotateSpeed;
+    unsigned long _rotateDeadline;
+    volatile bool _rotating;
     
     void moveLook(Direction direction);
     bool isInterrupt();
     void setMotorPin(int pin, int value);  // Helper for unified pin control
+    void setTargets(float left, float right);
+    void applyOutputs();
+    void writeWheel(int pin1, int pin2, float command, int32_t& written);
+    void updateRotation();
+    void controlStep(float dt);
+    static Direction directionOf(float left, float right);
+    static void taskFunction(void* parameter);
 };
 
 } // namespace Motors
@@ -0,0 +1,139 @@
+#include "Teleop.h"
+#include <esp_timer.h>
+
+namespace Motors {
+
+// Stick travel treated as centered
+static const float DEADZONE = 0.05f;
+
+Teleop::Teleop(MotorControl* motors, uint32_t deadmanMs)
+    : TAG("Teleop"),
+      _motors(motors),
+      _deadmanUs(deadmanMs * 1000),
+      _mux(portMUX_INITIALIZER_UNLOCKED),
+      _pending{},
+      _hasPending(false),
+      _hasSequence(false),
+      _lastCommandUs(0),
+      _sessions(0),
+      _stats{}
+{
+}
+
+bool Teleop::submit(const uint8_t* data, size_t length) {
+    if (length < COMMAND_SIZE || data[0] != COMMAND_MAGIC || data[1] != COMMAND_VERSION) {
+        portENTER_CRITICAL(&_mux);
+        _stats.invalid++;
+        portEXIT_CRITICAL(&_mux);
+        return false;
+    }
+
+    uint16_t sequence = data[2] | (data[3] << 8);
+    int16_t x = (int16_t)(data[4] | (data[5] << 8));
+    int16_t y = (int16_t)(data[6] | (data[7] << 8));
+    return submit(sequence, x, y);
+}
+
+bool Teleop::submit(uint16_t sequence, int16_t x, int16_t y) {
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&_mux);
+    // Sequences wrap, newer means ahead by less than half the range
+    uint16_t newest = _hasPending ? _pending.sequence : _stats.lastSequence;
+    if (_hasSequence && (int16_t)(sequence - newest) <= 0) {
+        _stats.stale++;
+        portEXIT_CRITICAL(&_mux);
+        return false;
+    }
+
+    if (_hasPending) {
+        _stats.coalesced++;
+    }
+    _pending.sequence = sequence;
+    _pending.x = x;
+    _pending.y = y;
+    _pending.receivedUs = now;
+    _hasPending = true;
+    _hasSequence = true;
+    _lastCommandUs = now;
+    _stats.received++;
+    portEXIT_CRITICAL(&_mux);
+    return true;
+}
+
+void Teleop::resetSequence() {
+    portENTER_CRITICAL(&_mux);
+    _hasSequence = false;
+    portEXIT_CRITICAL(&_mux);
+}
+
+void Teleop::tick() {
+    portENTER_CRITICAL(&_mux);
+    bool hasCommand = _hasPending;
+    Command command = _pending;
+    _hasPending = false;
+    int64_t lastCommandUs = _lastCommandUs;
+    bool active = _stats.active;
+    portEXIT_CRITICAL(&_mux);
+
+    int64_t now = esp_timer_get_time();
+
+    if (!hasCommand) {
+        if (active && now - lastCommandUs > _deadmanUs) {
+            _motors->stop();
+            portENTER_CRITICAL(&_mux);
+            _stats.active = false;
+            _stats.deadmanStops++;
+            portEXIT_CRITICAL(&_mux);
+            ESP_LOGW(TAG, "No command for %u ms, stopped", _deadmanUs / 1000);
+        }
+        return;
+    }
+
+    float left, right;
+    mix(command.x / (float)AXIS_MAX, command.y / (float)AXIS_MAX, left, right);
+    _motors->drive(left, right);
+
+    uint32_t latencyUs = (uint32_t)(esp_timer_get_time() - command.receivedUs);
+    portENTER_CRITICAL(&_mux);
+    _stats.applied++;
+    _stats.active = left != 0.0f || right != 0.0f;
+    _stats.lastSequence = command.sequence;
+    _stats.lastLatencyUs = latencyUs;
+    _stats.totalLatencyUs += latencyUs;
+    if (latencyUs > _stats.maxLatencyUs) {
+        _stats.maxLatencyUs = latencyUs;
+    }
+    portEXIT_CRITICAL(&_mux);
+}
+
+Teleop::Stats Teleop::getStats() const {
+    portENTER_CRITICAL(&_mux);
+    Stats stats = _stats;
+    portEXIT_CRITICAL(&_mux);
+    return stats;
+}
+
+void Teleop::mix(float x, float y, float& left, float& right) {
+    x = constrain(x, -1.0f, 1.0f);
+    y = constrain(y, -1.0f, 1.0f);
+    if (fabsf(x) < DEADZONE) {
+        x = 0.0f;
+    }
+    if (fabsf(y) < DEADZONE) {
+        y = 0.0f;
+    }
+
+    // Turning right speeds up the left wheel
+    left = y + x;
+    right = y - x;
+
+    // Scale both down together so a full diagonal keeps the turn ratio
+    float largest = fmaxf(fabsf(left), fabsf(right));
+    if (largest > 1.0f) {
+        left /= largest;
+        right /= largest;
+    }
+}
+
+} // namespace Motors
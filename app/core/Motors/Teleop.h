@@ -0,0 +1,115 @@
+#pragma once
+
+#include <Arduino.h>
+#include "MotorControl.h"
+
+namespace Motors {
+
+/**
+ * Remote driving with newest-command-wins coalescing
+ *
+ * Commands arrive from the network at any rate and only overwrite a single
+ * pending slot. A periodic tick takes whatever is pending, mixes the stick
+ * vector into per-wheel commands and applies it, so a burst of commands
+ * costs one motor update per period. Without a fresh command for the
+ * dead-man timeout the wheels stop.
+ *
+ * Binary command message, one WebSocket binary frame on /teleop, little endian:
+ *   uint8  magic 'C'
+ *   uint8  version
+ *   uint16 sequence    Older or repeated sequences are ignored
+ *   int16  x           -1000 (left) to 1000 (right)
+ *   int16  y           -1000 (backward) to 1000 (forward)
+ */
+class Teleop {
+public:
+    static const uint8_t COMMAND_MAGIC = 'C';
+    static const uint8_t COMMAND_VERSION = 1;
+    static const size_t COMMAND_SIZE = 8;
+    static const int16_t AXIS_MAX = 1000;
+
+    struct Stats {
+        uint32_t received;      // Commands accepted
+        uint32_t applied;       // Commands that reached the motors
+        uint32_t coalesced;     // Commands overwritten before a tick
+        uint32_t stale;         // Out-of-order or repeated sequences
+        uint32_t invalid;       // Malformed messages
+        uint32_t deadmanStops;
+        uint16_t lastSequence;  // Last applied sequence
+        uint32_t lastLatencyUs; // Receive to motor update, last command
+        uint32_t maxLatencyUs;
+        uint64_t totalLatencyUs;
+        bool active;            // Wheels currently driven by teleop
+    };
+
+    /**
+     * @param motors Motor driver
+     * @param deadmanMs Stop after this long without a command
+     */
+    Teleop(MotorControl* motors, uint32_t deadmanMs = 300);
+
+    /**
+     * Decode and queue a binary command, safe from any task
+     * @return true if the message was a valid, newer command
+     */
+    bool submit(const uint8_t* data, size_t length);
+
+    /**
+     * Queue a command, safe from any task
+     * @param x Turn, -AXIS_MAX to AXIS_MAX
+     * @param y Throttle, -AXIS_MAX to AXIS_MAX
+     * @return false if the sequence is not newer than the last one
+     */
+    bool submit(uint16_t sequence, int16_t x, int16_t y);
+
+    /**
+     * Accept any sequence again, for a new client session
+     */
+    void resetSequence();
+
+    /**
+     * Number of logged in clients; while any is connected the robot is
+     * driven by hand and nothing else should move it
+     */
+    void setSessions(uint8_t count) { _sessions = count; }
+    bool hasSession() const { return _sessions > 0; }
+
+    /**
+     * Apply the newest pending command or enforce the dead-man timeout,
+     * called once per control period by the scheduler
+     */
+    void tick();
+
+    Stats getStats() const;
+
+    /**
+     * Differential drive mixer
+     * @param x Turn, -1 (left) to 1 (right)
+     * @param y Throttle, -1 (backward) to 1 (forward)
+     * @param left Left wheel command, -1 to 1
+     * @param right Right wheel command, -1 to 1
+     */
+    static void mix(float x, float y, float& left, float& right);
+
+private:
+    struct Command {
+        uint16_t sequence;
+        int16_t x;
+        int16_t y;
+        int64_t receivedUs;
+    };
+
+    const char* TAG;
+    MotorControl* _motors;
+    uint32_t _deadmanUs;
+
+    mutable portMUX_TYPE _mux;
+    Command _pending;
+    bool _hasPending;
+    bool _hasSequence;
+    int64_t _lastCommandUs;
+    volatile uint8_t _sessions;
+    Stats _stats;
+};
+
+} // namespace Motors
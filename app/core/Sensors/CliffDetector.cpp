@@ -7,11 +7,14 @@ CliffDetector::CliffDetector() : _pin(-1),
                                  _cliffDetected(false), 
                                  _initialized(false),
                                  _useIoExtender(false),
-                                 _ioExtender(nullptr) {
+                                 _ioExtender(nullptr),
+                                 _interruptEnabled(false),
+                                 _callback(nullptr),
+                                 _callbackArg(nullptr) {
 }
 
 CliffDetector::~CliffDetector() {
-    // Clean up resources if needed
+    disableInterrupt();
 }
 
 bool CliffDetector::init(int pin) {
@@ -63,6 +66,43 @@ bool CliffDetector::calibrate() {
     return true;
 }
 
+bool CliffDetector::enableInterrupt(CliffCallback callback, void* arg) {
+    if (!_initialized || _useIoExtender) {
+        return false;
+    }
+
+    _callback = callback;
+    _callbackArg = arg;
+    _cliffDetected = digitalRead(_pin);
+    attachInterruptArg(_pin, &CliffDetector::pinIsr, this, CHANGE);
+    _interruptEnabled = true;
+
+    Utils::Logger::getInstance().info("CliffDetector: Interrupt enabled on GPIO pin %d", _pin);
+    return true;
+}
+
+void CliffDetector::disableInterrupt() {
+    if (!_interruptEnabled) {
+        return;
+    }
+
+    detachInterrupt(_pin);
+    _interruptEnabled = false;
+    _callback = nullptr;
+    _callbackArg = nullptr;
+}
+
+void ARDUINO_ISR_ATTR CliffDetector::pinIsr(void* arg) {
+    CliffDetector* self = static_cast<CliffDetector*>(arg);
+    // 1 means cliff detected
+    bool detected = digitalRead(self->_pin);
+    self->_cliffDetected = detected;
+
+    if (self->_callback) {
+        self->_callback(self, detected, self->_callbackArg);
+    }
+}
+
 int CliffDetector::readPin() {
     if (!_initialized) {
         return LOW;
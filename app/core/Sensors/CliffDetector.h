@@ -10,6 +10,12 @@ namespace Sensors {
  */
 class CliffDetector {
 public:
+    /**
+     * Called when the cliff state changes.
+     * Runs in interrupt context; keep it short and ISR-safe.
+     */
+    using CliffCallback = void (*)(CliffDetector* detector, bool detected, void* arg);
+
     CliffDetector();
     ~CliffDetector();
 
@@ -45,13 +51,42 @@ public:
      */
     bool calibrate();
 
+    /**
+     * Report cliff changes through a GPIO edge interrupt
+     * Only available for direct GPIO pins, extender pins must be polled
+     * @param callback Function to call on every state change
+     * @param arg User argument passed to the callback
+     * @return true if the interrupt was attached
+     */
+    bool enableInterrupt(CliffCallback callback, void* arg = nullptr);
+
+    /**
+     * Detach the edge interrupt
+     */
+    void disableInterrupt();
+
+    /**
+     * @return true if state changes are reported by interrupt
+     */
+    bool hasInterrupt() const { return _interruptEnabled; }
+
+    /**
+     * @return true if the detector reads through the I/O extender
+     */
+    bool usesExtender() const { return _useIoExtender; }
+
 private:
     int _pin;
-    bool _cliffDetected;
+    volatile bool _cliffDetected;
     int _threshold;
     bool _initialized;
     bool _useIoExtender;
     Utils::IOExtern* _ioExtender;
+    bool _interruptEnabled;
+    CliffCallback _callback;
+    void* _callbackArg;
+
+    static void pinIsr(void* arg);
     
     // Helper method to read from either GPIO or I/O extender
     int readPin();
@@ -2,100 +2,385 @@
 
 namespace Sensors {
 
-DistanceSensor::DistanceSensor() : _triggerPin(-1), _echoPin(-1),
-                                 _maxDistance(400), _threshold(20.0),
-                                 _timeout(0), _lastValue(0.), _inprogress(false),
-                                 _initialized(false) {
+// Consecutive filtered samples below threshold before an obstacle is reported
+static const uint8_t OBSTACLE_CONFIRM_SAMPLES = 2;
+// Raw samples further than this from the running median are flagged as outliers
+static const int32_t OUTLIER_GATE_MM = 300;
+// Consecutive outliers after which the scene is taken to have really changed
+static const uint8_t OUTLIER_MAX_RUN = 2;
+
+DistanceSensor::DistanceSensor() : TAG("DistanceSensor"),
+                                 _triggerPin(-1), _echoPin(-1),
+                                 _threshold(20.0), _thresholdMm(200),
+                                 _maxDistance(400), _timeout(0),
+                                 _initialized(false),
+                                 _continuous(false), _singleShot(false), _measuring(false),
+                                 _intervalMs(60),
+                                 _triggerTimer(nullptr),
+                                 _capTimer(nullptr), _capChannel(nullptr),
+                                 _capResolutionHz(0), _echoStartTicks(0),
+                                 _echoRising(false), _triggerAt(0), _awaitingEcho(false),
+                                 _window{}, _windowPos(0), _windowCount(0),
+                                 _lastMedian(-1), _outlierRun(0), _nearCount(0),
+                                 _outliers(0), _timeouts(0),
+                                 _sequence(0),
+                                 _writeMux(portMUX_INITIALIZER_UNLOCKED),
+                                 _sampleCallback(nullptr), _sampleCallbackArg(nullptr) {
+    for (int i = 0; i < RING_SIZE; i++) {
+        _ring[i].lock.store(0);
+        _ring[i].sample = Sample{-1, -1, 0, 0, false};
+    }
 }
 
 DistanceSensor::~DistanceSensor() {
-    // Release resources if needed
-    if (_initialized) {
-        // Nothing to clean up specifically for HC-SR04
-    }
+    stopContinuous();
 }
 
 bool DistanceSensor::init(int triggerPin, int echoPin) {
     _triggerPin = triggerPin;
     _echoPin = echoPin;
-    
+
     // Calculate the timeout based on the maximum distance
     // Sound speed varies with temperature: v = 331.3 + (0.606 * temperature)
     float temperatureCelsius = 20.0; // Default room temperature
     float soundSpeed = 331.3 + (0.606 * temperatureCelsius); // m/s
     float soundSpeedCmPerUs = soundSpeed / 10000.0; // Convert to cm/μs
-    
+
     // For round trip (echo), we need to wait for double the time
     // Plus a small buffer for sensor response time
-    _timeout = (unsigned long)((_maxDistance * 2.0) / soundSpeedCmPerUs) + 1000; // microseconds
-    
-    // Configure pins
+    _timeout = (uint32_t)((_maxDistance * 2.0) / soundSpeedCmPerUs) + 1000; // microseconds
+
+    // Configure trigger pin, the echo pin is owned by the capture unit
     pinMode(_triggerPin, OUTPUT);
-    pinMode(_echoPin, INPUT);
-    
-    // Initialize TRIG pin to LOW
     digitalWrite(_triggerPin, LOW);
     delay(50); // Allow sensor to stabilize
-    
+
     _initialized = true;
     return true;
 }
 
 void DistanceSensor::setThresHold(float threshold) {
 	_threshold = threshold;
+	_thresholdMm = (int32_t)(threshold * 10.0f);
 }
 
-float DistanceSensor::measureDistance() {
+bool DistanceSensor::startContinuous(uint32_t intervalMs) {
     if (!_initialized) {
-        return -1.0;
+        return false;
+    }
+
+    if (_continuous) {
+        return true;
+    }
+
+    _intervalMs = intervalMs < 60 ? 60 : intervalMs;
+
+    // Echo pulse width is measured by the MCPWM capture unit in hardware
+    mcpwm_capture_timer_config_t timerConfig = {};
+    timerConfig.group_id = 0;
+    timerConfig.clk_src = MCPWM_CAPTURE_CLK_SRC_DEFAULT;
+    if (mcpwm_new_capture_timer(&timerConfig, &_capTimer) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create capture timer");
+        _capTimer = nullptr;
+        return false;
+    }
+
+    mcpwm_capture_channel_config_t channelConfig = {};
+    channelConfig.gpio_num = _echoPin;
+    channelConfig.prescale = 1;
+    channelConfig.flags.pos_edge = true;
+    channelConfig.flags.neg_edge = true;
+    if (mcpwm_new_capture_channel(_capTimer, &channelConfig, &_capChannel) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create capture channel on GPIO %d", _echoPin);
+        _capChannel = nullptr;
+        stopContinuous();
+        return false;
+    }
+
+    mcpwm_capture_event_callbacks_t callbacks = {};
+    callbacks.on_cap = &DistanceSensor::echoCaptureCallback;
+    mcpwm_capture_channel_register_event_callbacks(_capChannel, &callbacks, this);
+    mcpwm_capture_timer_get_resolution(_capTimer, &_capResolutionHz);
+
+    if (mcpwm_capture_channel_enable(_capChannel) != ESP_OK ||
+        mcpwm_capture_timer_enable(_capTimer) != ESP_OK ||
+        mcpwm_capture_timer_start(_capTimer) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start capture unit");
+        stopContinuous();
+        return false;
+    }
+
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.callback = &DistanceSensor::triggerTimerCallback;
+    timerArgs.arg = this;
+    timerArgs.dispatch_method = ESP_TIMER_TASK;
+    timerArgs.name = "ultrasonic";
+
+    if (esp_timer_create(&timerArgs, &_triggerTimer) != ESP_OK ||
+        esp_timer_start_periodic(_triggerTimer, (uint64_t)_intervalMs * 1000ULL) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start trigger timer");
+        stopContinuous();
+        return false;
+    }
+
+    _continuous = true;
+    ESP_LOGI(TAG, "Background ranging every %u ms (capture %u Hz)", _intervalMs, _capResolutionHz);
+    return true;
+}
+
+bool DistanceSensor::startSingleShot(uint32_t intervalMs) {
+    if (!_initialized) {
+        return false;
+    }
+
+    _intervalMs = intervalMs < 60 ? 60 : intervalMs;
+    pinMode(_echoPin, INPUT);
+    _singleShot = true;
+    ESP_LOGW(TAG, "Single-shot ranging, at most every %u ms", _intervalMs);
+    return true;
+}
+
+void DistanceSensor::stopContinuous() {
+    _continuous = false;
+
+    if (_triggerTimer) {
+        esp_timer_stop(_triggerTimer);
+        esp_timer_delete(_triggerTimer);
+        _triggerTimer = nullptr;
+    }
+
+    if (_capTimer) {
+        mcpwm_capture_timer_stop(_capTimer);
+        mcpwm_capture_timer_disable(_capTimer);
+    }
+
+    if (_capChannel) {
+        mcpwm_capture_channel_disable(_capChannel);
+        mcpwm_del_capture_channel(_capChannel);
+        _capChannel = nullptr;
+    }
+
+    if (_capTimer) {
+        mcpwm_del_capture_timer(_capTimer);
+        _capTimer = nullptr;
+    }
+
+    _awaitingEcho = false;
+    _echoRising = false;
+}
+
+void DistanceSensor::setSampleCallback(SampleCallback callback, void* arg) {
+    portENTER_CRITICAL_SAFE(&_writeMux);
+    _sampleCallback = callback;
+    _sampleCallbackArg = arg;
+    portEXIT_CRITICAL_SAFE(&_writeMux);
+}
+
+void DistanceSensor::triggerTimerCallback(void* arg) {
+    DistanceSensor* self = static_cast<DistanceSensor*>(arg);
+    int64_t now = esp_timer_get_time();
+
+    // The previous echo never completed, publish it as a timeout
+    if (self->_awaitingEcho && now - self->_triggerAt > (int64_t)self->_timeout) {
+        self->_awaitingEcho = false;
+        self->_echoRising = false;
+        self->publishSample(-1, now);
     }
 
-    if (_inprogress) 
-        return _lastValue;
-    
-    _inprogress = true;
     // Send a 10μs pulse on the TRIG pin
-    digitalWrite(_triggerPin, LOW);
-    delayMicroseconds(2);
-    digitalWrite(_triggerPin, HIGH);
+    digitalWrite(self->_triggerPin, HIGH);
     delayMicroseconds(10);
-    digitalWrite(_triggerPin, LOW);
-    
-    // Measure the duration of the pulse on the ECHO pin
-    unsigned long duration = pulseIn(_echoPin, HIGH, _timeout);
-    
-    // Calculate the distance in centimeters
-    // Speed of sound is ~343m/s or ~0.0343cm/μs
-    // Distance = (Duration / 2) * 0.0343
-    float distance = (duration / 2.0) * 0.0343;
-    _inprogress = false;
-    
-    // Check if the measurement is valid
-    if (duration == 0) {
-        return _lastValue > 0 ? _lastValue : -1.0; // Timeout or out of range
-    }
-    _lastValue = distance;
-    
-    return distance;
+    digitalWrite(self->_triggerPin, LOW);
+
+    self->_triggerAt = esp_timer_get_time();
+    self->_awaitingEcho = true;
 }
 
-bool DistanceSensor::isObstacleDetected() {
-    float distance = measureDistance();
-    if (distance < _threshold) {
-        float calculate = distance;
-        for (int i = 0; i < 4; ++i) {
-            vTaskDelay(pdMS_TO_TICKS(20));
-            float measure;
-            do {
-                measure = measureDistance();
-                vTaskDelay(pdMS_TO_TICKS(20));
-            } while (measure == -1.0);
-            calculate += measure;
+bool DistanceSensor::echoCaptureCallback(mcpwm_cap_channel_handle_t channel,
+                                         const mcpwm_capture_event_data_t* edata, void* arg) {
+    DistanceSensor* self = static_cast<DistanceSensor*>(arg);
+
+    if (edata->cap_edge == MCPWM_CAP_EDGE_POS) {
+        self->_echoStartTicks = edata->cap_value;
+        self->_echoRising = true;
+        return false;
+    }
+
+    if (!self->_echoRising || !self->_awaitingEcho || self->_capResolutionHz == 0) {
+        return false;
+    }
+
+    self->_echoRising = false;
+    self->_awaitingEcho = false;
+
+    uint32_t ticks = edata->cap_value - self->_echoStartTicks;
+    uint32_t widthUs = (uint32_t)((uint64_t)ticks * 1000000ULL / self->_capResolutionHz);
+
+    // Speed of sound is ~0.343mm/μs, halved for the round trip
+    int32_t distanceMm = widthUs > self->_timeout ? -1 : (int32_t)(widthUs * 343 / 2000);
+    self->publishSample(distanceMm, esp_timer_get_time());
+    return false;
+}
+
+int32_t DistanceSensor::updateMedian(int32_t distanceMm) {
+    // Timeouts count as "far" so an empty view pulls the median out of range
+    const int32_t farMm = _maxDistance * 10;
+    _window[_windowPos] = distanceMm > 0 ? distanceMm : farMm;
+    _windowPos = (_windowPos + 1) % MEDIAN_WINDOW;
+    if (_windowCount < MEDIAN_WINDOW) _windowCount++;
+
+    // Fixed size insertion sort, constant cost per sample
+    int32_t sorted[MEDIAN_WINDOW];
+    for (uint8_t i = 0; i < _windowCount; i++) {
+        int32_t value = _window[i];
+        int j = i - 1;
+        while (j >= 0 && sorted[j] > value) {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = value;
+    }
+
+    int32_t median = sorted[_windowCount / 2];
+    return median >= farMm ? -1 : median;
+}
+
+void DistanceSensor::publishSample(int32_t distanceMm, int64_t timestamp) {
+    portENTER_CRITICAL_SAFE(&_writeMux);
+
+    Sample sample;
+    sample.distanceMm = distanceMm;
+    sample.timestamp = timestamp;
+    sample.outlier = false;
+
+    if (distanceMm < 0) {
+        _timeouts++;
+    } else if (_windowCount == MEDIAN_WINDOW && _lastMedian > 0) {
+        int32_t delta = distanceMm - _lastMedian;
+        if ((delta > OUTLIER_GATE_MM || delta < -OUTLIER_GATE_MM) && _outlierRun < OUTLIER_MAX_RUN) {
+            sample.outlier = true;
+            _outliers++;
         }
-        distance = calculate / 5.0f;
     }
 
-    return (distance > 0 && distance < _threshold);
+    // Rejected samples stay in the raw ring but never reach the median; a run
+    // of them is accepted so a real step change still comes through
+    if (sample.outlier) {
+        _outlierRun++;
+        sample.filteredMm = _lastMedian;
+    } else {
+        _outlierRun = 0;
+        sample.filteredMm = updateMedian(distanceMm);
+        _lastMedian = sample.filteredMm;
+    }
+
+    if (sample.filteredMm > 0 && sample.filteredMm < _thresholdMm) {
+        if (_nearCount < 255) _nearCount++;
+    } else {
+        _nearCount = 0;
+    }
+
+    // Per-slot seqlock, readers retry instead of blocking the producer
+    uint32_t sequence = _sequence.load(std::memory_order_relaxed) + 1;
+    sample.sequence = sequence;
+    Slot& slot = _ring[sequence % RING_SIZE];
+    slot.lock.fetch_add(1, std::memory_order_acq_rel);
+    slot.sample = sample;
+    slot.lock.fetch_add(1, std::memory_order_release);
+    _sequence.store(sequence, std::memory_order_release);
+
+    SampleCallback callback = _sampleCallback;
+    void* callbackArg = _sampleCallbackArg;
+    portEXIT_CRITICAL_SAFE(&_writeMux);
+
+    if (callback) {
+        callback(sample, callbackArg);
+    }
+}
+
+void DistanceSensor::measureOnce() {
+    // Concurrent readers share one measurement instead of queueing up
+    bool idle = false;
+    if (!_measuring.compare_exchange_strong(idle, true)) {
+        return;
+    }
+
+    Sample latest = getLatestSample();
+    if (latest.sequence == 0 || esp_timer_get_time() - latest.timestamp >= (int64_t)_intervalMs * 1000) {
+        digitalWrite(_triggerPin, LOW);
+        delayMicroseconds(2);
+        digitalWrite(_triggerPin, HIGH);
+        delayMicroseconds(10);
+        digitalWrite(_triggerPin, LOW);
+
+        unsigned long widthUs = pulseIn(_echoPin, HIGH, _timeout);
+        publishSample(widthUs == 0 ? -1 : (int32_t)(widthUs * 343 / 2000), esp_timer_get_time());
+    }
+
+    _measuring.store(false);
+}
+
+bool DistanceSensor::readSlot(uint32_t sequence, Sample& out) const {
+    const Slot& slot = _ring[sequence % RING_SIZE];
+    uint32_t before = slot.lock.load(std::memory_order_acquire);
+    if (before & 1) {
+        return false;
+    }
+    out = slot.sample;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint32_t after = slot.lock.load(std::memory_order_relaxed);
+    return before == after && out.sequence == sequence;
+}
+
+DistanceSensor::Sample DistanceSensor::getLatestSample() const {
+    Sample sample = {-1, -1, 0, 0, false};
+    for (int attempt = 0; attempt < 4; attempt++) {
+        uint32_t sequence = _sequence.load(std::memory_order_acquire);
+        if (sequence == 0 || readSlot(sequence, sample)) {
+            break;
+        }
+    }
+    return sample;
+}
+
+size_t DistanceSensor::getSamples(Sample* out, size_t maxSamples) const {
+    uint32_t sequence = _sequence.load(std::memory_order_acquire);
+    size_t count = 0;
+    // Leave one slot of slack for the producer
+    while (count < maxSamples && count < RING_SIZE - 1 && sequence > 0) {
+        if (readSlot(sequence, out[count])) {
+            count++;
+        }
+        sequence--;
+    }
+    return count;
+}
+
+float DistanceSensor::measureDistance() {
+    if (!_initialized) {
+        return -1.0;
+    }
+
+    if (_singleShot) {
+        measureOnce();
+    }
+    return getLatestSample().distance();
+}
+
+bool DistanceSensor::isObstacleDetected() {
+    if (!_continuous && !_singleShot) {
+        return false;
+    }
+
+    if (_singleShot) {
+        measureOnce();
+    }
+    Sample sample = getLatestSample();
+    int64_t maxAge = (int64_t)_intervalMs * 3 * 1000;
+    if (sample.sequence == 0 || esp_timer_get_time() - sample.timestamp > maxAge) {
+        return false; // No fresh data
+    }
+    return _nearCount >= OBSTACLE_CONFIRM_SAMPLES;
 }
 
 } // namespace Sensors
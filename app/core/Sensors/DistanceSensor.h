@@ -1,17 +1,56 @@
 #pragma once
 
 #include <Arduino.h>
+#include <atomic>
+#include <esp_timer.h>
+#include <driver/mcpwm_cap.h>
 
 namespace Sensors {
 
 /**
  * HC-SR04 Ultrasonic Distance Sensor class
- * 
+ *
  * This class provides an interface to the HC-SR04 ultrasonic sensor
  * for measuring distances.
+ *
+ * Ranging runs in the background: an esp_timer fires the trigger at a fixed
+ * rate and the MCPWM capture unit timestamps both echo edges in hardware.
+ * Samples land in a lock-free ring together with a running median, so
+ * readers never block and never touch the sensor themselves.
+ *
+ * Without the capture unit the sensor falls back to single-shot ranging:
+ * readers trigger a blocking measurement when the latest sample is older
+ * than the interval, and it goes through the same filter and ring.
  */
 class DistanceSensor {
 public:
+    static const int RING_SIZE = 16;      // Samples kept for readers
+    static const int MEDIAN_WINDOW = 5;   // Running median length
+
+    /**
+     * A single timestamped ranging result
+     * Distances are kept in integer millimeters so they can be produced
+     * in interrupt context without touching the FPU.
+     */
+    struct Sample {
+        int32_t distanceMm;   // Raw echo distance, -1 on timeout
+        int32_t filteredMm;   // Running median, -1 if the window has no valid data
+        int64_t timestamp;    // esp_timer_get_time() when the echo ended (us)
+        uint32_t sequence;    // Incremented for every published sample
+        bool outlier;         // Raw value rejected by the outlier gate, not in filteredMm
+
+        /**
+         * @return Filtered distance in centimeters, or -1 if unknown
+         */
+        float distance() const { return filteredMm > 0 ? filteredMm / 10.0f : -1.0f; }
+    };
+
+    /**
+     * Called for every published sample.
+     * Runs in interrupt context; keep it short, ISR-safe and integer only.
+     */
+    using SampleCallback = void (*)(const Sample& sample, void* arg);
+
     DistanceSensor();
     ~DistanceSensor();
 
@@ -19,7 +58,6 @@ public:
      * Initialize the distance sensor
      * @param triggerPin GPIO pin connected to the TRIG pin of the sensor
      * @param echoPin GPIO pin connected to the ECHO pin of the sensor
-     * @param maxDistance Maximum distance to measure in centimeters (default: 400cm)
      * @return true if initialization was successful, false otherwise
      */
     bool init(int triggerPin, int echoPin);
@@ -27,27 +65,142 @@ public:
 		void setThresHold(float threshold = 20.0);
 
     /**
-     * Measure the distance
-     * @return Distance in centimeters, or -1 if measurement failed
+     * Start background ranging
+     * @param intervalMs Trigger period in milliseconds (HC-SR04 needs >= 60ms)
+     * @return true if the capture unit and trigger timer are running
+     */
+    bool startContinuous(uint32_t intervalMs = 60);
+
+    /**
+     * Stop background ranging and release the capture unit
+     */
+    void stopContinuous();
+
+    /**
+     * @return true if background ranging is running
+     */
+    bool isContinuous() const { return _continuous; }
+
+    /**
+     * Measure on demand when background ranging is not available
+     * @param intervalMs Shortest time between two measurements
+     * @return true if the sensor was initialized
+     */
+    bool startSingleShot(uint32_t intervalMs = 60);
+
+    /**
+     * @return true if samples are produced, in the background or on demand
+     */
+    bool isRanging() const { return _continuous || _singleShot; }
+
+    /**
+     * Get the most recent sample
+     * @return Latest sample (sequence 0 if nothing was measured yet)
+     */
+    Sample getLatestSample() const;
+
+    /**
+     * Copy recent samples, newest first, without blocking the producer
+     * @param out Destination array
+     * @param maxSamples Capacity of out
+     * @return Number of samples copied
+     */
+    size_t getSamples(Sample* out, size_t maxSamples) const;
+
+    /**
+     * Register a listener for new samples
+     * @param callback Function to call, or nullptr to remove
+     * @param arg User argument passed to the callback
+     */
+    void setSampleCallback(SampleCallback callback, void* arg = nullptr);
+
+    /**
+     * Latest filtered distance, never blocks
+     * @return Distance in centimeters, or -1 if no valid measurement
      */
     float measureDistance();
 
     /**
-     * Check if an obstacle is detected within the specified range
-     * @param threshold Distance threshold in centimeters
+     * Check if an obstacle is detected within the configured threshold
+     * Uses the filtered value and requires a few consecutive confirmations.
      * @return true if an obstacle is detected within the threshold, false otherwise
      */
     bool isObstacleDetected();
 
+    /**
+     * @return Configured obstacle threshold in centimeters
+     */
+    float getThreshold() const { return _threshold; }
+
+    /**
+     * @return Configured obstacle threshold in millimeters
+     */
+    int32_t getThresholdMm() const { return _thresholdMm; }
+
+    /**
+     * @return Number of samples rejected by the outlier gate
+     */
+    uint32_t getOutlierCount() const { return _outliers; }
+
+    /**
+     * @return Number of triggers without an echo
+     */
+    uint32_t getTimeoutCount() const { return _timeouts; }
+
 private:
+    struct Slot {
+        std::atomic<uint32_t> lock;   // Odd while the slot is being written
+        Sample sample;
+    };
+
+    const char* TAG;
     int _triggerPin;
     int _echoPin;
 		float _threshold;
+    volatile int32_t _thresholdMm;
     int _maxDistance;
-    float _lastValue;
-    bool _inprogress;
-    unsigned long _timeout; // Timeout in microseconds
+    uint32_t _timeout; // Echo timeout in microseconds
     bool _initialized;
+
+    // Background ranging state
+    bool _continuous;
+    bool _singleShot;
+    std::atomic<bool> _measuring;      // A single-shot measurement is running
+    uint32_t _intervalMs;
+    esp_timer_handle_t _triggerTimer;
+    mcpwm_cap_timer_handle_t _capTimer;
+    mcpwm_cap_channel_handle_t _capChannel;
+    uint32_t _capResolutionHz;
+    uint32_t _echoStartTicks;
+    volatile bool _echoRising;
+    volatile int64_t _triggerAt;
+    volatile bool _awaitingEcho;
+
+    // Filter state, only touched by the producer under _writeMux
+    int32_t _window[MEDIAN_WINDOW];
+    uint8_t _windowPos;
+    uint8_t _windowCount;
+    int32_t _lastMedian;
+    uint8_t _outlierRun;               // Consecutive samples rejected by the gate
+    volatile uint8_t _nearCount;       // Consecutive filtered samples under threshold
+    volatile uint32_t _outliers;
+    volatile uint32_t _timeouts;
+
+    // Lock-free ring for readers
+    Slot _ring[RING_SIZE];
+    std::atomic<uint32_t> _sequence;
+
+    mutable portMUX_TYPE _writeMux;
+    SampleCallback _sampleCallback;
+    void* _sampleCallbackArg;
+
+    static void triggerTimerCallback(void* arg);
+    static bool echoCaptureCallback(mcpwm_cap_channel_handle_t channel,
+                                    const mcpwm_capture_event_data_t* edata, void* arg);
+    void publishSample(int32_t distanceMm, int64_t timestamp);
+    void measureOnce();
+    int32_t updateMedian(int32_t distanceMm);
+    bool readSlot(uint32_t sequence, Sample& out) const;
 };
 
 } // namespace Sensors
@@ -13,6 +13,28 @@ const int BUFFER_Y2 = 3; // Y low byte
 const int BUFFER_Z1 = 4; // Z high byte
 const int BUFFER_Z2 = 5; // Z low byte
 
+// FIFO stream mode registers
+const uint8_t MPU6050_ADDR = 0x68;
+const uint8_t MPU6050_REG_SMPLRT_DIV = 0x19;
+const uint8_t MPU6050_REG_FIFO_EN = 0x23;
+const uint8_t MPU6050_REG_INT_PIN_CFG = 0x37;
+const uint8_t MPU6050_REG_INT_ENABLE = 0x38;
+const uint8_t MPU6050_REG_INT_STATUS = 0x3A;
+const uint8_t MPU6050_REG_USER_CTRL = 0x6A;
+const uint8_t MPU6050_REG_FIFO_COUNTH = 0x72;
+const uint8_t MPU6050_REG_FIFO_R_W = 0x74;
+
+const uint8_t FIFO_EN_ACCEL_GYRO = 0x78;     // XG, YG, ZG and ACCEL into the FIFO
+const uint8_t USER_CTRL_FIFO_EN = 0x40;
+const uint8_t USER_CTRL_FIFO_RESET = 0x04;
+const uint8_t INT_PIN_CFG_RD_CLEAR = 0x10;   // Any read clears the interrupt status
+const uint8_t INT_DATA_RDY = 0x01;
+const uint8_t INT_FIFO_OFLOW = 0x10;
+
+const int FIFO_SIZE = 1024;
+const int FIFO_SAMPLE_BYTES = 12;            // Accel XYZ then gyro XYZ, big endian
+const int FIFO_BURST_SAMPLES = 10;           // Stays within the 128 byte Wire buffer
+
 OrientationSensor::OrientationSensor() : TAG("OrientationSensor"),
     _x(0), _y(0), _z(0), 
     _accelX(0), _accelY(0), _accelZ(0),
@@ -22,11 +44,20 @@ OrientationSensor::OrientationSensor() : TAG("OrientationSensor"),
     _gyroRange(GYRO_RANGE_250_DEG), 
     _accelRange(ACCEL_RANGE_2G),
     _gyroScale(131.0), // Default scale for ±250°/s
-    _accelScale(16384.0) // Default scale for ±2g
-{}
+    _accelScale(16384.0), // Default scale for ±2g
+    _streaming(false), _sampleRateHz(0), _samplePeriodUs(0),
+    _batchMs(20), _intPin(-1), _streamTask(nullptr),
+    _sequence(0), _stats{},
+    _statsMux(portMUX_INITIALIZER_UNLOCKED)
+{
+    for (int i = 0; i < STREAM_RING_SIZE; i++) {
+        _ring[i].lock.store(0);
+        _ring[i].sample = Sample{};
+    }
+}
 
 OrientationSensor::~OrientationSensor() {
-    // Clean up resources if needed
+    stopStream();
 }
 
 bool OrientationSensor::init(int sda, int scl) {
@@ -42,7 +73,6 @@ bool OrientationSensor::init(int sda, int scl) {
     }
     
     // MPU6050 register addresses
-    const uint8_t MPU6050_ADDR = 0x68;
     const uint8_t MPU6050_REG_PWR_MGMT_1 = 0x6B;
     const uint8_t MPU6050_REG_CONFIG = 0x1A;
     const uint8_t MPU6050_REG_GYRO_CONFIG = 0x1B;
@@ -90,9 +120,22 @@ void OrientationSensor::update() {
     if (!_initialized) {
         return;
     }
+
+    // Stream mode: the reader task owns the bus, just take the latest sample
+    if (_streaming) {
+        Sample sample = getLatestSample();
+        if (sample.sequence != 0) {
+            _x = sample.gyroX;
+            _y = sample.gyroY;
+            _z = sample.gyroZ;
+            _accelX = sample.accelX;
+            _accelY = sample.accelY;
+            _accelZ = sample.accelZ;
+        }
+        return;
+    }
     
     // MPU6050 register addresses
-    const uint8_t MPU6050_ADDR = 0x68;
     const uint8_t MPU6050_REG_ACCEL_XOUT_H = 0x3B;  // Accelerometer data starts at this register
     const uint8_t MPU6050_REG_GYRO_XOUT_H = 0x43;   // Gyroscope data starts at this register
     
@@ -172,6 +215,11 @@ bool OrientationSensor::calibrate() {
     if (!_initialized) {
         return false;
     }
+
+    if (_streaming) {
+        ESP_LOGW(TAG, "Stop the FIFO stream before calibrating");
+        return false;
+    }
     
     ESP_LOGI(TAG, "Starting gyroscope and accelerometer calibration...");
     
@@ -181,7 +229,6 @@ bool OrientationSensor::calibrate() {
     float sumAccelX = 0, sumAccelY = 0, sumAccelZ = 0;
     
     // MPU6050 register addresses
-    const uint8_t MPU6050_ADDR = 0x68;
     const uint8_t MPU6050_REG_ACCEL_XOUT_H = 0x3B;
     const uint8_t MPU6050_REG_GYRO_XOUT_H = 0x43;
     
@@ -280,7 +327,6 @@ bool OrientationSensor::setGyroRange(GyroRange range) {
         return false;
     }
     
-    const uint8_t MPU6050_ADDR = 0x68;
     const uint8_t MPU6050_REG_GYRO_CONFIG = 0x1B;
     
     // Configure the gyroscope with new range
@@ -301,7 +347,6 @@ bool OrientationSensor::setAccelRange(AccelRange range) {
         return false;
     }
     
-    const uint8_t MPU6050_ADDR = 0x68;
     const uint8_t MPU6050_REG_ACCEL_CONFIG = 0x1C;
     
     // Configure the accelerometer with new range
@@ -317,6 +362,266 @@ bool OrientationSensor::setAccelRange(AccelRange range) {
     return true;
 }
 
+bool OrientationSensor::startStream(uint16_t sampleRateHz, int intPin, uint32_t batchMs,
+                                    int core, UBaseType_t priority) {
+    if (!_initialized) {
+        return false;
+    }
+
+    if (_streaming) {
+        return true;
+    }
+
+    Utils::I2CManager& i2c = Utils::I2CManager::getInstance();
+
+    // With the DLPF enabled the gyro output rate is 1kHz
+    if (sampleRateHz < 4) sampleRateHz = 4;
+    if (sampleRateHz > 1000) sampleRateHz = 1000;
+    uint8_t divider = (uint8_t)(1000 / sampleRateHz - 1);
+    _sampleRateHz = 1000 / (divider + 1);
+    _samplePeriodUs = 1000000UL / _sampleRateHz;
+    _batchMs = batchMs;
+    _intPin = intPin;
+
+    if (!i2c.writeRegister("base", MPU6050_ADDR, MPU6050_REG_SMPLRT_DIV, divider) ||
+        !i2c.writeRegister("base", MPU6050_ADDR, MPU6050_REG_FIFO_EN, FIFO_EN_ACCEL_GYRO) ||
+        !i2c.writeRegister("base", MPU6050_ADDR, MPU6050_REG_INT_PIN_CFG, INT_PIN_CFG_RD_CLEAR) ||
+        !i2c.writeRegister("base", MPU6050_ADDR, MPU6050_REG_INT_ENABLE, _intPin >= 0 ? INT_DATA_RDY : 0) ||
+        !resetFifo()) {
+        ESP_LOGE(TAG, "Failed to configure FIFO");
+        return false;
+    }
+
+    _streaming = true;
+    BaseType_t result = xTaskCreatePinnedToCore(
+        streamTaskFunction,
+        "ImuStream",
+        3 * 1024,
+        this,
+        priority,
+        &_streamTask,
+        core
+    );
+
+    if (result != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create stream task");
+        _streamTask = nullptr;
+        _streaming = false;
+        return false;
+    }
+
+    if (_intPin >= 0) {
+        pinMode(_intPin, INPUT);
+        attachInterruptArg(_intPin, dataReadyIsr, this, RISING);
+    }
+
+    ESP_LOGI(TAG, "FIFO stream at %u Hz, drained every %u ms (%s)", _sampleRateHz, _batchMs,
+        _intPin >= 0 ? "data-ready interrupt" : "timer");
+    return true;
+}
+
+void OrientationSensor::stopStream() {
+    if (!_streaming) {
+        return;
+    }
+
+    if (_intPin >= 0) {
+        detachInterrupt(_intPin);
+    }
+
+    // Let the reader finish its burst and exit on its own so it never
+    // dies while holding the bus
+    _streaming = false;
+    if (_streamTask) {
+        xTaskNotifyGive(_streamTask);
+    }
+    for (int i = 0; i < 20 && _streamTask != nullptr; i++) {
+        delay(10);
+    }
+
+    Utils::I2CManager& i2c = Utils::I2CManager::getInstance();
+    i2c.writeRegister("base", MPU6050_ADDR, MPU6050_REG_INT_ENABLE, 0);
+    i2c.writeRegister("base", MPU6050_ADDR, MPU6050_REG_FIFO_EN, 0);
+    i2c.writeRegister("base", MPU6050_ADDR, MPU6050_REG_USER_CTRL, 0);
+}
+
+bool OrientationSensor::resetFifo() {
+    Utils::I2CManager& i2c = Utils::I2CManager::getInstance();
+    return i2c.writeRegister("base", MPU6050_ADDR, MPU6050_REG_USER_CTRL, USER_CTRL_FIFO_RESET) &&
+           i2c.writeRegister("base", MPU6050_ADDR, MPU6050_REG_USER_CTRL, USER_CTRL_FIFO_EN);
+}
+
+void ARDUINO_ISR_ATTR OrientationSensor::dataReadyIsr(void* arg) {
+    OrientationSensor* self = static_cast<OrientationSensor*>(arg);
+    if (self->_streamTask == nullptr) {
+        return;
+    }
+
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(self->_streamTask, &woken);
+    if (woken == pdTRUE) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+void OrientationSensor::streamTaskFunction(void* parameter) {
+    OrientationSensor* self = static_cast<OrientationSensor*>(parameter);
+    TickType_t timeout = pdMS_TO_TICKS(self->_batchMs > 0 ? self->_batchMs : 10);
+
+    while (self->_streaming) {
+        // Interrupt wakes us as soon as data is there, the timeout covers
+        // boards without INT wiring
+        ulTaskNotifyTake(pdTRUE, self->_intPin >= 0 ? timeout * 2 : timeout);
+        if (!self->_streaming) {
+            break;
+        }
+
+        self->drainFifo();
+
+        // Let samples pile up in the FIFO so the next drain is one burst
+        if (self->_intPin >= 0 && self->_batchMs > 0) {
+            vTaskDelay(timeout);
+        }
+    }
+
+    self->_streamTask = nullptr;
+    vTaskDelete(NULL);
+}
+
+void OrientationSensor::drainFifo() {
+    Utils::I2CManager& i2c = Utils::I2CManager::getInstance();
+
+    portENTER_CRITICAL(&_statsMux);
+    _stats.wakeups++;
+    portEXIT_CRITICAL(&_statsMux);
+
+    // Reading INT_STATUS also clears the interrupt line
+    uint8_t status = 0;
+    uint8_t countBuffer[2];
+    if (!i2c.readRegister("base", MPU6050_ADDR, MPU6050_REG_INT_STATUS, status) ||
+        !i2c.readRegisters("base", MPU6050_ADDR, MPU6050_REG_FIFO_COUNTH, countBuffer, sizeof(countBuffer))) {
+        ESP_LOGE(TAG, "Failed to read FIFO status");
+        return;
+    }
+
+    uint16_t count = (countBuffer[0] << 8) | countBuffer[1];
+    if ((status & INT_FIFO_OFLOW) || count > FIFO_SIZE - FIFO_SAMPLE_BYTES) {
+        // Sample boundaries are lost once the FIFO wraps, start over
+        ESP_LOGW(TAG, "IMU FIFO overflow, dropping %u bytes", count);
+        portENTER_CRITICAL(&_statsMux);
+        _stats.overflows++;
+        portEXIT_CRITICAL(&_statsMux);
+        resetFifo();
+        return;
+    }
+
+    int pending = count / FIFO_SAMPLE_BYTES;
+    if (pending == 0) {
+        return;
+    }
+
+    // The newest sample was taken about now, older ones one period apart
+    int64_t newest = esp_timer_get_time();
+    int index = 0;
+    uint8_t buffer[FIFO_BURST_SAMPLES * FIFO_SAMPLE_BYTES];
+
+    while (index < pending) {
+        int chunk = pending - index;
+        if (chunk > FIFO_BURST_SAMPLES) chunk = FIFO_BURST_SAMPLES;
+
+        if (!i2c.readRegisters("base", MPU6050_ADDR, MPU6050_REG_FIFO_R_W, buffer, chunk * FIFO_SAMPLE_BYTES)) {
+            ESP_LOGE(TAG, "FIFO burst read failed");
+            resetFifo();
+            return;
+        }
+
+        for (int i = 0; i < chunk; i++, index++) {
+            int64_t timestamp = newest - (int64_t)(pending - 1 - index) * _samplePeriodUs;
+            publishSample(buffer + i * FIFO_SAMPLE_BYTES, timestamp);
+        }
+
+        portENTER_CRITICAL(&_statsMux);
+        _stats.bursts++;
+        portEXIT_CRITICAL(&_statsMux);
+    }
+}
+
+void OrientationSensor::publishSample(const uint8_t* raw, int64_t timestamp) {
+    const uint8_t* accel = raw;
+    const uint8_t* gyro = raw + 6;
+
+    Sample sample;
+    sample.accelX = ((int16_t)((accel[BUFFER_X1] << 8) | accel[BUFFER_X2])) / _accelScale - _accelOffsetX;
+    sample.accelY = ((int16_t)((accel[BUFFER_Y1] << 8) | accel[BUFFER_Y2])) / _accelScale - _accelOffsetY;
+    sample.accelZ = ((int16_t)((accel[BUFFER_Z1] << 8) | accel[BUFFER_Z2])) / _accelScale - _accelOffsetZ;
+    sample.gyroX = ((int16_t)((gyro[BUFFER_X1] << 8) | gyro[BUFFER_X2])) / _gyroScale - _offsetX;
+    sample.gyroY = ((int16_t)((gyro[BUFFER_Y1] << 8) | gyro[BUFFER_Y2])) / _gyroScale - _offsetY;
+    sample.gyroZ = ((int16_t)((gyro[BUFFER_Z1] << 8) | gyro[BUFFER_Z2])) / _gyroScale - _offsetZ;
+    sample.timestamp = timestamp;
+
+    // Single producer, per-slot seqlock so readers never block it
+    uint32_t sequence = _sequence.load(std::memory_order_relaxed) + 1;
+    sample.sequence = sequence;
+    Slot& slot = _ring[sequence % STREAM_RING_SIZE];
+    slot.lock.fetch_add(1, std::memory_order_acq_rel);
+    slot.sample = sample;
+    slot.lock.fetch_add(1, std::memory_order_release);
+    _sequence.store(sequence, std::memory_order_release);
+
+    portENTER_CRITICAL(&_statsMux);
+    _stats.samples++;
+    portEXIT_CRITICAL(&_statsMux);
+}
+
+bool OrientationSensor::readSlot(uint32_t sequence, Sample& out) const {
+    const Slot& slot = _ring[sequence % STREAM_RING_SIZE];
+    uint32_t before = slot.lock.load(std::memory_order_acquire);
+    if (before & 1) {
+        return false;
+    }
+    out = slot.sample;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint32_t after = slot.lock.load(std::memory_order_relaxed);
+    return before == after && out.sequence == sequence;
+}
+
+OrientationSensor::Sample OrientationSensor::getLatestSample() const {
+    Sample sample = {};
+    for (int attempt = 0; attempt < 4; attempt++) {
+        uint32_t sequence = _sequence.load(std::memory_order_acquire);
+        if (sequence == 0 || readSlot(sequence, sample)) {
+            break;
+        }
+    }
+    return sample;
+}
+
+size_t OrientationSensor::getSamplesSince(uint32_t sequence, Sample* out, size_t maxSamples) const {
+    uint32_t latest = _sequence.load(std::memory_order_acquire);
+    if (latest <= sequence) {
+        return 0;
+    }
+
+    // Leave one slot of slack for the producer
+    uint32_t oldest = latest > STREAM_RING_SIZE - 2 ? latest - (STREAM_RING_SIZE - 2) : 1;
+    uint32_t first = sequence + 1 > oldest ? sequence + 1 : oldest;
+
+    size_t count = 0;
+    for (uint32_t seq = first; seq <= latest && count < maxSamples; seq++) {
+        if (readSlot(seq, out[count])) {
+            count++;
+        }
+    }
+    return count;
+}
+
+OrientationSensor::StreamStats OrientationSensor::getStreamStats() const {
+    portENTER_CRITICAL(&_statsMux);
+    StreamStats stats = _stats;
+    portEXIT_CRITICAL(&_statsMux);
+    return stats;
+}
+
 GyroRange OrientationSensor::getGyroRange() const {
     return _gyroRange;
 }
@@ -2,6 +2,8 @@
 
 #include <Arduino.h>
 #include <Wire.h>
+#include <atomic>
+#include <esp_timer.h>
 #include "I2CManager.h"
 
 namespace Sensors {
@@ -24,9 +26,34 @@ enum AccelRange {
 
 /**
  * Gyroscope and accelerometer sensor class for motion detection and orientation
+ *
+ * In stream mode the MPU6050 samples into its FIFO at a fixed rate and a
+ * reader task drains it in burst reads, woken by the data-ready interrupt
+ * (or a timer without INT wiring). Samples are published to a lock-free
+ * ring with timestamps and sequence numbers; update() and the getters then
+ * only read the latest sample and never touch the bus.
  */
 class OrientationSensor {
 public:
+    static const int STREAM_RING_SIZE = 64;
+
+    /**
+     * A single calibrated IMU sample
+     */
+    struct Sample {
+        float gyroX, gyroY, gyroZ;     // Degrees per second
+        float accelX, accelY, accelZ;  // g
+        int64_t timestamp;             // esp_timer_get_time() at sampling (us)
+        uint32_t sequence;             // Incremented for every sample, 0 = none
+    };
+
+    struct StreamStats {
+        uint32_t samples;    // Samples published
+        uint32_t bursts;     // Burst reads issued
+        uint32_t wakeups;    // Reader task wake-ups
+        uint32_t overflows;  // FIFO overflows (samples lost)
+    };
+
     OrientationSensor();
     ~OrientationSensor();
 
@@ -40,9 +67,58 @@ public:
 
     /**
      * Update gyroscope and accelerometer readings
+     * In stream mode this only copies the latest sample, no bus traffic.
      */
     void update();
 
+    /**
+     * Start FIFO stream mode
+     * @param sampleRateHz IMU output rate (4..1000 Hz)
+     * @param intPin GPIO wired to the MPU6050 INT pin, -1 to drain on a timer
+     * @param batchMs Minimum time between FIFO drains, samples are batched meanwhile
+     * @param core Core to pin the reader task to
+     * @param priority Reader task priority
+     * @return true if the FIFO and the reader task are running
+     */
+    bool startStream(uint16_t sampleRateHz = 200, int intPin = -1, uint32_t batchMs = 20,
+                     int core = 0, UBaseType_t priority = 6);
+
+    /**
+     * Stop stream mode and disable the FIFO
+     */
+    void stopStream();
+
+    /**
+     * @return true if stream mode is running
+     */
+    bool isStreaming() const { return _streaming; }
+
+    /**
+     * @return Stream sample rate in Hz, 0 if not streaming
+     */
+    uint16_t getSampleRate() const { return _streaming ? _sampleRateHz : 0; }
+
+    /**
+     * Get the most recent streamed sample
+     * @return Latest sample (sequence 0 if nothing was published yet)
+     */
+    Sample getLatestSample() const;
+
+    /**
+     * Copy samples newer than a sequence number, oldest first
+     * Callers that fall behind by more than the ring size see a sequence gap.
+     * @param sequence Last sequence the caller has seen (0 for everything available)
+     * @param out Destination array
+     * @param maxSamples Capacity of out
+     * @return Number of samples copied
+     */
+    size_t getSamplesSince(uint32_t sequence, Sample* out, size_t maxSamples) const;
+
+    /**
+     * @return Stream counters
+     */
+    StreamStats getStreamStats() const;
+
     /**
      * Get the X-axis rotation in degrees per second
      * @return X-axis rotation in degrees per second
@@ -130,10 +206,34 @@ private:
     float _gyroScale;  // Current gyroscope scaling factor
     float _accelScale;  // Current accelerometer scaling factor
 
+    // Stream mode
+    struct Slot {
+        std::atomic<uint32_t> lock;   // Odd while the slot is being written
+        Sample sample;
+    };
+
+    volatile bool _streaming;
+    uint16_t _sampleRateHz;
+    uint32_t _samplePeriodUs;
+    uint32_t _batchMs;
+    int _intPin;
+    TaskHandle_t _streamTask;
+    Slot _ring[STREAM_RING_SIZE];
+    std::atomic<uint32_t> _sequence;
+    StreamStats _stats;
+    mutable portMUX_TYPE _statsMux;
+
     /**
      * Update scaling factors based on current range settings
      */
     void updateScalingFactors();
+
+    static void streamTaskFunction(void* parameter);
+    static void dataReadyIsr(void* arg);
+    bool resetFifo();
+    void drainFifo();
+    void publishSample(const uint8_t* raw, int64_t timestamp);
+    bool readSlot(uint32_t sequence, Sample& out) const;
 };
 
 } // namespace Sensors
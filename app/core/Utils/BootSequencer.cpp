@@ -0,0 +1,291 @@
+#include "BootSequencer.h"
+#include <esp_timer.h>
+#include <string.h>
+#include "Logger.h"
+
+namespace Utils {
+
+static uint32_t sinceBootUs() {
+    return (uint32_t)esp_timer_get_time();
+}
+
+BootSequencer::BootSequencer()
+    : TAG("BootSequencer"),
+      _stageCount(0),
+      _milestones{},
+      _milestoneCount(0),
+      _runUs(0),
+      _mutex(xSemaphoreCreateMutex()),
+      _finished(xSemaphoreCreateCounting(2 * WORKERS_PER_CORE, 0)),
+      _workers{},
+      _workerCount(0),
+      _running(0),
+      _remaining(0)
+{
+}
+
+BootSequencer::~BootSequencer() {
+    if (_mutex) {
+        vSemaphoreDelete(_mutex);
+    }
+    if (_finished) {
+        vSemaphoreDelete(_finished);
+    }
+}
+
+int BootSequencer::addStage(const char* name, StageFunction function,
+                            std::initializer_list<const char*> dependencies, int core) {
+    if (_stageCount >= MAX_STAGES || dependencies.size() > MAX_DEPENDENCIES) {
+        Utils::Logger::getInstance().error("%s: cannot add stage %s", TAG, name);
+        return -1;
+    }
+
+    Stage& stage = _stages[_stageCount];
+    stage.name = name;
+    stage.function = function;
+    stage.dependencyCount = 0;
+    for (const char* dependency : dependencies) {
+        stage.dependencyNames[stage.dependencyCount++] = dependency;
+    }
+    stage.unmet = 0;
+    stage.core = core < 0 ? ANY_CORE : core;
+    stage.state = PENDING;
+    stage.timing = {};
+    stage.timing.name = name;
+    stage.timing.core = -1;
+    return _stageCount++;
+}
+
+bool BootSequencer::resolve() {
+    bool ok = true;
+    for (int i = 0; i < _stageCount; i++) {
+        Stage& stage = _stages[i];
+        stage.unmet = 0;
+        for (int d = 0; d < stage.dependencyCount; d++) {
+            stage.dependencies[d] = -1;
+            for (int j = 0; j < _stageCount; j++) {
+                if (j != i && strcmp(_stages[j].name, stage.dependencyNames[d]) == 0) {
+                    stage.dependencies[d] = j;
+                    break;
+                }
+            }
+            if (stage.dependencies[d] < 0) {
+                // Missing stage, most likely compiled out: do not wait for it
+                Utils::Logger::getInstance().warning("%s: %s depends on unknown stage %s",
+                    TAG, stage.name, stage.dependencyNames[d]);
+                ok = false;
+                continue;
+            }
+            stage.unmet++;
+        }
+    }
+    return ok;
+}
+
+bool BootSequencer::run(uint32_t stackSize, UBaseType_t priority) {
+    if (_stageCount == 0) {
+        return true;
+    }
+
+    bool ok = resolve();
+    uint32_t startUs = sinceBootUs();
+    _running = 0;
+    _remaining = _stageCount;
+    for (int i = 0; i < _stageCount; i++) {
+        if (_stages[i].unmet == 0) {
+            _stages[i].timing.readyUs = startUs;
+        }
+    }
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    _workerCount = 0;
+    for (int core = 0; core < portNUM_PROCESSORS && core < 2; core++) {
+        for (int n = 0; n < WORKERS_PER_CORE; n++) {
+            Worker& worker = _workers[_workerCount];
+            worker.owner = this;
+            worker.core = core;
+            worker.handle = nullptr;
+            if (xTaskCreatePinnedToCore(workerFunction, "boot", stackSize, &worker,
+                                        priority, &worker.handle, core) == pdPASS) {
+                _workerCount++;
+            }
+        }
+    }
+    xSemaphoreGive(_mutex);
+
+    if (_workerCount == 0) {
+        // No memory for workers: fall back to running in order on this task
+        Utils::Logger::getInstance().warning("%s: no workers, booting sequentially", TAG);
+        int index;
+        while ((index = take(ANY_CORE)) >= 0) {
+            _stages[index].function();
+            complete(index);
+        }
+    } else {
+        for (int i = 0; i < _workerCount; i++) {
+            xSemaphoreTake(_finished, portMAX_DELAY);
+        }
+    }
+
+    _runUs = sinceBootUs() - startUs;
+
+    for (int i = 0; i < _stageCount; i++) {
+        if (_stages[i].state != DONE) {
+            _stages[i].state = SKIPPED;
+            Utils::Logger::getInstance().error("%s: stage %s never became ready (dependency cycle)",
+                TAG, _stages[i].name);
+            ok = false;
+        }
+    }
+
+    logTimings();
+    return ok;
+}
+
+int BootSequencer::take(int core) {
+    for (int i = 0; i < _stageCount; i++) {
+        Stage& stage = _stages[i];
+        if (stage.state != PENDING || stage.unmet > 0) {
+            continue;
+        }
+        if (core != ANY_CORE && stage.core != ANY_CORE && stage.core != core) {
+            continue;
+        }
+        stage.state = RUNNING;
+        stage.timing.startUs = sinceBootUs();
+        stage.timing.core = xPortGetCoreID();
+        _running++;
+        return i;
+    }
+    return -1;
+}
+
+void BootSequencer::complete(int index) {
+    Stage& stage = _stages[index];
+    uint32_t now = sinceBootUs();
+    stage.state = DONE;
+    stage.timing.done = true;
+    stage.timing.durationUs = now - stage.timing.startUs;
+    _running--;
+    _remaining--;
+
+    for (int i = 0; i < _stageCount; i++) {
+        Stage& dependent = _stages[i];
+        for (int d = 0; d < dependent.dependencyCount; d++) {
+            if (dependent.dependencies[d] == index && dependent.unmet > 0) {
+                if (--dependent.unmet == 0) {
+                    dependent.timing.readyUs = now;
+                }
+            }
+        }
+    }
+}
+
+void BootSequencer::wakeWorkers() {
+    for (int i = 0; i < _workerCount; i++) {
+        if (_workers[i].handle != nullptr) {
+            xTaskNotifyGive(_workers[i].handle);
+        }
+    }
+}
+
+void BootSequencer::workerFunction(void* parameter) {
+    Worker* worker = static_cast<Worker*>(parameter);
+    BootSequencer* self = worker->owner;
+
+    while (true) {
+        xSemaphoreTake(self->_mutex, portMAX_DELAY);
+        int index = self->take(worker->core);
+
+        if (index < 0 && self->_running == 0) {
+            // Nothing running and nothing this worker may take: done, or
+            // stuck if no other worker can take anything either
+            bool othersReady = false;
+            for (int i = 0; i < self->_stageCount && !othersReady; i++) {
+                othersReady = self->_stages[i].state == PENDING && self->_stages[i].unmet == 0;
+            }
+            if (!othersReady) {
+                self->_remaining = 0;
+            }
+        }
+
+        if (index < 0 && self->_remaining == 0) {
+            worker->handle = nullptr;
+            self->wakeWorkers();
+            xSemaphoreGive(self->_mutex);
+            break;
+        }
+        xSemaphoreGive(self->_mutex);
+
+        if (index < 0) {
+            // A notification given meanwhile is kept, no wakeup is lost
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
+        self->_stages[index].function();
+
+        xSemaphoreTake(self->_mutex, portMAX_DELAY);
+        self->complete(index);
+        self->wakeWorkers();
+        xSemaphoreGive(self->_mutex);
+    }
+
+    xSemaphoreGive(self->_finished);
+    vTaskDelete(NULL);
+}
+
+void BootSequencer::markMilestone(const char* name) {
+    uint32_t now = sinceBootUs();
+    if (_milestoneCount >= MAX_MILESTONES) {
+        return;
+    }
+    _milestones[_milestoneCount].name = name;
+    _milestones[_milestoneCount].us = now;
+    _milestoneCount++;
+    Utils::Logger::getInstance().info("Boot milestone %s at %u ms", name, now / 1000);
+}
+
+bool BootSequencer::getTiming(int index, StageTiming& out) const {
+    if (index < 0 || index >= _stageCount) {
+        return false;
+    }
+    out = _stages[index].timing;
+    return true;
+}
+
+bool BootSequencer::getMilestone(int index, Milestone& out) const {
+    if (index < 0 || index >= _milestoneCount) {
+        return false;
+    }
+    out = _milestones[index];
+    return true;
+}
+
+void BootSequencer::logTimings() const {
+    // Insertion sort by start time, the table is small
+    int order[MAX_STAGES];
+    for (int i = 0; i < _stageCount; i++) {
+        int j = i;
+        while (j > 0 && _stages[order[j - 1]].timing.startUs > _stages[i].timing.startUs) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+
+    Utils::Logger& logger = Utils::Logger::getInstance();
+    logger.info("Boot stages, %u ms for the graph:", _runUs / 1000);
+    logger.info("  %-16s %4s %8s %8s %8s", "stage", "core", "wait ms", "start ms", "took ms");
+    for (int i = 0; i < _stageCount; i++) {
+        const StageTiming& timing = _stages[order[i]].timing;
+        if (!timing.done) {
+            logger.info("  %-16s skipped", timing.name);
+            continue;
+        }
+        logger.info("  %-16s %4d %8u %8u %8u", timing.name, timing.core,
+            (timing.startUs - timing.readyUs) / 1000, timing.startUs / 1000, timing.durationUs / 1000);
+    }
+}
+
+} // namespace Utils
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+#include <initializer_list>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+namespace Utils {
+
+/**
+ * Dependency graph boot
+ *
+ * Every subsystem is a stage naming the stages it needs. run() starts a
+ * pool of workers on both cores; a stage starts as soon as everything it
+ * depends on has finished, so independent bring-up (network, speech models,
+ * sensors) overlaps instead of queueing behind each other's waits. Stages
+ * start in registration order when several are ready.
+ *
+ * Stages sharing a resource without a lock, such as an I2C bus during
+ * init, must depend on each other to stay serialized.
+ */
+class BootSequencer {
+public:
+    static const int MAX_STAGES = 48;
+    static const int MAX_DEPENDENCIES = 8;
+    static const int MAX_MILESTONES = 8;
+    static const int WORKERS_PER_CORE = 2;
+    static const int ANY_CORE = -1;
+
+    typedef std::function<void()> StageFunction;
+
+    struct StageTiming {
+        const char* name;
+        int8_t core;            // Core it ran on
+        bool done;
+        uint32_t readyUs;       // Dependencies met, since boot
+        uint32_t startUs;       // Started, since boot
+        uint32_t durationUs;
+    };
+
+    struct Milestone {
+        const char* name;
+        uint32_t us;            // Since boot
+    };
+
+    BootSequencer();
+    ~BootSequencer();
+
+    /**
+     * Register a stage before run()
+     * @param name Stage name, must stay valid, used by dependencies
+     * @param function Init work, may block
+     * @param dependencies Names of stages that must finish first
+     * @param core Core to run on, ANY_CORE for whichever worker is free
+     * @return Stage index, -1 if the table is full
+     */
+    int addStage(const char* name, StageFunction function,
+                 std::initializer_list<const char*> dependencies = {}, int core = ANY_CORE);
+
+    /**
+     * Run every stage and wait for all of them
+     * @param stackSize Worker stack, must fit the hungriest stage
+     * @param priority Worker priority
+     * @return false if a dependency is unknown or the graph has a cycle;
+     *         stages that could not run are reported and skipped
+     */
+    bool run(uint32_t stackSize = 12 * 1024, UBaseType_t priority = 5);
+
+    /**
+     * Record a point of interest, e.g. when wake word detection is live
+     */
+    void markMilestone(const char* name);
+
+    int getStageCount() const { return _stageCount; }
+    bool getTiming(int index, StageTiming& out) const;
+    int getMilestoneCount() const { return _milestoneCount; }
+    bool getMilestone(int index, Milestone& out) const;
+
+    /**
+     * Graph run time, first stage start to last stage end
+     */
+    uint32_t getRunUs() const { return _runUs; }
+
+    /**
+     * Log the per-stage timing table, ordered by start time
+     */
+    void logTimings() const;
+
+private:
+    enum State : uint8_t {
+        PENDING,
+        RUNNING,
+        DONE,
+        SKIPPED
+    };
+
+    struct Stage {
+        const char* name;
+        StageFunction function;
+        const char* dependencyNames[MAX_DEPENDENCIES];
+        int dependencies[MAX_DEPENDENCIES];
+        uint8_t dependencyCount;
+        uint8_t unmet;          // Dependencies not done yet
+        int8_t core;
+        State state;
+        StageTiming timing;
+    };
+
+    struct Worker {
+        BootSequencer* owner;
+        int core;
+        TaskHandle_t handle;
+    };
+
+    const char* TAG;
+    Stage _stages[MAX_STAGES];
+    int _stageCount;
+    Milestone _milestones[MAX_MILESTONES];
+    int _milestoneCount;
+    uint32_t _runUs;
+
+    SemaphoreHandle_t _mutex;
+    SemaphoreHandle_t _finished;
+    Worker _workers[2 * WORKERS_PER_CORE];
+    int _workerCount;
+    int _running;
+    int _remaining;
+
+    bool resolve();
+    int take(int core);
+    void complete(int index);
+    void wakeWorkers();
+    static void workerFunction(void* parameter);
+};
+
+} // namespace Utils
@@ -381,6 +381,8 @@ void CommandMapper::initCommandHandlers() {
 }
 
 bool CommandMapper::executeCommand(const Utils::Sstring& commandStr) {
+    Utils::TraceScope trace("CommandMapper::executeCommand");
+
     // Extract command and parameter using regex
     std::regex cmdRegex("\\[([A-Z_]+)(?:=([0-9msh]+))?\\]");
     std::cmatch matches;
@@ -427,6 +429,71 @@ int CommandMapper::executeCommandString(const Utils::Sstring& multiCommandStr) {
     return successCount;
 }
 
+bool CommandMapper::isValidBehavior(const char* line, size_t length) const {
+    size_t i = 0;
+    int commands = 0;
+    
+    while (i < length && line[i] == '[') {
+        size_t nameStart = ++i;
+        while (i < length && ((line[i] >= 'A' && line[i] <= 'Z') || line[i] == '_')) {
+            i++;
+        }
+        size_t nameLength = i - nameStart;
+        if (nameLength == 0) {
+            return false;
+        }
+        
+        if (i < length && line[i] == '=') {
+            size_t paramStart = ++i;
+            while (i < length && (isdigit((unsigned char)line[i]) || line[i] == 'm' || line[i] == 's' || line[i] == 'h')) {
+                i++;
+            }
+            if (i == paramStart) {
+                return false;
+            }
+        }
+        if (i >= length || line[i] != ']') {
+            return false;
+        }
+        i++;
+        
+        // Only commands this mapper can run
+        char name[32];
+        if (nameLength >= sizeof(name)) {
+            return false;
+        }
+        memcpy(name, line + nameStart, nameLength);
+        name[nameLength] = '\0';
+        if (_commandHandlers.count(String(name)) == 0) {
+            return false;
+        }
+        commands++;
+        
+        while (i < length && line[i] == ' ') {
+            i++;
+        }
+    }
+    if (commands == 0) {
+        return false;
+    }
+    
+    // Optional spoken part, closed by its second asterisk
+    if (i < length) {
+        if (line[i] != '*') {
+            return false;
+        }
+        const char* close = static_cast<const char*>(memchr(line + i + 1, '*', length - i - 1));
+        if (close == nullptr || close == line + i + 1) {
+            return false;
+        }
+        i = close - line + 1;
+        while (i < length && isspace((unsigned char)line[i])) {
+            i++;
+        }
+    }
+    return i == length;
+}
+
 Utils::Sstring CommandMapper::extractCommands(const Utils::Sstring& gptResponse) {
     // Extract all commands from GPT response
     std::regex cmdRegex("\\[([A-Z_]+)(?:=([0-9msh]+))?\\]");
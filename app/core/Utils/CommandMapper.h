@@ -25,6 +25,10 @@ public:
     // Execute a series of commands in a single string
     int executeCommandString(const Utils::Sstring& multiCommandStr);
     
+    // Check an automation behavior line: one or more known [COMMAND] or
+    // [COMMAND=PARAM], then optionally *spoken text*, nothing else
+    bool isValidBehavior(const char* line, size_t length) const;
+    
     // Extract expression commands from GPT response
     Utils::Sstring extractCommands(const Utils::Sstring& gptResponse);
     
@@ -0,0 +1,123 @@
+#include "EventBus.h"
+#include <esp_timer.h>
+#include <string.h>
+#include "Logger.h"
+
+namespace Utils {
+
+EventBus::EventBus(size_t queueLength)
+    : _queueLength(queueLength),
+      _statsMux(portMUX_INITIALIZER_UNLOCKED),
+      _stats{}
+{
+    for (size_t i = 0; i < TOPIC_COUNT; i++) {
+        _queues[i] = xQueueCreate(queueLength, sizeof(Message));
+        if (_queues[i] == nullptr) {
+            Utils::Logger::getInstance().error("EventBus: failed to create queue for %s", topicName((Topic)i));
+        }
+        _stats[i].capacity = queueLength;
+    }
+}
+
+EventBus::~EventBus() {
+    for (size_t i = 0; i < TOPIC_COUNT; i++) {
+        if (_queues[i] != nullptr) {
+            vQueueDelete(_queues[i]);
+        }
+    }
+}
+
+bool EventBus::publishRaw(Topic topic, const void* payload, size_t size) {
+    size_t index = (size_t)topic;
+    QueueHandle_t queue = _queues[index];
+    if (queue == nullptr) {
+        return false;
+    }
+
+    Message message = {};
+    memcpy(message.payload, payload, size);
+    message.publishedUs = esp_timer_get_time();
+
+    bool dropped = false;
+    if (xQueueSend(queue, &message, 0) != pdTRUE) {
+        // Full: make room by discarding the oldest event
+        Message oldest;
+        dropped = xQueueReceive(queue, &oldest, 0) == pdTRUE;
+        if (xQueueSend(queue, &message, 0) != pdTRUE) {
+            return false;
+        }
+    }
+
+    uint32_t depth = uxQueueMessagesWaiting(queue);
+    portENTER_CRITICAL(&_statsMux);
+    Stats& stats = _stats[index];
+    stats.published++;
+    if (dropped) {
+        stats.dropped++;
+    }
+    if (depth > stats.maxDepth) {
+        stats.maxDepth = depth;
+    }
+    portEXIT_CRITICAL(&_statsMux);
+    return true;
+}
+
+bool EventBus::receiveRaw(Topic topic, void* payload, size_t size, TickType_t wait) {
+    size_t index = (size_t)topic;
+    QueueHandle_t queue = _queues[index];
+    if (queue == nullptr) {
+        if (wait > 0) {
+            vTaskDelay(wait == portMAX_DELAY ? pdMS_TO_TICKS(1000) : wait);
+        }
+        return false;
+    }
+
+    Message message;
+    if (xQueueReceive(queue, &message, wait) != pdTRUE) {
+        return false;
+    }
+    memcpy(payload, message.payload, size);
+
+    uint32_t latency = (uint32_t)(esp_timer_get_time() - message.publishedUs);
+    portENTER_CRITICAL(&_statsMux);
+    Stats& stats = _stats[index];
+    stats.delivered++;
+    stats.lastLatencyUs = latency;
+    stats.totalLatencyUs += latency;
+    if (latency > stats.maxLatencyUs) {
+        stats.maxLatencyUs = latency;
+    }
+    portEXIT_CRITICAL(&_statsMux);
+    return true;
+}
+
+void EventBus::clear(Topic topic) {
+    QueueHandle_t queue = _queues[(size_t)topic];
+    if (queue != nullptr) {
+        xQueueReset(queue);
+    }
+}
+
+EventBus::Stats EventBus::getStats(Topic topic) const {
+    size_t index = (size_t)topic;
+    portENTER_CRITICAL(&_statsMux);
+    Stats stats = _stats[index];
+    portEXIT_CRITICAL(&_statsMux);
+
+    stats.depth = _queues[index] != nullptr ? uxQueueMessagesWaiting(_queues[index]) : 0;
+    return stats;
+}
+
+const char* EventBus::topicName(Topic topic) {
+    switch (topic) {
+        case Topic::DISPLAY:    return "display";
+        case Topic::SR:         return "sr";
+        case Topic::AUTOMATION: return "automation";
+        case Topic::TTS:        return "tts";
+        case Topic::AUDIO:      return "audio";
+        case Topic::NOTE:       return "note";
+        default:                return "unknown";
+    }
+}
+
+} // namespace Utils
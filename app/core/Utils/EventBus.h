@@ -0,0 +1,112 @@
+#pragma once
+
+#include <Arduino.h>
+#include <type_traits>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+namespace Utils {
+
+/**
+ * Event topics, one queue each
+ */
+enum class Topic : uint8_t {
+    DISPLAY,
+    SR,
+    AUTOMATION,
+    TTS,
+    AUDIO,
+    NOTE,
+    COUNT
+};
+
+/**
+ * Payload type of each topic, specialized next to the event definitions
+ * (see Constants.h and Note.h). Publishing or receiving a topic without a
+ * specialization does not compile.
+ */
+template<Topic T>
+struct TopicPayload;
+
+/**
+ * Typed event bus
+ *
+ * Every topic owns a FreeRTOS queue of fixed-size messages. Consumers block
+ * in receive() until an event arrives instead of polling, and each message
+ * carries its publish time so the bus can report delivery latency.
+ *
+ * A topic is meant to have a single consumer task. When its queue is full
+ * the oldest event is dropped, the newest command always gets through.
+ */
+class EventBus {
+public:
+    static const size_t PAYLOAD_SIZE = 8;
+    static const size_t TOPIC_COUNT = (size_t)Topic::COUNT;
+
+    struct Stats {
+        uint32_t published;     // Events accepted by publish()
+        uint32_t delivered;     // Events handed to a consumer
+        uint32_t dropped;       // Oldest events discarded because the queue was full
+        uint32_t depth;         // Events waiting right now
+        uint32_t maxDepth;      // Highest number of events waiting
+        uint32_t capacity;      // Queue length
+        uint32_t lastLatencyUs; // Publish to receive, last event
+        uint32_t maxLatencyUs;  // Publish to receive, worst event
+        uint64_t totalLatencyUs;
+    };
+
+    EventBus(size_t queueLength = 8);
+    ~EventBus();
+
+    /**
+     * Publish an event, never blocks
+     * @param payload Event value, type fixed by the topic
+     * @return false if the event could not be queued
+     */
+    template<Topic T>
+    bool publish(typename TopicPayload<T>::type payload) {
+        typedef typename TopicPayload<T>::type Payload;
+        static_assert(sizeof(Payload) <= PAYLOAD_SIZE, "Event payload too large");
+        static_assert(std::is_trivially_copyable<Payload>::value, "Event payload must be trivially copyable");
+        return publishRaw(T, &payload, sizeof(Payload));
+    }
+
+    /**
+     * Wait for the next event of a topic
+     * @param payload Receives the event value
+     * @param wait Ticks to block, portMAX_DELAY waits forever
+     * @return true if an event was received
+     */
+    template<Topic T>
+    bool receive(typename TopicPayload<T>::type& payload, TickType_t wait = portMAX_DELAY) {
+        return receiveRaw(T, &payload, sizeof(payload), wait);
+    }
+
+    /**
+     * Discard pending events of a topic
+     */
+    void clear(Topic topic);
+
+    /**
+     * Snapshot of the counters of a topic
+     */
+    Stats getStats(Topic topic) const;
+
+    static const char* topicName(Topic topic);
+
+private:
+    struct Message {
+        uint8_t payload[PAYLOAD_SIZE];
+        int64_t publishedUs;
+    };
+
+    QueueHandle_t _queues[TOPIC_COUNT];
+    size_t _queueLength;
+    mutable portMUX_TYPE _statsMux;
+    Stats _stats[TOPIC_COUNT];
+
+    bool publishRaw(Topic topic, const void* payload, size_t size);
+    bool receiveRaw(Topic topic, void* payload, size_t size, TickType_t wait);
+};
+
+} // namespace Utils
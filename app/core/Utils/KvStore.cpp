@@ -0,0 +1,429 @@
+#include "KvStore.h"
+#include <LittleFS.h>
+#include <esp_log.h>
+#include <esp_rom_crc.h>
+#include "SpiAllocator.h"
+
+namespace Utils {
+
+KvStore::KvStore(FileManager* fileManager, const char* path, size_t compactMinBytes)
+    : TAG("KvStore"),
+      _fileManager(fileManager),
+      _path(path),
+      _compactMinBytes(compactMinBytes),
+      _entries(nullptr),
+      _capacity(0),
+      _count(0),
+      _liveBytes(0),
+      _logBytes(0),
+      _stats{},
+      _mutex(xSemaphoreCreateMutex())
+{
+}
+
+KvStore::~KvStore() {
+    SpiRamAllocator* allocator = SpiRamAllocator::instance();
+    for (size_t i = 0; i < _capacity; i++) {
+        allocator->deallocate(_entries[i].data);
+    }
+    allocator->deallocate(_entries);
+    vSemaphoreDelete(_mutex);
+}
+
+bool KvStore::begin() {
+    uint32_t startMs = millis();
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+
+    if (!_entries && !grow()) {
+        xSemaphoreGive(_mutex);
+        ESP_LOGE(TAG, "Could not allocate the index");
+        return false;
+    }
+
+    // A compaction cut short by a reset left the old log in place
+    String tmpPath = _path + ".tmp";
+    if (_fileManager->exists(tmpPath)) {
+        if (_fileManager->exists(_path)) {
+            _fileManager->deleteFile(tmpPath);
+        } else {
+            LittleFS.rename(tmpPath, _path);
+        }
+    }
+
+    bool torn = false;
+    replay(torn);
+    if (torn) {
+        _stats.tornRecords++;
+        ESP_LOGW(TAG, "Dropped a torn record at the end of %s", _path.c_str());
+    }
+    if (torn || (_logBytes > _compactMinBytes && _logBytes > 2 * _liveBytes)) {
+        compactLocked();
+    }
+
+    _stats.loadMs = millis() - startMs;
+    xSemaphoreGive(_mutex);
+
+    ESP_LOGI(TAG, "Loaded %u keys from %u bytes in %u ms",
+             (unsigned)_count, (unsigned)_logBytes, (unsigned)_stats.loadMs);
+    return true;
+}
+
+bool KvStore::replay(bool& torn) {
+    torn = false;
+    _logBytes = 0;
+    if (!_fileManager->exists(_path)) {
+        return true;
+    }
+
+    File file = _fileManager->openFileForReading(_path);
+    if (!file) {
+        return false;
+    }
+
+    char* buffer = static_cast<char*>(malloc(MAX_KEY_LENGTH + MAX_VALUE_LENGTH));
+    if (!buffer) {
+        file.close();
+        return false;
+    }
+
+    uint8_t header[HEADER_SIZE];
+    size_t read;
+    while ((read = file.read(header, HEADER_SIZE)) > 0) {
+        size_t keyLength = header[2];
+        size_t valueLength = header[4] | (header[5] << 8);
+        uint32_t crc = header[8] | (header[9] << 8) | (header[10] << 16) | ((uint32_t)header[11] << 24);
+        uint8_t type = header[1];
+
+        if (read < HEADER_SIZE || header[0] != MAGIC || keyLength == 0 || keyLength > MAX_KEY_LENGTH ||
+            valueLength > MAX_VALUE_LENGTH || (type != TYPE_PUT && type != TYPE_REMOVE) ||
+            file.read((uint8_t*)buffer, keyLength + valueLength) != keyLength + valueLength ||
+            recordCrc(header, buffer, keyLength, buffer + keyLength, valueLength) != crc) {
+            torn = true;
+            break;
+        }
+
+        if (type == TYPE_PUT) {
+            setEntry(buffer, keyLength, buffer + keyLength, valueLength);
+        } else {
+            removeEntry(buffer, keyLength);
+        }
+        _logBytes += recordSize(keyLength, valueLength);
+    }
+
+    free(buffer);
+    file.close();
+    return true;
+}
+
+uint32_t KvStore::hash(const char* key, size_t length) {
+    // FNV-1a
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        h ^= (uint8_t)key[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+int KvStore::findBucket(uint32_t h, const char* key, size_t keyLength) const {
+    size_t mask = _capacity - 1;
+    for (size_t i = h & mask; _entries[i].data; i = (i + 1) & mask) {
+        const Entry& entry = _entries[i];
+        if (entry.hash == h && entry.keyLength == keyLength && memcmp(entry.data, key, keyLength) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool KvStore::grow() {
+    size_t capacity = _capacity ? _capacity * 2 : 32;
+    Entry* entries = static_cast<Entry*>(SpiRamAllocator::instance()->allocate(capacity * sizeof(Entry)));
+    if (!entries) {
+        return false;
+    }
+    memset(entries, 0, capacity * sizeof(Entry));
+
+    size_t mask = capacity - 1;
+    for (size_t i = 0; i < _capacity; i++) {
+        if (!_entries[i].data) {
+            continue;
+        }
+        size_t j = _entries[i].hash & mask;
+        while (entries[j].data) {
+            j = (j + 1) & mask;
+        }
+        entries[j] = _entries[i];
+    }
+
+    SpiRamAllocator::instance()->deallocate(_entries);
+    _entries = entries;
+    _capacity = capacity;
+    return true;
+}
+
+bool KvStore::setEntry(const char* key, size_t keyLength, const char* value, size_t valueLength) {
+    char* data = static_cast<char*>(SpiRamAllocator::instance()->allocate(keyLength + valueLength + 2));
+    if (!data) {
+        return false;
+    }
+    memcpy(data, key, keyLength);
+    data[keyLength] = '\0';
+    memcpy(data + keyLength + 1, value, valueLength);
+    data[keyLength + 1 + valueLength] = '\0';
+
+    uint32_t h = hash(key, keyLength);
+    int bucket = findBucket(h, key, keyLength);
+    if (bucket >= 0) {
+        Entry& entry = _entries[bucket];
+        _liveBytes -= recordSize(keyLength, entry.valueLength);
+        SpiRamAllocator::instance()->deallocate(entry.data);
+        entry.data = data;
+        entry.valueLength = valueLength;
+        _liveBytes += recordSize(keyLength, valueLength);
+        return true;
+    }
+
+    // Keep the table at most 70% full
+    if ((_count + 1) * 10 > _capacity * 7 && !grow()) {
+        SpiRamAllocator::instance()->deallocate(data);
+        return false;
+    }
+
+    size_t mask = _capacity - 1;
+    size_t i = h & mask;
+    while (_entries[i].data) {
+        i = (i + 1) & mask;
+    }
+    _entries[i] = {h, (uint8_t)keyLength, (uint16_t)valueLength, data};
+    _count++;
+    _liveBytes += recordSize(keyLength, valueLength);
+    return true;
+}
+
+bool KvStore::removeEntry(const char* key, size_t keyLength) {
+    int bucket = findBucket(hash(key, keyLength), key, keyLength);
+    if (bucket < 0) {
+        return false;
+    }
+
+    _liveBytes -= recordSize(keyLength, _entries[bucket].valueLength);
+    SpiRamAllocator::instance()->deallocate(_entries[bucket].data);
+    _count--;
+
+    // Shift later entries of the probe run back so lookups still find them
+    size_t mask = _capacity - 1;
+    size_t i = bucket;
+    size_t j = i;
+    while (true) {
+        j = (j + 1) & mask;
+        if (!_entries[j].data) {
+            break;
+        }
+        size_t home = _entries[j].hash & mask;
+        bool between = i <= j ? (home > i && home <= j) : (home > i || home <= j);
+        if (!between) {
+            _entries[i] = _entries[j];
+            i = j;
+        }
+    }
+    _entries[i] = {0, 0, 0, nullptr};
+    return true;
+}
+
+bool KvStore::get(const char* key, String& value) const {
+    size_t keyLength = strlen(key);
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    int bucket = _entries ? findBucket(hash(key, keyLength), key, keyLength) : -1;
+    if (bucket >= 0) {
+        value = _entries[bucket].data + keyLength + 1;
+    }
+    xSemaphoreGive(_mutex);
+    return bucket >= 0;
+}
+
+String KvStore::get(const char* key, const String& defaultValue) const {
+    String value;
+    if (!get(key, value)) {
+        return defaultValue;
+    }
+    return value;
+}
+
+bool KvStore::contains(const char* key) const {
+    size_t keyLength = strlen(key);
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    bool found = _entries && findBucket(hash(key, keyLength), key, keyLength) >= 0;
+    xSemaphoreGive(_mutex);
+    return found;
+}
+
+bool KvStore::put(const char* key, const String& value) {
+    size_t keyLength = strlen(key);
+    size_t valueLength = value.length();
+    if (keyLength == 0 || keyLength > MAX_KEY_LENGTH || valueLength > MAX_VALUE_LENGTH) {
+        return false;
+    }
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    if (!_entries) {
+        xSemaphoreGive(_mutex);
+        return false;
+    }
+
+    int bucket = findBucket(hash(key, keyLength), key, keyLength);
+    if (bucket >= 0 && _entries[bucket].valueLength == valueLength &&
+        memcmp(_entries[bucket].data + keyLength + 1, value.c_str(), valueLength) == 0) {
+        xSemaphoreGive(_mutex);
+        return true;
+    }
+
+    bool ok = appendRecord(TYPE_PUT, key, keyLength, value.c_str(), valueLength) &&
+              setEntry(key, keyLength, value.c_str(), valueLength);
+    if (ok) {
+        _stats.puts++;
+    }
+    if (!ok || (_logBytes > _compactMinBytes && _logBytes > 2 * _liveBytes)) {
+        // A failed append may have left a partial record, rewrite the log without it
+        compactLocked();
+    }
+    xSemaphoreGive(_mutex);
+    return ok;
+}
+
+bool KvStore::remove(const char* key) {
+    size_t keyLength = strlen(key);
+    if (keyLength == 0 || keyLength > MAX_KEY_LENGTH) {
+        return false;
+    }
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    if (!_entries || findBucket(hash(key, keyLength), key, keyLength) < 0) {
+        xSemaphoreGive(_mutex);
+        return false;
+    }
+
+    bool ok = appendRecord(TYPE_REMOVE, key, keyLength, "", 0);
+    if (ok) {
+        removeEntry(key, keyLength);
+        _stats.removes++;
+    }
+    if (!ok || (_logBytes > _compactMinBytes && _logBytes > 2 * _liveBytes)) {
+        compactLocked();
+    }
+    xSemaphoreGive(_mutex);
+    return ok;
+}
+
+void KvStore::forEach(const std::function<void(const char* key, const char* value)>& visitor) const {
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    for (size_t i = 0; i < _capacity; i++) {
+        const Entry& entry = _entries[i];
+        if (entry.data) {
+            visitor(entry.data, entry.data + entry.keyLength + 1);
+        }
+    }
+    xSemaphoreGive(_mutex);
+}
+
+void KvStore::encodeHeader(uint8_t* header, uint8_t type, const char* key, size_t keyLength,
+                           const char* value, size_t valueLength) {
+    header[0] = MAGIC;
+    header[1] = type;
+    header[2] = keyLength;
+    header[3] = 0;
+    header[4] = valueLength & 0xFF;
+    header[5] = valueLength >> 8;
+    header[6] = 0;
+    header[7] = 0;
+    uint32_t crc = recordCrc(header, key, keyLength, value, valueLength);
+    header[8] = crc & 0xFF;
+    header[9] = (crc >> 8) & 0xFF;
+    header[10] = (crc >> 16) & 0xFF;
+    header[11] = crc >> 24;
+}
+
+uint32_t KvStore::recordCrc(const uint8_t* header, const char* key, size_t keyLength,
+                            const char* value, size_t valueLength) {
+    uint32_t crc = esp_rom_crc32_le(0, header, 8);
+    crc = esp_rom_crc32_le(crc, (const uint8_t*)key, keyLength);
+    return esp_rom_crc32_le(crc, (const uint8_t*)value, valueLength);
+}
+
+bool KvStore::appendRecord(uint8_t type, const char* key, size_t keyLength, const char* value, size_t valueLength) {
+    File file = _fileManager->openFileForAppend(_path);
+    if (!file) {
+        ESP_LOGE(TAG, "Could not open %s", _path.c_str());
+        return false;
+    }
+
+    uint8_t header[HEADER_SIZE];
+    encodeHeader(header, type, key, keyLength, value, valueLength);
+    size_t written = file.write(header, HEADER_SIZE);
+    written += file.write((const uint8_t*)key, keyLength);
+    written += file.write((const uint8_t*)value, valueLength);
+    file.close();
+
+    if (written != recordSize(keyLength, valueLength)) {
+        ESP_LOGE(TAG, "Short write to %s", _path.c_str());
+        return false;
+    }
+    _logBytes += written;
+    return true;
+}
+
+bool KvStore::compact() {
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    bool ok = compactLocked();
+    xSemaphoreGive(_mutex);
+    return ok;
+}
+
+bool KvStore::compactLocked() {
+    String tmpPath = _path + ".tmp";
+    File file = _fileManager->openFileForWriting(tmpPath);
+    if (!file) {
+        ESP_LOGE(TAG, "Could not open %s", tmpPath.c_str());
+        return false;
+    }
+
+    size_t expected = 0;
+    size_t written = 0;
+    uint8_t header[HEADER_SIZE];
+    for (size_t i = 0; i < _capacity; i++) {
+        const Entry& entry = _entries[i];
+        if (!entry.data) {
+            continue;
+        }
+        const char* value = entry.data + entry.keyLength + 1;
+        encodeHeader(header, TYPE_PUT, entry.data, entry.keyLength, value, entry.valueLength);
+        written += file.write(header, HEADER_SIZE);
+        written += file.write((const uint8_t*)entry.data, entry.keyLength);
+        written += file.write((const uint8_t*)value, entry.valueLength);
+        expected += recordSize(entry.keyLength, entry.valueLength);
+    }
+    file.close();
+
+    // The old log stays in place until the new one is complete
+    if (written != expected || !LittleFS.rename(tmpPath, _path)) {
+        ESP_LOGE(TAG, "Compaction of %s failed", _path.c_str());
+        _fileManager->deleteFile(tmpPath);
+        return false;
+    }
+
+    _logBytes = written;
+    _stats.compactions++;
+    return true;
+}
+
+KvStore::Stats KvStore::getStats() const {
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    Stats stats = _stats;
+    stats.keys = _count;
+    stats.liveBytes = _liveBytes;
+    stats.logBytes = _logBytes;
+    xSemaphoreGive(_mutex);
+    return stats;
+}
+
+} // namespace Utils
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "FileManager.h"
+
+namespace Utils {
+
+/**
+ * Log-structured key-value store on LittleFS
+ *
+ * Every put or remove appends one record to the log. The whole log is
+ * replayed into a RAM hash table at boot, so a get is a hash lookup and
+ * never touches flash.
+ *
+ * Records carry a CRC32. A record is committed once it is complete on
+ * flash; a record torn by a reset fails its CRC, and replay stops there.
+ * Superseded records are dropped by compaction, which writes the live
+ * records to a temporary file and renames it over the log. Compaction
+ * runs when dead bytes outweigh live ones, or after a torn tail is found.
+ *
+ * Record: magic, type, key length, 0, value length (LE16), 0, 0, CRC32 (LE), key, value
+ */
+class KvStore {
+public:
+    static const size_t MAX_KEY_LENGTH = 64;
+    static const size_t MAX_VALUE_LENGTH = 1024;
+
+    struct Stats {
+        uint32_t keys;
+        uint32_t liveBytes;         // Records a compaction would keep
+        uint32_t logBytes;
+        uint32_t puts;
+        uint32_t removes;
+        uint32_t compactions;
+        uint32_t tornRecords;       // Records dropped at boot for a bad CRC or a short read
+        uint32_t loadMs;
+    };
+
+    /**
+     * @param compactMinBytes Log size below which dead records are kept
+     */
+    KvStore(FileManager* fileManager, const char* path, size_t compactMinBytes = 4096);
+    ~KvStore();
+
+    /**
+     * Replay the log into the index
+     * @return false if the index could not be allocated
+     */
+    bool begin();
+
+    bool get(const char* key, String& value) const;
+    String get(const char* key, const String& defaultValue) const;
+    bool contains(const char* key) const;
+
+    /**
+     * Store a value, returns once its record is on flash. Writing the
+     * value a key already has is a no-op.
+     */
+    bool put(const char* key, const String& value);
+    bool remove(const char* key);
+
+    /**
+     * Visit every key, in no particular order; the store is locked meanwhile
+     */
+    void forEach(const std::function<void(const char* key, const char* value)>& visitor) const;
+
+    size_t size() const { return _count; }
+
+    /**
+     * Rewrite the log with only the live records
+     */
+    bool compact();
+
+    Stats getStats() const;
+
+private:
+    static const uint8_t MAGIC = 0xA5;
+    static const uint8_t TYPE_PUT = 1;
+    static const uint8_t TYPE_REMOVE = 2;
+    static const size_t HEADER_SIZE = 12;
+
+    struct Entry {
+        uint32_t hash;
+        uint8_t keyLength;
+        uint16_t valueLength;
+        char* data;             // key\0value\0, nullptr when the bucket is empty
+    };
+
+    const char* TAG;
+    FileManager* _fileManager;
+    String _path;
+    size_t _compactMinBytes;
+    Entry* _entries;
+    size_t _capacity;           // Buckets, a power of two
+    size_t _count;
+    size_t _liveBytes;
+    size_t _logBytes;
+    Stats _stats;
+    SemaphoreHandle_t _mutex;
+
+    int findBucket(uint32_t hash, const char* key, size_t keyLength) const;
+    bool setEntry(const char* key, size_t keyLength, const char* value, size_t valueLength);
+    bool removeEntry(const char* key, size_t keyLength);
+    bool grow();
+
+    bool appendRecord(uint8_t type, const char* key, size_t keyLength, const char* value, size_t valueLength);
+    bool compactLocked();
+    bool replay(bool& torn);
+
+    static void encodeHeader(uint8_t* header, uint8_t type, const char* key, size_t keyLength,
+                             const char* value, size_t valueLength);
+    static uint32_t recordCrc(const uint8_t* header, const char* key, size_t keyLength,
+                              const char* value, size_t valueLength);
+    static size_t recordSize(size_t keyLength, size_t valueLength) { return HEADER_SIZE + keyLength + valueLength; }
+    static uint32_t hash(const char* key, size_t length);
+};
+
+} // namespace Utils
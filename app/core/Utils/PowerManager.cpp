@@ -0,0 +1,239 @@
+#include "PowerManager.h"
+#include <esp_timer.h>
+#include <esp_freertos_hooks.h>
+#include "Logger.h"
+
+namespace Utils {
+
+// Frequency ranges per profile, indexed by PowerProfile
+static const PowerManager::ProfileConfig PROFILE_CONFIGS[] = {
+    { 240, 240, false },    // ACTIVE: speech recognition needs the full clock
+    { 160, 40, true },      // IDLE: scale down, sleep between wakeups
+    { 80, 40, true },       // DOCKED: housekeeping only
+};
+
+// Display frame period per profile
+static const uint32_t FRAME_PERIOD_MS[] = { 50, 100, 200 };
+
+std::atomic<uint32_t> PowerManager::_idleLoops[2];
+
+PowerManager::PowerManager(Scheduler* scheduler, unsigned long idleTimeoutMs)
+    : TAG("PowerManager"),
+      _scheduler(scheduler),
+      _profile(PowerProfile::ACTIVE),
+      _automatic(true),
+      _lastActivity(0),
+      _idleTimeoutMs(idleTimeoutMs),
+      _hooksInstalled(false),
+      _listening(false),
+#if CONFIG_PM_ENABLE
+      _cpuLock(nullptr),
+      _cpuLockHeld(false),
+#endif
+      _lastSampleUs(0),
+      _lastIdleLoops{},
+      _lastSchedulerWakeups(0),
+      _lastIdleRunTime{},
+      _statsMux(portMUX_INITIALIZER_UNLOCKED),
+      _stats{}
+{
+    _stats.cpuIdlePercent[0] = -1;
+    _stats.cpuIdlePercent[1] = -1;
+}
+
+PowerManager::~PowerManager() {
+    if (_hooksInstalled) {
+        esp_deregister_freertos_idle_hook_for_cpu(idleHookCore0, 0);
+#if portNUM_PROCESSORS > 1
+        esp_deregister_freertos_idle_hook_for_cpu(idleHookCore1, 1);
+#endif
+    }
+#if CONFIG_PM_ENABLE
+    if (_cpuLock) {
+        if (_cpuLockHeld) {
+            esp_pm_lock_release(_cpuLock);
+        }
+        esp_pm_lock_delete(_cpuLock);
+    }
+#endif
+}
+
+bool PowerManager::begin(PowerProfile initial) {
+    // The idle task loops once per wakeup: count loops to count wakeups
+    _hooksInstalled = esp_register_freertos_idle_hook_for_cpu(idleHookCore0, 0) == ESP_OK;
+#if portNUM_PROCESSORS > 1
+    _hooksInstalled = esp_register_freertos_idle_hook_for_cpu(idleHookCore1, 1) == ESP_OK && _hooksInstalled;
+#endif
+
+#if CONFIG_PM_ENABLE
+    if (esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "profile", &_cpuLock) != ESP_OK) {
+        _cpuLock = nullptr;
+    }
+#endif
+
+    _lastActivity = millis();
+    _lastSampleUs = esp_timer_get_time();
+    apply(initial);
+    return _hooksInstalled;
+}
+
+void PowerManager::setProfile(PowerProfile profile) {
+    _automatic = false;
+    apply(profile);
+}
+
+void PowerManager::setListening(bool listening) {
+    if (listening == _listening) {
+        return;
+    }
+    _listening = listening;
+    apply(_profile);
+}
+
+void PowerManager::update() {
+    if (_automatic) {
+        PowerProfile wanted = selectProfile();
+        if (wanted != _profile) {
+            apply(wanted);
+        }
+    }
+    sample();
+}
+
+PowerProfile PowerManager::selectProfile() const {
+    if (_isDocked && _isDocked()) {
+        return PowerProfile::DOCKED;
+    }
+    if ((_isBusy && _isBusy()) || millis() - _lastActivity < _idleTimeoutMs) {
+        return PowerProfile::ACTIVE;
+    }
+    return PowerProfile::IDLE;
+}
+
+void PowerManager::apply(PowerProfile profile) {
+    ProfileConfig config = profileConfig(profile);
+    bool listening = _listening;
+    if (listening) {
+        // Pinned to the clock of the active profile, the lock below holds it
+        config.maxMhz = config.minMhz = profileConfig(PowerProfile::ACTIVE).maxMhz;
+        config.lightSleep = false;
+    }
+    bool dfs = false;
+    bool tickless = false;
+
+#if CONFIG_PM_ENABLE
+    esp_pm_config_t pm = {};
+    pm.max_freq_mhz = config.maxMhz;
+    pm.min_freq_mhz = config.minMhz;
+#if CONFIG_FREERTOS_USE_TICKLESS_IDLE
+    pm.light_sleep_enable = config.lightSleep;
+    tickless = true;
+#endif
+    dfs = esp_pm_configure(&pm) == ESP_OK;
+
+    // Full clock while active or listening, the governor may scale down otherwise
+    if (_cpuLock) {
+        if (config.maxMhz == config.minMhz && !_cpuLockHeld) {
+            _cpuLockHeld = esp_pm_lock_acquire(_cpuLock) == ESP_OK;
+        } else if (config.maxMhz != config.minMhz && _cpuLockHeld) {
+            esp_pm_lock_release(_cpuLock);
+            _cpuLockHeld = false;
+        }
+    }
+#endif
+
+    if (!dfs) {
+        setCpuFrequencyMhz(config.maxMhz);
+    }
+
+    if (_scheduler) {
+        _scheduler->setProfile(profile);
+    }
+
+    PowerProfile previous = _profile;
+    _profile = profile;
+
+    portENTER_CRITICAL(&_statsMux);
+    _stats.dfs = dfs;
+    _stats.tickless = tickless;
+    _stats.listening = listening;
+    if (previous != profile) {
+        _stats.profileChanges++;
+    }
+    portEXIT_CRITICAL(&_statsMux);
+
+    Utils::Logger::getInstance().info("PowerManager: %s profile, %u-%u MHz%s%s%s",
+        Scheduler::profileName(profile), config.minMhz, config.maxMhz,
+        dfs ? " (DFS)" : "", tickless && config.lightSleep ? ", light sleep" : "",
+        listening ? ", listening" : "");
+}
+
+void PowerManager::sample() {
+    int64_t now = esp_timer_get_time();
+    float seconds = (now - _lastSampleUs) / 1e6f;
+    if (seconds <= 0) {
+        return;
+    }
+
+    Stats stats = getStats();
+    for (int core = 0; core < portNUM_PROCESSORS && core < 2; core++) {
+        uint32_t loops = _idleLoops[core].load(std::memory_order_relaxed);
+        stats.wakeupsPerSecond[core] = (loops - _lastIdleLoops[core]) / seconds;
+        _lastIdleLoops[core] = loops;
+
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+        // Run time counter ticks in microseconds (esp_timer)
+        uint64_t idleTime = ulTaskGetRunTimeCounter(xTaskGetIdleTaskHandleForCore(core));
+        uint64_t idleDelta = (uint32_t)(idleTime - _lastIdleRunTime[core]);
+        _lastIdleRunTime[core] = idleTime;
+        float percent = idleDelta * 100.0f / (now - _lastSampleUs);
+        stats.cpuIdlePercent[core] = percent > 100.0f ? 100.0f : percent;
+#endif
+    }
+
+    if (_scheduler) {
+        uint32_t wakeups = _scheduler->getStats().wakeups;
+        stats.schedulerWakeupsPerSecond = (wakeups - _lastSchedulerWakeups) / seconds;
+        _lastSchedulerWakeups = wakeups;
+    }
+    _lastSampleUs = now;
+
+    portENTER_CRITICAL(&_statsMux);
+    for (int core = 0; core < 2; core++) {
+        _stats.wakeupsPerSecond[core] = stats.wakeupsPerSecond[core];
+        _stats.cpuIdlePercent[core] = stats.cpuIdlePercent[core];
+    }
+    _stats.schedulerWakeupsPerSecond = stats.schedulerWakeupsPerSecond;
+    portEXIT_CRITICAL(&_statsMux);
+}
+
+PowerManager::Stats PowerManager::getStats() const {
+    portENTER_CRITICAL(&_statsMux);
+    Stats stats = _stats;
+    portEXIT_CRITICAL(&_statsMux);
+    return stats;
+}
+
+uint32_t PowerManager::getFramePeriodMs() const {
+    return FRAME_PERIOD_MS[(size_t)_profile];
+}
+
+const PowerManager::ProfileConfig& PowerManager::profileConfig(PowerProfile profile) {
+    size_t index = (size_t)profile;
+    if (index >= sizeof(PROFILE_CONFIGS) / sizeof(PROFILE_CONFIGS[0])) {
+        index = 0;
+    }
+    return PROFILE_CONFIGS[index];
+}
+
+bool PowerManager::idleHookCore0() {
+    _idleLoops[0].fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool PowerManager::idleHookCore1() {
+    _idleLoops[1].fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+} // namespace Utils
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include <functional>
+#include "Scheduler.h"
+
+#if CONFIG_PM_ENABLE
+#include <esp_pm.h>
+#endif
+
+namespace Utils {
+
+/**
+ * Power profile selection and CPU load accounting
+ *
+ * A profile sets the periodic job rates of the scheduler, the CPU frequency
+ * range for dynamic frequency scaling and whether FreeRTOS may enter light
+ * sleep when idle. Light sleep needs tickless idle in the sdkconfig; without
+ * CONFIG_PM_ENABLE the profile only sets a fixed CPU frequency.
+ *
+ * In automatic mode the profile follows the robot: docked while charging,
+ * active while automation runs or after recent activity, idle otherwise.
+ * While speech recognition listens for the wake word every profile keeps
+ * the full clock without light sleep, only the job rates change.
+ */
+class PowerManager {
+public:
+    struct ProfileConfig {
+        uint16_t maxMhz;
+        uint16_t minMhz;
+        bool lightSleep;
+    };
+
+    struct Stats {
+        float wakeupsPerSecond[2];  // Idle task exits per core, each one a CPU wakeup
+        float cpuIdlePercent[2];    // -1 when run time stats are unavailable
+        float schedulerWakeupsPerSecond;
+        uint32_t profileChanges;
+        bool dfs;                   // Dynamic frequency scaling configured
+        bool tickless;              // Tickless idle available
+        bool listening;             // Full clock held for speech recognition
+    };
+
+    /**
+     * @param scheduler Scheduler whose job rates follow the profile
+     * @param idleTimeoutMs Time without activity before switching to idle
+     */
+    PowerManager(Scheduler* scheduler, unsigned long idleTimeoutMs = 60000);
+    ~PowerManager();
+
+    /**
+     * Install idle hooks and apply the initial profile
+     */
+    bool begin(PowerProfile initial = PowerProfile::ACTIVE);
+
+    /**
+     * Force a profile, disables automatic selection
+     */
+    void setProfile(PowerProfile profile);
+
+    /**
+     * Let update() choose the profile again
+     */
+    void setAutomatic(bool automatic) { _automatic = automatic; }
+    bool isAutomatic() const { return _automatic; }
+
+    /**
+     * Automatic selection inputs
+     * @param docked Returns true while the robot is charging
+     * @param busy Returns true while the robot is doing something on its own
+     */
+    void setConditions(std::function<bool()> docked, std::function<bool()> busy) {
+        _isDocked = docked;
+        _isBusy = busy;
+    }
+
+    PowerProfile getProfile() const { return _profile; }
+
+    /**
+     * Something happened that needs full responsiveness (voice, touch, web)
+     */
+    void noteActivity() { _lastActivity = millis(); }
+
+    /**
+     * Speech recognition started or stopped listening, it needs the full
+     * clock to keep up with the microphone in any profile
+     */
+    void setListening(bool listening);
+
+    /**
+     * Pick the automatic profile and sample the load counters, called
+     * periodically by the scheduler
+     */
+    void update();
+
+    Stats getStats() const;
+
+    /**
+     * Display frame period for the current profile
+     */
+    uint32_t getFramePeriodMs() const;
+
+    static const ProfileConfig& profileConfig(PowerProfile profile);
+
+private:
+    const char* TAG;
+    Scheduler* _scheduler;
+    PowerProfile _profile;
+    volatile bool _automatic;
+    volatile unsigned long _lastActivity;
+    unsigned long _idleTimeoutMs;
+    std::function<bool()> _isDocked;
+    std::function<bool()> _isBusy;
+    bool _hooksInstalled;
+    volatile bool _listening;
+
+#if CONFIG_PM_ENABLE
+    esp_pm_lock_handle_t _cpuLock;  // Held in the active profile
+    bool _cpuLockHeld;
+#endif
+
+    // Sampling window
+    int64_t _lastSampleUs;
+    uint32_t _lastIdleLoops[2];
+    uint32_t _lastSchedulerWakeups;
+    uint64_t _lastIdleRunTime[2];
+
+    mutable portMUX_TYPE _statsMux;
+    Stats _stats;
+
+    static std::atomic<uint32_t> _idleLoops[2];
+    static bool idleHookCore0();
+    static bool idleHookCore1();
+
+    void apply(PowerProfile profile);
+    PowerProfile selectProfile() const;
+    void sample();
+};
+
+} // namespace Utils
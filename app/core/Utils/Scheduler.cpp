@@ -0,0 +1,331 @@
+#include "Scheduler.h"
+#include <esp_timer.h>
+#include "Logger.h"
+
+namespace Utils {
+
+Scheduler::Scheduler(uint32_t resolutionMs)
+    : TAG("Scheduler"),
+      _resolutionMs(resolutionMs > 0 ? resolutionMs : 1),
+      _taskHandle(nullptr),
+      _mutex(xSemaphoreCreateMutex()),
+      _statsMux(portMUX_INITIALIZER_UNLOCKED),
+      _jobCount(0),
+      _wheel{},
+      _currentTick(0),
+      _startUs(esp_timer_get_time()),
+      _profile(PowerProfile::ACTIVE),
+      _stats{}
+{
+}
+
+Scheduler::~Scheduler() {
+    stop();
+    if (_mutex) {
+        vSemaphoreDelete(_mutex);
+    }
+}
+
+int Scheduler::addJob(const char* name, JobFunction function, const Rates& rates, uint32_t slackMs) {
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    if (_jobCount >= MAX_JOBS) {
+        xSemaphoreGive(_mutex);
+        Utils::Logger::getInstance().error("Scheduler: no room for job %s", name);
+        return -1;
+    }
+
+    int id = _jobCount++;
+    Job* job = &_jobs[id];
+    job->name = name;
+    job->function = function;
+    job->rates = rates;
+    job->slackTicks = slackMs / _resolutionMs;
+    job->running = false;
+    job->slotTick = 0;
+    job->next = nullptr;
+    job->stats = {};
+    job->stats.name = name;
+
+    uint32_t periodMs = rates.get(_profile);
+    job->periodTicks = periodMs > 0 ? (periodMs + _resolutionMs - 1) / _resolutionMs : 0;
+    job->stats.periodMs = periodMs;
+    if (job->periodTicks > 0) {
+        job->dueTick = _currentTick + job->periodTicks;
+        insert(job, job->dueTick);
+    }
+    xSemaphoreGive(_mutex);
+
+    portENTER_CRITICAL(&_statsMux);
+    _stats.jobCount = _jobCount;
+    portEXIT_CRITICAL(&_statsMux);
+
+    if (_taskHandle) {
+        xTaskNotifyGive(_taskHandle);
+    }
+    return id;
+}
+
+bool Scheduler::start(int core, UBaseType_t priority, uint32_t stackSize) {
+    if (_taskHandle != nullptr) {
+        return true;
+    }
+
+    BaseType_t result = xTaskCreatePinnedToCore(
+        taskFunction,
+        "Scheduler",
+        stackSize,
+        this,
+        priority,
+        &_taskHandle,
+        core
+    );
+
+    if (result != pdPASS) {
+        _taskHandle = nullptr;
+        Utils::Logger::getInstance().error("Scheduler: failed to create task");
+        return false;
+    }
+
+    Utils::Logger::getInstance().info("Scheduler: started with %d jobs, %u ms resolution", _jobCount, _resolutionMs);
+    return true;
+}
+
+void Scheduler::stop() {
+    if (_taskHandle != nullptr) {
+        vTaskDelete(_taskHandle);
+        _taskHandle = nullptr;
+    }
+}
+
+void Scheduler::setProfile(PowerProfile profile) {
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    _profile = profile;
+
+    for (int i = 0; i < WHEEL_SLOTS; i++) {
+        _wheel[i] = nullptr;
+    }
+
+    for (int i = 0; i < _jobCount; i++) {
+        Job* job = &_jobs[i];
+        uint32_t periodMs = job->rates.get(profile);
+        job->periodTicks = periodMs > 0 ? (periodMs + _resolutionMs - 1) / _resolutionMs : 0;
+        job->dueTick = _currentTick + job->periodTicks;
+        job->slotTick = job->dueTick;
+        job->next = nullptr;
+
+        portENTER_CRITICAL(&_statsMux);
+        job->stats.periodMs = periodMs;
+        portEXIT_CRITICAL(&_statsMux);
+    }
+
+    // A running job is put back by reschedule() with its new period
+    for (int i = 0; i < _jobCount; i++) {
+        Job* job = &_jobs[i];
+        if (job->periodTicks > 0 && !job->running) {
+            insert(job, job->dueTick);
+        }
+    }
+    xSemaphoreGive(_mutex);
+
+    if (_taskHandle) {
+        xTaskNotifyGive(_taskHandle);
+    }
+}
+
+Scheduler::Stats Scheduler::getStats() const {
+    portENTER_CRITICAL(&_statsMux);
+    Stats stats = _stats;
+    portEXIT_CRITICAL(&_statsMux);
+    return stats;
+}
+
+bool Scheduler::getJobStats(int id, JobStats& out) const {
+    if (id < 0 || id >= _jobCount) {
+        return false;
+    }
+    portENTER_CRITICAL(&_statsMux);
+    out = _jobs[id].stats;
+    portEXIT_CRITICAL(&_statsMux);
+    return true;
+}
+
+const char* Scheduler::profileName(PowerProfile profile) {
+    switch (profile) {
+        case PowerProfile::ACTIVE: return "active";
+        case PowerProfile::IDLE:   return "idle";
+        case PowerProfile::DOCKED: return "docked";
+        default:                   return "unknown";
+    }
+}
+
+void Scheduler::taskFunction(void* parameter) {
+    Scheduler* self = static_cast<Scheduler*>(parameter);
+    self->run();
+}
+
+uint32_t Scheduler::nowTick() const {
+    return (uint32_t)((esp_timer_get_time() - _startUs) / (_resolutionMs * 1000));
+}
+
+void Scheduler::run() {
+    while (true) {
+        uint32_t target;
+        xSemaphoreTake(_mutex, portMAX_DELAY);
+        bool pending = nextDueTick(target);
+        xSemaphoreGive(_mutex);
+
+        // Sleep until the next occupied slot, or until jobs or the profile change
+        TickType_t wait = portMAX_DELAY;
+        if (pending) {
+            int64_t remainingUs = _startUs + (int64_t)target * _resolutionMs * 1000 - esp_timer_get_time();
+            wait = remainingUs > 0 ? pdMS_TO_TICKS((remainingUs + 999) / 1000) : 0;
+            if (remainingUs > 0 && wait == 0) {
+                wait = 1;
+            }
+        }
+        if (wait > 0) {
+            ulTaskNotifyTake(pdTRUE, wait);
+        }
+
+        portENTER_CRITICAL(&_statsMux);
+        _stats.wakeups++;
+        portEXIT_CRITICAL(&_statsMux);
+
+        uint32_t now = nowTick();
+        while ((int32_t)(now - _currentTick) > 0) {
+            processTick(_currentTick + 1);
+        }
+    }
+}
+
+bool Scheduler::nextDueTick(uint32_t& tick) const {
+    bool occupied = false;
+    for (uint32_t delta = 1; delta <= WHEEL_SLOTS; delta++) {
+        uint32_t candidate = _currentTick + delta;
+        for (Job* job = _wheel[candidate % WHEEL_SLOTS]; job; job = job->next) {
+            occupied = true;
+            if (job->rounds == 0) {
+                tick = candidate;
+                return true;
+            }
+        }
+    }
+
+    // Only far away jobs: one revolution to count their rounds down
+    if (occupied) {
+        tick = _currentTick + WHEEL_SLOTS;
+        return true;
+    }
+    return false;
+}
+
+void Scheduler::insert(Job* job, uint32_t dueTick) {
+    if ((int32_t)(dueTick - _currentTick) < 1) {
+        dueTick = _currentTick + 1;
+    }
+
+    // Prefer a slot inside the slack window where another job wakes up
+    // anyway, either already placed there or due there by its period
+    uint32_t target = dueTick;
+    for (uint32_t t = dueTick; t <= dueTick + job->slackTicks; t++) {
+        if (wakesAt(job, t)) {
+            target = t;
+            break;
+        }
+    }
+
+    if (target != dueTick) {
+        portENTER_CRITICAL(&_statsMux);
+        _stats.coalesced++;
+        portEXIT_CRITICAL(&_statsMux);
+    }
+
+    uint32_t slot = target % WHEEL_SLOTS;
+    job->slotTick = target;
+    job->rounds = (target - _currentTick - 1) / WHEEL_SLOTS;
+    job->next = _wheel[slot];
+    _wheel[slot] = job;
+}
+
+bool Scheduler::wakesAt(const Job* job, uint32_t tick) const {
+    for (int i = 0; i < _jobCount; i++) {
+        const Job* other = &_jobs[i];
+        if (other == job || other->periodTicks == 0) {
+            continue;
+        }
+        if (!other->running && other->slotTick == tick) {
+            return true;
+        }
+        int32_t offset = (int32_t)(tick - other->dueTick);
+        if (offset > 0 && offset % other->periodTicks == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Scheduler::processTick(uint32_t tick) {
+    Job* due[MAX_JOBS];
+    int dueCount = 0;
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    _currentTick = tick;
+    Job** link = &_wheel[tick % WHEEL_SLOTS];
+    while (*link) {
+        Job* job = *link;
+        if (job->rounds > 0) {
+            job->rounds--;
+            link = &job->next;
+            continue;
+        }
+        *link = job->next;
+        job->next = nullptr;
+        job->running = true;
+        due[dueCount++] = job;
+    }
+    xSemaphoreGive(_mutex);
+
+    // Run without the lock, jobs may add jobs or change the profile
+    for (int i = 0; i < dueCount; i++) {
+        Job* job = due[i];
+        int64_t startUs = esp_timer_get_time();
+        job->function();
+        int64_t endUs = esp_timer_get_time();
+
+        int64_t nominalUs = _startUs + (int64_t)job->dueTick * _resolutionMs * 1000;
+        uint32_t lateUs = startUs > nominalUs ? (uint32_t)(startUs - nominalUs) : 0;
+        uint32_t runUs = (uint32_t)(endUs - startUs);
+        // One tick of timer granularity on top of the slack
+        bool missed = lateUs > (job->slackTicks + 1) * _resolutionMs * 1000;
+
+        portENTER_CRITICAL(&_statsMux);
+        job->stats.runs++;
+        if (runUs > job->stats.maxRunUs) job->stats.maxRunUs = runUs;
+        if (lateUs > job->stats.maxLateUs) job->stats.maxLateUs = lateUs;
+        if (missed) job->stats.misses++;
+        _stats.runs++;
+        portEXIT_CRITICAL(&_statsMux);
+
+        xSemaphoreTake(_mutex, portMAX_DELAY);
+        job->running = false;
+        reschedule(job);
+        xSemaphoreGive(_mutex);
+    }
+}
+
+void Scheduler::reschedule(Job* job) {
+    if (job->periodTicks == 0) {
+        return;
+    }
+
+    // Keep the phase of the nominal deadline so coalescing does not drift,
+    // skip periods that were missed entirely
+    uint32_t due = job->dueTick + job->periodTicks;
+    if ((int32_t)(due - _currentTick) < 1) {
+        due = _currentTick + job->periodTicks;
+    }
+    job->dueTick = due;
+    insert(job, due);
+}
+
+} // namespace Utils
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+namespace Utils {
+
+/**
+ * Power profile, selects which period every periodic job runs at
+ */
+enum class PowerProfile : uint8_t {
+    ACTIVE,     // Moving or talking, full rates
+    IDLE,       // Nobody around, reduced rates
+    DOCKED,     // Charging, housekeeping only
+    COUNT
+};
+
+/**
+ * Cooperative periodic job scheduler
+ *
+ * Runs every periodic job from one task on a hashed timer wheel. Each job
+ * may run up to its slack late; a deadline that falls within the slack of a
+ * slot already holding another job is moved onto that slot, so jobs with
+ * unrelated periods share wakeups instead of each waking the CPU.
+ *
+ * Jobs run one after another on the scheduler task and must not block.
+ */
+class Scheduler {
+public:
+    static const int MAX_JOBS = 16;
+    static const int WHEEL_SLOTS = 64;
+
+    typedef std::function<void()> JobFunction;
+
+    /**
+     * Job period per power profile in milliseconds, 0 disables the job
+     */
+    struct Rates {
+        uint32_t activeMs;
+        uint32_t idleMs;
+        uint32_t dockedMs;
+
+        uint32_t get(PowerProfile profile) const {
+            switch (profile) {
+                case PowerProfile::IDLE:   return idleMs;
+                case PowerProfile::DOCKED: return dockedMs;
+                default:                   return activeMs;
+            }
+        }
+    };
+
+    struct JobStats {
+        const char* name;
+        uint32_t periodMs;      // Period in the current profile, 0 = disabled
+        uint32_t runs;
+        uint32_t maxRunUs;      // Longest single run
+        uint32_t maxLateUs;     // Worst start delay behind the nominal deadline
+        uint32_t misses;        // Runs that started later than their slack allows
+    };
+
+    struct Stats {
+        uint32_t wakeups;       // Scheduler task wakeups
+        uint32_t runs;          // Jobs run
+        uint32_t coalesced;     // Deadlines moved onto an already used slot
+        uint32_t jobCount;
+    };
+
+    Scheduler(uint32_t resolutionMs = 10);
+    ~Scheduler();
+
+    /**
+     * Register a periodic job, before or after start()
+     * @param name Job name, must stay valid
+     * @param function Work to run, must not block
+     * @param rates Period per power profile
+     * @param slackMs How late the job may run so it can share a wakeup
+     * @return Job id, -1 if the table is full
+     */
+    int addJob(const char* name, JobFunction function, const Rates& rates, uint32_t slackMs = 0);
+
+    /**
+     * Start the scheduler task
+     */
+    bool start(int core = 0, UBaseType_t priority = 5, uint32_t stackSize = 6 * 1024);
+    void stop();
+
+    /**
+     * Switch every job to the periods of a profile
+     */
+    void setProfile(PowerProfile profile);
+    PowerProfile getProfile() const { return _profile; }
+
+    Stats getStats() const;
+    bool getJobStats(int id, JobStats& out) const;
+    int getJobCount() const { return _jobCount; }
+
+    static const char* profileName(PowerProfile profile);
+
+private:
+    struct Job {
+        const char* name;
+        JobFunction function;
+        Rates rates;
+        uint32_t slackTicks;
+        uint32_t periodTicks;   // Current profile, 0 = disabled
+        uint32_t dueTick;       // Nominal deadline, before coalescing
+        uint32_t slotTick;      // Tick it is placed at, after coalescing
+        uint32_t rounds;        // Wheel revolutions left before it is due
+        bool running;           // Taken off the wheel while its function runs
+        Job* next;
+        JobStats stats;
+    };
+
+    const char* TAG;
+    uint32_t _resolutionMs;
+    TaskHandle_t _taskHandle;
+    SemaphoreHandle_t _mutex;
+    mutable portMUX_TYPE _statsMux;
+
+    Job _jobs[MAX_JOBS];
+    int _jobCount;
+    Job* _wheel[WHEEL_SLOTS];
+    uint32_t _currentTick;      // Last processed wheel tick
+    int64_t _startUs;
+    PowerProfile _profile;
+    Stats _stats;
+
+    static void taskFunction(void* parameter);
+    void run();
+    uint32_t nowTick() const;
+    void insert(Job* job, uint32_t dueTick);
+    bool wakesAt(const Job* job, uint32_t tick) const;
+    bool nextDueTick(uint32_t& tick) const;
+    void processTick(uint32_t tick);
+    void reschedule(Job* job);
+};
+
+} // namespace Utils
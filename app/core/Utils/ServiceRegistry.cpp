@@ -0,0 +1,175 @@
+#include "ServiceRegistry.h"
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include <string.h>
+#include "Logger.h"
+
+namespace Utils {
+
+ServiceRegistry::ServiceRegistry()
+    : TAG("ServiceRegistry"),
+      _mutex(xSemaphoreCreateMutex()),
+      _serviceCount(0)
+{
+}
+
+ServiceRegistry::~ServiceRegistry() {
+    for (int i = 0; i < _serviceCount; i++) {
+        if (_services[i].stats.resident && _services[i].destroy) {
+            _services[i].destroy();
+        }
+    }
+    if (_mutex) {
+        vSemaphoreDelete(_mutex);
+    }
+}
+
+int ServiceRegistry::add(const char* name, CreateFunction create, DestroyFunction destroy,
+                         uint32_t idleTimeoutMs, BusyFunction busy) {
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    if (_serviceCount >= MAX_SERVICES) {
+        xSemaphoreGive(_mutex);
+        Utils::Logger::getInstance().error("%s: cannot add service %s", TAG, name);
+        return -1;
+    }
+
+    Service& service = _services[_serviceCount];
+    service.name = name;
+    service.create = create;
+    service.destroy = destroy;
+    service.busy = busy;
+    service.released = false;
+    service.lastUseMs = 0;
+    service.stats = {};
+    service.stats.name = name;
+    service.stats.idleTimeoutMs = idleTimeoutMs;
+    int id = _serviceCount++;
+    xSemaphoreGive(_mutex);
+    return id;
+}
+
+int ServiceRegistry::find(const char* name) const {
+    if (name == nullptr) {
+        return -1;
+    }
+    for (int i = 0; i < _serviceCount; i++) {
+        if (strcmp(_services[i].name, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool ServiceRegistry::acquire(int id) {
+    if (id < 0 || id >= _serviceCount) {
+        return false;
+    }
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    Service& service = _services[id];
+    service.lastUseMs = millis();
+    service.released = false;
+
+    if (!service.stats.resident) {
+        // Heap deltas are approximate, other tasks allocate meanwhile
+        size_t internalBefore = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+        size_t psramBefore = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+        int64_t startUs = esp_timer_get_time();
+
+        bool created = service.create && service.create();
+
+        service.stats.createUs = (uint32_t)(esp_timer_get_time() - startUs);
+        if (created) {
+            service.stats.resident = true;
+            service.stats.creates++;
+            service.stats.internalBytes = (int32_t)internalBefore - (int32_t)heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+            service.stats.psramBytes = (int32_t)psramBefore - (int32_t)heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+            Utils::Logger::getInstance().info("%s: %s started in %u ms", TAG, service.name,
+                service.stats.createUs / 1000);
+        } else {
+            service.stats.failures++;
+            Utils::Logger::getInstance().error("%s: %s failed to start", TAG, service.name);
+        }
+    }
+
+    bool resident = service.stats.resident;
+    xSemaphoreGive(_mutex);
+    return resident;
+}
+
+void ServiceRegistry::release(int id) {
+    if (id < 0 || id >= _serviceCount) {
+        return;
+    }
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    if (_services[id].stats.resident) {
+        _services[id].released = true;
+    }
+    xSemaphoreGive(_mutex);
+}
+
+bool ServiceRegistry::isResident(int id) const {
+    if (id < 0 || id >= _serviceCount) {
+        return false;
+    }
+    return _services[id].stats.resident;
+}
+
+int ServiceRegistry::collect() {
+    int collected = 0;
+    uint32_t now = millis();
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    for (int i = 0; i < _serviceCount; i++) {
+        Service& service = _services[i];
+        if (!service.stats.resident) {
+            continue;
+        }
+        if (service.busy && service.busy()) {
+            service.lastUseMs = now;
+            service.released = false;
+            continue;
+        }
+
+        bool idle = service.stats.idleTimeoutMs > 0 && now - service.lastUseMs >= service.stats.idleTimeoutMs;
+        if (!idle && !service.released) {
+            continue;
+        }
+
+        if (service.destroy) {
+            service.destroy();
+        }
+        service.stats.resident = false;
+        service.stats.destroys++;
+        service.released = false;
+        collected++;
+        Utils::Logger::getInstance().info("%s: %s stopped after %u ms unused", TAG, service.name,
+            now - service.lastUseMs);
+    }
+    xSemaphoreGive(_mutex);
+
+    return collected;
+}
+
+int ServiceRegistry::getResidentCount() const {
+    int count = 0;
+    for (int i = 0; i < _serviceCount; i++) {
+        if (_services[i].stats.resident) {
+            count++;
+        }
+    }
+    return count;
+}
+
+bool ServiceRegistry::getStats(int id, ServiceStats& out) const {
+    if (id < 0 || id >= _serviceCount) {
+        return false;
+    }
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    out = _services[id].stats;
+    out.idleMs = out.resident ? millis() - _services[id].lastUseMs : 0;
+    xSemaphoreGive(_mutex);
+    return true;
+}
+
+} // namespace Utils
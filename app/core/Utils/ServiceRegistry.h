@@ -0,0 +1,106 @@
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+namespace Utils {
+
+/**
+ * Lazily constructed, idle collected services
+ *
+ * Rarely used subsystems register a create and a destroy function instead
+ * of being built at boot. acquire() builds a service on first use and
+ * marks it used; collect(), run periodically, tears down every service
+ * unused for longer than its idle timeout so its memory returns to the
+ * heap until the next use.
+ *
+ * Teardown only happens inside collect(), so a service is never destroyed
+ * under the task that collects. Users on other tasks must acquire() before
+ * each use; a busy predicate keeps a service resident while it is in use.
+ */
+class ServiceRegistry {
+public:
+    static const int MAX_SERVICES = 8;
+
+    typedef std::function<bool()> CreateFunction;
+    typedef std::function<void()> DestroyFunction;
+    typedef std::function<bool()> BusyFunction;
+
+    struct ServiceStats {
+        const char* name;
+        bool resident;
+        uint32_t idleTimeoutMs;     // 0 = stays once created
+        uint32_t idleMs;            // Since last use, 0 when not resident
+        uint32_t creates;
+        uint32_t destroys;
+        uint32_t failures;          // Create functions that returned false
+        uint32_t createUs;          // Last construction time
+        int32_t internalBytes;      // Internal heap taken by the last construction
+        int32_t psramBytes;         // PSRAM taken by the last construction
+    };
+
+    ServiceRegistry();
+    ~ServiceRegistry();
+
+    /**
+     * Register a service, nothing is constructed yet
+     * @param name Service name, must stay valid
+     * @param create Builds the service, false on failure
+     * @param destroy Releases everything create built
+     * @param idleTimeoutMs Unused time before teardown, 0 never tears down
+     * @param busy Optional, true while the service must stay resident
+     * @return Service id, -1 if the table is full
+     */
+    int add(const char* name, CreateFunction create, DestroyFunction destroy,
+            uint32_t idleTimeoutMs, BusyFunction busy = nullptr);
+
+    /**
+     * Find a service by name
+     * @return Service id, -1 if unknown
+     */
+    int find(const char* name) const;
+
+    /**
+     * Construct the service if needed and mark it used
+     * @return true if the service is resident
+     */
+    bool acquire(int id);
+    bool acquire(const char* name) { return acquire(find(name)); }
+
+    /**
+     * Ask for teardown at the next collect(), unless the service is busy
+     */
+    void release(int id);
+
+    bool isResident(int id) const;
+
+    /**
+     * Tear down idle and released services, called periodically
+     * @return Services torn down
+     */
+    int collect();
+
+    int getServiceCount() const { return _serviceCount; }
+    int getResidentCount() const;
+    bool getStats(int id, ServiceStats& out) const;
+
+private:
+    struct Service {
+        const char* name;
+        CreateFunction create;
+        DestroyFunction destroy;
+        BusyFunction busy;
+        bool released;
+        uint32_t lastUseMs;
+        ServiceStats stats;
+    };
+
+    const char* TAG;
+    SemaphoreHandle_t _mutex;
+    Service _services[MAX_SERVICES];
+    int _serviceCount;
+};
+
+} // namespace Utils
@@ -7,7 +7,8 @@ Display::Display() : _u8g2(nullptr), _initialized(false),
     _state(STATE_FACE), _holdTimer(0),
     _micLevel(0), _width(128), _height(64),
     _mux(nullptr), _face(nullptr), _weather(nullptr), _cube3D(nullptr), 
-    _spaceGame(nullptr), _battery(nullptr), _useMutex(false) {
+    _spaceGame(nullptr), _battery(nullptr), _useMutex(false),
+    _cube3DService(-1), _spaceGameService(-1), _spaceGameRunning(false) {
 }
 
 Display::~Display() {
@@ -55,13 +56,27 @@ bool Display::init(int sda, int scl, int width, int height) {
     _micStatus = new MicStatus(_u8g2);
     _displayStatus = new DisplayStatus(_u8g2);
     _weather = new Weather(_u8g2, width, height);
-    _cube3D = new Cube3D(_u8g2, width, height);
-    
-    // Initialize SpaceGame - it will get sensor data via notification system
-    _spaceGame = new SpaceGame(_u8g2, nullptr, width, height);
-    if (_spaceGame) {
-        _spaceGame->init();
-        _spaceGame->setAutoFire(true); // Enable auto-fire for demo
+    _width = width;
+    _height = height;
+
+    // Cube and game only exist while shown, unless there is no registry
+    if (services) {
+        _cube3DService = services->add("cube3d",
+            [this]() { return _createCube3D(); },
+            [this]() { delete _cube3D; _cube3D = nullptr; },
+            DISPLAY_COMPONENT_IDLE_MS,
+            [this]() { return _state == STATE_ORIENTATION; });
+        _spaceGameService = services->add("spacegame",
+            [this]() { return _createSpaceGame(); },
+            [this]() { delete _spaceGame; _spaceGame = nullptr; },
+            DISPLAY_COMPONENT_IDLE_MS,
+            [this]() { return _state == STATE_SPACE_GAME || _spaceGameRunning; });
+    }
+    if (_cube3DService < 0) {
+        _createCube3D();
+    }
+    if (_spaceGameService < 0) {
+        _createSpaceGame();
     }
     
     // Initialize Battery component
@@ -72,9 +87,6 @@ bool Display::init(int sda, int scl, int width, int height) {
         log_e("failed to initiate battery display status: %s", esp_err_to_name(err));
        }
     }
-    
-    _width = width;
-    _height = height;
 
     faceInit();
     update();
@@ -104,12 +116,15 @@ void Display::update() {
     if (_initialized == false || _u8g2 == nullptr) {
         return;
     }
+    Utils::TraceScope trace("Display::update", _state);
 
     if (_useMutex && _lock() == pdFAIL) return;
 
-    if (_state != STATE_SPACE_GAME && _spaceGame->isGameActive()) {
+    // The game stays resident while running, so it can be paused here
+    if (_state != STATE_SPACE_GAME && _spaceGameRunning) {
+        _spaceGameRunning = false;
         _spaceGame->pauseGame();
-        notification->send(NOTIFICATION_NOTE, (void*)Note::STOP);
+        eventBus->publish<Topic::NOTE>(Note::STOP);
     }
 
     // each state maybe need clearBuffer or not, check each state to makesure.
@@ -154,13 +169,16 @@ void Display::update() {
             _weather->draw();
             break;
         case STATE_ORIENTATION:
-            _cube3D->draw();
+            if (_acquire(_cube3DService) && _cube3D) {
+                _cube3D->draw();
+            }
             break;
         case STATE_SPACE_GAME:
-            if (_spaceGame) {
+            if (_acquire(_spaceGameService) && _spaceGame) {
                 if (!_spaceGame->isGameActive()) {
                     _spaceGame->startGame();
-                    notification->send(NOTIFICATION_NOTE, (void*)Note::RANDOM);
+                    _spaceGameRunning = true;
+                    eventBus->publish<Topic::NOTE>(Note::RANDOM);
                 }
                 
                 _spaceGame->draw();
@@ -197,14 +215,15 @@ void Display::updateWeatherData(const Communication::WeatherService::WeatherData
     }
 }
 
-void Display::updateOrientation(Sensors::OrientationSensor* orientation) {
-    if (_cube3D && orientation) {
-        _cube3D->updateRotation(orientation);
+void Display::updateOrientation(Logic::AttitudeService* attitude) {
+    // Only while shown, the busy check keeps them resident meanwhile
+    if (_cube3D && attitude && _state == STATE_ORIENTATION) {
+        _cube3D->updateRotation(attitude);
     }
     
     // Also update SpaceGame with gyro input if it's the active game
-    if (_spaceGame && orientation && _state == STATE_SPACE_GAME) {
-        _spaceGame->updateGyroInput(orientation);
+    if (_spaceGame && attitude && _state == STATE_SPACE_GAME) {
+        _spaceGame->updateGyroInput(attitude);
     }
 }
 
@@ -232,6 +251,28 @@ int Display::getHeight() const {
     return _u8g2->getHeight();
 }
 
+bool Display::_createCube3D() {
+    _cube3D = new Cube3D(_u8g2, _width, _height);
+    return _cube3D != nullptr;
+}
+
+bool Display::_createSpaceGame() {
+    // Gets sensor data via the attitude service
+    _spaceGame = new SpaceGame(_u8g2, nullptr, _width, _height);
+    if (!_spaceGame || !_spaceGame->init()) {
+        delete _spaceGame;
+        _spaceGame = nullptr;
+        return false;
+    }
+    _spaceGame->setAutoFire(true); // Enable auto-fire for demo
+    return true;
+}
+
+bool Display::_acquire(int service) {
+    // Without a registry the component was built at init
+    return service < 0 || services->acquire(service);
+}
+
 bool Display::_lock() {
     if (_initialized == false || _u8g2 == nullptr) {
         return false;
@@ -94,6 +94,7 @@ public:
     void drawCircle(int x, int y, int radius, bool fill = false);
 
     void setMicLevel(int level = 0);
+    int getMicLevel() const { return _micLevel; }
 
     /**
      * Update weather data for display
@@ -102,14 +103,14 @@ public:
     void updateWeatherData(const Communication::WeatherService::WeatherData& weatherData);
 
     /**
-     * Update orientation display with sensor data
-     * @param orientation The orientation sensor instance
+     * Update orientation display with the shared attitude estimate
+     * @param attitude The attitude service instance
      */
-    void updateOrientation(Sensors::OrientationSensor* orientation);
+    void updateOrientation(Logic::AttitudeService* attitude);
 
     /**
      * Get the SpaceGame component
-     * @return Pointer to the SpaceGame instance
+     * @return Pointer to the SpaceGame instance, nullptr while not resident
      */
     SpaceGame* getSpaceGame();
 
@@ -169,7 +170,13 @@ private:
     Cube3D *_cube3D;
     SpaceGame *_spaceGame;
     Battery::BatteryDisplay *_battery;
+    int _cube3DService;
+    int _spaceGameService;
+    volatile bool _spaceGameRunning;
 
+    bool _createCube3D();
+    bool _createSpaceGame();
+    bool _acquire(int service);
     bool _lock();
     void _unlock();
 };
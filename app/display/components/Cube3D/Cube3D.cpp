@@ -16,11 +16,7 @@ Cube3D::Cube3D(U8G2_SSD1306_128X64_NONAME_F_HW_I2C* display, int width, int heig
     _centerX = _width / 2;
     _centerY = _height / 2;
     
-    // Initialize complementary filter parameters
-    _alpha = 0.96f;           // 96% gyro, 4% accelerometer
-    _lastUpdateTime = 0;
-    _stationaryTime = 0;
-    _gyroThreshold = 0.5f;    // degrees/second threshold for "stationary"
+    _stationary = false;
     
     // Initialize debug variables
     _lastGyroX = 0;
@@ -48,86 +44,23 @@ void Cube3D::initVertices() {
     _vertices[7] = Point3D(-half,  half,  half); // Top-left-front
 }
 
-void Cube3D::updateRotation(Sensors::OrientationSensor* orientation) {
-    if (!orientation) return;
-    
-    unsigned long currentTime = millis();
-    
-    // Initialize timing on first call
-    if (_lastUpdateTime == 0) {
-        _lastUpdateTime = currentTime;
-        return;
-    }
-    
-    // Calculate time delta in seconds
-    float deltaTime = (currentTime - _lastUpdateTime) / 1000.0f;
-    _lastUpdateTime = currentTime;
-    
-    // Skip if time delta is too large (probably first call or long pause)
-    if (deltaTime > 0.1f) {
-        return;
-    }
-    
-    // Get gyroscope data (degrees per second)
-    // Try swapped axis mapping to match expected behavior:
-    // When tilting forward/backward → pitch rotation (X-axis)
-    // When turning left/right → yaw rotation (Y-axis) 
-    // When rolling left/right → roll rotation (Z-axis)
-    float gyroX = -orientation->getY(); // Pitch rate (forward/backward tilt) - negated and swapped
-    float gyroY = orientation->getZ();  // Yaw rate (left/right turn) - swapped
-    float gyroZ = orientation->getX();  // Roll rate (left/right tilt) - swapped
-    
+void Cube3D::updateRotation(Logic::AttitudeService* attitude) {
+    if (!attitude) return;
+
+    Logic::AttitudeService::Attitude current = attitude->getAttitude();
+    if (current.sampleSequence == 0) return;
+
+    // Same axes as before: pitch tilts forward/backward, yaw turns,
+    // roll tilts left/right
+    _rotX = -current.pitch * PI / 180.0f;
+    _rotY = current.yaw * PI / 180.0f;
+    _rotZ = current.roll * PI / 180.0f;
+
     // Store for debugging
-    _lastGyroX = orientation->getX(); // Store original values for debug
-    _lastGyroY = orientation->getY();
-    _lastGyroZ = orientation->getZ();
-    
-    // Get accelerometer data for gravity reference - match the gyro axis swap
-    float accelX = -orientation->getAccelY(); // For pitch calculation - negated and swapped
-    float accelY = orientation->getAccelZ();  // For yaw (not used) - swapped
-    float accelZ = orientation->getAccelX();  // For roll calculation - swapped
-    
-    // Calculate tilt angles from accelerometer (absolute reference)
-    // Pitch: rotation around X-axis (forward/backward tilt)
-    float accelPitch = atan2(-accelX, sqrt(accelY * accelY + accelZ * accelZ));
-    // Roll: rotation around Z-axis (left/right tilt) 
-    float accelRoll = atan2(accelZ, accelY);
-    
-    // Integrate gyroscope data
-    float gyroPitchDelta = gyroX * deltaTime * PI / 180.0f;
-    float gyroYawDelta = gyroY * deltaTime * PI / 180.0f;
-    float gyroRollDelta = gyroZ * deltaTime * PI / 180.0f;
-    
-    // Complementary filter: combine gyro (short-term) with accel (long-term)
-    // Pitch: forward/backward tilt (X-axis rotation)
-    _rotX = _alpha * (_rotX + gyroPitchDelta) + (1.0f - _alpha) * accelPitch;
-    // Roll: left/right tilt (Z-axis rotation)  
-    _rotZ = _alpha * (_rotZ + gyroRollDelta) + (1.0f - _alpha) * accelRoll;
-    
-    // Yaw has no gravity reference, use pure gyro integration with drift correction
-    _rotY += gyroYawDelta;
-    
-    // Auto-drift correction for yaw when robot is stationary
-    float gyroMagnitude = sqrt(gyroX*gyroX + gyroY*gyroY + gyroZ*gyroZ);
-    
-    if (gyroMagnitude < _gyroThreshold) {
-        _stationaryTime += deltaTime;
-        
-        // After 3 seconds of being stationary, slowly drift yaw back to zero
-        if (_stationaryTime > 3.0f) {
-            _rotY *= 0.995f; // Slow drift correction
-        }
-    } else {
-        _stationaryTime = 0;
-    }
-    
-    // Wrap angles to prevent overflow
-    while (_rotX > PI) _rotX -= 2 * PI;
-    while (_rotX < -PI) _rotX += 2 * PI;
-    while (_rotY > PI) _rotY -= 2 * PI;
-    while (_rotY < -PI) _rotY += 2 * PI;
-    while (_rotZ > PI) _rotZ -= 2 * PI;
-    while (_rotZ < -PI) _rotZ += 2 * PI;
+    _lastGyroX = current.rateX;
+    _lastGyroY = current.rateY;
+    _lastGyroZ = current.rateZ;
+    _stationary = current.stationary;
 }
 
 void Cube3D::updateRotation(float rotX, float rotY, float rotZ) {
@@ -188,12 +121,11 @@ void Cube3D::draw() {
     _display->setFont(u8g2_font_4x6_tf);
     _display->drawStr(2, 8, gyroText.c_str());
     
-    // Show complementary filter status
-    String filterText = "CF:" + String((int)(_alpha * 100)) + "%";
-    _display->drawStr(2, _height - 8, filterText.c_str());
+    // Show filter status
+    _display->drawStr(2, _height - 8, "AHRS");
     
-    // Show drift correction status
-    if (_stationaryTime > 3.0f) {
+    // Show bias learning status
+    if (_stationary) {
         _display->drawStr(_width - 20, _height - 8, "DC");
     } else {
         _display->drawStr(_width - 25, _height - 8, "GYRO");
@@ -206,13 +138,6 @@ void Cube3D::setCubeSize(float size) {
     initVertices();
 }
 
-void Cube3D::setFilterAlpha(float alpha) {
-    // Clamp alpha between reasonable values
-    if (alpha < 0.8f) alpha = 0.8f;
-    if (alpha > 0.99f) alpha = 0.99f;
-    _alpha = alpha;
-}
-
 Point3D Cube3D::rotateX(const Point3D& point, float angle) {
     float cosA = cos(angle);
     float sinA = sin(angle);
@@ -4,7 +4,7 @@
 #include <Arduino.h>
 #include <U8g2lib.h>
 #include <math.h>
-#include "core/Sensors/OrientationSensor.h"
+#include "core/Logic/Attitude/AttitudeService.h"
 
 namespace Display {
 
@@ -35,15 +35,8 @@ private:
     // Current rotation angles (in radians)
     float _rotX, _rotY, _rotZ;
     
-    // Complementary filter parameters
-    float _alpha; // Filter coefficient (0.95 = 95% gyro, 5% accel)
-    
-    // Timing for gyroscope integration
-    unsigned long _lastUpdateTime;
-    
-    // Auto-drift correction
-    float _stationaryTime;
-    float _gyroThreshold;
+    // Gyro bias is being learned (sensor still)
+    bool _stationary;
     
     // Last gyro readings for debugging
     float _lastGyroX, _lastGyroY, _lastGyroZ;
@@ -62,10 +55,10 @@ public:
     ~Cube3D();
 
     /**
-     * Update cube rotation based on orientation sensor data
-     * @param orientation The orientation sensor instance
+     * Update cube rotation from the shared attitude estimate
+     * @param attitude The attitude service instance
      */
-    void updateRotation(Sensors::OrientationSensor* orientation);
+    void updateRotation(Logic::AttitudeService* attitude);
     
     /**
      * Update cube rotation with explicit angles
@@ -86,12 +79,6 @@ public:
      */
     void setCubeSize(float size);
 
-    /**
-     * Set complementary filter coefficient
-     * @param alpha Filter coefficient (0.9-0.99, higher = more gyro influence)
-     */
-    void setFilterAlpha(float alpha);
-
 private:
     /**
      * Initialize cube vertices
@@ -9,8 +9,7 @@ SpaceGame::SpaceGame(U8G2_SSD1306_128X64_NONAME_F_HW_I2C* display, void* unused,
       _playerPoints(0), _playerPointsDelayed(0), _highScore(0), _difficulty(1), _toDiffCnt(0),
       _gyroSensitivity(1.f), _playerAccel(0.0f), _isFiring(false), _autoFire(true),
     _firePlayer(0), _firePeriod(25), _manualFireDelay(20), _isFireLastValue(0),
-    _lastGyroUpdate(0), _centerPosition(AREA_HEIGHT/2.0f), _currentTilt(0.0f), _alpha(1.0f),
-      _stationaryTime(0), _gyroThreshold(0.5f),
+    _lastGyroUpdate(0), _centerPosition(AREA_HEIGHT/2.0f), _currentTilt(0.0f), _tiltReference(0.0f),
     _lastGyroX(0), _lastGyroY(0), _lastGyroZ(0), _lastAccelX(0), _lastAccelY(0), _lastAccelZ(0) {
     
     // Initialize random seed
@@ -40,7 +39,7 @@ void SpaceGame::startGame() {
     _gameActive = true;
     _gameState = STATE_GAME; // Reset to game state
     setupInGame(); // Initialize the game objects right away
-    _lastGyroUpdate = 0; // Reset gyro timing
+    _lastGyroUpdate = 0; // Re-capture the level tilt
 }
 
 void SpaceGame::pauseGame() {
@@ -59,47 +58,26 @@ void SpaceGame::setGyroSensitivity(float sensitivity) {
     _gyroSensitivity = sensitivity;
 }
 
-void SpaceGame::updateGyroInput(Sensors::OrientationSensor* orientation) {
-    if (!orientation) {
+void SpaceGame::updateGyroInput(Logic::AttitudeService* attitude) {
+    if (!attitude) {
         return; // Just return, don't disable anything
     }
-    
-    unsigned long currentTime = millis();
-    
-    // Initialize timing on first call
-    if (_lastGyroUpdate == 0) {
-        _lastGyroUpdate = currentTime;
-        return;
-    }
-    
-    // Calculate time delta in seconds
-    float deltaTime = (currentTime - _lastGyroUpdate) / 1000.0f;
-    _lastGyroUpdate = currentTime;
-    
-    // Skip if time delta is too large (probably first call or long pause)
-    if (deltaTime > 0.1f) {
+
+    Logic::AttitudeService::Attitude current = attitude->getAttitude();
+    if (current.sampleSequence == 0) {
         return;
     }
-    
-    // Get gyroscope and accelerometer data
+
     // For vertical game movement, we want roll (left/right tilt) - easier to play
-    float gyroZ = orientation->getX();  // Roll rate (left/right tilt) - swapped like Cube3D
-    float accelX = -orientation->getAccelY(); // For roll calculation reference
-    float accelY = orientation->getAccelZ();  // For roll calculation 
-    float accelZ = orientation->getAccelX();  // For roll calculation - swapped like Cube3D
-    
-    // Calculate tilt angle from accelerometer (absolute reference like Cube3D)
-    float accelRoll = atan2(accelZ, accelY); // Roll: rotation around Z-axis (left/right tilt)
-    
-    // Integrate gyroscope data
-    float gyroRollDelta = gyroZ * deltaTime * PI / 180.0f;
-    
-    // Pure gyro integration for tilt (no blending with accel, no auto-centering)
-    _currentTilt = _currentTilt + gyroRollDelta;
-    
-    // No drift correction needed for roll - accelerometer provides absolute reference
-    // (Unlike yaw in Cube3D, roll has gravity reference so it's naturally stable)
-    // ...no stationary/slowdown logic...
+    float roll = current.roll * PI / 180.0f;
+
+    // The pose at game start counts as level
+    if (_lastGyroUpdate == 0) {
+        _lastGyroUpdate = millis();
+        _tiltReference = roll;
+    }
+
+    _currentTilt = roll - _tiltReference;
     
     // Wrap angles to prevent overflow (like Cube3D)
     while (_currentTilt > PI) _currentTilt -= 2 * PI;
@@ -2,7 +2,7 @@
 
 #include <Arduino.h>
 #include <U8g2lib.h>
-#include "core/Sensors/OrientationSensor.h"
+#include "core/Logic/Attitude/AttitudeService.h"
 
 namespace Display {
 
@@ -79,10 +79,10 @@ public:
     void setGyroSensitivity(float sensitivity);
 
     /**
-     * Update player position based on orientation sensor data
-     * @param orientation The orientation sensor instance
+     * Update player position from the shared attitude estimate
+     * @param attitude The attitude service instance
      */
-    void updateGyroInput(Sensors::OrientationSensor* orientation);
+    void updateGyroInput(Logic::AttitudeService* attitude);
 
 private:
     // Game constants
@@ -164,9 +164,7 @@ private:
     // Gyro control (following Cube3D pattern)
     float _centerPosition;
     float _currentTilt;
-    float _alpha; // Complementary filter coefficient
-    float _stationaryTime; // Track how long device has been stationary
-    float _gyroThreshold; // Threshold for considering device "stationary"
+    float _tiltReference; // Roll captured at game start
     
     // Debug variables for gyro/accel display (like Cube3D)
     float _lastGyroX, _lastGyroY, _lastGyroZ;
@@ -1,105 +1,70 @@
 #ifndef CONFIGURATION_MODEL_H
 #define CONFIGURATION_MODEL_H
 
-#include "Database/Model.h"
 #include <Arduino.h>
+#include <functional>
+#include "core/Utils/KvStore.h"
 
 namespace IModel {
 
-class Configuration : public Model {
+/**
+ * Key-value configuration backed by the log-structured store
+ *
+ * Reads are served from the store's RAM index; a set is durable once it
+ * returns. Until setStore() is called every get returns the default.
+ */
+class Configuration {
 public:
-    // Constructor
-    Configuration() : Model("configurations") {
-        initTable();
-    }
-    
-    // Create a new configuration instance
-    Configuration(const String& key, const String& value) : Model("configurations") {
-        initTable();
-        setKey(key);
-        setValue(value);
-    }
-    
-    // Getters
-    String getKey() const { return get("key"); }
-    String getValue() const { return get("value"); }
-    
-    // Setters
-    void setKey(const String& key) { set("key", key); }
-    void setValue(const String& value) { set("value", value); }
-    
+    static void setStore(Utils::KvStore* store) { _store() = store; }
+    static Utils::KvStore* getStore() { return _store(); }
+
     // Get a configuration value by key
     static String get(const String& key, const String& defaultValue = "") {
-        Configuration* config = findByKey(key);
-        if (!config) {
+        Utils::KvStore* store = _store();
+        if (!store) {
             return defaultValue;
         }
-        
-        String value = config->getValue();
-        delete config;
-        return value;
+        return store->get(key.c_str(), defaultValue);
     }
-    
+
     // Set a configuration value
     static bool set(const String& key, const String& value) {
-        Configuration* config = findByKey(key);
-        bool result = false;
-        
-        if (config) {
-            // Update existing
-            config->setValue(value);
-            result = config->save();
-            delete config;
-        } else {
-            // Create new
-            Configuration newConfig(key, value);
-            result = newConfig.save();
+        Utils::KvStore* store = _store();
+        if (!store) {
+            return false;
         }
-        
-        return result;
+        return store->put(key.c_str(), value);
     }
-    
-    // Find a configuration by key
-    static Configuration* findByKey(const String& key) {
-        CsvDatabase* db = Model::getDatabase();
-        if (!db) return nullptr;
-        
-        // Make sure table exists
-        if (!db->tableExists("configurations")) {
-            if (!initTable()) {
-                return nullptr;
-            }
-        }
-        
-        // Find by key
-        std::map<String, String> conditions;
-        conditions["key"] = key;
-        
-        std::vector<std::map<String, String>> results = db->select("configurations", conditions);
-        
-        if (results.size() > 0) {
-            Configuration* config = new Configuration();
-            config->fill(results[0]);
-            return config;
+
+    // Remove a configuration value
+    static bool remove(const String& key) {
+        Utils::KvStore* store = _store();
+        if (!store) {
+            return false;
         }
-        
-        return nullptr;
+        return store->remove(key.c_str());
     }
-private:
-    // Initialize configurations table
-    static bool initTable() {
-        // Get the database from Model
-        CsvDatabase* db = Model::getDatabase();
-        if (!db) return false;
-        
-        // Create table if it doesn't exist
-        if (!db->tableExists("configurations")) {
-            std::vector<String> columns = {"key", "value"};
-            return db->createTable("configurations", columns);
+
+    // Visit every configuration value, the store is locked meanwhile;
+    // keys starting with "__" are bookkeeping and skipped
+    static bool forEach(const std::function<void(const char* key, const char* value)>& visitor) {
+        Utils::KvStore* store = _store();
+        if (!store) {
+            return false;
         }
-        
+        store->forEach([&visitor](const char* key, const char* value) {
+            if (strncmp(key, "__", 2) != 0) {
+                visitor(key, value);
+            }
+        });
         return true;
     }
+
+private:
+    static Utils::KvStore*& _store() {
+        static Utils::KvStore* store = nullptr;
+        return store;
+    }
 };
 
 }; // end namespace
@@ -0,0 +1,248 @@
+#include "RegionTable.h"
+#include <esp_log.h>
+
+namespace IModel {
+
+static uint16_t readU16(const uint8_t* p) {
+    return p[0] | (p[1] << 8);
+}
+
+static uint32_t readU32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+RegionTable::RegionTable(Utils::FileManager* fileManager, const char* path)
+    : TAG("RegionTable"),
+      _fileManager(fileManager),
+      _path(path),
+      _mutex(xSemaphoreCreateMutex()),
+      _rows(0),
+      _names{},
+      _keysOffset(0),
+      _columnOffsets{},
+      _desaOffset(0),
+      _dictionaryOffset(0),
+      _stringsOffset(0),
+      _stringsSize(0)
+{
+}
+
+RegionTable::~RegionTable() {
+    if (_file) {
+        _file.close();
+    }
+    vSemaphoreDelete(_mutex);
+}
+
+bool RegionTable::begin() {
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    if (!_file) {
+        _file = _fileManager->openFileForReading(_path);
+    }
+
+    uint8_t header[HEADER_SIZE];
+    if (!_file || !readAt(0, header, HEADER_SIZE) || memcmp(header, "ADMR", 4) != 0 ||
+        readU16(header + 4) != VERSION || readU16(header + 6) != KEY_LENGTH) {
+        if (_file) {
+            _file.close();
+        }
+        _rows = 0;
+        xSemaphoreGive(_mutex);
+        ESP_LOGE(TAG, "%s is missing or not a region table", _path.c_str());
+        return false;
+    }
+
+    _rows = readU32(header + 8);
+    _names[(int)Column::PROVINSI] = readU16(header + 12);
+    _names[(int)Column::KOTKAB] = readU16(header + 14);
+    _names[(int)Column::KECAMATAN] = readU16(header + 16);
+    _keysOffset = readU32(header + 20);
+    _columnOffsets[(int)Column::PROVINSI] = readU32(header + 24);
+    _columnOffsets[(int)Column::KOTKAB] = readU32(header + 28);
+    _columnOffsets[(int)Column::KECAMATAN] = readU32(header + 32);
+    _desaOffset = readU32(header + 36);
+    _dictionaryOffset = readU32(header + 40);
+    _stringsOffset = readU32(header + 44);
+    _stringsSize = readU32(header + 48);
+    xSemaphoreGive(_mutex);
+
+    ESP_LOGI(TAG, "Loaded %u regions, %u provinces, %u cities", (unsigned)_rows,
+             (unsigned)_names[(int)Column::PROVINSI], (unsigned)_names[(int)Column::KOTKAB]);
+    return true;
+}
+
+bool RegionTable::readAt(uint32_t offset, void* buffer, size_t length) {
+    return _fileManager->seekFile(_file, offset) &&
+           _fileManager->readStream(_file, static_cast<uint8_t*>(buffer), length) == length;
+}
+
+bool RegionTable::readString(uint32_t offset, String& value) {
+    uint8_t buffer[256];
+    if (offset >= _stringsSize || !readAt(_stringsOffset + offset, buffer, 1)) {
+        return false;
+    }
+    size_t length = buffer[0];
+    if (!readAt(_stringsOffset + offset + 1, buffer, length)) {
+        return false;
+    }
+    buffer[length] = '\0';
+    value = (const char*)buffer;
+    return true;
+}
+
+uint32_t RegionTable::dictionaryBase(Column column) const {
+    uint32_t base = _dictionaryOffset;
+    for (int i = 0; i < (int)column; i++) {
+        base += _names[i] * sizeof(uint32_t);
+    }
+    return base;
+}
+
+bool RegionTable::readName(Column column, uint16_t index, String& value) {
+    uint8_t offset[4];
+    if (index >= _names[(int)column] || !readAt(dictionaryBase(column) + index * sizeof(uint32_t), offset, 4)) {
+        return false;
+    }
+    return readString(readU32(offset), value);
+}
+
+int RegionTable::findName(Column column, const char* name) {
+    // Dictionaries are sorted, binary search them
+    int lo = 0;
+    int hi = (int)_names[(int)column] - 1;
+    String probe;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        if (!readName(column, mid, probe)) {
+            return -1;
+        }
+        int cmp = strcmp(probe.c_str(), name);
+        if (cmp == 0) {
+            return mid;
+        }
+        if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return -1;
+}
+
+bool RegionTable::readRow(uint32_t index, const char* key, Row& row) {
+    uint8_t ids[2];
+    uint8_t desa[4];
+    memcpy(row.adm4, key, KEY_LENGTH);
+    row.adm4[KEY_LENGTH] = '\0';
+
+    if (!readAt(_columnOffsets[(int)Column::PROVINSI] + index * 2, ids, 2) ||
+        !readName(Column::PROVINSI, readU16(ids), row.provinsi)) {
+        return false;
+    }
+    if (!readAt(_columnOffsets[(int)Column::KOTKAB] + index * 2, ids, 2) ||
+        !readName(Column::KOTKAB, readU16(ids), row.kotkab)) {
+        return false;
+    }
+    if (!readAt(_columnOffsets[(int)Column::KECAMATAN] + index * 2, ids, 2) ||
+        !readName(Column::KECAMATAN, readU16(ids), row.kecamatan)) {
+        return false;
+    }
+    return readAt(_desaOffset + index * 4, desa, 4) && readString(readU32(desa), row.desa);
+}
+
+bool RegionTable::findByAdm4(const char* adm4, Row& row) {
+    char key[KEY_LENGTH] = {};
+    size_t length = strlen(adm4);
+    if (length == 0 || length > KEY_LENGTH) {
+        return false;
+    }
+    memcpy(key, adm4, length);
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    if (!_file) {
+        xSemaphoreGive(_mutex);
+        return false;
+    }
+
+    // Halve the key column one probe at a time, then read the last few keys in one go
+    uint32_t lo = 0;
+    uint32_t hi = _rows;
+    char probe[KEY_LENGTH];
+    bool ok = true;
+    while (ok && hi - lo > KEY_BLOCK) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        ok = readAt(_keysOffset + mid * KEY_LENGTH, probe, KEY_LENGTH);
+        int cmp = memcmp(probe, key, KEY_LENGTH);
+        if (cmp == 0) {
+            lo = mid;
+            hi = mid + 1;
+        } else if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    bool found = false;
+    char block[KEY_BLOCK * KEY_LENGTH];
+    if (ok && hi > lo && readAt(_keysOffset + lo * KEY_LENGTH, block, (hi - lo) * KEY_LENGTH)) {
+        for (uint32_t i = 0; i < hi - lo; i++) {
+            if (memcmp(block + i * KEY_LENGTH, key, KEY_LENGTH) == 0) {
+                found = readRow(lo + i, key, row);
+                break;
+            }
+        }
+    }
+    xSemaphoreGive(_mutex);
+    return found;
+}
+
+size_t RegionTable::forEachWhere(Column column, const char* name, const std::function<void(const Row& row)>& visitor) {
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    int id = _file ? findName(column, name) : -1;
+    if (id < 0) {
+        xSemaphoreGive(_mutex);
+        return 0;
+    }
+
+    // Collect matches a chunk at a time, then decode them; decoding moves the file position
+    uint8_t ids[SCAN_CHUNK * 2];
+    uint32_t matches[SCAN_CHUNK];
+    char key[KEY_LENGTH];
+    Row row;
+    size_t visited = 0;
+    for (uint32_t start = 0; start < _rows; start += SCAN_CHUNK) {
+        size_t count = _rows - start < SCAN_CHUNK ? _rows - start : SCAN_CHUNK;
+        if (!readAt(_columnOffsets[(int)column] + start * 2, ids, count * 2)) {
+            break;
+        }
+
+        size_t found = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (readU16(ids + i * 2) == id) {
+                matches[found++] = start + i;
+            }
+        }
+        for (size_t i = 0; i < found; i++) {
+            if (readAt(_keysOffset + matches[i] * KEY_LENGTH, key, KEY_LENGTH) && readRow(matches[i], key, row)) {
+                visitor(row);
+                visited++;
+            }
+        }
+    }
+    xSemaphoreGive(_mutex);
+    return visited;
+}
+
+void RegionTable::forEachName(Column column, const std::function<void(const String& name)>& visitor) {
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    String name;
+    for (uint16_t i = 0; _file && i < _names[(int)column]; i++) {
+        if (readName(column, i, name)) {
+            visitor(name);
+        }
+    }
+    xSemaphoreGive(_mutex);
+}
+
+}; // end namespace
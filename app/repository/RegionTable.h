@@ -0,0 +1,100 @@
+#ifndef REGION_TABLE_H
+#define REGION_TABLE_H
+
+#include <Arduino.h>
+#include <functional>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "FileManager.h"
+
+namespace IModel {
+
+/**
+ * Read-only columnar table of administrative regions
+ *
+ * The table is built from administrative_regions.csv by
+ * tools/build_regions.py when the filesystem image is built. Rows are
+ * sorted by adm4 code, so a code lookup is a binary search over the key
+ * column; province, city and district are 16-bit dictionary indexes, so a
+ * filter scans two bytes per row and only decodes the rows that match.
+ *
+ * Nothing but the header is held in RAM, every read seeks into the open
+ * file.
+ */
+class RegionTable {
+public:
+    static const size_t KEY_LENGTH = 16;
+
+    enum class Column : uint8_t {
+        PROVINSI,
+        KOTKAB,
+        KECAMATAN
+    };
+
+    /**
+     * Row with its names resolved, the adm1 to adm3 codes are prefixes of adm4
+     */
+    struct Row {
+        char adm4[KEY_LENGTH + 1];
+        String provinsi;
+        String kotkab;
+        String kecamatan;
+        String desa;
+    };
+
+    RegionTable(Utils::FileManager* fileManager, const char* path);
+    ~RegionTable();
+
+    /**
+     * Open the table and check its header
+     * @return false if the file is missing or not a table of this version
+     */
+    bool begin();
+
+    size_t size() const { return _rows; }
+
+    bool findByAdm4(const char* adm4, Row& row);
+
+    /**
+     * Visit every row whose column has the given name, in adm4 order
+     * @return Rows visited
+     */
+    size_t forEachWhere(Column column, const char* name, const std::function<void(const Row& row)>& visitor);
+
+    /**
+     * Visit every distinct name of a column, in byte order
+     */
+    void forEachName(Column column, const std::function<void(const String& name)>& visitor);
+
+private:
+    static const size_t HEADER_SIZE = 52;
+    static const uint16_t VERSION = 1;
+    static const size_t SCAN_CHUNK = 128;       // Column entries read per chunk when filtering
+    static const size_t KEY_BLOCK = 32;         // Keys left when the search reads them in one go
+
+    const char* TAG;
+    Utils::FileManager* _fileManager;
+    String _path;
+    File _file;
+    SemaphoreHandle_t _mutex;
+
+    uint32_t _rows;
+    uint16_t _names[3];             // Dictionary sizes by column
+    uint32_t _keysOffset;
+    uint32_t _columnOffsets[3];
+    uint32_t _desaOffset;
+    uint32_t _dictionaryOffset;
+    uint32_t _stringsOffset;
+    uint32_t _stringsSize;
+
+    bool readAt(uint32_t offset, void* buffer, size_t length);
+    bool readString(uint32_t offset, String& value);
+    bool readName(Column column, uint16_t index, String& value);
+    bool readRow(uint32_t index, const char* key, Row& row);
+    int findName(Column column, const char* name);
+    uint32_t dictionaryBase(Column column) const;
+};
+
+}; // end namespace
+
+#endif // REGION_TABLE_H
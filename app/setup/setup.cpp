@@ -1,52 +1,82 @@
 #include "setup.h"
 
+Utils::BootSequencer* bootSequencer;
+
 void setupApp() {
 	setupLogger();
-	setupFilemanager();
-  setupNotification();
-  setupDisplay();
-
-  // Initialize components
-  setupExtender();
-  setupCliffDetector();
-  setupOrientation();
-  setupMotors();
-  setupServos();
-  setupDistanceSensor();
-  setupTouchDetector();
-  setupTemperatureSensor();
-  setupBatteryManager();
-  setupMicrophone();
-  setupSpeakers();
-  setupCommandMapper();
-  setupAutomation();
-  setupPicoTTS();
-  setupSpeechRecognition();
-  setupAudioRecorder();
-  setupNotePlayer();
-
-  delay(10);
-
-  setupWiFi();
-  setupGPT();
-  setupFTPServer();
-  setupWebServer();
-
-  if (motors && display)
-    motors->setDisplay(display);
-  if (servos && display)
-    servos->setDisplay(display);
-
-  delay(10);
-  setupWeather();
-  setupScanArea();
-  
+	setupTrace();
+
+  // Each subsystem waits only for what it uses, the rest boots in parallel
+  // on both cores. Devices on the I2C bus need the bus set up by the display.
+  bootSequencer = new Utils::BootSequencer();
+  Utils::BootSequencer& boot = *bootSequencer;
+
+  boot.addStage("filemanager", setupFilemanager);
+  boot.addStage("config", setupConfigStore, {"filemanager"});
+  boot.addStage("regions", setupRegionTable, {"filemanager"});
+  boot.addStage("eventbus", setupEventBus);
+  boot.addStage("services", setupServices);
+  boot.addStage("display", setupDisplay, {"eventbus", "services"});
+
+  // Sensors and actuators
+  boot.addStage("extender", setupExtender, {"display"});
+  boot.addStage("cliff", setupCliffDetector, {"extender"});
+  boot.addStage("orientation", setupOrientation, {"display"});
+  boot.addStage("attitude", setupAttitude, {"orientation"});
+  boot.addStage("motors", setupMotors, {"extender", "attitude"});
+  boot.addStage("servos", setupServos, {"extender", "display", "motors"});  // LEDC channels one at a time
+  boot.addStage("distance", setupDistanceSensor);
+  boot.addStage("touch", setupTouchDetector);
+  boot.addStage("temperature", setupTemperatureSensor);
+  boot.addStage("battery", setupBatteryManager);
+  boot.addStage("face", []() {
+    if (motors && display)
+      motors->setDisplay(display);
+    if (servos && display)
+      servos->setDisplay(display);
+  }, {"motors", "servos"});
+
+  // Audio and speech, model loading overlaps the network bring-up
+  boot.addStage("microphone", setupMicrophone);
+  boot.addStage("speakers", setupSpeakers);
+  boot.addStage("commandmapper", setupCommandMapper, {"display", "motors", "servos"});
+  boot.addStage("automation", setupAutomation, {"commandmapper", "filemanager"});
+  boot.addStage("picotts", setupPicoTTS, {"speakers"});
+  boot.addStage("speech", setupSpeechRecognition, {"microphone"});
+  boot.addStage("recorder", setupAudioRecorder, {"microphone", "filemanager", "eventbus"});
+  boot.addStage("noteplayer", setupNotePlayer, {"speakers"});
+  boot.addStage("listening", startListening, {"speech", "commandmapper", "tasks_cpu1", "picotts", "recorder", "scheduler"});
+
+  // Network
+  boot.addStage("wifi", setupWiFi, {"filemanager", "display"});
+  boot.addStage("gpt", setupGPT, {"wifi"});
+  boot.addStage("ftp", setupFTPServer, {"wifi", "services"});
+  boot.addStage("webserver", setupWebServer, {"wifi", "filemanager", "config", "regions"});
+  boot.addStage("weather", setupWeather, {"wifi", "filemanager", "regions"});
+
+  // Behaviour on top of the sensors
+  boot.addStage("scanarea", setupScanArea, {"attitude", "distance"});
+  boot.addStage("safety", setupSafetyMonitor, {"motors", "distance", "cliff", "scanarea"});  // Escapes use the map
+  boot.addStage("scheduler", setupScheduler, {"battery", "automation", "scanarea", "ftp", "display"});
+  boot.addStage("telemetry", setupTelemetry, {"scheduler"});
+  boot.addStage("teleop", setupTeleop, {"scheduler", "motors"});
+
+  // Background tasks, each started once what it runs exists
+  boot.addStage("tasks_cpu0", setupTasksCpu0, {"safety", "display", "scheduler", "telemetry", "teleop"});
+  boot.addStage("tasks_cpu1", setupTasksCpu1, {"automation", "noteplayer"});
+  boot.addStage("weathertask", startWeatherTask, {"weather"});
+
+  boot.run(BOOT_WORKER_STACK_SIZE);
+
   logger->info("System initialization complete");
-  
+
   if (display) {
     display->clear();
     display->drawCenteredText(20, "Cozmo System");
     display->drawCenteredText(40, "Ready!");
+    if (wifiManager) {
+      display->drawCenteredText(54, wifiManager->getIP().c_str());
+    }
     display->update();
   }
-}
\ No newline at end of file
+}
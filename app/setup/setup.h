@@ -6,13 +6,13 @@
 #include <Constants.h>
 #include <picotts.h>
 #include <csr.h>
-#include <Notification.h>
 #include <AsyncWebSocket.h>
 #include <ESPAsyncWebServer.h>
 #include <ArduinoJson.h>
 #include <display/Display.h>
 #include <FileManager.h>
 #include <Logger.h>
+#include <Trace.h>
 #include <I2CScanner.h>
 #include <I2CManager.h>
 #include <IOExtern.h>
@@ -34,28 +34,32 @@
 #include "core/Sensors/TemperatureSensor.h"
 #include "core/Motors/MotorControl.h"
 #include "core/Motors/ServoControl.h"
+#include "core/Motors/Teleop.h"
 #include "core/Communication/WiFiManager.h"
+#include "core/Communication/ConnectionPool.h"
 #include "core/Communication/GPTAdapter.h"
 #include "core/Communication/WeatherService.h"
+#include "core/Communication/TelemetryStream.h"
 #include "core/Audio/AudioRecorder.h"
 #include "core/Audio/Note.h"
 #include "core/Utils/CommandMapper.h"
+#include "core/Utils/EventBus.h"
+#include "core/Utils/Scheduler.h"
+#include "core/Utils/PowerManager.h"
+#include "core/Utils/BootSequencer.h"
+#include "core/Utils/ServiceRegistry.h"
+#include "core/Utils/KvStore.h"
 #include "repository/Configuration.h"
 #include "repository/AdministrativeRegion.h"
 #include "tasks/register.h"
 #include "callback/register.h"
 #include "web/Routes/routes.h"
 
+#include "core/Logic/Attitude/AttitudeService.h"
 #include "core/Logic/Area/ScanArea.h"
+#include "core/Logic/Safety/SafetyMonitor.h"
 
-#ifndef WEB_VAR_H
-#define WEB_VAR_H
-struct {
-  bool authenticated = false;
-} sessions[5];
-#endif
-
-extern Notification* notification;
+extern Utils::EventBus* eventBus;
 extern Automation::Automation* automation;
 extern Sensors::Camera* camera;
 extern Sensors::OrientationSensor* orientation;
@@ -67,13 +71,18 @@ extern Sensors::TemperatureSensor* temperatureSensor;
 extern BatteryManager* batteryManager;
 extern Motors::MotorControl* motors;
 extern Motors::ServoControl* servos;
+extern Motors::Teleop* teleop;
 extern Communication::WiFiManager* wifiManager;
+extern Communication::ConnectionPool* connectionPool;
 extern Communication::GPTAdapter* gptAdapter;
 extern Communication::WeatherService* weatherService;
+extern IModel::RegionTable* regionTable;
+extern Communication::TelemetryStream* telemetry;
 extern AudioRecorder* audioRecorder;
 extern Note* notePlayer;
 extern Display::Display* display;
 extern Utils::FileManager* fileManager;
+extern Utils::KvStore* configStore;
 extern Utils::Logger* logger;
 extern Utils::CommandMapper* commandMapper;
 extern Utils::IOExtern ioExpander;
@@ -81,18 +90,29 @@ extern AnalogMicrophone* amicrophone;
 extern I2SMicrophone* microphone;
 extern I2SSpeaker* i2sSpeaker;
 extern AudioSamples* audioSamples;
-extern FTPServer ftpSrv;
+extern FTPServer* ftpSrv;
+extern Logic::AttitudeService* attitude;
 extern Logic::ScanArea* scanArea;
+extern Logic::SafetyMonitor* safetyMonitor;
+extern Utils::Scheduler* scheduler;
+extern Utils::PowerManager* powerManager;
+extern Utils::BootSequencer* bootSequencer;
+extern Utils::ServiceRegistry* services;
 
 void setupApp();
 
 void setupLogger();
-void setupNotification();
+void setupTrace();
+void setupServices();
+void setupEventBus();
 void setupFilemanager();
+void setupConfigStore();
+void setupRegionTable();
 void setupWebServer();
 void setupMotors();
 void setupServos();
 void setupOrientation();
+void setupAttitude();
 void setupDistanceSensor();
 void setupCliffDetector();
 void setupTouchDetector();
@@ -113,9 +133,16 @@ void setupWeather();
 void setupAudioRecorder();
 void setupNotePlayer();
 void setupScanArea();
+void setupSafetyMonitor();
+void setupEscape(int core);
+void setupScheduler();
+void setupTelemetry();
+void setupTeleop();
 
 void setupTasksCpu0();
 void setupTasksCpu1();
+void startWeatherTask();
+void startListening();
 
 #if PICOTTS_ENABLED
 extern bool picotts_initialized;
@@ -0,0 +1,18 @@
+#include <Arduino.h>
+#include "setup/setup.h"
+
+Logic::AttitudeService *attitude;
+
+void setupAttitude() {
+  if (!orientation) {
+    logger->info("Attitude service disabled: orientation sensor not available");
+    return;
+  }
+
+  attitude = new Logic::AttitudeService(orientation);
+  if (!attitude->start(ATTITUDE_RATE_HZ, 0, ATTITUDE_PRIORITY)) {
+    logger->error("Attitude service failed to start");
+    delete attitude;
+    attitude = nullptr;
+  }
+}
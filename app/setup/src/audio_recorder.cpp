@@ -8,7 +8,7 @@ AudioRecorder* audioRecorder = nullptr;
 void setupAudioRecorder() {
     #if AUDIO_RECORDING_ENABLED
     if (audioRecorder == nullptr) {
-        audioRecorder = new AudioRecorder(fileManager, logger, notification, mic_fill_callback);
+        audioRecorder = new AudioRecorder(fileManager, logger, eventBus, mic_fill_callback);
         
         if (audioRecorder) {
             logger->info("AudioRecorder setup complete");
@@ -21,6 +21,7 @@ void setupBatteryManager() {
     batteryManager->setVoltage(BATTERY_VOLTAGE_MIN, BATTERY_VOLTAGE_MAX, BATTERY_VOLTAGE_DIVIDER);
     batteryManager->setAdcResolution(BATTERY_ADC_RESOLUTION);
     batteryManager->setUpdateInterval(BATTERY_UPDATE_INTERVAL);
+    batteryManager->setSampleRate(BATTERY_ADC_SAMPLE_RATE_HZ); // DMA background sampling, 0 = analogRead()
     batteryManager->enableNotifications(true, true); // Enable critical and low battery notifications
 
     // Initialize the battery manager
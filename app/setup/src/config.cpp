@@ -0,0 +1,49 @@
+#include "../setup.h"
+#include "Database/Model.h"
+
+Utils::KvStore* configStore = nullptr;
+
+// Written last, a store without it was never migrated or was cut short
+static const char* const MIGRATED_KEY = "__migrated";
+
+// Copy the configurations table of the CSV database into the store, keys
+// already in it were copied before a reset or set since and are kept
+static void migrateLegacyConfigurations() {
+	CsvDatabase legacy(LittleFS);
+	if (!legacy.tableExists("configurations")) {
+		configStore->put(MIGRATED_KEY, "1");
+		return;
+	}
+
+	int migrated = 0;
+	std::vector<std::map<String, String>> rows = legacy.select("configurations");
+	for (const auto& row : rows) {
+		auto key = row.find("key");
+		auto value = row.find("value");
+		if (key == row.end() || value == row.end() || configStore->contains(key->second.c_str())) {
+			continue;
+		}
+		if (!configStore->put(key->second.c_str(), value->second)) {
+			logger->error("Configuration migration stopped at %s", key->second.c_str());
+			return;
+		}
+		migrated++;
+	}
+	configStore->put(MIGRATED_KEY, "1");
+	logger->info("Migrated %d configurations to the store", migrated);
+}
+
+void setupConfigStore() {
+	if (configStore) return;
+
+	configStore = new Utils::KvStore(fileManager, CONFIG_STORE_PATH, CONFIG_COMPACT_MIN_BYTES);
+	if (!configStore->begin()) {
+		logger->error("Configuration store initialization failed");
+		return;
+	}
+	if (!configStore->contains(MIGRATED_KEY)) {
+		migrateLegacyConfigurations();
+	}
+
+	IModel::Configuration::setStore(configStore);
+}
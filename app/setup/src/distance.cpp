@@ -12,8 +12,16 @@ void setupDistanceSensor() {
     	distanceSensor->setThresHold(ULTRASONIC_OBSTACLE_TRESHOLD);
       logger->info("HC-SR04 initialized successfully");
       
-      // Perform a test measurement
-      delay(1000);
+      if (distanceSensor->startContinuous(ULTRASONIC_SAMPLE_INTERVAL_MS)) {
+        logger->info("HC-SR04 continuous ranging every %d ms", ULTRASONIC_SAMPLE_INTERVAL_MS);
+      } else if (distanceSensor->startSingleShot(ULTRASONIC_SAMPLE_INTERVAL_MS)) {
+        logger->warning("HC-SR04 continuous ranging failed, measuring on demand");
+      } else {
+        logger->error("HC-SR04 ranging unavailable, forward motion will be stopped");
+      }
+
+      // Wait for the median window to fill before reporting the first value
+      delay(ULTRASONIC_SAMPLE_INTERVAL_MS * (Sensors::DistanceSensor::MEDIAN_WINDOW + 1));
       float distance = distanceSensor->measureDistance();
       if (distance >= 0) {
         logger->info("Initial distance measurement: " + String(distance, 2) + " cm");
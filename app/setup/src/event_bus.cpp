@@ -0,0 +1,10 @@
+#include "../setup.h"
+
+Utils::EventBus* eventBus;
+
+void setupEventBus() {
+	if (!eventBus) {
+		eventBus =
+			new Utils::EventBus();
+	}
+}
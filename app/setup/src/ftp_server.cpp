@@ -1,7 +1,29 @@
 #include "setup/setup.h"
 
-FTPServer ftpSrv(LittleFS);
+FTPServer* ftpSrv;
 
 void setupFTPServer() {
-	ftpSrv.begin(FTP_USER, FTP_PASS);
-}
\ No newline at end of file
+	if (!services) {
+		ftpSrv = new FTPServer(LittleFS);
+		ftpSrv->begin(FTP_USER, FTP_PASS);
+		return;
+	}
+
+	// Polled by the ftp scheduler job, stopped by the services job on the
+	// same task
+	services->add("ftp", []() {
+		FTPServer* server = new FTPServer(LittleFS);
+		server->begin(FTP_USER, FTP_PASS);
+		ftpSrv = server;
+		return true;
+	}, []() {
+		FTPServer* server = ftpSrv;
+		ftpSrv = nullptr;
+		server->stop();
+		delete server;
+	}, FTP_IDLE_TIMEOUT_MS);
+
+#if !FTP_ON_DEMAND
+	services->acquire("ftp");
+#endif
+}
@@ -8,6 +8,8 @@ void setupGPT(){
 	gptAdapter = new Communication::GPTAdapter();
 	#if GPT_ENABLED
 	gptAdapter->init(GPT_API_KEY);
+	gptAdapter->setEndpoint(GPT_API_URL);
+	gptAdapter->setConnectionPool(connectionPool);
 	gptAdapter->setModel(GPT_MODEL);
 	gptAdapter->setMaxTokens(GPT_MAX_TOKENS);
 	gptAdapter->setTemperature(GPT_TEMPERATURE);
@@ -46,5 +46,4 @@ void setupMicrophone() {
   #else
   logger->info("Microphone sensor disabled in configuration");
   #endif
-  delay(1000);  
 }
\ No newline at end of file
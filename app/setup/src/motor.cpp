@@ -13,6 +13,13 @@ void setupMotors() {
     if (motors->init(LEFT_MOTOR_PIN1, LEFT_MOTOR_PIN2, RIGHT_MOTOR_PIN1, RIGHT_MOTOR_PIN2)) {
     #endif
       logger->info("Motors initialized successfully");
+      #if !MOTOR_IO_EXTENDER
+      motors->enablePwm(MOTOR_PWM_FREQUENCY, MOTOR_PWM_RESOLUTION, MOTOR_PWM_MIN_DUTY);
+      #endif
+      if (attitude) {
+        motors->setHeadingSource([]() { return attitude->getAttitude().yaw; });
+      }
+      motors->startControl(MOTOR_CONTROL_PERIOD_MS, MOTOR_ACCELERATION);
       motors->move(Motors::MotorControl::FORWARD);
       delay(500);
       motors->move(Motors::MotorControl::BACKWARD);
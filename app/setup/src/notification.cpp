@@ -1,10 +0,0 @@
-#include "../setup.h"
-
-Notification* notification;
-
-void setupNotification() {
-	if (!notification) {
-		notification =
-			new Notification();
-	}
-}
\ No newline at end of file
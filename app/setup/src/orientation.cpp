@@ -12,6 +12,12 @@ void setupOrientation() {
       orientation->setGyroRange(Sensors::GYRO_RANGE_250_DEG);
       orientation->setAccelRange(Sensors::ACCEL_RANGE_2G);
       logger->info("Gyroscope initialized successfully");
+
+      if (orientation->startStream(ORIENTATION_SAMPLE_RATE_HZ, ORIENTATION_INT_PIN, ORIENTATION_BATCH_MS)) {
+        logger->info("Gyroscope FIFO stream at %d Hz", orientation->getSampleRate());
+      } else {
+        logger->warning("Gyroscope FIFO stream failed, falling back to register reads");
+      }
     } else {
       logger->error("Gyroscope initialization failed");
       orientation = nullptr;
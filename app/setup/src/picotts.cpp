@@ -48,6 +48,8 @@ bool isPicoTTSInitialized() {
 }
 
 bool sayText(const char* text) {
+    Utils::TraceScope trace("sayText");
+
     // Validate text length
     if (strlen(text) > PICOTTS_MAX_TEXT_LENGTH) {
         logger->warning("Text too long (%d chars), truncating to %d", 
@@ -1,6 +1,18 @@
 #include "setup/setup.h"
 #include "tasks/register.h"
 
+/**
+ * Back up away from a hazard, cliff guarded by the safety monitor
+ * @return false if backing up ran into a cliff, the maneuver ends there
+ */
+static bool backAway() {
+    if (safetyMonitor) {
+        return safetyMonitor->reverse(ESCAPE_REVERSE_MS);
+    }
+    motors->move(Motors::MotorControl::BACKWARD, ESCAPE_REVERSE_MS);
+    return true;
+}
+
 /**
  * Handles cliff detection and evasive maneuvers
  * @return true if cliff was detected and handled
@@ -13,7 +25,10 @@ bool handleCliffDetection() {
     if (motors) {
         motors->interuptMotor();
 
-        motors->move(Motors::MotorControl::BACKWARD, 1000);
+        if (!backAway()) {
+            logger->warning("Cliff behind, escape aborted");
+            return true;
+        }
         Motors::MotorControl::Direction turnDirection = (rand() % 2 == 0) ?
                 Motors::MotorControl::LEFT : Motors::MotorControl::RIGHT;
         motors->move(turnDirection, 1000);
@@ -27,8 +42,46 @@ bool handleCliffDetection() {
     return true;  // Cliff was detected and handled
 }
 
+/**
+ * Turn in place until the yaw reported by ScanArea reaches a heading
+ * @param heading Target yaw in degrees
+ */
+static void turnToHeading(float heading) {
+    float delta = Logic::OccupancyGrid::wrapDegrees(heading - scanArea->getCurrentYaw());
+    if (fabsf(delta) < ESCAPE_HEADING_TOLERANCE_DEG) {
+        return;
+    }
+
+    // Closed loop on the gyro yaw in the motor control task
+    if (motors->rotate(delta)) {
+        unsigned long start = millis();
+        while (motors->isRotating() && millis() - start < ESCAPE_TURN_TIMEOUT_MS) {
+            vTaskDelay(pdMS_TO_TICKS(20));
+        }
+        motors->stop();
+        return;
+    }
+
+    // Positive yaw is a counter clockwise (left) turn
+    motors->move(delta > 0 ? Motors::MotorControl::LEFT : Motors::MotorControl::RIGHT);
+
+    unsigned long start = millis();
+    while (millis() - start < ESCAPE_TURN_TIMEOUT_MS) {
+        vTaskDelay(pdMS_TO_TICKS(20));
+        float remaining = Logic::OccupancyGrid::wrapDegrees(heading - scanArea->getCurrentYaw());
+        // Stop when close enough or once we overshoot
+        if (fabsf(remaining) < ESCAPE_HEADING_TOLERANCE_DEG || (remaining > 0) != (delta > 0)) {
+            break;
+        }
+    }
+
+    motors->stop();
+}
+
 /**
  * Handles obstacle detection and evasive maneuvers
+ * The escape heading comes from a single occupancy grid lookup: the free
+ * heading closest to where we were going.
  * @return true if obstacle was detected and handled
  */
 bool handleObstacleDetection() {
@@ -36,34 +89,29 @@ bool handleObstacleDetection() {
         return false;  // No obstacle detected or sensor not available
     }
 
-    bool pathFound = false;
-
     if (motors) {
-        Motors::MotorControl::Direction currentMove = motors->getCurrentDirection();
         motors->interuptMotor();
+        if (!backAway()) {
+            logger->warning("Cliff behind, escape aborted");
+            return true;
+        }
 
-        // Try to find a safe path
-        int attempts = 0;
-        const int maxAttempts = 20;  // Prevent infinite loop
-
-        while (!pathFound && attempts < maxAttempts) {
-            motors->interuptMotor();
-            // Choose random direction
+        float heading = 0;
+        bool pathFound = scanArea && scanArea->getOccupancyGrid().findFreeHeading(
+            scanArea->getCurrentYaw(), ESCAPE_CLEARANCE_CM, heading);
+
+        if (pathFound) {
+            turnToHeading(heading);
+            if (logger) {
+                logger->info("Escaping towards %.0f deg", heading);
+            }
+        } else {
+            // Everything around is blocked or the map is unavailable
             Motors::MotorControl::Direction turnDirection = (rand() % 2 == 0) ?
                 Motors::MotorControl::LEFT : Motors::MotorControl::RIGHT;
-
-            motors->move(Motors::MotorControl::BACKWARD, 1000);
             motors->move(turnDirection, 1500);
-
-            // Check if path is clear
-            pathFound = !distanceSensor->isObstacleDetected();
-            attempts++;
-
-            // Small delay before next check
-            vTaskDelay(pdMS_TO_TICKS(300));
+            motors->interuptMotor();
         }
-        
-        if(!pathFound) motors->interuptMotor();
     }
 
     if (logger) {
@@ -73,55 +121,69 @@ bool handleObstacleDetection() {
     return true;  // Obstacle was detected and handled
 }
 
+#if ESCAPE_ENABLED
 /**
- * Main protection function that prevents the robot from damage
- * by detecting obstacles and cliffs
+ * Hazards reported by the safety monitor, the escape runs on its own task
+ * since the maneuvers block for seconds
  */
-bool _protectInProgress = false;
-void protectCozmo() {
-    if (!motors || _protectInProgress) {
-        return;
-    }
-
-    Motors::MotorControl::Direction currentDirection = motors->getCurrentDirection();
+static QueueHandle_t escapeQueue = nullptr;
 
-    // Only run protection when moving forward or turning
-    if (currentDirection == Motors::MotorControl::STOP ||
-        currentDirection == Motors::MotorControl::BACKWARD) {
-        return;
+static bool isEscapeAllowed(Logic::SafetyMonitor::Hazard hazard) {
+    // Whoever drives by hand decides how to get away, and backing away from a
+    // blind distance sensor gains nothing
+    if (teleop && teleop->hasSession()) {
+        return false;
     }
+    return hazard != Logic::SafetyMonitor::HAZARD_OBSTACLE || !distanceSensor || distanceSensor->isRanging();
+}
 
-    _protectInProgress = true;
-    bool protectionActivated = false;
+static void escapeTask(void* param) {
+    Logic::SafetyMonitor::Hazard hazard;
+    while (true) {
+        if (xQueueReceive(escapeQueue, &hazard, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
 
-    // Handle cliff detection first (higher priority)
-    if (cliffLeftDetector->isCliffDetected() || cliffRightDetector->isCliffDetected()) {
-        protectionActivated = true;
-    }
+        if (!isEscapeAllowed(hazard)) {
+            continue;
+        }
+        if (hazard == Logic::SafetyMonitor::HAZARD_CLIFF) {
+            handleCliffDetection();
+        } else {
+            handleObstacleDetection();
+        }
 
-    // Then handle obstacle detection if no cliff was detected
-    else if (distanceSensor->isObstacleDetected()) {
-        protectionActivated = true;
+        // Stops during the maneuver were caused by the maneuver itself
+        xQueueReset(escapeQueue);
     }
+}
 
-    // Make sure we stop at the end if protection was activated
-    if (protectionActivated) {
-        if (motors) {
-            motors->stop();
-        }
+static void onSafetyStop(Logic::SafetyMonitor::Hazard hazard, void* arg) {
+    // Runs on the monitor task, never wait here
+    if (isEscapeAllowed(hazard)) {
+        xQueueOverwrite(escapeQueue, &hazard);
     }
-
-    _protectInProgress = false;
-    vTaskDelay(pdMS_TO_TICKS(100));
 }
 
-void protectCozmoTask(void * param) {
-	while (true)
-	{
-		protectCozmo();
-		vTaskDelay(pdMS_TO_TICKS(5));
+/**
+ * Back away from hazards the safety monitor stopped for
+ * @param core Core to run the escape maneuvers on
+ */
+void setupEscape(int core) {
+    if (!safetyMonitor || !motors) {
+        return;
+    }
 
-		taskYIELD();
-	}
+    escapeQueue = xQueueCreate(1, sizeof(Logic::SafetyMonitor::Hazard));
+    if (escapeQueue == nullptr ||
+        xTaskCreatePinnedToCore(escapeTask, "escape", 4096, nullptr, 2, nullptr, core) != pdPASS) {
+        logger->error("Failed to start the escape task");
+        return;
+    }
 
-}
\ No newline at end of file
+    safetyMonitor->setStopCallback(onSafetyStop);
+    logger->info("Escape maneuvers after safety stops enabled");
+}
+#else
+void setupEscape(int core) {}
+#endif
@@ -0,0 +1,12 @@
+#include <setup/setup.h>
+
+IModel::RegionTable* regionTable = nullptr;
+
+void setupRegionTable() {
+	if (regionTable) return;
+
+	regionTable = new IModel::RegionTable(fileManager, REGION_TABLE_PATH);
+	if (regionTable->begin()) {
+		IModel::AdministrativeRegion::setTable(regionTable);
+	}
+}
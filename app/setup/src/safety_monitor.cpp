@@ -0,0 +1,29 @@
+#include <Arduino.h>
+#include "setup/setup.h"
+
+Logic::SafetyMonitor *safetyMonitor;
+
+void setupSafetyMonitor() {
+  #if PROTECT_COZMO
+  if (!motors) {
+    logger->warning("Safety monitor disabled: motors not available");
+    return;
+  }
+
+  safetyMonitor = new Logic::SafetyMonitor(motors, distanceSensor, cliffLeftDetector, cliffRightDetector);
+  safetyMonitor->setPollInterval(SAFETY_POLL_INTERVAL_MS);
+  safetyMonitor->setDeadline(SAFETY_STOP_DEADLINE_US);
+
+  // Motion runs on core 1, so do the maneuvers after a stop
+  setupEscape(1);
+
+  #if CLIFF_DETECTOR_ENABLED && CLIFF_IO_EXTENDER
+  if (CLIFF_IO_EXTENDER_INT_PIN >= 0) {
+    safetyMonitor->attachExtenderInterrupt(CLIFF_IO_EXTENDER_INT_PIN);
+  }
+  #endif
+
+  logger->info("Safety monitor configured, worst-case stop budget %u us",
+    safetyMonitor->getWorstCaseBudgetUs());
+  #endif
+}
@@ -4,6 +4,6 @@
 Logic::ScanArea *scanArea;
 
 void setupScanArea() {
-  scanArea = new Logic::ScanArea(orientation, distanceSensor);
+  scanArea = new Logic::ScanArea(attitude, distanceSensor);
   scanArea->update();
 }
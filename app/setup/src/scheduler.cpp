@@ -0,0 +1,38 @@
+#include <Arduino.h>
+#include "setup/setup.h"
+
+Utils::Scheduler *scheduler;
+Utils::PowerManager *powerManager;
+
+void setupScheduler() {
+  scheduler = new Utils::Scheduler(SCHEDULER_RESOLUTION_MS);
+  powerManager = new Utils::PowerManager(scheduler, POWER_IDLE_TIMEOUT_MS);
+
+  // Periods per profile: active, idle, docked. Slack lets a job share the
+  // wakeup of another one instead of waking the CPU on its own.
+  scheduler->addJob("sensors", sensorMonitorJob, {50, 100, 500}, 10);
+  scheduler->addJob("ftp", ftpJob, {100, 250, 100}, 50);
+  scheduler->addJob("tasks", taskMonitorJob, {10000, 30000, 30000}, 1000);
+  scheduler->addJob("power", []() {
+    powerManager->update();
+  }, {1000, 1000, 1000}, 200);
+  if (connectionPool) {
+    scheduler->addJob("https", []() {
+      connectionPool->closeIdle();
+    }, {5000, 5000, 5000}, 2500);
+  }
+  if (services) {
+    // Same task as the FTP job, so FTP is never stopped mid poll
+    scheduler->addJob("services", []() {
+      services->collect();
+    }, {SERVICE_COLLECT_INTERVAL_MS, SERVICE_COLLECT_INTERVAL_MS, SERVICE_COLLECT_INTERVAL_MS}, SERVICE_COLLECT_INTERVAL_MS / 2);
+  }
+
+  powerManager->setConditions(
+    []() { return batteryManager && batteryManager->isCharging(); },
+    []() { return automation && automation->isEnabled(); }
+  );
+  powerManager->begin(Utils::PowerProfile::ACTIVE);
+
+  logger->info("Scheduler configured with %d jobs", scheduler->getJobCount());
+}
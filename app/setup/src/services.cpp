@@ -0,0 +1,26 @@
+#include "../setup.h"
+
+Utils::ServiceRegistry* services;
+Sensors::Camera* camera;
+
+void setupServices() {
+	services = new Utils::ServiceRegistry();
+
+#if CAMERA_ENABLED
+	// Built on the first services->acquire("camera") instead of at boot
+	services->add("camera", []() {
+		Sensors::Camera* instance = new Sensors::Camera();
+		if (!instance->init()) {
+			delete instance;
+			return false;
+		}
+		instance->setResolution(CAMERA_FRAME_SIZE);
+		camera = instance;
+		return true;
+	}, []() {
+		Sensors::Camera* instance = camera;
+		camera = nullptr;
+		delete instance;
+	}, CAMERA_IDLE_TIMEOUT_MS);
+#endif
+}
@@ -4,10 +4,7 @@
 #include <SendTask.h>
 
 // Task IDs for tracking
-String taskMonitorerId;
 String displayTaskId;
-String sensorMonitorTaskId;
-String cameraTaskId;
 
 /**
  * Initialize all background tasks on CPU 0
@@ -16,6 +13,17 @@ void setupTasksCpu0() {
     logger->info("Initializing tasks cpu 0 ...");
     
     bool core = 0;
+
+    #if PROTECT_COZMO
+    // Event driven safety monitor, sleeps until a sensor reports a hazard
+    if (safetyMonitor) {
+        if (safetyMonitor->start(core, SAFETY_MONITOR_PRIORITY)) {
+            logger->info("Safety monitor started on core 0");
+        } else {
+            logger->error("Failed to start safety monitor");
+        }
+    }
+    #endif
     
     // Create display task using SendTask library
     if (display) {
@@ -35,54 +43,15 @@ void setupTasksCpu0() {
         }
     }
     
-    // Create sensor monitoring task using SendTask library
-    sensorMonitorTaskId = SendTask::createLoopTaskOnCore(
-        sensorMonitorTask,
-        "SensorMonitor",
-        4096,                        // Stack size
-        5,                           // Priority
-        core,                        // Core ID (CPU 0)
-        "Sensor monitoring task for distance, orientation, and cliff detection"
-    );
-    
-    if (sensorMonitorTaskId.isEmpty()) {
-        logger->error("Failed to create sensor monitor task");
-    } else {
-        logger->info("Sensor monitor task created with ID: %s", sensorMonitorTaskId.c_str());
-    }
-    
-    // Create camera task using SendTask library
-    cameraTaskId = SendTask::createLoopTaskOnCore(
-        cameraTask,
-        "CameraTask",
-        4096,                        // Stack size
-        0,                           // Priority (lower priority)
-        core,                        // Core ID (CPU 0)
-        "Camera capture and processing task"
-    );
-    
-    if (cameraTaskId.isEmpty()) {
-        logger->error("Failed to create camera task");
-    } else {
-        logger->info("Camera task created with ID: %s", cameraTaskId.c_str());
+    // Periodic jobs (sensors, FTP, task monitor, power profile) share one
+    // scheduler task so their wakeups can be coalesced
+    if (scheduler) {
+        if (scheduler->start(core, 5, 8 * 1024)) {  // FTP needs the larger stack
+            logger->info("Scheduler started on core 0");
+        } else {
+            logger->error("Failed to start scheduler");
+        }
     }
-
-    // Create taskMonitorer task using SendTask library
-    taskMonitorerId = SendTask::createLoopTaskOnCore(
-        taskMonitorer,
-        "taskMonitorer",
-        4096,                        // Stack size
-        0,                           // Priority (lower priority)
-        core,                        // Core ID (CPU 0)
-        "Task monitor"
-    );
     
-    if (taskMonitorerId.isEmpty()) {
-        logger->error("Failed to create task monitor");
-    } else {
-        logger->info("Task monitor created with ID: %s", taskMonitorerId.c_str());
-    }
-
-    delay(1000);
     logger->info("Tasks initialized on cpu 0");
 }
\ No newline at end of file
@@ -4,8 +4,6 @@
 #include <SendTask.h>
 
 // Task IDs for tracking
-String protectCozmoTaskId;
-String ftpTaskId;
 String weatherServiceTaskId;
 String srControlTaskId;
 String notePlayerTaskId;
@@ -18,24 +16,6 @@ void setupTasksCpu1() {
 
     bool core = 1;
 
-    #if PROTECT_COZMO
-    // Create protect cozmo task using SendTask library
-    protectCozmoTaskId = SendTask::createLoopTaskOnCore(
-        protectCozmoTask,
-        "ProtectCozmo",
-        4 * 1024,                // Stack size
-        2,                       // Priority
-        core,                    // Core ID (CPU 1)
-        "Protect Cozmo task for safety monitoring"
-    );
-    
-    if (protectCozmoTaskId.isEmpty()) {
-        logger->error("Failed to create protect cozmo task");
-    } else {
-        logger->info("Protect Cozmo task created with ID: %s", protectCozmoTaskId.c_str());
-    }
-    #endif
-    
     // Create automation task using automation component's built-in method
     if (automation) {
         automation->start(1);  // Start on core 1
@@ -43,21 +23,33 @@ void setupTasksCpu1() {
         logger->info("Automation task started on core 1");
     }
 
-    // Create FTP task using SendTask library
-    ftpTaskId = SendTask::createLoopTaskOnCore(
-        ftpTask,
-        "FTPTask",
-        1024 * 8,                // Stack size
+    #if SPEAKER_ENABLED
+    // Create Note task for musical note playback using SendTask library
+    notePlayerTaskId = SendTask::createLoopTaskOnCore(
+        notePlayerTask,
+        "NotePlayer",
+        4096,                    // Stack size
         1,                       // Priority
         core,                    // Core ID (CPU 1)
-        "FTP server task for file management"
+        "Note musical playback task for audio effects and melodies"
     );
     
-    if (ftpTaskId.isEmpty()) {
-        logger->error("Failed to create FTP task");
+    if (notePlayerTaskId.isEmpty()) {
+        logger->error("Failed to create Note task");
     } else {
-        logger->info("FTP task created with ID: %s", ftpTaskId.c_str());
+        logger->info("Note task created with ID: %s", notePlayerTaskId.c_str());
     }
+    #endif
+
+    logger->info("Tasks initialized on cpu 1");
+}
+
+/**
+ * Start the weather task on CPU 1 once the service exists, a boot stage
+ * of its own so the rest of CPU 1 doesn't wait for the network
+ */
+void startWeatherTask() {
+    bool core = 1;
 
     // Create weather service task using SendTask library
     weatherServiceTaskId = SendTask::createLoopTaskOnCore(
@@ -74,14 +66,25 @@ void setupTasksCpu1() {
     } else {
         logger->info("Weather service task created with ID: %s", weatherServiceTaskId.c_str());
     }
+}
 
+/**
+ * Start wake word detection on CPU 1, run as a boot stage as soon as the
+ * models are loaded instead of after the whole boot
+ */
+void startListening() {
     #if MICROPHONE_ENABLED
+    bool core = 1;
+
     // Start speech recognition using ESP-SR library
     SR::sr_start(core);  // Start on core 1
     logger->info("Speech recognition started on core 1");
-    #endif
 
-    #if MICROPHONE_ENABLED
+    // Wake word detection needs the full clock in every power profile
+    if (powerManager) {
+        powerManager->setListening(true);
+    }
+
     // Create SR control task for handling ESP-SR pause/resume events using SendTask library
     srControlTaskId = SendTask::createLoopTaskOnCore(
         srControlTask,
@@ -97,26 +100,10 @@ void setupTasksCpu1() {
     } else {
         logger->info("SR control task created with ID: %s", srControlTaskId.c_str());
     }
-    #endif
 
-    #if SPEAKER_ENABLED
-    // Create Note task for musical note playback using SendTask library
-    notePlayerTaskId = SendTask::createLoopTaskOnCore(
-        notePlayerTask,
-        "NotePlayer",
-        4096,                    // Stack size
-        1,                       // Priority
-        core,                    // Core ID (CPU 1)
-        "Note musical playback task for audio effects and melodies"
-    );
-    
-    if (notePlayerTaskId.isEmpty()) {
-        logger->error("Failed to create Note task");
-    } else {
-        logger->info("Note task created with ID: %s", notePlayerTaskId.c_str());
+    // Commands now reach a running automation task
+    if (bootSequencer) {
+        bootSequencer->markMilestone("listening");
     }
     #endif
-
-    delay(1000);
-    logger->info("Tasks initialized on cpu 1");
 }
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include <Arduino.h>
+#include "setup/setup.h"
+
+Communication::TelemetryStream *telemetry;
+
+using Communication::TelemetryStream;
+
+/**
+ * Quantize the current robot state, every read here is a cached value
+ */
+static void sampleTelemetry(TelemetryStream::Sample& sample) {
+  int16_t* values = sample.values;
+  uint16_t flags = 0;
+
+  if (attitude) {
+    Logic::AttitudeService::Attitude state = attitude->getAttitude();
+    values[TelemetryStream::ROLL] = TelemetryStream::clamp(state.roll * 10.0f);
+    values[TelemetryStream::PITCH] = TelemetryStream::clamp(state.pitch * 10.0f);
+    values[TelemetryStream::YAW] = TelemetryStream::clamp(state.yaw * 10.0f);
+    if (state.stationary) flags |= TelemetryStream::FLAG_STATIONARY;
+  }
+
+  values[TelemetryStream::DISTANCE] = -1;
+  if (distanceSensor) {
+    Sensors::DistanceSensor::Sample distance = distanceSensor->getLatestSample();
+    if (distance.sequence > 0 && distance.filteredMm > 0) {
+      values[TelemetryStream::DISTANCE] = TelemetryStream::clamp(distance.filteredMm);
+    }
+    if (distanceSensor->isObstacleDetected()) flags |= TelemetryStream::FLAG_OBSTACLE;
+  }
+
+  if (cliffLeftDetector && cliffLeftDetector->isCliffDetected()) flags |= TelemetryStream::FLAG_CLIFF_LEFT;
+  if (cliffRightDetector && cliffRightDetector->isCliffDetected()) flags |= TelemetryStream::FLAG_CLIFF_RIGHT;
+  if (touchDetector && touchDetector->detected()) flags |= TelemetryStream::FLAG_TOUCH;
+
+  if (batteryManager) {
+    values[TelemetryStream::BATTERY_MV] = TelemetryStream::clamp(batteryManager->getVoltage() * 1000.0f);
+    values[TelemetryStream::BATTERY_LEVEL] = batteryManager->getLevel();
+    if (batteryManager->isCharging()) flags |= TelemetryStream::FLAG_CHARGING;
+  }
+
+  values[TelemetryStream::MOTOR_DIRECTION] = motors ? motors->getCurrentDirection() : Motors::MotorControl::STOP;
+  if (servos) {
+    values[TelemetryStream::HEAD_ANGLE] = servos->getHead();
+    values[TelemetryStream::HAND_ANGLE] = servos->getHand();
+  }
+  if (display) {
+    values[TelemetryStream::MIC_LEVEL] = TelemetryStream::clamp(display->getMicLevel());
+  }
+
+  if (teleop) {
+    Motors::Teleop::Stats stats = teleop->getStats();
+    values[TelemetryStream::TELEOP_SEQUENCE] = (int16_t)stats.lastSequence;
+    values[TelemetryStream::TELEOP_LATENCY] = TelemetryStream::clamp(stats.lastLatencyUs / 100.0f);
+  }
+
+  values[TelemetryStream::FLAGS] = flags;
+}
+
+void setupTelemetry() {
+  #if WEBSOCKET_ENABLED && TELEMETRY_ENABLED
+  if (!scheduler) {
+    logger->warning("Telemetry disabled: scheduler not available");
+    return;
+  }
+
+  telemetry = new TelemetryStream(TELEMETRY_MAX_RATE_HZ, TELEMETRY_KEYFRAME_MS);
+  telemetry->setSource(sampleTelemetry);
+  telemetry->setSink(sendWebSocketFrame);
+
+  // Ticks at the highest client rate, returns at once without subscribers
+  uint32_t periodMs = 1000 / TELEMETRY_MAX_RATE_HZ;
+  scheduler->addJob("telemetry", []() {
+    telemetry->tick();
+  }, {periodMs, periodMs * 2, periodMs * 5}, periodMs / 4);
+
+  logger->info("Telemetry stream ready, up to %d Hz", TELEMETRY_MAX_RATE_HZ);
+  #endif
+}
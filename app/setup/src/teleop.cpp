@@ -0,0 +1,22 @@
+#include <Arduino.h>
+#include "setup/setup.h"
+
+Motors::Teleop *teleop;
+
+void setupTeleop() {
+  #if WEBSOCKET_ENABLED && TELEOP_ENABLED
+  if (!motors || !scheduler) {
+    logger->warning("Teleop disabled: motors or scheduler not available");
+    return;
+  }
+
+  teleop = new Motors::Teleop(motors, TELEOP_DEADMAN_MS);
+
+  // Same period in every profile, driving must not slow down when idle
+  scheduler->addJob("teleop", []() {
+    teleop->tick();
+  }, {TELEOP_PERIOD_MS, TELEOP_PERIOD_MS, TELEOP_PERIOD_MS});
+
+  logger->info("Teleop ready, %d ms control period, %d ms dead-man", TELEOP_PERIOD_MS, TELEOP_DEADMAN_MS);
+  #endif
+}
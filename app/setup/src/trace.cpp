@@ -0,0 +1,13 @@
+#include "../setup.h"
+
+void setupTrace() {
+#if TRACE_ENABLED
+	if (Utils::Trace::init(TRACE_EVENTS_PER_CORE)) {
+		logger->info("Trace rings ready, %u events per core", Utils::Trace::getStats().capacity);
+	} else {
+		logger->error("Failed to allocate trace rings");
+	}
+#else
+	logger->info("Tracing disabled in configuration");
+#endif
+}
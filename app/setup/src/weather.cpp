@@ -8,11 +8,17 @@ void setupWeather(){
 	Communication::WeatherService::WeatherConfig cfg;
 	cfg.adm4Code = "31.71.03.1001"; // Kemayoran, Jakarta Pusat
 	cfg.cacheExpiryMinutes = 60;
+	cfg.minRefreshMs = WEATHER_MIN_REFRESH_MS;
+	cfg.refreshJitterMs = WEATHER_REFRESH_JITTER_MS;
+	cfg.coalesceWindowMs = WEATHER_COALESCE_WINDOW_MS;
+	cfg.retryMinMs = WEATHER_RETRY_MIN_MS;
+	cfg.retryMaxMs = WEATHER_RETRY_MAX_MS;
 
 	weatherService = new Communication::WeatherService(fileManager);
 	weatherService->init(cfg);
+	weatherService->setConnectionPool(connectionPool);
 
 	if (WiFi.status() == WL_CONNECTED) {
-		weatherService->getCurrentWeather(weatherCallback, true);
+		weatherService->refreshIfDue(weatherCallback);
 	}
 }
\ No newline at end of file
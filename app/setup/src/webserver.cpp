@@ -34,6 +34,7 @@ void setupWebServer() {
 	registerWebRoutes(webRouter);
 	registerApiRoutes(webRouter);
 	registerWebSocketRoutes(webRouter);
+	registerTeleopSocket();
 
 	// Start the application
 	app->run();
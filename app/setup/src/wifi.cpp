@@ -2,12 +2,37 @@
 #include "setup/setup.h"
 
 Communication::WiFiManager *wifiManager;
+Communication::ConnectionPool *connectionPool = nullptr;
+
+// Kept for the lifetime of the pool, which holds a pointer to it
+static String httpsRootCA;
+
+static void setupRootCA() {
+  const char* path = HTTPS_CA_CERT_FILE;
+  if (path[0] == '\0') {
+    return;
+  }
+
+  if (fileManager && fileManager->exists(path)) {
+    httpsRootCA = fileManager->readFile(path);
+  }
+  if (httpsRootCA.indexOf("-----BEGIN CERTIFICATE-----") < 0) {
+    logger->warning("No CA certificate in %s, TLS hosts are not verified", path);
+    httpsRootCA = "";
+    return;
+  }
+
+  connectionPool->setCACert(httpsRootCA.c_str());
+  logger->info("TLS hosts verified against %s", path);
+}
 
 void setupWiFi() {
   if (WIFI_ENABLED) {
     logger->info("Setting up WiFi...");
     wifiManager = new Communication::WiFiManager(fileManager);
     wifiManager->init();
+    connectionPool = new Communication::ConnectionPool(HTTPS_IDLE_TIMEOUT_MS, HTTPS_TIMEOUT_MS);
+    setupRootCA();
     
     // Get config (already loaded from file or defaults in constructor)
     Communication::WiFiManager::WiFiConfig config = wifiManager->getConfig();
@@ -30,7 +55,6 @@ void setupWiFi() {
         display->drawCenteredText(30, config.ssid.c_str());
         display->drawCenteredText(50, wifiManager->getIP().c_str());
         display->update();
-        delay(2000);
       }
     } else {
       logger->warning("WiFi connection failed, starting AP mode");
@@ -52,7 +76,6 @@ void setupWiFi() {
           display->drawCenteredText(30, config.apSsid.c_str());
           display->drawCenteredText(50, wifiManager->getIP().c_str());
           display->update();
-          delay(2000);
         }
       } else {
         logger->error("AP start failed");
@@ -3,30 +3,30 @@
 #include "setup/setup.h"
 
 // Task IDs for tracking
-extern String taskMonitorerId;
 extern String displayTaskId;
-extern String sensorMonitorTaskId;
-extern String cameraTaskId;
-extern String protectCozmoTaskId;
-extern String ftpTaskId;
 extern String weatherServiceTaskId;
 extern String srControlTaskId;
 extern String notePlayerTaskId;
 
-void taskMonitorer(void* param);
-void protectCozmoTask(void * param);
 void displayTask(void* param);
 void gptChatTask(void* parameter);
-void sensorMonitorTask(void* parameter);
-void ftpTask(void* param);
+
+/**
+ * Ask GPT about a prompt with the robot context; the reply is spoken and
+ * its commands run while it streams in
+ * @return false if GPT is unavailable or already answering
+ */
+bool startGptChat(const Utils::Sstring& prompt);
 void weatherServiceTask(void* param);
 void srControlTask(void* param);
-void cameraTask(void* param);
 void notePlayerTask(void* param);
 
-// Function prototypes
-void protectCozmo();
+// Periodic jobs, run by the scheduler
+void sensorMonitorJob();
+void ftpJob();
+void taskMonitorJob();
 
 // Task management utilities
 void printTaskStatus();
+void printLoopProfiles();
 void cleanupTasks();
\ No newline at end of file
@@ -1,10 +1,8 @@
 #include "tasks/register.h"
 
-void ftpTask(void* param) {
-	TickType_t lastWakeTime = xTaskGetTickCount();
-	TickType_t updateFrequency = pdMS_TO_TICKS(100);
-	while(1){
-		vTaskDelayUntil(&lastWakeTime, updateFrequency);
-		ftpSrv.handleFTP();
+void ftpJob() {
+	// Started and stopped on this task by the service registry
+	if (ftpSrv) {
+		ftpSrv->handleFTP();
 	}
 }
\ No newline at end of file
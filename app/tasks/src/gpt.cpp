@@ -1,192 +1,222 @@
 #include "../register.h"
 
-void gptChatTask(void * param) {
-	if (param != nullptr){
-		// Create additional command with comprehensive hardware and sensor context
-		Utils::Sstring additionalCommand = "You are the AI brain of a Cozmo IoT Robot. Here's the current hardware status and sensor readings:\n\n";
-		
-		// ---- SYSTEM INFORMATION ----
-		additionalCommand += "=== SYSTEM INFORMATION ===\n";
-		additionalCommand += "System version: Cozmo IoT System (June 2025)\n";
-		
-		#if CONFIG_IDF_TARGET_ESP32
-		additionalCommand += "Hardware: ESP32CAM\n";
-		#elif CONFIG_IDF_TARGET_ESP32S3
-		additionalCommand += "Hardware: ESP32-S3-DevKitC-1\n";
-		#else
-		additionalCommand += "Hardware: Unknown ESP32 variant\n";
-		#endif
-		
-				// CPU temperature using our TemperatureSensor class
-		if (temperatureSensor != nullptr && temperatureSensor->isSupported()) {
-			float cpuTemp = temperatureSensor->readTemperature();
-			if (!isnan(cpuTemp)) {
-				additionalCommand += "CPU temperature: "; 
-				additionalCommand += Utils::Sstring(cpuTemp, 1); 
-				additionalCommand += "°C\n";
-			} else {
-				additionalCommand += "CPU temperature: Not available\n";
-			}
-		} else {
-			additionalCommand += "CPU temperature: Sensor not supported\n";
-		}
-		
-		// ---- SENSOR READINGS ----
-		additionalCommand += "\n=== CURRENT SENSOR READINGS ===\n";
-		
-		// Distance sensor (ultrasonic) readings
-		if (distanceSensor != nullptr) {
-			float distance = distanceSensor->measureDistance();
-			additionalCommand += "Distance sensor: "; 
-			additionalCommand += Utils::Sstring(distance); 
-			additionalCommand += " cm\n";
-			bool isObstacle = (distance > 0 && distance < ULTRASONIC_OBSTACLE_TRESHOLD);
-			additionalCommand += "Obstacle detected: "; 
-			additionalCommand += isObstacle ? "Yes\n" : "No\n";
-		}
-		
-		// Cliff detector readings
-		if (cliffLeftDetector != nullptr) {
-			cliffLeftDetector->update(); // Ensure we have fresh data
-			bool leftCliffDetected = cliffLeftDetector->isCliffDetected();
-			additionalCommand += "Left cliff detector: ";
-			additionalCommand += leftCliffDetected ? "CLIFF DETECTED\n" : "No cliff\n";
-		}
-		
-		if (cliffRightDetector != nullptr) {
-			cliffRightDetector->update(); // Ensure we have fresh data
-			bool rightCliffDetected = cliffRightDetector->isCliffDetected();
-			additionalCommand += "Right cliff detector: ";
-			additionalCommand += rightCliffDetected ? "CLIFF DETECTED\n" : "No cliff\n";
-		}
-		
-		// Orientation sensor readings
-		if (orientation != nullptr) {
-			// Add more specific orientation data if available
-			additionalCommand += "Orientation sensors: Active\n";
-			// If methods available, add specific values:
-			additionalCommand += "Gyro X: "; 
-			additionalCommand += Utils::Sstring(orientation->getX());
-			additionalCommand += ", Y: ";
-			additionalCommand += Utils::Sstring(orientation->getY()); 
-			additionalCommand += ", Z: ";
-			additionalCommand += Utils::Sstring(orientation->getZ()); 
-			additionalCommand += "\nAccel X: "; 
-			additionalCommand += Utils::Sstring(orientation->getAccelX()); 
-			additionalCommand += ", Y: "; 
-			additionalCommand += Utils::Sstring(orientation->getAccelY());
-			additionalCommand += ", Z: ";
-			additionalCommand += Utils::Sstring(orientation->getAccelZ());
-			additionalCommand += "\n";
+/**
+ * Commands from a streamed reply, run in order on their own task since
+ * movement commands block for their duration while the stream keeps reading
+ */
+struct GptCommand {
+	char text[Communication::GptStreamParser::MAX_COMMAND + 1];
+};
+
+static QueueHandle_t gptCommandQueue = nullptr;
+
+static void gptCommandTask(void* param) {
+	GptCommand command;
+	while (true) {
+		if (xQueueReceive(gptCommandQueue, &command, portMAX_DELAY) == pdTRUE && commandMapper != nullptr) {
+			commandMapper->executeCommand(Utils::Sstring(command.text));
 		}
-		
-		// ---- HARDWARE CONFIGURATION ----
-		additionalCommand += "\n=== HARDWARE CONFIGURATION ===\n";
-		
-		// Motors configuration
-		if (motors != nullptr) {
-			additionalCommand += "Motors: Enabled \n";
-		} else {
-			additionalCommand += "Motors: Disabled\n";
+	}
+}
+
+static bool queueGptCommand(const char* text, size_t length) {
+	if (gptCommandQueue == nullptr) {
+		gptCommandQueue = xQueueCreate(8, sizeof(GptCommand));
+		if (gptCommandQueue == nullptr ||
+			xTaskCreatePinnedToCore(gptCommandTask, "gpt_commands", 4096, nullptr, 1, nullptr, 1) != pdPASS) {
+			logger->error("Failed to start the GPT command task");
+			return false;
 		}
-		
-		// Servo information
-		#if SERVO_ENABLED
-		additionalCommand += "Servos: Enabled\n";
-		#else
-		additionalCommand += "Servos: Disabled\n";
-		#endif
-		
-		// Sensors configuration
-		additionalCommand += "\nSensor Configuration:\n";
-		
-		// Ultrasonic sensor
-		#if ULTRASONIC_ENABLED
-		additionalCommand += "- Ultrasonic: Enabled\n";
-		#else
-		additionalCommand += "- Ultrasonic: Disabled\n";
-		#endif
-		
-		// Cliff detectors
-		#if CLIFF_DETECTOR_ENABLED
-		additionalCommand += "- Cliff detectors: Enabled (Digital sensors)(1=cliff detected)\n";
-		#else
-		additionalCommand += "- Cliff detectors: Disabled\n";
-		#endif
-		
-		// Orientation sensors
-		#if ORIENTATION_ENABLED
-		additionalCommand += "- Orientation sensors: Enabled\n";
-		#else
-		additionalCommand += "- Orientation sensors: Disabled\n";
-		#endif
-		
-		// Camera configuration
+	}
+
+	GptCommand command;
+	length = std::min(length, sizeof(command.text) - 1);
+	memcpy(command.text, text, length);
+	command.text[length] = '\0';
+	if (xQueueSend(gptCommandQueue, &command, 0) != pdTRUE) {
+		logger->warning("GPT command queue full, dropped %s", command.text);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Static parts of the robot context, kept in flash and written straight
+ * into the request body
+ */
+static const char CONTEXT_INTRO[] =
+	"You are the AI brain of a Cozmo IoT Robot. Here's the current hardware status and sensor readings:\n\n"
+	"=== SYSTEM INFORMATION ===\n"
+	"System version: Cozmo IoT System (June 2025)\n"
+#if CONFIG_IDF_TARGET_ESP32
+	"Hardware: ESP32CAM\n";
+#elif CONFIG_IDF_TARGET_ESP32S3
+	"Hardware: ESP32-S3-DevKitC-1\n";
+#else
+	"Hardware: Unknown ESP32 variant\n";
+#endif
+
+static const char CONTEXT_SENSOR_CONFIGURATION[] =
+#if SERVO_ENABLED
+	"Servos: Enabled\n"
+#else
+	"Servos: Disabled\n"
+#endif
+	"\nSensor Configuration:\n"
+#if ULTRASONIC_ENABLED
+	"- Ultrasonic: Enabled\n"
+#else
+	"- Ultrasonic: Disabled\n"
+#endif
+#if CLIFF_DETECTOR_ENABLED
+	"- Cliff detectors: Enabled (Digital sensors)(1=cliff detected)\n"
+#else
+	"- Cliff detectors: Disabled\n"
+#endif
+#if ORIENTATION_ENABLED
+	"- Orientation sensors: Enabled\n"
+#else
+	"- Orientation sensors: Disabled\n"
+#endif
 #if CAMERA_ENABLED
 	#if CONFIG_IDF_TARGET_ESP32
-		additionalCommand += "- Camera: Enabled (Model: AI-THINKER ESP32-CAM)\n";
+	"- Camera: Enabled (Model: AI-THINKER ESP32-CAM)\n"
 	#elif CONFIG_IDF_TARGET_ESP32S3
-		additionalCommand += "- Camera: Enabled (Model: ESP32-S3 OV2640)\n";
+	"- Camera: Enabled (Model: ESP32-S3 OV2640)\n"
 	#else
-		additionalCommand += "- Camera: Enabled (Unknown model)\n";
+	"- Camera: Enabled (Unknown model)\n"
 	#endif
 #else
-		additionalCommand += "- Camera: Disabled\n";
+	"- Camera: Disabled\n"
 #endif
-		
-		// Display
 #if SCREEN_ENABLED
-		additionalCommand += "- Screen: Enabled\n";
+	"- Screen: Enabled\n";
 #else
-		additionalCommand += "- Screen: Disabled\n";
+	"- Screen: Disabled\n";
 #endif
-		
-		// Add tips for responding to the robot
-		additionalCommand += "\n=== RESPONSE GUIDELINES ===\n";
-		additionalCommand += "1. Format your commands using exact syntax: [COMMAND] or [COMMAND=parameter]\n";
-		additionalCommand += "   - Duration format examples: 5s, 10s, 1m (minimum 3 seconds)\n";
-		additionalCommand += "   - Position parameters: 0-180 for servo positions\n";
-		additionalCommand += "2. Available face expressions: [FACE_NORMAL], [FACE_HAPPY], [FACE_SAD], [FACE_ANGRY], [FACE_SURPRISED], \n";
-		additionalCommand += "   [FACE_WORRIED], [FACE_FOCUSED], [FACE_ANNOYED], [FACE_SKEPTIC], [FACE_FRUSTRATED], [FACE_UNIMPRESSED],\n";
-		additionalCommand += "   [FACE_SLEEPY], [FACE_SUSPICIOUS], [FACE_SQUINT], [FACE_FURIOUS], [FACE_SCARED], [FACE_AWE], [FACE_GLEE]\n";
-		additionalCommand += "3. Look direction commands: [LOOK_LEFT], [LOOK_RIGHT], [LOOK_FRONT], [LOOK_TOP], [LOOK_BOTTOM], [BLINK], [LOOK_AROUND]\n";
-		additionalCommand += "4. Movement commands: [MOVE_FORWARD=5s], [MOVE_BACKWARD=5s], [TURN_LEFT=3s], [TURN_RIGHT=3s], [STOP] but you only can use backward commands when you call forward too\n";
-		additionalCommand += "5. Advanced motor commands: [MOTOR_LEFT=duration], [MOTOR_RIGHT=duration] where duration in ms\n";
-		additionalCommand += "6. Servo commands: [HEAD_UP], [HEAD_DOWN], [HEAD_CENTER], [HAND_UP], [HAND_DOWN], [HAND_CENTER]\n";
-		additionalCommand += "7. Precise servo control: [HEAD_POSITION=angle], [HAND_POSITION=angle] where angle is 0-180\n";
-		additionalCommand += "8. Combined actions: [LOOK_AROUND] or you can combine a few commands to make custom dances\n";
-		additionalCommand += "9. Consider sensor readings when responding (avoid cliffs, obstacles, etc)\n";
-		additionalCommand += "10. Be concise but helpful in your responses\n";
-		additionalCommand += "11. If asked about hardware capabilities, use this context to provide accurate information\n\n";
-		
-		// Send the prompt with enhanced context
-		// gptAdapter->sendPrompt(data->prompt, additionalCommand, [data](const Utils::Sstring& gptResponse){
-		// 	// Process commands in the response if CommandMapper is available
-		// 	Utils::Sstring processedResponse = gptResponse;
-			
-		// 	if (commandMapper != nullptr) {
-		// 		// Extract and execute any commands in the response
-		// 		logger->debug("Processing commands in GPT response");
-		// 		int commandCount = commandMapper->executeCommandString(gptResponse);
-				
-		// 		if (commandCount > 0) {
-		// 			logger->debug("Executed " + Utils::Sstring(commandCount) + " commands from GPT response");
-					
-		// 			// Get just the text without commands
-		// 			processedResponse = commandMapper->extractText(gptResponse);
-		// 		}
-		// 	}
-
-		// 	// Call the callback with the processed response
-		// 	data->callback(processedResponse);
-
-		// 	if (display){
-		// 		display->mutexClear();
-		// 		display->drawCenteredText(20, processedResponse);
-		// 		display->mutexUpdate();
-		// 	}
-		// });
+
+static const char CONTEXT_GUIDELINES[] =
+	"\n=== RESPONSE GUIDELINES ===\n"
+	"1. Format your commands using exact syntax: [COMMAND] or [COMMAND=parameter]\n"
+	"   - Duration format examples: 5s, 10s, 1m (minimum 3 seconds)\n"
+	"   - Position parameters: 0-180 for servo positions\n"
+	"2. Available face expressions: [FACE_NORMAL], [FACE_HAPPY], [FACE_SAD], [FACE_ANGRY], [FACE_SURPRISED], \n"
+	"   [FACE_WORRIED], [FACE_FOCUSED], [FACE_ANNOYED], [FACE_SKEPTIC], [FACE_FRUSTRATED], [FACE_UNIMPRESSED],\n"
+	"   [FACE_SLEEPY], [FACE_SUSPICIOUS], [FACE_SQUINT], [FACE_FURIOUS], [FACE_SCARED], [FACE_AWE], [FACE_GLEE]\n"
+	"3. Look direction commands: [LOOK_LEFT], [LOOK_RIGHT], [LOOK_FRONT], [LOOK_TOP], [LOOK_BOTTOM], [BLINK], [LOOK_AROUND]\n"
+	"4. Movement commands: [MOVE_FORWARD=5s], [MOVE_BACKWARD=5s], [TURN_LEFT=3s], [TURN_RIGHT=3s], [STOP] but you only can use backward commands when you call forward too\n"
+	"5. Advanced motor commands: [MOTOR_LEFT=duration], [MOTOR_RIGHT=duration] where duration in ms\n"
+	"6. Servo commands: [HEAD_UP], [HEAD_DOWN], [HEAD_CENTER], [HAND_UP], [HAND_DOWN], [HAND_CENTER]\n"
+	"7. Precise servo control: [HEAD_POSITION=angle], [HAND_POSITION=angle] where angle is 0-180\n"
+	"8. Combined actions: [LOOK_AROUND] or you can combine a few commands to make custom dances\n"
+	"9. Consider sensor readings when responding (avoid cliffs, obstacles, etc)\n"
+	"10. Be concise but helpful in your responses\n"
+	"11. If asked about hardware capabilities, use this context to provide accurate information\n\n";
+
+/**
+ * Write the hardware status and current sensor readings into a prompt
+ */
+static void writeRobotContext(Communication::PromptWriter& out) {
+	out.text(CONTEXT_INTRO, sizeof(CONTEXT_INTRO) - 1);
+
+	// CPU temperature using our TemperatureSensor class
+	if (temperatureSensor != nullptr && temperatureSensor->isSupported()) {
+		float cpuTemp = temperatureSensor->readTemperature();
+		if (!isnan(cpuTemp)) {
+			out.text("CPU temperature: ").number(cpuTemp, 1).text("°C\n");
+		} else {
+			out.text("CPU temperature: Not available\n");
+		}
+	} else {
+		out.text("CPU temperature: Sensor not supported\n");
+	}
+
+	// ---- SENSOR READINGS ----
+	out.text("\n=== CURRENT SENSOR READINGS ===\n");
+
+	// Distance sensor (ultrasonic) readings
+	if (distanceSensor != nullptr) {
+		float distance = distanceSensor->measureDistance();
+		bool isObstacle = (distance > 0 && distance < ULTRASONIC_OBSTACLE_TRESHOLD);
+		out.text("Distance sensor: ").number(distance).text(" cm\n");
+		out.text("Obstacle detected: ").text(isObstacle ? "Yes\n" : "No\n");
+	}
+
+	// Cliff detector readings
+	if (cliffLeftDetector != nullptr) {
+		cliffLeftDetector->update(); // Ensure we have fresh data
+		out.text("Left cliff detector: ").text(cliffLeftDetector->isCliffDetected() ? "CLIFF DETECTED\n" : "No cliff\n");
+	}
+
+	if (cliffRightDetector != nullptr) {
+		cliffRightDetector->update(); // Ensure we have fresh data
+		out.text("Right cliff detector: ").text(cliffRightDetector->isCliffDetected() ? "CLIFF DETECTED\n" : "No cliff\n");
+	}
+
+	// Orientation sensor readings
+	if (orientation != nullptr) {
+		out.text("Orientation sensors: Active\n");
+		out.text("Gyro X: ").number(orientation->getX())
+		   .text(", Y: ").number(orientation->getY())
+		   .text(", Z: ").number(orientation->getZ())
+		   .text("\nAccel X: ").number(orientation->getAccelX())
+		   .text(", Y: ").number(orientation->getAccelY())
+		   .text(", Z: ").number(orientation->getAccelZ())
+		   .text("\n");
+	}
+
+	// ---- HARDWARE CONFIGURATION ----
+	out.text("\n=== HARDWARE CONFIGURATION ===\n");
+	out.text(motors != nullptr ? "Motors: Enabled \n" : "Motors: Disabled\n");
+	out.text(CONTEXT_SENSOR_CONFIGURATION, sizeof(CONTEXT_SENSOR_CONFIGURATION) - 1);
+	out.text(CONTEXT_GUIDELINES, sizeof(CONTEXT_GUIDELINES) - 1);
+}
+
+/**
+ * Ask GPT about a prompt with the current robot context
+ * @param param Heap allocated Utils::Sstring prompt, deleted by the task
+ */
+void gptChatTask(void * param) {
+	if (param != nullptr){
+		// Stream the reply: commands run and sentences are spoken while the
+		// rest is still arriving
+		Utils::Sstring* prompt = static_cast<Utils::Sstring*>(param);
+		Communication::GPTAdapter::StreamHandlers handlers;
+		handlers.onCommand = [](const char* command, size_t length) {
+			queueGptCommand(command, length);
+		};
+		handlers.onSentence = [](const char* sentence, size_t length) {
+			sayText(sentence);
+		};
+		handlers.onDone = [](const Utils::Sstring& text, const Utils::Sstring& error) {
+			if (error.length() > 0) {
+				logger->error("GPT stream failed: %s", error.c_str());
+				return;
+			}
+			logger->debug("GPT reply: %s", text.c_str());
+		};
+
+		// The context is read from the sensors while the request body is written
+		if (gptAdapter == nullptr || !gptAdapter->streamPrompt(*prompt, writeRobotContext, handlers)) {
+			logger->warning("GPT chat not started, adapter unavailable, busy or the prompt did not fit");
+		}
+		delete prompt;
 	}
 	
 	vTaskDelete(NULL);
-}
\ No newline at end of file
+}
+
+bool startGptChat(const Utils::Sstring& prompt) {
+	// Checked here too so a busy adapter doesn't cost a task
+	if (gptAdapter == nullptr || !gptAdapter->isInitialized() || gptAdapter->isStreaming() || prompt.length() == 0) {
+		return false;
+	}
+
+	Utils::Sstring* param = new Utils::Sstring(prompt);
+	if (xTaskCreatePinnedToCore(gptChatTask, "gpt_chat", 4096, param, 1, nullptr, 1) != pdPASS) {
+		delete param;
+		logger->error("Failed to start the GPT chat task");
+		return false;
+	}
+	return true;
+}
@@ -1,28 +1,21 @@
 #include "../register.h"
 
 void notePlayerTask(void* param) {
-    if (!notePlayer || !notification) {
-        logger->error("Note task: Note system or notification not initialized");
+    if (!notePlayer || !eventBus) {
+        logger->error("Note task: Note system or event bus not initialized");
         vTaskDelete(NULL);
         return;
     }
 
     logger->info("Note task started");
-    
-    const TickType_t checkFrequency = pdMS_TO_TICKS(50); // Check every 50ms
 
     while (true) {
-        void* eventPtr = notification->consume(NOTIFICATION_NOTE, checkFrequency);
-        
-        if (eventPtr) {
-            const Note::Melody event = (Note::Melody)(intptr_t)eventPtr;
+        Note::Melody event;
+        if (eventBus->receive<Topic::NOTE>(event)) {
             logger->info("Note task received event: %d", event);
             
             // Call the callback function to handle the event
-            callbackNotePlayer(eventPtr);
+            callbackNotePlayer(event);
         }
-        
-        // Small delay to prevent watchdog issues
-        vTaskDelay(pdMS_TO_TICKS(10));
     }
 }
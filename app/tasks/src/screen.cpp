@@ -1,15 +1,22 @@
 #include "../register.h"
+#include <SendTask.h>
 
 void displayTask(void *param){
-		TickType_t lastWakeTime = xTaskGetTickCount();
 		TickType_t updateFrequency = pdMS_TO_TICKS(50);
+		TickType_t nextFrame = xTaskGetTickCount() + updateFrequency;
 		const char* TAG = "displayTask";
 
 		size_t updateDelay = 0;
 		EVENT_DISPLAY lastEvent = EVENT_DISPLAY::NOTHING;
 		display->enableMutex();
 		while(1) {
-				vTaskDelayUntil(&lastWakeTime, updateFrequency);
+				// Sleep until the next frame, an event wakes us earlier so
+				// the screen reacts without waiting for the frame
+				TickType_t now = xTaskGetTickCount();
+				TickType_t wait = (int32_t)(nextFrame - now) > 0 ? nextFrame - now : 0;
+				EVENT_DISPLAY event;
+				bool received = eventBus->receive<Topic::DISPLAY>(event, wait);
+				bool frameDue = (int32_t)(xTaskGetTickCount() - nextFrame) >= 0;
 
 				if (updateDelay > 0 && updateDelay <= millis()) {
 					updateDelay = 0;
@@ -21,9 +28,7 @@ void displayTask(void *param){
 					ESP_LOGI(TAG, "Reset Event Screen %d triggered", lastEvent);
 				}
 
-				if (notification->has(NOTIFICATION_DISPLAY)){
-					void* eventPtr = notification->consume(NOTIFICATION_DISPLAY, updateFrequency);
-					EVENT_DISPLAY event = (EVENT_DISPLAY)(intptr_t)eventPtr;
+				if (received){
 					if (event >= 0 && event <= EVENT_DISPLAY::NOTHING) {
 						lastEvent = event;
 						updateDelay = 0;
@@ -76,6 +81,21 @@ void displayTask(void *param){
 							lastEvent = EVENT_DISPLAY::NOTHING;
 					}
 				}
+
+				if (!frameDue) {
+					continue;
+				}
+				// Frame rate follows the power profile
+				if (powerManager) {
+					updateFrequency = pdMS_TO_TICKS(powerManager->getFramePeriodMs());
+				}
+				nextFrame += updateFrequency;
+				bool missed = (int32_t)(xTaskGetTickCount() - nextFrame) >= 0;
+				if (missed) {
+					// Fell behind, do not try to catch up with a burst of frames
+					nextFrame = xTaskGetTickCount() + updateFrequency;
+				}
+				SendTask::beginIteration();
 				
 		#if MICROPHONE_ENABLED
 			#if MICROPHONE_ANALOG
@@ -87,11 +107,12 @@ void displayTask(void *param){
 
 		// Update orientation data if orientation sensor is available and display is in orientation mode
 		#if ORIENTATION_ENABLED
-			if (orientation && display) {
-				display->updateOrientation(orientation);
+			if (attitude && display) {
+				display->updateOrientation(attitude);
 			}
 		#endif
 			
 			display->update();
+			SendTask::endIteration(missed);
 		}
 }
\ No newline at end of file
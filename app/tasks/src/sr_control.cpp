@@ -3,41 +3,45 @@
 #if MICROPHONE_ENABLED
 
 void srControlTask(void *param) {
-    TickType_t lastWakeTime = xTaskGetTickCount();
-    TickType_t checkFrequency = pdMS_TO_TICKS(10); // Check every 10ms for responsiveness
-    
     logger->info("SR Control Task started");
     
     while(1) {
-        vTaskDelayUntil(&lastWakeTime, checkFrequency);
-        
-        if (notification->has(NOTIFICATION_SR)) {
-            void* eventPtr = notification->consume(NOTIFICATION_SR, checkFrequency);
-            const char* event = (const char*)eventPtr;
-            
-            if (event) {
-                if (strcmp(event, EVENT_SR::PAUSE) == 0) {
-                    logger->info("Pausing ESP-SR system");
-                    esp_err_t result = SR::sr_pause();
-                    if (result == ESP_OK) {
-                        logger->info("ESP-SR paused successfully");
-                    } else {
-                        logger->error("Failed to pause ESP-SR: %s", esp_err_to_name(result));
+        // Sleep until someone asks to pause or resume
+        EVENT_SR::Type event;
+        if (!eventBus->receive<Topic::SR>(event)) {
+            continue;
+        }
+
+        switch (event) {
+            case EVENT_SR::PAUSE: {
+                logger->info("Pausing ESP-SR system");
+                esp_err_t result = SR::sr_pause();
+                if (result == ESP_OK) {
+                    logger->info("ESP-SR paused successfully");
+                    if (powerManager) {
+                        powerManager->setListening(false);
                     }
+                } else {
+                    logger->error("Failed to pause ESP-SR: %s", esp_err_to_name(result));
                 }
-                else if (strcmp(event, EVENT_SR::RESUME) == 0) {
-                    logger->info("Resuming ESP-SR system");
-                    esp_err_t result = SR::sr_resume();
-                    if (result == ESP_OK) {
-                        logger->info("ESP-SR resumed successfully");
-                    } else {
-                        logger->error("Failed to resume ESP-SR: %s", esp_err_to_name(result));
+                break;
+            }
+            case EVENT_SR::RESUME: {
+                logger->info("Resuming ESP-SR system");
+                esp_err_t result = SR::sr_resume();
+                if (result == ESP_OK) {
+                    logger->info("ESP-SR resumed successfully");
+                    if (powerManager) {
+                        powerManager->setListening(true);
                     }
+                } else {
+                    logger->error("Failed to resume ESP-SR: %s", esp_err_to_name(result));
                 }
-                else {
-                    logger->debug("Unknown SR event: %s", event);
-                }
+                break;
             }
+            default:
+                logger->debug("Unknown SR event: %d", event);
+                break;
         }
     }
 }
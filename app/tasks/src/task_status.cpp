@@ -1,18 +1,9 @@
 #include "setup/setup.h"
 #include <SendTask.h>
 
-void taskMonitorer(void* param){
-	TickType_t lastWakeTime = xTaskGetTickCount();
-	TickType_t updateFrequency = pdMS_TO_TICKS(10000);
-
-    vTaskDelay(pdMS_TO_TICKS(10000));
-    do {
-		vTaskDelayUntil(&lastWakeTime, updateFrequency);
-
-        cleanupTasks();
-		printTaskStatus();
-    }
-    while(1);
+void taskMonitorJob(){
+    cleanupTasks();
+	printTaskStatus();
 }
 
 /**
@@ -27,6 +18,9 @@ void printTaskStatus() {
     // Update memory usage for all tasks
     SendTask::updateAllTasksMemoryUsage();
     
+    // CPU share since the previous report
+    bool cpuStats = SendTask::updateCpuUsage();
+    
     auto allTasks = SendTask::getAllTasks();
     
     if (allTasks.empty()) {
@@ -82,15 +76,7 @@ void printTaskStatus() {
     
     // Print detailed task information
     for (const auto& task : allTasks) {
-        const char* statusStr = "UNKNOWN";
-        switch (task.status) {
-            case SendTask::TaskStatus::WAITING: statusStr = "WAITING"; break;
-            case SendTask::TaskStatus::INPROGRESS: statusStr = "RUNNING"; break;
-            case SendTask::TaskStatus::DONE: statusStr = "DONE"; break;
-            case SendTask::TaskStatus::FAILED: statusStr = "FAILED"; break;
-            case SendTask::TaskStatus::PAUSED: statusStr = "PAUSED"; break;
-            case SendTask::TaskStatus::EXTERNAL_TASK: statusStr = "EXTERNAL"; break;
-        }
+        const char* statusStr = SendTask::getStatusName(task.status);
         
         unsigned long runtime = 0;
         if (task.startedAt > 0) {
@@ -109,17 +95,43 @@ void printTaskStatus() {
             memUsagePercent = (float)task.stackUsed * 100.0f / task.stackSize;
         }
         
-        logger->info("Task: %s [%s] (%s) - Status: %s, Core: %d, Priority: %d, Runtime: %lums, Memory: %u/%u bytes (%.1f%% used), Free: %u bytes%s%s",
+        logger->info("Task: %s [%s] (%s) - Status: %s, Core: %d, Priority: %d, Runtime: %lums, CPU: %.1f%%, Memory: %u/%u bytes (%.1f%% used), Free: %u bytes%s%s",
                 task.name.c_str(), task.taskId.c_str(), taskType, statusStr, 
-                task.coreId, task.priority, runtime,
+                task.coreId, task.priority, runtime, task.cpuPercent < 0 ? 0.0f : task.cpuPercent,
                 task.stackUsed, task.stackSize, memUsagePercent, task.stackFreeMin,
                 (task.isExternal && (task.name == "cam_task" || task.name.indexOf("camera") >= 0)) ? " [CAMERA]" : "",
                 (memUsagePercent > 80.0f) ? " [HIGH MEM!]" : "");
     }
     
+    if (!cpuStats) {
+        logger->info("CPU usage unavailable: FreeRTOS run time stats are disabled");
+    }
+    
+    printLoopProfiles();
+    
     logger->info("=== End Task Status Report ===");
 }
 
+/**
+ * Print iteration time and deadline misses of profiled loops, one line each
+ */
+void printLoopProfiles() {
+    auto loops = SendTask::getLoopProfiles();
+    for (const auto& loop : loops) {
+        uint32_t average = loop.iterations > 0 ? (uint32_t)(loop.totalIterationUs / loop.iterations) : 0;
+        
+        // Histogram as counts per bucket: <1ms/<2/<5/<10/<20/<50/<100/more
+        char histogram[96];
+        int length = 0;
+        for (int i = 0; i < SendTask::LOOP_HISTOGRAM_BUCKETS && length < (int)sizeof(histogram); i++) {
+            length += snprintf(histogram + length, sizeof(histogram) - length, i == 0 ? "%u" : "/%u", loop.histogram[i]);
+        }
+        
+        logger->info("Loop: %s - Iterations: %u, Avg: %uus, Max: %uus, Misses: %u, Histogram: %s",
+                loop.name.c_str(), loop.iterations, average, loop.maxIterationUs, loop.deadlineMisses, histogram);
+    }
+}
+
 /**
  * Clean up completed and failed tasks to free memory
  */
@@ -1,8 +1,9 @@
 #include <tasks/register.h>
+#include <SendTask.h>
 
 void weatherServiceTask(void* param) {
 	TickType_t lastWakeTime = xTaskGetTickCount();
-	TickType_t updateFrequency = pdMS_TO_TICKS(60000);
+	TickType_t updateFrequency = pdMS_TO_TICKS(WEATHER_POLL_INTERVAL_MS);
 	const char* TAG = "weatherTask";
 
 	int check = 0;
@@ -22,9 +23,10 @@ void weatherServiceTask(void* param) {
 		}
 	}while(check++ < 3);
 
+	// The service keeps its own schedule, most wakeups don't touch the network
 	do {
-		weatherService->getCurrentWeather(weatherCallback, false);
+		weatherService->refreshIfDue(weatherCallback);
 
-		vTaskDelayUntil(&lastWakeTime, updateFrequency);
+		SendTask::delayUntil(&lastWakeTime, updateFrequency);
 	}while(1);
 }
\ No newline at end of file
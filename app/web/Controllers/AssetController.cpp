@@ -0,0 +1,82 @@
+#include "AssetController.h"
+#include "setup/setup.h"
+
+std::map<String, String> AssetController::_etags;
+bool AssetController::_manifestLoaded = false;
+
+Response AssetController::serve(Request& request) {
+    String name = request.route("file");
+    if (!isValidName(name)) {
+        return Response(request.getServerRequest())
+            .content("invalid asset")
+            .status(400);
+    }
+
+    // The build keeps only "name.gz" for compressible files; the file
+    // response falls back to it and adds Content-Encoding: gzip
+    String path = "/assets/" + name;
+    if (!LittleFS.exists(path) && !LittleFS.exists(path + ".gz")) {
+        return Response(request.getServerRequest())
+            .content("asset not found")
+            .status(404);
+    }
+
+    loadManifest();
+    auto entry = _etags.find(name);
+    if (entry == _etags.end()) {
+        // Not built by the asset pipeline, serve as is
+        return Response(request.getServerRequest())
+            .file(path.c_str());
+    }
+
+    String etag = "\"" + entry->second + "\"";
+    String cacheControl = "public, max-age=" + String(ASSET_CACHE_MAX_AGE);
+
+    String ifNoneMatch = request.header("If-None-Match");
+    if (ifNoneMatch.length() > 0 && ifNoneMatch.indexOf(etag) >= 0) {
+        return Response(request.getServerRequest())
+            .status(304)
+            .header("ETag", etag)
+            .header("Cache-Control", cacheControl)
+            .content("");
+    }
+
+    return Response(request.getServerRequest())
+        .header("ETag", etag)
+        .header("Cache-Control", cacheControl)
+        .header("Vary", "Accept-Encoding")
+        .file(path.c_str());
+}
+
+void AssetController::loadManifest() {
+    if (_manifestLoaded) {
+        return;
+    }
+    _manifestLoaded = true;
+
+    File file = LittleFS.open("/assets/manifest.json", "r");
+    if (!file) {
+        logger->warning("Asset manifest missing, assets served without ETag");
+        return;
+    }
+
+    Utils::SpiJsonDocument manifest;
+    DeserializationError error = deserializeJson(manifest, file);
+    file.close();
+    if (error) {
+        logger->error("Asset manifest invalid: %s", error.c_str());
+        return;
+    }
+
+    for (JsonPair pair : manifest["files"].as<JsonObject>()) {
+        const char* etag = pair.value()["etag"];
+        if (etag) {
+            _etags[pair.key().c_str()] = etag;
+        }
+    }
+    logger->info("Asset manifest loaded, %d assets", _etags.size());
+}
+
+bool AssetController::isValidName(const String& name) {
+    return name.length() > 0 && name.indexOf("..") < 0 && name.indexOf('/') < 0;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <MVCFramework.h>
+#include "Http/Controller.h"
+#include "Http/Request.h"
+#include "Http/Response.h"
+#include <LittleFS.h>
+#include <map>
+
+class AssetController : public Controller {
+public:
+    // Serve a static asset, pre-compressed by tools/compress_assets.py
+    static Response serve(Request& request);
+
+private:
+    // Content hashes from /assets/manifest.json, keyed by file name
+    static std::map<String, String> _etags;
+    static bool _manifestLoaded;
+
+    static void loadManifest();
+    static bool isValidName(const String& name);
+};
@@ -1,5 +1,10 @@
 #include "AuthController.h"
 #include <LittleFS.h>
+#include <esp_random.h>
+
+char AuthController::_sessions[AuthController::MAX_SESSIONS][AuthController::MAX_TOKEN + 1] = {};
+size_t AuthController::_nextSession = 0;
+portMUX_TYPE AuthController::_sessionMux = portMUX_INITIALIZER_UNLOCKED;
 
 Response AuthController::showLogin(Request& request) {
 		// Check if user is already authenticated
@@ -59,8 +64,20 @@ Response AuthController::login(Request& request) {
 		// Get user data from database
 		user = IModel::User::findByUsername(username.c_str());
 		
-		// Generate JWT token
+		// Issue a session token
 		Utils::Sstring token = generateToken(username);
+		if (token.length() == 0) {
+				if (user) {
+						delete user;
+				}
+				Utils::SpiJsonDocument error;
+				error["success"] = false;
+				error["message"] = "Username too long";
+				
+				return Response(request.getServerRequest())
+						.status(400)
+						.json(error);
+		}
 		
 		Utils::SpiJsonDocument response;
 		response["success"] = true;
@@ -78,7 +95,11 @@ Response AuthController::login(Request& request) {
 }
 
 Response AuthController::logout(Request& request) {
-		// In a real implementation, you might want to blacklist the token
+		Utils::Sstring token = request.header("Authorization");
+		if (token.startsWith("Bearer ")) {
+				revokeToken(token.substring(7));
+		}
+
 		Utils::SpiJsonDocument response;
 		response["success"] = true;
 		response["message"] = "Logged out successfully";
@@ -130,16 +151,43 @@ bool AuthController::validateCredentials(const Utils::Sstring& username, const U
 }
 
 Utils::Sstring AuthController::generateToken(const Utils::Sstring& username) {
-		// Simple token generation - in production use proper JWT library
-		// For demo, encode username in the token for easy extraction
-		Utils::Sstring token = Utils::Sstring("cozmo_token_") + username + '_' + Utils::Sstring(millis());
-		// In real implementation, use proper JWT encoding with signature
+		// Username stays extractable, the random tail makes the token unguessable
+		char nonce[17];
+		snprintf(nonce, sizeof(nonce), "%08lx%08lx", (unsigned long)esp_random(), (unsigned long)esp_random());
+		Utils::Sstring token = Utils::Sstring("cozmo_token_") + username + '_' + Utils::Sstring(nonce);
+		if (token.length() > MAX_TOKEN) {
+				return "";
+		}
+
+		portENTER_CRITICAL(&_sessionMux);
+		strcpy(_sessions[_nextSession], token.c_str());
+		_nextSession = (_nextSession + 1) % MAX_SESSIONS;
+		portEXIT_CRITICAL(&_sessionMux);
 		return token;
 }
 
 bool AuthController::verifyToken(const Utils::Sstring& token) {
-		// Simple token verification - in production use proper JWT verification
-		return token.startsWith("cozmo_token_") && token.length() > 20;
+		if (!token.startsWith("cozmo_token_") || token.length() > MAX_TOKEN) {
+				return false;
+		}
+
+		bool issued = false;
+		portENTER_CRITICAL(&_sessionMux);
+		for (size_t i = 0; i < MAX_SESSIONS && !issued; i++) {
+				issued = _sessions[i][0] != '\0' && strcmp(_sessions[i], token.c_str()) == 0;
+		}
+		portEXIT_CRITICAL(&_sessionMux);
+		return issued;
+}
+
+void AuthController::revokeToken(const Utils::Sstring& token) {
+		portENTER_CRITICAL(&_sessionMux);
+		for (size_t i = 0; i < MAX_SESSIONS; i++) {
+				if (strcmp(_sessions[i], token.c_str()) == 0) {
+						_sessions[i][0] = '\0';
+				}
+		}
+		portEXIT_CRITICAL(&_sessionMux);
 }
 
 Utils::Sstring AuthController::extractUsernameFromToken(const Utils::Sstring& token) {
@@ -169,8 +217,7 @@ Utils::Sstring AuthController::getCurrentUserUsername(Request& request) {
 				token = token.substring(7);
 		}
 		
-		// Simple token verification - in production use proper JWT
-		if (!token.startsWith("cozmo_token_")) {
+		if (!verifyToken(token)) {
 				return "";
 		}
 		
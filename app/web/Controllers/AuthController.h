@@ -23,14 +23,26 @@ public:
     // Static helper methods for other controllers
     static Utils::Sstring getCurrentUserUsername(Request& request);
     static class IModel::User* getCurrentUser(Request& request);
+
+    /**
+     * Token was handed out by login and not logged out since boot
+     */
+    static bool verifyToken(const Utils::Sstring& token);
     
     // API method for getting current user info
     Response getUserInfo(Request& request);
     
 private:
     bool validateCredentials(const Utils::Sstring& username, const Utils::Sstring& password);
+    static const size_t MAX_SESSIONS = 8;       // Oldest login is dropped beyond this
+    static const size_t MAX_TOKEN = 64;
+
+    static char _sessions[MAX_SESSIONS][MAX_TOKEN + 1];
+    static size_t _nextSession;
+    static portMUX_TYPE _sessionMux;
+
     Utils::Sstring generateToken(const Utils::Sstring& username);
-    bool verifyToken(const Utils::Sstring& token);
+    static void revokeToken(const Utils::Sstring& token);
     Utils::Sstring extractUsernameFromToken(const Utils::Sstring& token);
 };
 
@@ -1,5 +1,19 @@
 #include "FileController.h"
 #include "setup/setup.h"
+#include <esp_heap_caps.h>
+#include <esp_rom_crc.h>
+#include <mbedtls/base64.h>
+#include <memory>
+
+// Uploads and deletes stay below these, away from the user database,
+// the configuration store and the cache
+static const char* const WRITABLE_ROOTS[] = { "/assets/", "/uploads/" };
+
+// Extensions accepted for uploads, web assets and media
+static const char* const ALLOWED_EXTENSIONS[] = {
+    "txt", "json", "csv", "html", "htm", "css", "js", "gz",
+    "png", "jpg", "jpeg", "gif", "svg", "ico", "wav", "mp3"
+};
 
 Response FileController::download(Request& request) {
     // Check authentication for protected downloads
@@ -34,13 +48,59 @@ Response FileController::download(Request& request) {
             .status(404)
             .json(error);
     }
+    
+    // Ranges and whole files both stream from flash
+    String range = request.header("Range");
+    if (!range.isEmpty()) {
+        return rangeResponse(request, path, range);
+    }
 		
     return Response(request.getServerRequest())
         .status(200)
+        .header("Accept-Ranges", "bytes")
         .header("Content-Disposition", "attachment; filename=\"" + path.substring(path.lastIndexOf('/') + 1) + "\"")
         .file(path);
 }
 
+Response FileController::rangeResponse(Request& request, const String& path, const String& rangeHeader) {
+    // Kept open until the response is done with it
+    std::shared_ptr<File> file = std::make_shared<File>(fileManager->openFileForReading(path));
+    size_t fileSize = *file ? file->size() : 0;
+
+    size_t start = 0;
+    size_t end = 0;
+    if (!parseRange(rangeHeader, fileSize, start, end) || !fileManager->seekFile(*file, start)) {
+        fileManager->closeFile(*file);
+        Utils::SpiJsonDocument error = createErrorResponse("Range not satisfiable", "INVALID_RANGE");
+        return Response(request.getServerRequest())
+            .status(416)
+            .header("Content-Range", "bytes */" + String(fileSize))
+            .json(error);
+    }
+
+    // The async server asks for the body a TCP window at a time, read each
+    // piece straight into its buffer
+    size_t length = end - start;
+    std::shared_ptr<size_t> remaining = std::make_shared<size_t>(length);
+    AsyncWebServerRequest* serverRequest = request.getServerRequest();
+    AsyncWebServerResponse* response = serverRequest->beginResponse(getMimeType(path), length,
+        [file, remaining](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+            size_t bytesRead = fileManager->readStream(*file, buffer, std::min(maxLen, *remaining));
+            *remaining -= bytesRead;
+            if (bytesRead == 0 || *remaining == 0) {
+                fileManager->closeFile(*file);
+            }
+            return bytesRead;
+        });
+    response->setCode(206);
+    response->addHeader("Accept-Ranges", "bytes");
+    response->addHeader("Content-Range", "bytes " + String(start) + "-" + String(end - 1) + "/" + String(fileSize));
+    serverRequest->send(response);
+
+    // Answered above, the framework's Response only carries whole bodies
+    return Response(serverRequest);
+}
+
 Response FileController::upload(Request& request) {
     // Check authentication
     IModel::User* user = AuthController::getCurrentUser(request);
@@ -72,6 +132,15 @@ Response FileController::upload(Request& request) {
         targetPath += "/";
     }
     
+    String fullPath = (targetPath + filename).c_str();
+    fullPath = sanitizePath(fullPath).c_str();
+    if (!isWritablePath(fullPath)) {
+        Utils::SpiJsonDocument error = createErrorResponse("Path is not writable", "PROTECTED_PATH");
+        return Response(request.getServerRequest())
+            .status(403)
+            .json(error);
+    }
+    
     // Ensure directory exists
     if (!targetPath.equals("/")) {
         if (!LittleFS.exists(targetPath) && LittleFS.mkdir(targetPath)) {
@@ -79,11 +148,16 @@ Response FileController::upload(Request& request) {
         }
     }
     
-    String fullPath = (targetPath + filename).c_str();
-    fullPath = sanitizePath(fullPath).c_str();
+    // The form field is held in RAM, larger files go through uploadChunk
+    if (content.length() > FILE_UPLOAD_CHUNK_SIZE) {
+        Utils::SpiJsonDocument error = createErrorResponse("File too large, use the chunked upload", "FILE_TOO_LARGE");
+        return Response(request.getServerRequest())
+            .status(413)
+            .json(error);
+    }
     
     // Open file for writing
-    File file = LittleFS.open(fullPath, "w");
+    File file = fileManager->openFileForWriting(fullPath);
     if (!file) {
         Utils::SpiJsonDocument error = createErrorResponse("Failed to create file", "FILE_CREATION_ERROR");
         return Response(request.getServerRequest())
@@ -91,10 +165,10 @@ Response FileController::upload(Request& request) {
             .json(error);
     }
     
-    size_t bytesWritten = file.print(content.c_str());
-    file.close();
+    size_t bytesWritten = fileManager->writeBinary(file, (const uint8_t*)content.c_str(), content.length());
+    fileManager->closeFile(file);
     
-    logger->info("File uploaded: %s (%d bytes)", fullPath, bytesWritten);
+    logger->info("File uploaded: %s (%u bytes)", fullPath.c_str(), bytesWritten);
     
     Utils::SpiJsonDocument responseData;
     responseData["filename"] = filename;
@@ -109,6 +183,209 @@ Response FileController::upload(Request& request) {
         .json(response);
 }
 
+Response FileController::uploadChunk(Request& request) {
+    IModel::User* user = AuthController::getCurrentUser(request);
+    if (!user) {
+        return unauthorizedResponse(request);
+    }
+    delete user;
+    
+    String path = request.input("path");
+    String data = request.input("data");
+    size_t offset = strtoul(request.input("offset", "0").c_str(), nullptr, 10);
+    
+    path = sanitizePath(path).c_str();
+    if (path.isEmpty() || !isValidPath(path)) {
+        Utils::SpiJsonDocument error = createErrorResponse("Invalid file path", "INVALID_PATH");
+        return Response(request.getServerRequest())
+            .status(400)
+            .json(error);
+    }
+    if (!isWritablePath(path)) {
+        Utils::SpiJsonDocument error = createErrorResponse("Path is not writable", "PROTECTED_PATH");
+        return Response(request.getServerRequest())
+            .status(403)
+            .json(error);
+    }
+    
+    // Base64 carries the chunk through the form field, 4 chars per 3 bytes
+    size_t maxEncoded = (FILE_UPLOAD_CHUNK_SIZE + 2) / 3 * 4;
+    if (data.isEmpty() || data.length() > maxEncoded) {
+        Utils::SpiJsonDocument error = createErrorResponse("Chunk missing or larger than FILE_UPLOAD_CHUNK_SIZE", "INVALID_CHUNK");
+        return Response(request.getServerRequest())
+            .status(413)
+            .json(error);
+    }
+    
+    // Chunks must arrive in order; a gap or overlap tells the client where to resume
+    String partPath = partialPath(path);
+    size_t received = 0;
+    if (offset > 0) {
+        File part = fileManager->openFileForReading(partPath);
+        received = part ? part.size() : 0;
+        fileManager->closeFile(part);
+        if (offset != received) {
+            Utils::SpiJsonDocument error = createErrorResponse("Offset does not match received bytes", "OFFSET_MISMATCH");
+            error["received"] = received;
+            return Response(request.getServerRequest())
+                .status(409)
+                .json(error);
+        }
+    }
+    
+    uint8_t* buffer = (uint8_t*)heap_caps_malloc(FILE_UPLOAD_CHUNK_SIZE, MALLOC_CAP_DEFAULT);
+    if (!buffer) {
+        Utils::SpiJsonDocument error = createErrorResponse("Not enough memory for chunk", "OUT_OF_MEMORY");
+        return Response(request.getServerRequest())
+            .status(503)
+            .json(error);
+    }
+    
+    size_t length = 0;
+    int decoded = mbedtls_base64_decode(buffer, FILE_UPLOAD_CHUNK_SIZE, &length, (const unsigned char*)data.c_str(), data.length());
+    if (decoded != 0) {
+        heap_caps_free(buffer);
+        Utils::SpiJsonDocument error = createErrorResponse("Chunk is not valid base64", "INVALID_CHUNK");
+        return Response(request.getServerRequest())
+            .status(400)
+            .json(error);
+    }
+    
+    // Offset 0 starts the file over
+    File part = offset == 0 ? fileManager->openFileForWriting(partPath) : fileManager->openFileForAppend(partPath);
+    size_t written = part ? fileManager->writeBinary(part, buffer, length) : 0;
+    fileManager->closeFile(part);
+    heap_caps_free(buffer);
+    
+    if (written != length) {
+        Utils::SpiJsonDocument error = createErrorResponse("Failed to write chunk", "WRITE_ERROR");
+        error["received"] = offset + written;
+        return Response(request.getServerRequest())
+            .status(507)
+            .json(error);
+    }
+    
+    Utils::SpiJsonDocument responseData;
+    responseData["path"] = path;
+    responseData["received"] = offset + written;
+    
+    Utils::SpiJsonDocument response = createSuccessResponse(responseData);
+    return Response(request.getServerRequest())
+        .status(200)
+        .json(response);
+}
+
+Response FileController::uploadStatus(Request& request) {
+    IModel::User* user = AuthController::getCurrentUser(request);
+    if (!user) {
+        return unauthorizedResponse(request);
+    }
+    delete user;
+    
+    String path = request.input("path");
+    path = sanitizePath(path).c_str();
+    if (path.isEmpty() || !isValidPath(path)) {
+        Utils::SpiJsonDocument error = createErrorResponse("Invalid file path", "INVALID_PATH");
+        return Response(request.getServerRequest())
+            .status(400)
+            .json(error);
+    }
+    
+    File part = fileManager->openFileForReading(partialPath(path));
+    Utils::SpiJsonDocument responseData;
+    responseData["path"] = path;
+    responseData["in_progress"] = (bool)part;
+    responseData["received"] = part ? part.size() : 0;
+    responseData["chunk_size"] = FILE_UPLOAD_CHUNK_SIZE;
+    fileManager->closeFile(part);
+    
+    Utils::SpiJsonDocument response = createSuccessResponse(responseData);
+    return Response(request.getServerRequest())
+        .status(200)
+        .json(response);
+}
+
+Response FileController::uploadFinish(Request& request) {
+    IModel::User* user = AuthController::getCurrentUser(request);
+    if (!user) {
+        return unauthorizedResponse(request);
+    }
+    delete user;
+    
+    String path = request.input("path");
+    String expectedCrc = request.input("crc32");
+    String expectedSize = request.input("size");
+    
+    path = sanitizePath(path).c_str();
+    if (path.isEmpty() || !isValidPath(path) || expectedCrc.isEmpty()) {
+        Utils::SpiJsonDocument error = createErrorResponse("Path and crc32 are required", "MISSING_PARAMETER");
+        return Response(request.getServerRequest())
+            .status(400)
+            .json(error);
+    }
+    if (!isWritablePath(path)) {
+        Utils::SpiJsonDocument error = createErrorResponse("Path is not writable", "PROTECTED_PATH");
+        return Response(request.getServerRequest())
+            .status(403)
+            .json(error);
+    }
+    
+    String partPath = partialPath(path);
+    File part = fileManager->openFileForReading(partPath);
+    if (!part) {
+        Utils::SpiJsonDocument error = createErrorResponse("No upload in progress", "UPLOAD_NOT_FOUND");
+        return Response(request.getServerRequest())
+            .status(404)
+            .json(error);
+    }
+    
+    // Checksum what actually landed on flash, not what was received
+    uint8_t buffer[1024];
+    uint32_t crc = 0;
+    size_t size = 0;
+    size_t bytesRead;
+    while ((bytesRead = fileManager->readStream(part, buffer, sizeof(buffer))) > 0) {
+        crc = esp_rom_crc32_le(crc, buffer, bytesRead);
+        size += bytesRead;
+    }
+    fileManager->closeFile(part);
+    
+    char crcHex[9];
+    snprintf(crcHex, sizeof(crcHex), "%08x", crc);
+    
+    bool sizeMatches = expectedSize.isEmpty() || strtoul(expectedSize.c_str(), nullptr, 10) == size;
+    if (!sizeMatches || strtoul(expectedCrc.c_str(), nullptr, 16) != crc) {
+        fileManager->deleteFile(partPath);
+        Utils::SpiJsonDocument error = createErrorResponse("Checksum mismatch, upload discarded", "CHECKSUM_MISMATCH");
+        error["crc32"] = crcHex;
+        error["size"] = size;
+        return Response(request.getServerRequest())
+            .status(422)
+            .json(error);
+    }
+    
+    // LittleFS renames over an existing file atomically, a failed rename
+    // leaves both the old file and the upload in place
+    if (!LittleFS.rename(partPath, path)) {
+        Utils::SpiJsonDocument error = createErrorResponse("Failed to move uploaded file", "RENAME_ERROR");
+        return Response(request.getServerRequest())
+            .status(500)
+            .json(error);
+    }
+    
+    logger->info("File uploaded in chunks: %s (%u bytes, crc32 %s)", path.c_str(), size, crcHex);
+    
+    Utils::SpiJsonDocument responseData;
+    responseData["path"] = path;
+    responseData["size"] = size;
+    responseData["crc32"] = crcHex;
+    
+    Utils::SpiJsonDocument response = createSuccessResponse(responseData);
+    return Response(request.getServerRequest())
+        .status(201)
+        .json(response);
+}
+
 Response FileController::listFiles(Request& request) {
     // Check authentication for file listing
     if (requiresAuthentication("list")) {
@@ -216,8 +493,8 @@ Response FileController::deleteFile(Request& request) {
             .json(error);
     }
     
-    // Prevent deletion of critical system files
-    if (path.startsWith("/css/") || path.startsWith("/js/") || path.equals("/index.html")) {
+    // Prevent deletion of system files, the databases and the configuration
+    if (!isWritablePath(path)) {
         Utils::SpiJsonDocument error = createErrorResponse("Cannot delete system files", "PROTECTED_FILE");
         return Response(request.getServerRequest())
             .status(403)
@@ -225,7 +502,7 @@ Response FileController::deleteFile(Request& request) {
     }
     
     if (LittleFS.remove(path.c_str())) {
-        logger->info("File deleted: %s" + path);
+        logger->info("File deleted: %s", path.c_str());
         
         Utils::SpiJsonDocument responseData;
         responseData["path"] = path;
@@ -306,7 +583,30 @@ bool FileController::isValidPath(const Utils::Sstring& path) {
 }
 
 bool FileController::isAllowedFileType(const Utils::Sstring& filename) {
-		return true;
+    int lastDot = filename.toString().lastIndexOf('.');
+    if (lastDot < 0) {
+        return false;
+    }
+    String extension = filename.toString().substring(lastDot + 1);
+    extension.toLowerCase();
+    for (const char* allowed : ALLOWED_EXTENSIONS) {
+        if (extension.equals(allowed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FileController::isWritablePath(const Utils::Sstring& path) {
+    if (!isValidPath(path) || !isAllowedFileType(path)) {
+        return false;
+    }
+    for (const char* root : WRITABLE_ROOTS) {
+        if (path.startsWith(root)) {
+            return true;
+        }
+    }
+    return false;
 }
 
 Utils::Sstring FileController::sanitizePath(const Utils::Sstring& path) {
@@ -352,16 +652,7 @@ Utils::SpiJsonDocument FileController::formatFileInfo(const Utils::Sstring& path
             }
             info["extension"] = extension;
             
-            // Determine MIME type
-            Utils::Sstring mimeType = "application/octet-stream";
-            if (extension == "txt") mimeType = "text/plain";
-            else if (extension == "html") mimeType = "text/html";
-            else if (extension == "css") mimeType = "text/css";
-            else if (extension == "js") mimeType = "application/javascript";
-            else if (extension == "json") mimeType = "application/json";
-            else if (extension == "xml") mimeType = "application/xml";
-            
-            info["mime_type"] = mimeType;
+            info["mime_type"] = getMimeType(path);
             file.close();
         } else {
             info["exists"] = false;
@@ -374,6 +665,60 @@ Utils::SpiJsonDocument FileController::formatFileInfo(const Utils::Sstring& path
     return info;
 }
 
+Utils::Sstring FileController::getMimeType(const Utils::Sstring& path) {
+    Utils::Sstring extension = "";
+    int lastDot = path.toString().lastIndexOf('.');
+    if (lastDot > 0) {
+        extension = path.substring(lastDot + 1);
+    }
+    
+    if (extension == "txt") return "text/plain";
+    if (extension == "html") return "text/html";
+    if (extension == "css") return "text/css";
+    if (extension == "js") return "application/javascript";
+    if (extension == "json") return "application/json";
+    if (extension == "xml") return "application/xml";
+    return "application/octet-stream";
+}
+
+bool FileController::parseRange(const String& header, size_t fileSize, size_t& start, size_t& end) {
+    // Single range only: "bytes=first-last", "bytes=first-" or "bytes=-suffix"
+    if (!header.startsWith("bytes=") || header.indexOf(',') >= 0 || fileSize == 0) {
+        return false;
+    }
+    
+    String spec = header.substring(6);
+    int dash = spec.indexOf('-');
+    if (dash < 0) {
+        return false;
+    }
+    String first = spec.substring(0, dash);
+    String last = spec.substring(dash + 1);
+    first.trim();
+    last.trim();
+    
+    if (first.isEmpty()) {
+        size_t suffix = strtoul(last.c_str(), nullptr, 10);
+        if (suffix == 0) {
+            return false;
+        }
+        start = suffix < fileSize ? fileSize - suffix : 0;
+        end = fileSize;
+    } else {
+        start = strtoul(first.c_str(), nullptr, 10);
+        end = last.isEmpty() ? fileSize : strtoul(last.c_str(), nullptr, 10) + 1;
+    }
+    
+    if (end > fileSize) {
+        end = fileSize;
+    }
+    return start < end;
+}
+
+String FileController::partialPath(const String& path) {
+    return path + ".part";
+}
+
 Utils::SpiJsonDocument FileController::createErrorResponse(const Utils::Sstring& message, const Utils::Sstring& code) {
     Utils::SpiJsonDocument error;
     error["success"] = false;
@@ -400,9 +745,8 @@ Utils::SpiJsonDocument FileController::createSuccessResponse(const Utils::SpiJso
 }
 
 bool FileController::requiresAuthentication(const Utils::Sstring& operation) {
-    // List operations can be public for basic file access
-    // Upload, delete, and downloads of sensitive files require auth
-    return operation != "list" && operation != "info";
+    // The routes are admin only, a session is needed for every operation
+    return true;
 }
 
 Response FileController::unauthorizedResponse(Request& request) {
@@ -14,6 +14,13 @@ public:
     // File operations
     static Response download(Request& request);
     static Response upload(Request& request);
+    
+    // Chunked upload for files too large for one request: chunks are
+    // appended at an offset, status reports the offset to resume from,
+    // finish checks the CRC32 and moves the file in place
+    static Response uploadChunk(Request& request);
+    static Response uploadStatus(Request& request);
+    static Response uploadFinish(Request& request);
     static Response listFiles(Request& request);
     static Response deleteFile(Request& request);
     static Response getFileInfo(Request& request);
@@ -25,6 +32,7 @@ private:
     // Helper methods
     static bool isValidPath(const Utils::Sstring& path);
     static bool isAllowedFileType(const Utils::Sstring& filename);
+    static bool isWritablePath(const Utils::Sstring& path);
     static Utils::Sstring sanitizePath(const Utils::Sstring& path);
     static Utils::SpiJsonDocument formatFileInfo(const Utils::Sstring& path);
     static Utils::SpiJsonDocument createErrorResponse(const Utils::Sstring& message, const Utils::Sstring& code = "");
@@ -32,4 +40,8 @@ private:
     static bool requiresAuthentication(const Utils::Sstring& operation);
     static Response unauthorizedResponse(Request& request);
     static Utils::Sstring formatBytes(size_t bytes);
+    static Utils::Sstring getMimeType(const Utils::Sstring& path);
+    static bool parseRange(const String& header, size_t fileSize, size_t& start, size_t& end);
+    static String partialPath(const String& path);
+    static Response rangeResponse(Request& request, const String& path, const String& rangeHeader);
 };
\ No newline at end of file
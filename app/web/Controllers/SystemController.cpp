@@ -2,6 +2,8 @@
 #include <esp_system.h>
 #include <esp_heap_caps.h>
 #include "../../setup/setup.h"
+#include "../../tasks/register.h"
+#include <SendTask.h>
 
 Response SystemController::getStats(Request& request) {
     Utils::SpiJsonDocument response;
@@ -170,10 +172,532 @@ Utils::SpiJsonDocument SystemController::getSystemInfo() {
         battery["enabled"] = false;
     }
     systemInfo["battery"] = battery;
-    
+
+    // Safety monitor stop latency
+    Utils::SpiJsonDocument safety;
+    if (safetyMonitor) {
+        Logic::SafetyMonitor::Stats stats = safetyMonitor->getStats();
+        safety["enabled"] = true;
+        safety["events"] = stats.events;
+        safety["stops"] = stats.stops;
+        safety["deadline_misses"] = stats.deadlineMisses;
+        safety["last_latency_us"] = stats.lastLatencyUs;
+        safety["max_latency_us"] = stats.maxLatencyUs;
+        safety["budget_us"] = safetyMonitor->getWorstCaseBudgetUs();
+        safety["distance_unavailable"] = stats.distanceUnavailable;
+
+        JsonArray histogram = safety["latency_histogram"].to<JsonArray>();
+        for (int i = 0; i < Logic::SafetyMonitor::LATENCY_BUCKETS; i++) {
+            JsonObject bucket = histogram.add<JsonObject>();
+            uint32_t upper = Logic::SafetyMonitor::bucketUpperBoundUs(i);
+            if (upper == UINT32_MAX) {
+                bucket["le_us"] = nullptr;
+            } else {
+                bucket["le_us"] = upper;
+            }
+            bucket["count"] = stats.histogram[i];
+        }
+    } else {
+        safety["enabled"] = false;
+    }
+    systemInfo["safety"] = safety;
+
+    // IMU FIFO stream
+    Utils::SpiJsonDocument imu;
+    if (orientation && orientation->isStreaming()) {
+        Sensors::OrientationSensor::StreamStats stats = orientation->getStreamStats();
+        imu["streaming"] = true;
+        imu["sample_rate_hz"] = orientation->getSampleRate();
+        imu["samples"] = stats.samples;
+        imu["bursts"] = stats.bursts;
+        imu["wakeups"] = stats.wakeups;
+        imu["overflows"] = stats.overflows;
+    } else {
+        imu["streaming"] = false;
+    }
+    if (attitude) {
+        Logic::AttitudeService::Attitude current = attitude->getAttitude();
+        Logic::AttitudeService::Stats stats = attitude->getStats();
+        JsonObject fusion = imu["attitude"].to<JsonObject>();
+        fusion["roll"] = current.roll;
+        fusion["pitch"] = current.pitch;
+        fusion["yaw"] = current.yaw;
+        fusion["stationary"] = current.stationary;
+        fusion["updates"] = stats.updates;
+        fusion["missed"] = stats.missed;
+        fusion["max_batch"] = stats.maxBatch;
+        JsonArray bias = fusion["gyro_bias"].to<JsonArray>();
+        bias.add(stats.biasX);
+        bias.add(stats.biasY);
+        bias.add(stats.biasZ);
+    }
+    systemInfo["imu"] = imu;
+
+    // Power profile and scheduler wakeups
+    if (powerManager) {
+        Utils::PowerManager::Stats power = powerManager->getStats();
+        JsonObject powerInfo = systemInfo["power"].to<JsonObject>();
+        powerInfo["profile"] = Utils::Scheduler::profileName(powerManager->getProfile());
+        powerInfo["automatic"] = powerManager->isAutomatic();
+        powerInfo["dfs"] = power.dfs;
+        powerInfo["tickless_idle"] = power.tickless;
+        powerInfo["listening"] = power.listening;
+        powerInfo["cpu_mhz"] = getCpuFrequencyMhz();
+        powerInfo["profile_changes"] = power.profileChanges;
+
+        JsonArray wakeups = powerInfo["wakeups_per_second"].to<JsonArray>();
+        JsonArray idle = powerInfo["cpu_idle_percent"].to<JsonArray>();
+        for (int core = 0; core < 2; core++) {
+            wakeups.add(power.wakeupsPerSecond[core]);
+            if (power.cpuIdlePercent[core] < 0) {
+                idle.add(nullptr);
+            } else {
+                idle.add(power.cpuIdlePercent[core]);
+            }
+        }
+
+        if (scheduler) {
+            Utils::Scheduler::Stats stats = scheduler->getStats();
+            JsonObject schedulerInfo = powerInfo["scheduler"].to<JsonObject>();
+            schedulerInfo["wakeups_per_second"] = power.schedulerWakeupsPerSecond;
+            schedulerInfo["wakeups"] = stats.wakeups;
+            schedulerInfo["runs"] = stats.runs;
+            schedulerInfo["coalesced"] = stats.coalesced;
+
+            JsonArray jobs = schedulerInfo["jobs"].to<JsonArray>();
+            for (int i = 0; i < scheduler->getJobCount(); i++) {
+                Utils::Scheduler::JobStats job;
+                if (!scheduler->getJobStats(i, job)) continue;
+                JsonObject entry = jobs.add<JsonObject>();
+                entry["name"] = job.name;
+                entry["period_ms"] = job.periodMs;
+                entry["runs"] = job.runs;
+                entry["max_run_us"] = job.maxRunUs;
+                entry["max_late_us"] = job.maxLateUs;
+                entry["misses"] = job.misses;
+            }
+        }
+    }
+
+    // Trace ring fill
+    {
+        Utils::Trace::Stats stats = Utils::Trace::getStats();
+        JsonObject traceInfo = systemInfo["trace"].to<JsonObject>();
+        traceInfo["enabled"] = stats.enabled;
+        traceInfo["capacity"] = stats.capacity;
+        JsonArray recorded = traceInfo["recorded"].to<JsonArray>();
+        JsonArray overwritten = traceInfo["overwritten"].to<JsonArray>();
+        for (int core = 0; core < 2; core++) {
+            recorded.add(stats.recorded[core]);
+            overwritten.add(stats.overwritten[core]);
+        }
+    }
+
+    // Event bus delivery per topic
+    if (eventBus) {
+        JsonObject events = systemInfo["events"].to<JsonObject>();
+        for (size_t i = 0; i < Utils::EventBus::TOPIC_COUNT; i++) {
+            Utils::Topic topic = (Utils::Topic)i;
+            Utils::EventBus::Stats stats = eventBus->getStats(topic);
+            JsonObject entry = events[Utils::EventBus::topicName(topic)].to<JsonObject>();
+            entry["published"] = stats.published;
+            entry["delivered"] = stats.delivered;
+            entry["dropped"] = stats.dropped;
+            entry["depth"] = stats.depth;
+            entry["max_depth"] = stats.maxDepth;
+            entry["capacity"] = stats.capacity;
+            entry["last_latency_us"] = stats.lastLatencyUs;
+            entry["avg_latency_us"] = stats.delivered ? (uint32_t)(stats.totalLatencyUs / stats.delivered) : 0;
+            entry["max_latency_us"] = stats.maxLatencyUs;
+        }
+    }
+
+    // Binary telemetry on /ws
+    if (telemetry) {
+        Communication::TelemetryStream::Stats stats = telemetry->getStats();
+        JsonObject telemetryInfo = systemInfo["telemetry"].to<JsonObject>();
+        telemetryInfo["subscribers"] = stats.subscribers;
+        telemetryInfo["samples"] = stats.samples;
+        telemetryInfo["frames"] = stats.frames;
+        telemetryInfo["keyframes"] = stats.keyframes;
+        telemetryInfo["bytes"] = stats.bytes;
+        telemetryInfo["dropped"] = stats.dropped;
+        telemetryInfo["max_tick_us"] = stats.maxTickUs;
+    }
+
+    // Remote driving over /ws
+    if (teleop) {
+        Motors::Teleop::Stats stats = teleop->getStats();
+        JsonObject teleopInfo = systemInfo["teleop"].to<JsonObject>();
+        teleopInfo["active"] = stats.active;
+        teleopInfo["received"] = stats.received;
+        teleopInfo["applied"] = stats.applied;
+        teleopInfo["coalesced"] = stats.coalesced;
+        teleopInfo["stale"] = stats.stale;
+        teleopInfo["invalid"] = stats.invalid;
+        teleopInfo["deadman_stops"] = stats.deadmanStops;
+        teleopInfo["last_sequence"] = stats.lastSequence;
+        teleopInfo["last_latency_us"] = stats.lastLatencyUs;
+        teleopInfo["avg_latency_us"] = stats.applied ? (uint32_t)(stats.totalLatencyUs / stats.applied) : 0;
+        teleopInfo["max_latency_us"] = stats.maxLatencyUs;
+    }
+
+    // Streamed GPT replies
+    if (gptAdapter) {
+        Communication::GPTAdapter::StreamStats stats = gptAdapter->getStreamStats();
+        JsonObject gptInfo = systemInfo["gpt"].to<JsonObject>();
+        gptInfo["streaming"] = gptAdapter->isStreaming();
+        gptInfo["requests"] = stats.requests;
+        gptInfo["failures"] = stats.failures;
+        gptInfo["busy"] = stats.busy;
+        gptInfo["last_first_token_ms"] = stats.lastFirstTokenMs;
+        gptInfo["max_first_token_ms"] = stats.maxFirstTokenMs;
+        gptInfo["last_total_ms"] = stats.lastTotalMs;
+        gptInfo["bytes"] = stats.bytes;
+        gptInfo["last_payload_bytes"] = stats.lastPayloadBytes;
+        gptInfo["last_allocated_bytes"] = stats.lastAllocatedBytes;
+        gptInfo["last_build_us"] = stats.lastBuildUs;
+        gptInfo["payload_overflows"] = stats.payloadOverflows;
+    }
+
+    // Automation behavior corpus
+    if (automation) {
+        Automation::BehaviorStore::Stats stats = automation->getBehaviorStats();
+        JsonObject behaviors = systemInfo["behaviors"].to<JsonObject>();
+        behaviors["size"] = stats.size;
+        behaviors["pinned"] = stats.pinned;
+        behaviors["capacity"] = stats.capacity;
+        behaviors["added"] = stats.added;
+        behaviors["duplicates"] = stats.duplicates;
+        behaviors["invalid"] = stats.invalid;
+        behaviors["too_long"] = stats.tooLong;
+        behaviors["evicted"] = stats.evicted;
+        behaviors["log_records"] = stats.logRecords;
+        behaviors["compactions"] = stats.compactions;
+    }
+
+    // Configuration store
+    if (configStore) {
+        Utils::KvStore::Stats stats = configStore->getStats();
+        JsonObject config = systemInfo["config"].to<JsonObject>();
+        config["keys"] = stats.keys;
+        config["live_bytes"] = stats.liveBytes;
+        config["log_bytes"] = stats.logBytes;
+        config["puts"] = stats.puts;
+        config["removes"] = stats.removes;
+        config["compactions"] = stats.compactions;
+        config["torn_records"] = stats.tornRecords;
+        config["load_ms"] = stats.loadMs;
+    }
+
+    // Shared keep-alive connections of GPT and weather requests
+    if (connectionPool) {
+        Communication::ConnectionPool::Stats stats = connectionPool->getStats();
+        JsonObject https = systemInfo["https"].to<JsonObject>();
+        https["open"] = stats.open;
+        https["requests"] = stats.requests;
+        https["reused"] = stats.reused;
+        https["handshakes"] = stats.handshakes;
+        https["handshake_failures"] = stats.handshakeFailures;
+        https["last_handshake_ms"] = stats.lastHandshakeMs;
+        https["max_handshake_ms"] = stats.maxHandshakeMs;
+        https["avg_handshake_ms"] = stats.handshakes ? stats.totalHandshakeMs / stats.handshakes : 0;
+        https["one_off"] = stats.oneOff;
+        https["dropped"] = stats.dropped;
+        https["idle_closes"] = stats.idleCloses;
+    }
+
+    // Weather refresh schedule and traffic
+    if (weatherService) {
+        Communication::WeatherService::Stats stats = weatherService->getStats();
+        JsonObject weather = systemInfo["weather"].to<JsonObject>();
+        weather["requests"] = stats.requests;
+        weather["updated"] = stats.updated;
+        weather["not_modified"] = stats.notModified;
+        weather["failures"] = stats.failures;
+        weather["consecutive_failures"] = stats.consecutiveFailures;
+        weather["coalesced"] = stats.coalesced;
+        weather["bytes"] = stats.bytes;
+        weather["requests_day"] = stats.requestsDay;
+        weather["bytes_day"] = stats.bytesDay;
+        weather["requests_prev_day"] = stats.requestsPrevDay;
+        weather["bytes_prev_day"] = stats.bytesPrevDay;
+        weather["last_fetch_ms"] = stats.lastFetchMs;
+        weather["next_refresh_in_ms"] = stats.nextRefreshInMs;
+    }
+
+    // Lazily started services and what they hold while resident
+    if (services) {
+        JsonObject servicesInfo = systemInfo["services"].to<JsonObject>();
+        servicesInfo["resident"] = services->getResidentCount();
+        JsonArray list = servicesInfo["list"].to<JsonArray>();
+        Utils::ServiceRegistry::ServiceStats stats;
+        for (int i = 0; services->getStats(i, stats); i++) {
+            JsonObject service = list.add<JsonObject>();
+            service["name"] = stats.name;
+            service["resident"] = stats.resident;
+            service["idle_ms"] = stats.idleMs;
+            service["idle_timeout_ms"] = stats.idleTimeoutMs;
+            service["creates"] = stats.creates;
+            service["destroys"] = stats.destroys;
+            service["failures"] = stats.failures;
+            service["create_ms"] = stats.createUs / 1000;
+            service["internal_bytes"] = stats.internalBytes;
+            service["psram_bytes"] = stats.psramBytes;
+        }
+    }
+
+    // Boot stage timings, in start order as logged at boot
+    if (bootSequencer) {
+        JsonObject bootInfo = systemInfo["boot"].to<JsonObject>();
+        bootInfo["run_ms"] = bootSequencer->getRunUs() / 1000;
+        JsonArray stages = bootInfo["stages"].to<JsonArray>();
+        Utils::BootSequencer::StageTiming timing;
+        for (int i = 0; bootSequencer->getTiming(i, timing); i++) {
+            JsonObject stage = stages.add<JsonObject>();
+            stage["name"] = timing.name;
+            stage["done"] = timing.done;
+            if (timing.done) {
+                stage["core"] = timing.core;
+                stage["wait_ms"] = (timing.startUs - timing.readyUs) / 1000;
+                stage["start_ms"] = timing.startUs / 1000;
+                stage["took_ms"] = timing.durationUs / 1000;
+            }
+        }
+        JsonObject milestones = bootInfo["milestones"].to<JsonObject>();
+        Utils::BootSequencer::Milestone milestone;
+        for (int i = 0; bootSequencer->getMilestone(i, milestone); i++) {
+            milestones[milestone.name] = milestone.us / 1000;
+        }
+    }
+
     return systemInfo;
 }
 
+Response SystemController::setPowerProfile(Request& request) {
+    Utils::SpiJsonDocument response;
+    String profile = request.input("profile");
+
+    if (!powerManager) {
+        response["success"] = false;
+        response["message"] = "Power manager not initialized";
+        return Response(request.getServerRequest()).status(503).json(response);
+    }
+
+    if (profile == "auto") {
+        powerManager->setAutomatic(true);
+        powerManager->update();
+    } else if (profile == "active") {
+        powerManager->setProfile(Utils::PowerProfile::ACTIVE);
+    } else if (profile == "idle") {
+        powerManager->setProfile(Utils::PowerProfile::IDLE);
+    } else if (profile == "docked") {
+        powerManager->setProfile(Utils::PowerProfile::DOCKED);
+    } else {
+        response["success"] = false;
+        response["message"] = "Profile must be auto, active, idle or docked";
+        return Response(request.getServerRequest()).status(400).json(response);
+    }
+
+    response["success"] = true;
+    response["profile"] = Utils::Scheduler::profileName(powerManager->getProfile());
+    response["automatic"] = powerManager->isAutomatic();
+    return Response(request.getServerRequest()).status(200).json(response);
+}
+
+Response SystemController::chat(Request& request) {
+    Utils::SpiJsonDocument response;
+    String prompt = request.input("prompt");
+
+    if (prompt.isEmpty()) {
+        response["success"] = false;
+        response["message"] = "Prompt is required";
+        return Response(request.getServerRequest()).status(400).json(response);
+    }
+
+    // Answered by the robot, not in this response
+    if (!startGptChat(prompt.c_str())) {
+        response["success"] = false;
+        response["message"] = "GPT is unavailable or already answering";
+        return Response(request.getServerRequest()).status(503).json(response);
+    }
+
+    response["success"] = true;
+    return Response(request.getServerRequest()).status(202).json(response);
+}
+
+Response SystemController::updateService(Request& request) {
+    Utils::SpiJsonDocument response;
+    String name = request.input("name");
+    String action = request.input("action", "start");
+
+    if (!services) {
+        response["success"] = false;
+        response["message"] = "Service registry not initialized";
+        return Response(request.getServerRequest()).status(503).json(response);
+    }
+
+    int id = services->find(name.c_str());
+    if (id < 0) {
+        response["success"] = false;
+        response["message"] = "Unknown service";
+        return Response(request.getServerRequest()).status(404).json(response);
+    }
+
+    if (action == "start") {
+        if (!services->acquire(id)) {
+            response["success"] = false;
+            response["message"] = "Service failed to start";
+            return Response(request.getServerRequest()).status(500).json(response);
+        }
+    } else if (action == "stop") {
+        // Stopped by the next collection, unless in use
+        services->release(id);
+    } else {
+        response["success"] = false;
+        response["message"] = "Action must be start or stop";
+        return Response(request.getServerRequest()).status(400).json(response);
+    }
+
+    response["success"] = true;
+    response["name"] = name;
+    response["resident"] = services->isResident(id);
+    return Response(request.getServerRequest()).status(200).json(response);
+}
+
+Response SystemController::getTaskProfile(Request& request) {
+    Utils::SpiJsonDocument response;
+    JsonObject data = response["data"].to<JsonObject>();
+
+    SendTask::scanExternalTasks();
+    SendTask::updateAllTasksMemoryUsage();
+    bool cpuStats = SendTask::updateCpuUsage();
+    data["run_time_stats"] = cpuStats;
+
+    JsonArray tasks = data["tasks"].to<JsonArray>();
+    for (const auto& task : SendTask::getAllTasks()) {
+        JsonObject entry = tasks.add<JsonObject>();
+        entry["id"] = task.taskId;
+        entry["name"] = task.name;
+        entry["status"] = SendTask::getStatusName(task.status);
+        entry["external"] = task.isExternal;
+        entry["core"] = task.coreId == tskNO_AFFINITY ? -1 : (int)task.coreId;
+        entry["priority"] = task.priority;
+        if (cpuStats && task.cpuPercent >= 0) {
+            entry["cpu_percent"] = task.cpuPercent;
+            entry["run_time_ms"] = task.runTimeMs;
+        }
+        entry["stack_size"] = task.stackSize;
+        entry["stack_free_min"] = task.stackFreeMin;
+    }
+
+    // Iteration time histogram of loops that report their iterations
+    JsonArray bucketLimits = data["histogram_limits_us"].to<JsonArray>();
+    for (int i = 0; i < SendTask::LOOP_HISTOGRAM_BUCKETS - 1; i++) {
+        bucketLimits.add(SendTask::LOOP_HISTOGRAM_LIMITS_US[i]);
+    }
+
+    JsonArray loops = data["loops"].to<JsonArray>();
+    for (const auto& loop : SendTask::getLoopProfiles()) {
+        JsonObject entry = loops.add<JsonObject>();
+        entry["name"] = loop.name;
+        entry["iterations"] = loop.iterations;
+        entry["avg_us"] = loop.iterations > 0 ? (uint32_t)(loop.totalIterationUs / loop.iterations) : 0;
+        entry["max_us"] = loop.maxIterationUs;
+        entry["deadline_misses"] = loop.deadlineMisses;
+        JsonArray histogram = entry["histogram"].to<JsonArray>();
+        for (int i = 0; i < SendTask::LOOP_HISTOGRAM_BUCKETS; i++) {
+            histogram.add(loop.histogram[i]);
+        }
+    }
+
+    // Periodic jobs run by the scheduler
+    if (scheduler) {
+        JsonArray jobs = data["jobs"].to<JsonArray>();
+        for (int i = 0; i < scheduler->getJobCount(); i++) {
+            Utils::Scheduler::JobStats job;
+            if (!scheduler->getJobStats(i, job)) continue;
+            JsonObject entry = jobs.add<JsonObject>();
+            entry["name"] = job.name;
+            entry["period_ms"] = job.periodMs;
+            entry["runs"] = job.runs;
+            entry["max_run_us"] = job.maxRunUs;
+            entry["max_late_us"] = job.maxLateUs;
+            entry["misses"] = job.misses;
+        }
+    }
+
+    // Start a fresh measurement window on request
+    if (request.input("reset") == "1") {
+        SendTask::resetLoopProfiles();
+    }
+
+    response["success"] = true;
+    return Response(request.getServerRequest()).status(200).json(response);
+}
+
+Response SystemController::getTrace(Request& request) {
+    Utils::SpiJsonDocument response;
+    uint32_t events = request.input("events").toInt();
+    bool toSd = request.input("storage") == "sd";
+    Utils::FileManager::StorageType storage = toSd ? Utils::FileManager::STORAGE_SD_MMC : Utils::FileManager::STORAGE_LITTLEFS;
+    const char* path = "/trace.json";
+
+    if (Utils::Trace::getStats().capacity == 0) {
+        response["success"] = false;
+        response["message"] = "Tracing not initialized";
+        return Response(request.getServerRequest()).status(503).json(response);
+    }
+
+    if (!fileManager || (toSd && !fileManager->isSDMMCAvailable())) {
+        response["success"] = false;
+        response["message"] = "Storage not available";
+        return Response(request.getServerRequest()).status(503).json(response);
+    }
+
+    // Too large for a JSON document, stream it through a file
+    File file = fileManager->openFileForWriting(path, storage);
+    if (!file) {
+        response["success"] = false;
+        response["message"] = "Failed to open trace file";
+        return Response(request.getServerRequest()).status(500).json(response);
+    }
+    size_t written = Utils::Trace::writeChromeJson(file, events);
+    size_t size = file.size();
+    file.close();
+
+    if (toSd) {
+        response["success"] = true;
+        response["path"] = path;
+        response["events"] = written;
+        response["bytes"] = size;
+        return Response(request.getServerRequest()).status(200).json(response);
+    }
+
+    return Response(request.getServerRequest())
+        .status(200)
+        .header("Content-Disposition", "attachment; filename=\"trace.json\"")
+        .file(path);
+}
+
+Response SystemController::updateTrace(Request& request) {
+    Utils::SpiJsonDocument response;
+    String enabled = request.input("enabled");
+
+    if (request.input("clear") == "1") {
+        Utils::Trace::clear();
+    }
+    if (enabled == "1" || enabled == "true") {
+        Utils::Trace::setEnabled(true);
+    } else if (enabled == "0" || enabled == "false") {
+        Utils::Trace::setEnabled(false);
+    }
+
+    response["success"] = true;
+    response["enabled"] = Utils::Trace::isEnabled();
+    return Response(request.getServerRequest()).status(200).json(response);
+}
+
 Utils::Sstring SystemController::formatUptime(unsigned long milliseconds) {
     unsigned long seconds = milliseconds / 1000;
     unsigned long minutes = seconds / 60;
@@ -234,31 +758,21 @@ Response SystemController::getHostname(Request& request) {
 Response SystemController::getConfigurations(Request& request) {
     Utils::SpiJsonDocument response;
     
-    // Get all configurations
-    CsvDatabase* db = Model::getDatabase();
-    if (!db || !db->tableExists("configurations")) {
+    if (!IModel::Configuration::getStore()) {
         response["success"] = false;
-        response["message"] = "Configuration database not initialized";
+        response["message"] = "Configuration store not initialized";
         return Response(request.getServerRequest())
             .status(500)
             .json(response);
     }
     
-    std::vector<std::map<String, String>> results = db->select("configurations");
+    // Get all configurations
     JsonArray configs = response["configurations"].to<JsonArray>();
-    
-    for (const auto& row : results) {
+    IModel::Configuration::forEach([&configs](const char* key, const char* value) {
         JsonObject config = configs.add<JsonObject>();
-        
-        // Find key and value in the row
-        auto keyIt = row.find("key");
-        auto valueIt = row.find("value");
-        
-        if (keyIt != row.end() && valueIt != row.end()) {
-            config["key"] = keyIt->second;
-            config["value"] = valueIt->second;
-        }
-    }
+        config["key"] = key;
+        config["value"] = value;
+    });
     
     response["success"] = true;
     return Response(request.getServerRequest())
@@ -419,3 +933,21 @@ Response SystemController::getBatteryStatus(Request& request) {
         .status(200)
         .json(response);
 }
+
+Response SystemController::getOccupancyMap(Request& request) {
+    Utils::SpiJsonDocument response;
+
+    if (scanArea) {
+        JsonObject map = response["map"].to<JsonObject>();
+        map["yaw"] = scanArea->getCurrentYaw();
+        scanArea->getOccupancyGrid().toJson(map);
+        response["success"] = true;
+    } else {
+        response["success"] = false;
+        response["message"] = "Scan area not available";
+    }
+
+    return Response(request.getServerRequest())
+        .status(200)
+        .json(response);
+}
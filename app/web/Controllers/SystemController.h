@@ -39,6 +39,27 @@ public:
     // Get battery status
     static Response getBatteryStatus(Request& request);
 
+    // Get the occupancy map built by the scan area
+    static Response getOccupancyMap(Request& request);
+
+    // Select the power profile (auto, active, idle, docked)
+    static Response setPowerProfile(Request& request);
+
+    // Start or stop a lazily started service
+    static Response updateService(Request& request);
+
+    // Per-task CPU usage, loop iteration times and deadline misses
+    static Response getTaskProfile(Request& request);
+
+    // Download the trace rings as Chrome trace JSON, or dump them to SD
+    static Response getTrace(Request& request);
+
+    // Enable, disable or clear tracing
+    static Response updateTrace(Request& request);
+
+    // Ask GPT, the reply is spoken and acted out as it streams in
+    static Response chat(Request& request);
+
 private:
     // Helper methods
     static Utils::Sstring formatUptime(unsigned long milliseconds);
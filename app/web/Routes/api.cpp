@@ -51,6 +51,50 @@ void registerApiRoutes(Router* router) {
 						}).name("api.admin.users");
 				});
 
+				// File routes, the flash also holds the user database and the
+				// configuration store, so every route is admin only
+				api.group("/files", [&](Router& files) {
+						files.middleware({"auth", "admin"});
+						
+						files.get("", [](Request& request) -> Response {
+								return FileController::listFiles(request);
+						}).name("api.files.list");
+						
+						// Whole file, or a single byte range with a Range header
+						files.get("/download", [](Request& request) -> Response {
+								return FileController::download(request);
+						}).name("api.files.download");
+						
+						files.get("/info", [](Request& request) -> Response {
+								return FileController::getFileInfo(request);
+						}).name("api.files.info");
+						
+						files.get("/storage", [](Request& request) -> Response {
+								return FileController::getStorageInfo(request);
+						}).name("api.files.storage");
+						
+						files.post("/upload", [](Request& request) -> Response {
+								return FileController::upload(request);
+						}).name("api.files.upload");
+						
+						// Resumable upload: chunks at increasing offsets, then a CRC32 check
+						files.post("/upload/chunk", [](Request& request) -> Response {
+								return FileController::uploadChunk(request);
+						}).name("api.files.upload.chunk");
+						
+						files.get("/upload/status", [](Request& request) -> Response {
+								return FileController::uploadStatus(request);
+						}).name("api.files.upload.status");
+						
+						files.post("/upload/finish", [](Request& request) -> Response {
+								return FileController::uploadFinish(request);
+						}).name("api.files.upload.finish");
+						
+						files.post("/delete", [](Request& request) -> Response {
+								return FileController::deleteFile(request);
+						}).name("api.files.delete");
+				});
+
 				// System routes
 				api.group("/system", [&](Router& system) {
 						system.middleware({"auth", "admin"}); // Require authentication
@@ -95,6 +139,41 @@ void registerApiRoutes(Router* router) {
 								return SystemController::getBatteryStatus(request);
 						}).name("api.system.battery");
 						
+						// Get occupancy map around the robot
+						system.get("/map", [](Request& request) -> Response {
+								return SystemController::getOccupancyMap(request);
+						}).name("api.system.map");
+						
+						// Per-task CPU usage and loop latency, ?reset=1 clears the loop histograms
+						system.get("/tasks", [](Request& request) -> Response {
+								return SystemController::getTaskProfile(request);
+						}).name("api.system.tasks");
+						
+						// Chrome trace JSON, ?events=N newest per core, ?storage=sd dumps to the card
+						system.get("/trace", [](Request& request) -> Response {
+								return SystemController::getTrace(request);
+						}).name("api.system.trace");
+						
+						// Enable, disable or clear the trace rings
+						system.post("/trace", [](Request& request) -> Response {
+								return SystemController::updateTrace(request);
+						}).name("api.system.trace.update");
+						
+						// Select power profile: auto, active, idle or docked
+						system.post("/power", [](Request& request) -> Response {
+								return SystemController::setPowerProfile(request);
+						}).name("api.system.power");
+						
+						// Ask GPT, the robot speaks and acts out the streamed reply
+						system.post("/chat", [](Request& request) -> Response {
+								return SystemController::chat(request);
+						}).name("api.system.chat");
+						
+						// Start or stop a lazily started service (ftp, camera, ...)
+						system.post("/services", [](Request& request) -> Response {
+								return SystemController::updateService(request);
+						}).name("api.system.services");
+						
 						// System restart (admin only)
 						system.post("/restart", [](Request& request) -> Response {
 								return SystemController::restart(request);
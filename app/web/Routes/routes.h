@@ -7,9 +7,18 @@
 #include "Routing/Router.h"
 #include "../Controllers/AuthController.h"
 #include "../Controllers/SystemController.h"
+#include "../Controllers/AssetController.h"
+#include "../Controllers/FileController.h"
 
 void registerWebRoutes(Router* router);
 void registerApiRoutes(Router* router);
 void registerWebSocketRoutes(Router* router);
+void registerTeleopSocket();
+
+/**
+ * Send a binary frame to a /ws client, the telemetry sink
+ * @return false while the client's queue is full or before the first connect
+ */
+bool sendWebSocketFrame(uint32_t clientId, const uint8_t* data, size_t length);
 
 #endif
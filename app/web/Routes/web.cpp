@@ -39,12 +39,9 @@ void registerWebRoutes(Router* router) {
 						.redirect("/#dashboard");
 		}).name("dashboard");
 		
-		// Static file serving for CSS, JS, and other assets
+		// Static file serving for CSS, JS, and other assets, gzip with ETag
 		router->get("/assets/{file}", [](Request& request) -> Response {
-				String path = "/assets/" + request.route("file");
-				
-				return Response(request.getServerRequest())
-						.file(path.c_str());
+				return AssetController::serve(request);
 		}).name("assets");
 
 
@@ -1,5 +1,44 @@
 #include "routes.h"
 
+// Server behind /ws, kept so tasks can push frames outside the callbacks
+static AsyncWebSocket* wsServer = nullptr;
+static uint32_t wsClients[WEBSOCKET_MAX_CLIENTS];   // Logged in client ids, 0 when free
+
+static bool hasClient(const uint32_t* clients, size_t count, uint32_t clientId) {
+	for (size_t i = 0; i < count; i++) {
+		if (clients[i] == clientId) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Log a client in or out by its full id, a login fails while the table is full
+ */
+static void setClient(uint32_t* clients, size_t count, uint32_t clientId, bool authenticated) {
+	for (size_t i = 0; i < count; i++) {
+		if (clients[i] == clientId) {
+			clients[i] = 0;
+		}
+	}
+	for (size_t i = 0; authenticated && i < count; i++) {
+		if (clients[i] == 0) {
+			clients[i] = clientId;
+			return;
+		}
+	}
+}
+
+bool sendWebSocketFrame(uint32_t clientId, const uint8_t* data, size_t length) {
+	AsyncWebSocket* server = wsServer;
+	if (!server || !server->availableForWrite(clientId)) {
+		return false;
+	}
+	server->binary(clientId, data, length);
+	return true;
+}
+
 void registerWebSocketRoutes(Router* router) {
 	router->websocket("/ws")
 		.onConnect([](WebSocketRequest& request) {
@@ -7,7 +46,11 @@ void registerWebSocketRoutes(Router* router) {
 			Serial.printf("[WebSocket] client %u connected\n", request.clientId());
 			Utils::Sstring ip = request.clientIP();
 			logger->info("WebSocket client #%d connected from %s", clientId, ip.c_str());
-			sessions[clientId % 5].authenticated = false;
+			setClient(wsClients, WEBSOCKET_MAX_CLIENTS, clientId, false);
+			
+			if (!wsServer && request.getClient()) {
+				wsServer = request.getClient()->server();
+			}
 			
 			// Send welcome message
 			Utils::SpiJsonDocument welcome;
@@ -22,12 +65,16 @@ void registerWebSocketRoutes(Router* router) {
 		  uint32_t clientId = request.clientId();
       logger->info("WebSocket client #%d disconnected", clientId);
       // Clean up session data
-      sessions[clientId % 5].authenticated = false;
+      setClient(wsClients, WEBSOCKET_MAX_CLIENTS, clientId, false);
+      if (telemetry) {
+        telemetry->unsubscribe(clientId);
+      }
 		})
 		.onMessage([](WebSocketRequest& request, const String& message) {
+		  uint32_t clientId = request.clientId();
+
 			Utils::SpiJsonDocument doc;
 			DeserializationError error = deserializeJson(doc, message);
-		  uint32_t clientId = request.clientId();
 			
 			if (error) {
 				Serial.println("[WebSocket] Invalid JSON received");
@@ -39,10 +86,124 @@ void registerWebSocketRoutes(Router* router) {
 			Utils::Sstring version = doc["version"] | "0.0";
 
 			if (type == "login") {
+				// Same bearer token as the REST API, it must come from a login
+				Utils::Sstring token = data["token"] | "";
+				bool valid = AuthController::verifyToken(token);
+				setClient(wsClients, WEBSOCKET_MAX_CLIENTS, clientId, valid);
+				valid = valid && hasClient(wsClients, WEBSOCKET_MAX_CLIENTS, clientId);
 
+				Utils::SpiJsonDocument reply;
+				reply["type"] = "login";
+				reply["success"] = valid;
+				String replyMsg;
+				serializeJson(reply, replyMsg);
+				request.send(replyMsg.c_str());
 			}
-			else if (sessions[clientId % 5].authenticated) {
-			
+			else if (hasClient(wsClients, WEBSOCKET_MAX_CLIENTS, clientId)) {
+				if (type == "telemetry") {
+					// {"type":"telemetry","data":{"rate":20}}, rate 0 stops the stream
+					uint16_t rate = telemetry ? telemetry->subscribe(clientId, data["rate"] | 0) : 0;
+
+					Utils::SpiJsonDocument reply;
+					reply["type"] = "telemetry";
+					reply["rate"] = rate;
+					reply["version"] = Communication::TelemetryStream::FRAME_VERSION;
+					reply["fields"] = (int)Communication::TelemetryStream::FIELD_COUNT;
+					String replyMsg;
+					serializeJson(reply, replyMsg);
+					request.send(replyMsg.c_str());
+				}
 			}
 		});
 }
+
+
+#if WEBSOCKET_ENABLED && TELEOP_ENABLED
+/**
+ * Teleop has its own socket: commands are binary, and the framework hands
+ * /ws messages over as Strings without opcode or frame length
+ */
+static AsyncWebServer* teleopServer = nullptr;
+static AsyncWebSocket* teleopSocket = nullptr;
+static uint32_t teleopClients[TELEOP_MAX_CLIENTS];   // Logged in client ids, 0 when free
+
+static bool isTeleopClient(uint32_t clientId) {
+	return hasClient(teleopClients, TELEOP_MAX_CLIENTS, clientId);
+}
+
+static void setTeleopClient(uint32_t clientId, bool authenticated) {
+	setClient(teleopClients, TELEOP_MAX_CLIENTS, clientId, authenticated);
+
+	// Automatic maneuvers keep off the wheels while someone is driving
+	if (teleop) {
+		uint8_t sessions = 0;
+		for (size_t i = 0; i < TELEOP_MAX_CLIENTS; i++) {
+			sessions += teleopClients[i] != 0;
+		}
+		teleop->setSessions(sessions);
+	}
+}
+
+static void onTeleopLogin(AsyncWebSocketClient* client, const uint8_t* data, size_t length) {
+	// {"type":"login","data":{"token":"..."}}, same as /ws
+	Utils::SpiJsonDocument doc;
+	bool valid = false;
+	if (!deserializeJson(doc, data, length) && doc["type"] == "login") {
+		Utils::Sstring token = doc["data"]["token"] | "";
+		valid = AuthController::verifyToken(token);
+	}
+
+	setTeleopClient(client->id(), valid);
+	valid = valid && isTeleopClient(client->id());
+	if (valid && teleop) {
+		teleop->resetSequence();
+	}
+
+	Utils::SpiJsonDocument reply;
+	reply["type"] = "login";
+	reply["success"] = valid;
+	String replyMsg;
+	serializeJson(reply, replyMsg);
+	client->text(replyMsg);
+}
+
+static void onTeleopEvent(AsyncWebSocket* server, AsyncWebSocketClient* client, AwsEventType type,
+                          void* arg, uint8_t* data, size_t length) {
+	if (type == WS_EVT_DISCONNECT) {
+		setTeleopClient(client->id(), false);
+		return;
+	}
+	if (type != WS_EVT_DATA) {
+		return;
+	}
+
+	// Only whole messages in a single frame, commands and logins are small
+	AwsFrameInfo* info = static_cast<AwsFrameInfo*>(arg);
+	if (!info->final || info->index != 0 || info->len != length) {
+		return;
+	}
+
+	if (info->opcode == WS_BINARY) {
+		if (length == Motors::Teleop::COMMAND_SIZE && teleop && isTeleopClient(client->id())) {
+			teleop->submit(data, length);
+		}
+	} else if (info->opcode == WS_TEXT) {
+		onTeleopLogin(client, data, length);
+	}
+}
+
+void registerTeleopSocket() {
+	if (teleopServer) {
+		return;
+	}
+
+	teleopSocket = new AsyncWebSocket("/teleop");
+	teleopSocket->onEvent(onTeleopEvent);
+	teleopServer = new AsyncWebServer(TELEOP_WS_PORT);
+	teleopServer->addHandler(teleopSocket);
+	teleopServer->begin();
+	logger->info("Teleop socket listening on port %d", TELEOP_WS_PORT);
+}
+#else
+void registerTeleopSocket() {}
+#endif
@@ -6,6 +6,9 @@
 #define BATTERY_HIGH       75    // High battery level
 #define BATTERY_SAMPLES    10    // Number of samples to average for stable reading
 
+#define BATTERY_DMA_FRAME_SAMPLES 64  // Conversions per DMA frame (one callback)
+#define BATTERY_DMA_POOL_FRAMES   4   // Frames buffered by the driver
+
 #define BATTERY_NOTIFY_CRITICAL true  // Notify when battery is critical
 #define BATTERY_NOTIFY_LOW      true  // Notify when battery is low
 BatteryManager::BatteryManager(): TAG("BatteryManager") {
@@ -27,10 +30,18 @@ BatteryManager::BatteryManager(): TAG("BatteryManager") {
     notifyLow = BATTERY_NOTIFY_LOW;
     wasLowNotified = false;
     wasCriticalNotified = false;
+
+    adcHandle = nullptr;
+    caliHandle = nullptr;
+    adcChannel = ADC_CHANNEL_0;
+    sampleRateHz = 0;             // Polled analogRead() unless set
+    smoothingShift = 5;           // ~2s at 1kHz
+    rawAverageQ8 = 0;
+    frameCount = 0;
 }
 
 BatteryManager::~BatteryManager() {
-    // Nothing to clean up
+    stopContinuous();
 }
 
 void BatteryManager::init(int pin){
@@ -44,6 +55,10 @@ void BatteryManager::setup() {
     // Configure ADC
     analogReadResolution(12); // Set ADC resolution to 12 bits (0-4095)
     adcResolution = 4095; // Set the actual resolution value
+
+    if (sampleRateHz > 0 && !startContinuous()) {
+        ESP_LOGW(TAG, "BatteryManager: Continuous sampling unavailable, using analogRead()");
+    }
     
     // Get initial readings
     update();
@@ -63,8 +78,9 @@ void BatteryManager::update() {
     
     // Only update at the specified interval
     if ((currentTime - lastUpdate) >= updateInterval) {
-        // Read and calculate battery voltage and level
-        currentVoltage = readVoltage();
+        // Read and calculate battery voltage and level. With background
+        // sampling this is only a snapshot of the running average.
+        currentVoltage = isContinuous() ? snapshotVoltage() : readVoltage();
         currentLevel = calculateLevel(currentVoltage);
         BatteryState newState = determineState(currentLevel);
         
@@ -123,6 +139,154 @@ float BatteryManager::readVoltage() {
     return voltage;
 }
 
+bool BatteryManager::startContinuous() {
+    if (adcHandle != nullptr) {
+        return true;
+    }
+
+    adc_unit_t unit;
+    adc_channel_t channel;
+    if (adc_continuous_io_to_channel(batteryPin, &unit, &channel) != ESP_OK || unit != ADC_UNIT_1) {
+        // ADC2 is shared with WiFi and cannot run continuously
+        ESP_LOGW(TAG, "BatteryManager: GPIO %d is not an ADC1 pin", batteryPin);
+        return false;
+    }
+    adcChannel = channel;
+
+    adc_continuous_handle_cfg_t handleConfig = {};
+    handleConfig.max_store_buf_size = BATTERY_DMA_FRAME_SAMPLES * SOC_ADC_DIGI_RESULT_BYTES * BATTERY_DMA_POOL_FRAMES;
+    handleConfig.conv_frame_size = BATTERY_DMA_FRAME_SAMPLES * SOC_ADC_DIGI_RESULT_BYTES;
+    handleConfig.flags.flush_pool = 1; // Nobody reads the pool, frames are consumed in the callback
+    if (adc_continuous_new_handle(&handleConfig, &adcHandle) != ESP_OK) {
+        adcHandle = nullptr;
+        return false;
+    }
+
+    adc_digi_pattern_config_t pattern = {};
+    pattern.atten = ADC_ATTEN_DB_12;
+    pattern.channel = channel;
+    pattern.unit = unit;
+    pattern.bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+
+    adc_continuous_config_t config = {};
+    config.pattern_num = 1;
+    config.adc_pattern = &pattern;
+    config.sample_freq_hz = constrain(sampleRateHz, (uint32_t)SOC_ADC_SAMPLE_FREQ_THRES_LOW, (uint32_t)SOC_ADC_SAMPLE_FREQ_THRES_HIGH);
+    config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+
+    adc_continuous_evt_cbs_t callbacks = {};
+    callbacks.on_conv_done = onConversionDone;
+
+    if (adc_continuous_config(adcHandle, &config) != ESP_OK ||
+        adc_continuous_register_event_callbacks(adcHandle, &callbacks, this) != ESP_OK) {
+        adc_continuous_deinit(adcHandle);
+        adcHandle = nullptr;
+        return false;
+    }
+
+    // Factory calibration from eFuse, the raw 3.3V scale is off by up to 10%
+    esp_err_t caliResult = ESP_ERR_NOT_SUPPORTED;
+#if ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED
+    adc_cali_curve_fitting_config_t caliConfig = {};
+    caliConfig.unit_id = unit;
+    caliConfig.chan = channel;
+    caliConfig.atten = ADC_ATTEN_DB_12;
+    caliConfig.bitwidth = ADC_BITWIDTH_12;
+    caliResult = adc_cali_create_scheme_curve_fitting(&caliConfig, &caliHandle);
+#elif ADC_CALI_SCHEME_LINE_FITTING_SUPPORTED
+    adc_cali_line_fitting_config_t caliConfig = {};
+    caliConfig.unit_id = unit;
+    caliConfig.atten = ADC_ATTEN_DB_12;
+    caliConfig.bitwidth = ADC_BITWIDTH_12;
+    caliResult = adc_cali_create_scheme_line_fitting(&caliConfig, &caliHandle);
+#endif
+    if (caliResult != ESP_OK) {
+        caliHandle = nullptr;
+        ESP_LOGW(TAG, "BatteryManager: No eFuse calibration, using nominal ADC scale");
+    }
+
+    rawAverageQ8 = 0;
+    frameCount = 0;
+    if (adc_continuous_start(adcHandle) != ESP_OK) {
+        stopContinuous();
+        return false;
+    }
+
+    ESP_LOGI(TAG, "BatteryManager: DMA sampling at %u Hz, %s", (unsigned)config.sample_freq_hz,
+             caliHandle ? "calibrated" : "uncalibrated");
+
+    // Wait for the first frame so the initial reading is real
+    unsigned long start = millis();
+    while (frameCount.load() == 0 && millis() - start < 200) {
+        delay(5);
+    }
+    return true;
+}
+
+void BatteryManager::stopContinuous() {
+    if (adcHandle != nullptr) {
+        adc_continuous_stop(adcHandle);
+        adc_continuous_deinit(adcHandle);
+        adcHandle = nullptr;
+    }
+    if (caliHandle != nullptr) {
+#if ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED
+        adc_cali_delete_scheme_curve_fitting(caliHandle);
+#elif ADC_CALI_SCHEME_LINE_FITTING_SUPPORTED
+        adc_cali_delete_scheme_line_fitting(caliHandle);
+#endif
+        caliHandle = nullptr;
+    }
+}
+
+bool BatteryManager::onConversionDone(adc_continuous_handle_t handle,
+                                      const adc_continuous_evt_data_t* edata, void* userData) {
+    BatteryManager* self = static_cast<BatteryManager*>(userData);
+
+    // Integer only, this runs in the DMA interrupt
+    uint32_t sum = 0;
+    uint32_t count = 0;
+    for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= edata->size; i += SOC_ADC_DIGI_RESULT_BYTES) {
+        const adc_digi_output_data_t* result = reinterpret_cast<const adc_digi_output_data_t*>(&edata->conv_frame_buffer[i]);
+        if (result->type2.channel != self->adcChannel) {
+            continue;
+        }
+        sum += result->type2.data;
+        count++;
+    }
+    if (count == 0) {
+        return false;
+    }
+
+    uint32_t frameAverageQ8 = (sum << 8) / count;
+    uint32_t frames = self->frameCount.load(std::memory_order_relaxed);
+    uint32_t average = self->rawAverageQ8.load(std::memory_order_relaxed);
+    if (frames == 0) {
+        average = frameAverageQ8;
+    } else {
+        // average += (frame - average) / 2^shift, in signed fixed point
+        int32_t delta = (int32_t)frameAverageQ8 - (int32_t)average;
+        average = (uint32_t)((int32_t)average + (delta >> self->smoothingShift));
+    }
+    self->rawAverageQ8.store(average, std::memory_order_relaxed);
+    self->frameCount.store(frames + 1, std::memory_order_release);
+    return false;
+}
+
+float BatteryManager::snapshotVoltage() const {
+    uint32_t raw = (rawAverageQ8.load(std::memory_order_relaxed) + 128) >> 8;
+
+    float adcVoltage;
+    int millivolts;
+    if (caliHandle != nullptr && adc_cali_raw_to_voltage(caliHandle, raw, &millivolts) == ESP_OK) {
+        adcVoltage = millivolts / 1000.0f;
+    } else {
+        adcVoltage = raw * (3.3f / adcResolution);
+    }
+    return adcVoltage * voltageDivider;
+}
+
 int BatteryManager::calculateLevel(float voltage) {
     // Calculate battery percentage based on voltage
     // Linear mapping from min voltage (0%) to max voltage (100%)
@@ -143,6 +307,17 @@ BatteryState BatteryManager::determineState(int level) {
     return BATTERY_STATE_FULL;
 }
 
+const char* BatteryManager::stateName(BatteryState state) {
+    switch (state) {
+        case BATTERY_STATE_CRITICAL: return "CRITICAL";
+        case BATTERY_STATE_LOW:      return "LOW";
+        case BATTERY_STATE_MEDIUM:   return "MEDIUM";
+        case BATTERY_STATE_HIGH:     return "HIGH";
+        case BATTERY_STATE_FULL:     return "FULL";
+        default:                     return "UNKNOWN";
+    }
+}
+
 void BatteryManager::setUpdateInterval(unsigned long interval) {
     updateInterval = interval;
 }
@@ -167,16 +342,7 @@ void BatteryManager::printStatus() const {
     ESP_LOGI(TAG, "Level: %d%%", currentLevel);
     
     // Print state
-    const char* stateStr = "UNKNOWN";
-    switch (currentState) {
-        case BATTERY_STATE_CRITICAL: stateStr = "CRITICAL"; break;
-        case BATTERY_STATE_LOW:      stateStr = "LOW"; break;
-        case BATTERY_STATE_MEDIUM:   stateStr = "MEDIUM"; break;
-        case BATTERY_STATE_HIGH:     stateStr = "HIGH"; break;
-        case BATTERY_STATE_FULL:     stateStr = "FULL"; break;
-        default:                     stateStr = "UNKNOWN"; break;
-    }
-    ESP_LOGI(TAG, "State: %s", stateStr);
+    ESP_LOGI(TAG, "State: %s", getStateName());
     
     // Print charging state
     const char* chargingStr = "Unknown";
@@ -191,5 +357,7 @@ void BatteryManager::printStatus() const {
     // Print calibration info
     ESP_LOGI(TAG, "Voltage range: %.2fV - %.2fV", voltageMin, voltageMax);
     ESP_LOGI(TAG, "Voltage divider: %.2f", voltageDivider);
+    ESP_LOGI(TAG, "Sampling: %s%s", isContinuous() ? "DMA continuous" : "analogRead()",
+             isCalibrated() ? ", eFuse calibrated" : "");
     ESP_LOGI(TAG, "==============================");
 }
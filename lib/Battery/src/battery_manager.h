@@ -3,6 +3,10 @@
 
 #include <Arduino.h>
 #include <Preferences.h>
+#include <atomic>
+#include <esp_adc/adc_continuous.h>
+#include <esp_adc/adc_cali.h>
+#include <esp_adc/adc_cali_scheme.h>
 
 // Battery level states
 enum BatteryState {
@@ -43,8 +47,22 @@ private:
     bool notifyLow;                  // Whether to notify on low
     bool wasLowNotified;             // Whether low notification was shown
     bool wasCriticalNotified;        // Whether critical notification was shown
+
+    // Continuous (DMA) sampling
+    adc_continuous_handle_t adcHandle;
+    adc_cali_handle_t caliHandle;
+    adc_channel_t adcChannel;
+    uint32_t sampleRateHz;
+    uint8_t smoothingShift;          // Average over 2^shift DMA frames
+    std::atomic<uint32_t> rawAverageQ8; // Exponential average of raw ADC, 24.8 fixed point
+    std::atomic<uint32_t> frameCount;   // DMA frames averaged so far
     
     void setup();
+    bool startContinuous();
+    void stopContinuous();
+    float snapshotVoltage() const;   // Convert the current average, no ADC access
+    static bool onConversionDone(adc_continuous_handle_t handle,
+                                 const adc_continuous_evt_data_t* edata, void* userData);
 
     // Private methods
     float readVoltage();             // Read raw voltage from ADC
@@ -70,9 +88,23 @@ public:
     void setAdcResolution(float value) { adcResolution = value; };
     
     void setInterval(unsigned long value) { updateInterval = value; }
+
+    /**
+     * Background sampling rate, 0 falls back to blocking analogRead() bursts
+     * Must be set before init()
+     */
+    void setSampleRate(uint32_t hz) { sampleRateHz = hz; }
+
+    /**
+     * Averaging window of the background sampler, in powers of two DMA frames
+     */
+    void setSmoothing(uint8_t shift) { smoothingShift = shift > 12 ? 12 : shift; }
     
     // Getters
-    float getVoltage() const { return currentVoltage; }
+    /**
+     * Battery voltage, O(1) and non-blocking when background sampling runs
+     */
+    float getVoltage() const { return isContinuous() && frameCount.load() > 0 ? snapshotVoltage() : currentVoltage; }
     int getLevel() const { return currentLevel; }
     BatteryState getState() const { return currentState; }
     ChargingState getChargingState() const { return chargingState; }
@@ -81,6 +113,10 @@ public:
     bool isCritical() const { return currentState == BATTERY_STATE_CRITICAL; }
     bool isLow() const { return currentState == BATTERY_STATE_LOW; }
     bool isCharging() const { return chargingState == CHARGING_IN_PROGRESS; }
+    bool isContinuous() const { return adcHandle != nullptr; }
+    bool isCalibrated() const { return caliHandle != nullptr; }
+    const char* getStateName() const { return stateName(currentState); }
+    static const char* stateName(BatteryState state);
     
     // Charging detection (if supported by hardware)
     void setChargingState(ChargingState state);
@@ -18,6 +18,7 @@
 #include <sys/queue.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
+#include "Trace.h"
 #include "freertos/event_groups.h"
 #include "freertos/task.h"
 #include "esp_task_wdt.h"
@@ -111,6 +112,7 @@ void sr_handler_task(void *pvParam) {
     }
 
     if (WAKENET_DETECTED == result.wakenet_mode) {
+      Utils::Trace::instant("sr.wakeword");
       if (g_sr_data->user_cb) {
         g_sr_data->user_cb(g_sr_data->user_cb_arg, SR_EVENT_WAKEWORD, -1, -1);
         ESP_LOGI(SR::TAG, "SR_EVENT_WAKEWORD");
@@ -127,6 +129,7 @@ void sr_handler_task(void *pvParam) {
     }
 
     if (ESP_MN_STATE_DETECTED == result.state) {
+      Utils::Trace::instant("sr.command", result.command_id);
       if (g_sr_data->user_cb) {
         g_sr_data->user_cb(g_sr_data->user_cb_arg, SR_EVENT_COMMAND, result.command_id, result.phrase_id);
         ESP_LOGI(SR::TAG, "SR_EVENT_COMMAND");
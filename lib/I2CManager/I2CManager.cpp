@@ -1,4 +1,5 @@
 #include "I2CManager.h"
+#include "Trace.h"
 
 namespace Utils {
 
@@ -73,6 +74,7 @@ TwoWire* I2CManager::getBus(const char* busName) {
 }
 
 bool I2CManager::devicePresent(const char* busName, byte address) {
+    TraceScope trace("i2c.probe", address << 8);
     BusInfo* bus = takeBus(busName);
     if (!bus) {
         return false;
@@ -87,6 +89,8 @@ bool I2CManager::devicePresent(const char* busName, byte address) {
 
 bool I2CManager::writeRegister(const char* busName, byte deviceAddress, 
                               uint8_t registerAddress, uint8_t data) {
+    // Device and register in the trace argument, the span includes waiting for the bus
+    TraceScope trace("i2c.write", deviceAddress << 8 | registerAddress);
     BusInfo* bus = takeBus(busName);
     if (!bus) {
         return false;
@@ -124,6 +128,7 @@ bool I2CManager::writeRegister(const char* busName, byte deviceAddress,
 
 bool I2CManager::readRegister(const char* busName, byte deviceAddress, 
                              uint8_t registerAddress, uint8_t &result) {
+    TraceScope trace("i2c.read", deviceAddress << 8 | registerAddress);
     BusInfo* bus = takeBus(busName);
     if (!bus) {
         return false;
@@ -169,6 +174,8 @@ bool I2CManager::readRegisters(const char* busName, byte deviceAddress,
         return false;
     }
 
+    TraceScope trace("i2c.read", deviceAddress << 8 | registerAddress);
+
     BusInfo* bus = takeBus(busName);
     if (!bus) {
         return false;
@@ -1,4 +1,6 @@
 #include "SendTask.h"
+#include <esp_timer.h>
+#include <string.h>
 
 namespace SendTask {
 	
@@ -18,6 +20,62 @@ namespace SendTask {
 		return "task_" + String(millis()) + "_" + String(++taskCounter);
 	}
 	
+	// Loop profiles live in a fixed table found by task handle, so the hot
+	// path of a loop never waits for the registry mutex
+	static const int MAX_LOOP_PROFILES = 16;
+	
+	struct LoopSlot {
+		TaskHandle_t handle;
+		char name[configMAX_TASK_NAME_LEN];
+		int64_t iterationStartUs;
+		uint32_t iterations;
+		uint32_t deadlineMisses;
+		uint32_t maxIterationUs;
+		uint64_t totalIterationUs;
+		uint32_t histogram[LOOP_HISTOGRAM_BUCKETS];
+	};
+	
+	static LoopSlot loopSlots[MAX_LOOP_PROFILES];
+	static portMUX_TYPE loopMux = portMUX_INITIALIZER_UNLOCKED;
+	
+	// Run time counters at the previous CPU sample, guarded by the registry mutex
+	static std::map<TaskHandle_t, uint32_t> lastRunTime;
+	static uint32_t lastTotalRunTime = 0;
+	
+	// Slot of the calling task, claims a free one on first use. Call inside loopMux
+	static LoopSlot* currentLoopSlot() {
+		TaskHandle_t handle = xTaskGetCurrentTaskHandle();
+		LoopSlot* freeSlot = nullptr;
+		for (int i = 0; i < MAX_LOOP_PROFILES; i++) {
+			if (loopSlots[i].handle == handle) {
+				return &loopSlots[i];
+			}
+			if (loopSlots[i].handle == nullptr && freeSlot == nullptr) {
+				freeSlot = &loopSlots[i];
+			}
+		}
+		if (freeSlot != nullptr) {
+			memset(freeSlot, 0, sizeof(LoopSlot));
+			freeSlot->handle = handle;
+			strncpy(freeSlot->name, pcTaskGetName(handle), sizeof(freeSlot->name) - 1);
+		}
+		return freeSlot;
+	}
+	
+	// Forget the profile of a task that is going away, its handle may be reused
+	static void releaseLoopProfile(TaskHandle_t handle) {
+		if (handle == nullptr) {
+			return;
+		}
+		portENTER_CRITICAL(&loopMux);
+		for (int i = 0; i < MAX_LOOP_PROFILES; i++) {
+			if (loopSlots[i].handle == handle) {
+				loopSlots[i].handle = nullptr;
+			}
+		}
+		portEXIT_CRITICAL(&loopMux);
+	}
+	
 	// Update task status safely
 	static void updateTaskStatus(const String& taskId, TaskStatus status) {
 		ensureMutexInitialized();
@@ -103,6 +161,7 @@ namespace SendTask {
 				
 				// Cleanup
 				delete taskParams;
+				releaseLoopProfile(xTaskGetCurrentTaskHandle());
 				vTaskDelete(NULL);
 			}, 
 			config.name.c_str(),
@@ -130,6 +189,7 @@ namespace SendTask {
 				
 				// Cleanup
 				delete taskParams;
+				releaseLoopProfile(xTaskGetCurrentTaskHandle());
 				vTaskDelete(NULL);
 			}, 
 			config.name.c_str(),
@@ -213,6 +273,7 @@ namespace SendTask {
 				
 				// Cleanup
 				delete taskParams;
+				releaseLoopProfile(xTaskGetCurrentTaskHandle());
 				vTaskDelete(NULL);
 			}, 
 			config.name.c_str(),
@@ -241,6 +302,7 @@ namespace SendTask {
 				
 				// Cleanup
 				delete taskParams;
+				releaseLoopProfile(xTaskGetCurrentTaskHandle());
 				vTaskDelete(NULL);
 			}, 
 			config.name.c_str(),
@@ -385,6 +447,7 @@ namespace SendTask {
 					}
 					
 					// Stop external task
+					releaseLoopProfile(it->second.handle);
 					vTaskDelete(it->second.handle);
 					it->second.handle = nullptr;
 					it->second.status = TaskStatus::FAILED;
@@ -401,6 +464,7 @@ namespace SendTask {
 					    it->second.status == TaskStatus::PAUSED) {
 						
 						// Stop the task
+						releaseLoopProfile(it->second.handle);
 						vTaskDelete(it->second.handle);
 						it->second.handle = nullptr;
 						it->second.status = TaskStatus::FAILED;
@@ -538,6 +602,18 @@ namespace SendTask {
 		return count;
 	}
 
+	const char* getStatusName(TaskStatus status) {
+		switch (status) {
+			case TaskStatus::WAITING: return "WAITING";
+			case TaskStatus::INPROGRESS: return "RUNNING";
+			case TaskStatus::DONE: return "DONE";
+			case TaskStatus::FAILED: return "FAILED";
+			case TaskStatus::PAUSED: return "PAUSED";
+			case TaskStatus::EXTERNAL_TASK: return "EXTERNAL";
+			default: return "UNKNOWN";
+		}
+	}
+
 	void scanExternalTasks() {
 		ensureMutexInitialized();
 		
@@ -783,6 +859,7 @@ namespace SendTask {
 				}
 				
 				// Safe to delete non-critical external tasks
+				releaseLoopProfile(it->second.handle);
 				vTaskDelete(it->second.handle);
 				taskRegistry.erase(it);
 				deleted = true;
@@ -793,4 +870,133 @@ namespace SendTask {
 		return deleted;
 	}
 
+	bool updateCpuUsage() {
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+		ensureMutexInitialized();
+		
+		UBaseType_t taskCount = uxTaskGetNumberOfTasks();
+		TaskStatus_t* taskStatusArray = (TaskStatus_t*)malloc(taskCount * sizeof(TaskStatus_t));
+		if (taskStatusArray == nullptr) {
+			return false;
+		}
+		
+		// Run time counters tick in microseconds, the total is the wall clock
+		// so a percentage is the share of one core
+		uint32_t totalRunTime = 0;
+		UBaseType_t actualCount = uxTaskGetSystemState(taskStatusArray, taskCount, &totalRunTime);
+		uint32_t window = totalRunTime - lastTotalRunTime;
+		
+		std::map<TaskHandle_t, uint32_t> currentRunTime;
+		for (UBaseType_t i = 0; i < actualCount; i++) {
+			currentRunTime[taskStatusArray[i].xHandle] = taskStatusArray[i].ulRunTimeCounter;
+		}
+		free(taskStatusArray);
+		
+		if (xSemaphoreTake(registryMutex, portMAX_DELAY) == pdTRUE) {
+			for (auto& pair : taskRegistry) {
+				auto current = currentRunTime.find(pair.second.handle);
+				if (pair.second.handle == nullptr || current == currentRunTime.end()) {
+					pair.second.cpuPercent = -1;
+					continue;
+				}
+				pair.second.runTimeMs = current->second / 1000;
+				
+				auto previous = lastRunTime.find(pair.second.handle);
+				if (previous != lastRunTime.end() && lastTotalRunTime != 0 && window > 0) {
+					float percent = (uint32_t)(current->second - previous->second) * 100.0f / window;
+					pair.second.cpuPercent = percent > 100.0f ? 100.0f : percent;
+				}
+			}
+			lastRunTime.swap(currentRunTime);
+			lastTotalRunTime = totalRunTime;
+			xSemaphoreGive(registryMutex);
+		}
+		return true;
+#else
+		return false;
+#endif
+	}
+	
+	bool delayUntil(TickType_t* previousWakeTime, TickType_t period) {
+		// Missed when the body ran past the wakeup it is about to wait for
+		TickType_t deadline = *previousWakeTime + period;
+		bool missed = (int32_t)(xTaskGetTickCount() - deadline) > 0;
+		endIteration(missed);
+		vTaskDelayUntil(previousWakeTime, period);
+		beginIteration();
+		return !missed;
+	}
+	
+	void beginIteration() {
+		int64_t now = esp_timer_get_time();
+		portENTER_CRITICAL(&loopMux);
+		LoopSlot* slot = currentLoopSlot();
+		if (slot != nullptr) {
+			slot->iterationStartUs = now;
+		}
+		portEXIT_CRITICAL(&loopMux);
+	}
+	
+	void endIteration(bool deadlineMissed) {
+		int64_t now = esp_timer_get_time();
+		portENTER_CRITICAL(&loopMux);
+		LoopSlot* slot = currentLoopSlot();
+		if (slot != nullptr && slot->iterationStartUs != 0) {
+			uint32_t duration = (uint32_t)(now - slot->iterationStartUs);
+			slot->iterationStartUs = 0;
+			slot->iterations++;
+			slot->totalIterationUs += duration;
+			if (duration > slot->maxIterationUs) {
+				slot->maxIterationUs = duration;
+			}
+			if (deadlineMissed) {
+				slot->deadlineMisses++;
+			}
+			int bucket = 0;
+			while (bucket < LOOP_HISTOGRAM_BUCKETS - 1 && duration >= LOOP_HISTOGRAM_LIMITS_US[bucket]) {
+				bucket++;
+			}
+			slot->histogram[bucket]++;
+		}
+		portEXIT_CRITICAL(&loopMux);
+	}
+	
+	std::vector<LoopProfile> getLoopProfiles() {
+		LoopSlot snapshot[MAX_LOOP_PROFILES];
+		portENTER_CRITICAL(&loopMux);
+		memcpy(snapshot, loopSlots, sizeof(snapshot));
+		portEXIT_CRITICAL(&loopMux);
+		
+		std::vector<LoopProfile> profiles;
+		for (int i = 0; i < MAX_LOOP_PROFILES; i++) {
+			const LoopSlot& slot = snapshot[i];
+			if (slot.handle == nullptr) {
+				continue;
+			}
+			LoopProfile profile;
+			profile.name = String(slot.name);
+			profile.handle = slot.handle;
+			profile.iterations = slot.iterations;
+			profile.deadlineMisses = slot.deadlineMisses;
+			profile.maxIterationUs = slot.maxIterationUs;
+			profile.totalIterationUs = slot.totalIterationUs;
+			memcpy(profile.histogram, slot.histogram, sizeof(profile.histogram));
+			profiles.push_back(profile);
+		}
+		return profiles;
+	}
+	
+	void resetLoopProfiles() {
+		portENTER_CRITICAL(&loopMux);
+		for (int i = 0; i < MAX_LOOP_PROFILES; i++) {
+			LoopSlot& slot = loopSlots[i];
+			slot.iterations = 0;
+			slot.deadlineMisses = 0;
+			slot.maxIterationUs = 0;
+			slot.totalIterationUs = 0;
+			memset(slot.histogram, 0, sizeof(slot.histogram));
+		}
+		portEXIT_CRITICAL(&loopMux);
+	}
+
 }
\ No newline at end of file
@@ -44,6 +44,24 @@ namespace SendTask {
 		uint32_t stackSize = 0;    // Stack size allocated
 		uint32_t stackFreeMin = 0; // Minimum free stack (high water mark)
 		uint32_t stackUsed = 0;    // Current stack usage
+		float cpuPercent = -1;     // Share of one core since the previous sample, -1 when unknown
+		uint32_t runTimeMs = 0;    // Total run time, needs FreeRTOS run time stats
+	};
+	
+	// Loop iteration time histogram, upper bucket limits in microseconds
+	static const int LOOP_HISTOGRAM_BUCKETS = 8;
+	static const uint32_t LOOP_HISTOGRAM_LIMITS_US[LOOP_HISTOGRAM_BUCKETS] = {
+		1000, 2000, 5000, 10000, 20000, 50000, 100000, UINT32_MAX
+	};
+	
+	struct LoopProfile {
+		String name;
+		TaskHandle_t handle;
+		uint32_t iterations;
+		uint32_t deadlineMisses;     // Iterations that ended after the next wakeup was due
+		uint32_t maxIterationUs;
+		uint64_t totalIterationUs;
+		uint32_t histogram[LOOP_HISTOGRAM_BUCKETS];
 	};
 	
 	// Core task management functions
@@ -67,6 +85,7 @@ namespace SendTask {
 	bool removeTask(const String& taskId);
 	int getTaskCount();
 	int getTaskCountByStatus(TaskStatus status);
+	const char* getStatusName(TaskStatus status);
 	
 	// External task scanning
 	void scanExternalTasks();
@@ -75,6 +94,16 @@ namespace SendTask {
 	void updateTaskMemoryUsage(const String& taskId);
 	void updateAllTasksMemoryUsage();
 	bool deleteExternalTask(const String& taskId);  // Safely delete external tasks
+	
+	// CPU accounting, refreshes cpuPercent and runTimeMs of every registered task
+	bool updateCpuUsage();  // False without FreeRTOS run time stats
+	
+	// Loop profiling, called from inside the loop task being measured
+	bool delayUntil(TickType_t* previousWakeTime, TickType_t period);  // vTaskDelayUntil that times the iteration before it
+	void beginIteration();
+	void endIteration(bool deadlineMissed = false);
+	std::vector<LoopProfile> getLoopProfiles();
+	void resetLoopProfiles();
 }
 
 // Backward compatibility namespace - moved to global level
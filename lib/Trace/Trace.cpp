@@ -0,0 +1,158 @@
+#include "Trace.h"
+#include <esp_timer.h>
+#include <esp_heap_caps.h>
+#include <map>
+#include <string.h>
+
+namespace Utils {
+
+Trace::Event* Trace::_rings[2] = { nullptr, nullptr };
+uint32_t Trace::_capacity = 0;
+std::atomic<uint32_t> Trace::_heads[2];
+std::atomic<bool> Trace::_enabled(false);
+
+bool Trace::init(uint32_t eventsPerCore) {
+    if (_capacity > 0) {
+        return true;
+    }
+
+    if (eventsPerCore == 0) {
+        return false;
+    }
+
+    // Power of two, so a slot is the index masked
+    uint32_t capacity = 1;
+    while (capacity * 2 <= eventsPerCore) {
+        capacity *= 2;
+    }
+
+    uint32_t caps = ESP.getFreePsram() > 0 ? MALLOC_CAP_SPIRAM : MALLOC_CAP_DEFAULT;
+    for (int core = 0; core < 2; core++) {
+        _rings[core] = (Event*)heap_caps_calloc(capacity, sizeof(Event), caps);
+        if (_rings[core] == nullptr) {
+            for (int i = 0; i < core; i++) {
+                heap_caps_free(_rings[i]);
+                _rings[i] = nullptr;
+            }
+            return false;
+        }
+        _heads[core].store(0, std::memory_order_relaxed);
+    }
+
+    _capacity = capacity;
+    _enabled.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+void Trace::record(const char* name, Phase phase, uint16_t arg) {
+    if (!_enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    uint8_t core = xPortGetCoreID() & 1;
+    uint32_t index = _heads[core].fetch_add(1, std::memory_order_relaxed);
+    Event& event = _rings[core][index & (_capacity - 1)];
+
+    event.sequence = 0;
+    event.timestampUs = (uint32_t)esp_timer_get_time();
+    event.name = name;
+    event.task = xTaskGetCurrentTaskHandle();
+    event.arg = arg;
+    event.phase = phase;
+    event.core = core;
+    std::atomic_thread_fence(std::memory_order_release);
+    event.sequence = index + 1;
+}
+
+void Trace::clear() {
+    bool enabled = isEnabled();
+    _enabled.store(false, std::memory_order_relaxed);
+    for (int core = 0; core < 2 && _capacity > 0; core++) {
+        memset(_rings[core], 0, _capacity * sizeof(Event));
+        _heads[core].store(0, std::memory_order_relaxed);
+    }
+    _enabled.store(enabled, std::memory_order_relaxed);
+}
+
+Trace::Stats Trace::getStats() {
+    Stats stats = {};
+    stats.enabled = isEnabled();
+    stats.capacity = _capacity;
+    for (int core = 0; core < 2; core++) {
+        uint32_t head = _heads[core].load(std::memory_order_relaxed);
+        stats.recorded[core] = head;
+        stats.overwritten[core] = head > _capacity ? head - _capacity : 0;
+    }
+    return stats;
+}
+
+size_t Trace::writeChromeJson(Print& out, uint32_t maxEvents) {
+    // Stop the rings moving while they are read
+    bool enabled = isEnabled();
+    _enabled.store(false, std::memory_order_relaxed);
+
+    // Timestamps are 32 bit, widen them against the current time
+    int64_t nowUs = esp_timer_get_time();
+    uint32_t now32 = (uint32_t)nowUs;
+
+    // Names of the tasks still alive, deleted ones are shown by handle
+    std::map<TaskHandle_t, String> names;
+    UBaseType_t taskCount = uxTaskGetNumberOfTasks();
+    TaskStatus_t* tasks = (TaskStatus_t*)malloc(taskCount * sizeof(TaskStatus_t));
+    if (tasks != nullptr) {
+        taskCount = uxTaskGetSystemState(tasks, taskCount, nullptr);
+        for (UBaseType_t i = 0; i < taskCount; i++) {
+            names[tasks[i].xHandle] = tasks[i].pcTaskName;
+        }
+        free(tasks);
+    }
+
+    out.print("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    out.print("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"cozmo\"}}");
+
+    std::map<TaskHandle_t, bool> named;
+    size_t written = 0;
+    for (int core = 0; core < 2 && _capacity > 0; core++) {
+        uint32_t head = _heads[core].load(std::memory_order_acquire);
+        uint32_t available = head < _capacity ? head : _capacity;
+        if (maxEvents > 0 && available > maxEvents) {
+            available = maxEvents;
+        }
+
+        for (uint32_t index = head - available; index != head; index++) {
+            const Event& event = _rings[core][index & (_capacity - 1)];
+            if (event.sequence != index + 1 || event.name == nullptr) {
+                continue;
+            }
+
+            if (!named[event.task]) {
+                named[event.task] = true;
+                out.printf(",{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"",
+                    (uint32_t)(uintptr_t)event.task);
+                auto name = names.find(event.task);
+                if (name != names.end()) {
+                    out.print(name->second);
+                } else {
+                    out.printf("task %08x", (uint32_t)(uintptr_t)event.task);
+                }
+                out.print("\"}}");
+            }
+
+            int64_t timestamp = nowUs - (uint32_t)(now32 - event.timestampUs);
+            out.printf(",{\"name\":\"%s\",\"ph\":\"%c\",\"pid\":0,\"tid\":%u,\"ts\":",
+                event.name, event.phase, (uint32_t)(uintptr_t)event.task);
+            out.print((long long)timestamp);
+            if (event.phase == INSTANT) {
+                out.print(",\"s\":\"t\"");
+            }
+            out.printf(",\"args\":{\"core\":%u,\"arg\":%u}}", event.core, event.arg);
+            written++;
+        }
+    }
+    out.print("]}");
+
+    _enabled.store(enabled, std::memory_order_relaxed);
+    return written;
+}
+
+} // namespace Utils
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+namespace Utils {
+
+/**
+ * Cross-task timing trace
+ *
+ * Begin, end and instant events go into one ring per core, so writers on
+ * different cores never share an index. A writer reserves its slot with an
+ * atomic increment and stamps the slot with its sequence number last; the
+ * exporter skips slots whose stamp does not match, which covers a task
+ * preempted halfway through a write on the same core.
+ *
+ * Event names must be string literals, only the pointer is stored.
+ * Rings live in PSRAM when available. Export writes Chrome trace JSON,
+ * viewable in chrome://tracing or Perfetto.
+ */
+class Trace {
+public:
+    enum Phase : char {
+        BEGIN = 'B',
+        END = 'E',
+        INSTANT = 'i'
+    };
+
+    struct Event {
+        uint32_t sequence;      // Reservation index + 1, written last
+        uint32_t timestampUs;   // Low 32 bits of esp_timer, wraps after 71 minutes
+        const char* name;
+        TaskHandle_t task;
+        uint16_t arg;
+        char phase;
+        uint8_t core;
+    };
+
+    struct Stats {
+        bool enabled;
+        uint32_t capacity;      // Events per core
+        uint32_t recorded[2];   // Events written per core since the last clear
+        uint32_t overwritten[2];
+    };
+
+    /**
+     * Allocate the per-core rings
+     * @param eventsPerCore Ring length, rounded down to a power of two
+     * @return true if the rings were allocated
+     */
+    static bool init(uint32_t eventsPerCore = 4096);
+
+    static void setEnabled(bool enabled) { _enabled.store(enabled && _capacity > 0, std::memory_order_relaxed); }
+    static bool isEnabled() { return _enabled.load(std::memory_order_relaxed); }
+
+    static void begin(const char* name, uint16_t arg = 0) { record(name, BEGIN, arg); }
+    static void end(const char* name, uint16_t arg = 0) { record(name, END, arg); }
+    static void instant(const char* name, uint16_t arg = 0) { record(name, INSTANT, arg); }
+
+    /**
+     * Drop every recorded event
+     */
+    static void clear();
+
+    /**
+     * Write the newest events as Chrome trace JSON, recording pauses meanwhile
+     * @param out Destination, a file or the serial port
+     * @param maxEvents Newest events per core to write, 0 for all
+     * @return Number of events written
+     */
+    static size_t writeChromeJson(Print& out, uint32_t maxEvents = 0);
+
+    static Stats getStats();
+
+private:
+    static Event* _rings[2];
+    static uint32_t _capacity;
+    static std::atomic<uint32_t> _heads[2];
+    static std::atomic<bool> _enabled;
+
+    static void record(const char* name, Phase phase, uint16_t arg);
+};
+
+/**
+ * Begin event on construction, end event when leaving the scope
+ */
+class TraceScope {
+public:
+    TraceScope(const char* name, uint16_t arg = 0) : _name(name), _arg(arg) { Trace::begin(name, arg); }
+    ~TraceScope() { Trace::end(_name, _arg); }
+
+private:
+    const char* _name;
+    uint16_t _arg;
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+};
+
+} // namespace Utils
@@ -0,0 +1,156 @@
+"""
+Build the columnar administrative region table for the LittleFS image.
+
+As a PlatformIO pre script it runs after compress_assets.py on
+buildfs/uploadfs: database/administrative_regions.csv in the staged data
+directory is replaced by database/administrative_regions.bin, which
+IModel::RegionTable reads on the device. The sources in data/ stay
+untouched.
+
+Rows are sorted by adm4 code so the device can binary search them.
+Province, city and district names are dictionary encoded; every distinct
+string is stored once. adm1 to adm3 are prefixes of the adm4 code and are
+not stored.
+
+Layout, little endian:
+    header      magic "ADMR", u16 version, u16 key length, u32 rows,
+                u16 provinces, u16 kotkabs, u16 kecamatans, u16 0,
+                u32 offsets of the key, province, kotkab, kecamatan and
+                desa columns, the dictionary and the string pool,
+                u32 string pool size
+    keys        rows x key length bytes, adm4 codes zero padded
+    provinsi    rows x u16 dictionary index
+    kotkab      rows x u16 dictionary index
+    kecamatan   rows x u16 dictionary index
+    desa        rows x u32 string offset
+    dictionary  u32 string offsets of provinces, then kotkabs, then
+                kecamatans, each group sorted by name
+    strings     u8 length + UTF-8 bytes per string
+
+Standalone:
+    python tools/build_regions.py [csv_path] [bin_path]
+"""
+
+import csv
+import os
+import struct
+import sys
+
+CSV_PATH = os.path.join("database", "administrative_regions.csv")
+BIN_PATH = os.path.join("database", "administrative_regions.bin")
+FS_TARGETS = ("buildfs", "uploadfs", "uploadfsota")
+
+MAGIC = b"ADMR"
+VERSION = 1
+KEY_LENGTH = 16
+HEADER = struct.Struct("<4sHHIHHHHIIIIIIII")
+COLUMNS = ("adm1", "adm2", "adm3", "adm4", "provinsi", "kotkab", "kecamatan", "desa")
+
+
+def read_rows(csv_path):
+    with open(csv_path, newline="", encoding="utf-8") as f:
+        lines = [line for line in f if line.strip() and not line.lstrip().startswith("#")]
+
+    rows = {}
+    for row in csv.DictReader(lines):
+        row = {column: (row.get(column) or "").strip() for column in COLUMNS}
+        adm4 = row["adm4"]
+        parts = adm4.split(".")
+        if len(parts) != 4 or len(adm4.encode("utf-8")) > KEY_LENGTH:
+            raise ValueError("regions: bad adm4 code %r" % adm4)
+        if (row["adm1"], row["adm2"], row["adm3"]) != (parts[0], ".".join(parts[:2]), ".".join(parts[:3])):
+            raise ValueError("regions: adm1-adm3 of %s are not prefixes of its code" % adm4)
+        if adm4 in rows:
+            raise ValueError("regions: duplicate adm4 code %s" % adm4)
+        rows[adm4] = row
+
+    # Byte order, the device compares with memcmp
+    return [rows[key] for key in sorted(rows, key=lambda k: k.encode("utf-8"))]
+
+
+def build_table(rows):
+    strings = bytearray()
+    offsets = {}
+
+    def intern(text):
+        data = text.encode("utf-8")
+        if len(data) > 255:
+            raise ValueError("regions: name longer than 255 bytes: %r" % text)
+        if text not in offsets:
+            offsets[text] = len(strings)
+            strings.append(len(data))
+            strings.extend(data)
+        return offsets[text]
+
+    dictionaries = {}
+    for column in ("provinsi", "kotkab", "kecamatan"):
+        names = sorted({row[column] for row in rows}, key=lambda n: n.encode("utf-8"))
+        if len(names) > 0xFFFF:
+            raise ValueError("regions: too many distinct %s names" % column)
+        dictionaries[column] = {name: i for i, name in enumerate(names)}
+
+    dictionary = bytearray()
+    for column in ("provinsi", "kotkab", "kecamatan"):
+        for name in dictionaries[column]:
+            dictionary += struct.pack("<I", intern(name))
+
+    keys = bytearray()
+    provinsi = bytearray()
+    kotkab = bytearray()
+    kecamatan = bytearray()
+    desa = bytearray()
+    for row in rows:
+        keys += row["adm4"].encode("utf-8").ljust(KEY_LENGTH, b"\0")
+        provinsi += struct.pack("<H", dictionaries["provinsi"][row["provinsi"]])
+        kotkab += struct.pack("<H", dictionaries["kotkab"][row["kotkab"]])
+        kecamatan += struct.pack("<H", dictionaries["kecamatan"][row["kecamatan"]])
+        desa += struct.pack("<I", intern(row["desa"]))
+
+    sections = [keys, provinsi, kotkab, kecamatan, desa, dictionary, strings]
+    offset = HEADER.size
+    starts = []
+    for section in sections:
+        starts.append(offset)
+        offset += len(section)
+
+    header = HEADER.pack(MAGIC, VERSION, KEY_LENGTH, len(rows),
+                         len(dictionaries["provinsi"]), len(dictionaries["kotkab"]),
+                         len(dictionaries["kecamatan"]), 0, *starts, len(strings))
+    return header + b"".join(bytes(section) for section in sections)
+
+
+def build_regions(csv_path, bin_path):
+    rows = read_rows(csv_path)
+    table = build_table(rows)
+    with open(bin_path, "wb") as f:
+        f.write(table)
+    print("regions: %d rows, %d -> %d bytes" % (len(rows), os.path.getsize(csv_path), len(table)))
+
+
+def stage_regions(staging_dir):
+    csv_path = os.path.join(staging_dir, CSV_PATH)
+    if not os.path.isfile(csv_path):
+        return
+    build_regions(csv_path, os.path.join(staging_dir, BIN_PATH))
+    os.remove(csv_path)
+
+
+def main(argv):
+    csv_path = argv[1] if len(argv) > 1 else os.path.join("data", CSV_PATH)
+    bin_path = argv[2] if len(argv) > 2 else os.path.join(".pio", "administrative_regions.bin")
+    build_regions(csv_path, bin_path)
+
+
+try:
+    Import("env")  # noqa: F821, provided by SCons
+except NameError:
+    env = None
+
+if env is not None:
+    from SCons.Script import COMMAND_LINE_TARGETS  # noqa: E402
+
+    # compress_assets.py already pointed PROJECT_DATA_DIR at the staged copy
+    if any(target in FS_TARGETS for target in COMMAND_LINE_TARGETS):
+        stage_regions(env.subst("$PROJECT_DATA_DIR"))
+elif __name__ == "__main__":
+    main(sys.argv)
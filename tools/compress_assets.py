@@ -0,0 +1,112 @@
+"""
+Pre-compress the web assets for the LittleFS image.
+
+As a PlatformIO pre script it runs before buildfs/uploadfs: the data
+directory is copied to the build directory, every compressible file under
+assets/ is replaced by its .gz version and assets/manifest.json records a
+content hash per asset. The filesystem image is then built from that copy,
+the sources in data/ stay untouched.
+
+The web server serves "/assets/x.js" from "x.js.gz" with Content-Encoding
+gzip and uses the manifest hash as a strong ETag.
+
+Standalone:
+    python tools/compress_assets.py [data_dir] [output_dir]
+"""
+
+import gzip
+import hashlib
+import json
+import os
+import shutil
+import sys
+
+ASSET_DIR = "assets"
+MANIFEST = "manifest.json"
+COMPRESSIBLE = (".js", ".css", ".html", ".htm", ".svg", ".json", ".txt", ".map")
+MIN_SIZE = 512  # Below this the gzip header eats the saving
+FS_TARGETS = ("buildfs", "uploadfs", "uploadfsota")
+
+
+def content_hash(data):
+    # 64 bits of SHA-256 are plenty to tell two versions of a file apart
+    return hashlib.sha256(data).hexdigest()[:16]
+
+
+def gzip_bytes(data):
+    # mtime=0 keeps the output identical between builds
+    return gzip.compress(data, compresslevel=9, mtime=0)
+
+
+def compress_assets(asset_dir):
+    manifest = {"version": 1, "files": {}}
+    total_raw = 0
+    total_served = 0
+
+    for name in sorted(os.listdir(asset_dir)):
+        path = os.path.join(asset_dir, name)
+        if not os.path.isfile(path) or name == MANIFEST or name.endswith(".gz"):
+            continue
+
+        with open(path, "rb") as f:
+            data = f.read()
+
+        entry = {"etag": content_hash(data), "size": len(data), "encoding": "identity"}
+        served = len(data)
+
+        if name.lower().endswith(COMPRESSIBLE) and len(data) >= MIN_SIZE:
+            packed = gzip_bytes(data)
+            if len(packed) < len(data):
+                with open(path + ".gz", "wb") as f:
+                    f.write(packed)
+                os.remove(path)
+                entry["encoding"] = "gzip"
+                entry["gzip_size"] = len(packed)
+                served = len(packed)
+
+        manifest["files"][name] = entry
+        total_raw += len(data)
+        total_served += served
+        print("assets: %-28s %8d -> %8d bytes (%s)" % (name, len(data), served, entry["encoding"]))
+
+    with open(os.path.join(asset_dir, MANIFEST), "w") as f:
+        json.dump(manifest, f, indent=1, sort_keys=True)
+
+    if total_raw:
+        print("assets: %d -> %d bytes, %.0f%% saved" % (total_raw, total_served, 100.0 - total_served * 100.0 / total_raw))
+    return manifest
+
+
+def stage_data(data_dir, staging_dir):
+    if os.path.isdir(staging_dir):
+        shutil.rmtree(staging_dir)
+    shutil.copytree(data_dir, staging_dir)
+
+    asset_dir = os.path.join(staging_dir, ASSET_DIR)
+    if os.path.isdir(asset_dir):
+        compress_assets(asset_dir)
+    return staging_dir
+
+
+def main(argv):
+    data_dir = argv[1] if len(argv) > 1 else "data"
+    staging_dir = argv[2] if len(argv) > 2 else os.path.join(".pio", "data_compressed")
+    stage_data(data_dir, staging_dir)
+    print("assets: filesystem staged in %s" % staging_dir)
+
+
+try:
+    Import("env")  # noqa: F821, provided by SCons
+except NameError:
+    env = None
+
+if env is not None:
+    from SCons.Script import COMMAND_LINE_TARGETS  # noqa: E402
+
+    if any(target in FS_TARGETS for target in COMMAND_LINE_TARGETS):
+        data_dir = env.subst("$PROJECT_DATA_DIR")
+        staging_dir = os.path.join(env.subst("$BUILD_DIR"), "data")
+        stage_data(data_dir, staging_dir)
+        env.Replace(PROJECT_DATA_DIR=staging_dir)
+elif __name__ == "__main__":
+    main(sys.argv)
@@ -0,0 +1,175 @@
+// Feed streamed chat completions through GptStreamParser on the host.
+//
+// Build:  g++ -O2 -std=c++17 -Iapp tools/gpt_stream_replay.cpp app/core/Communication/GptStreamParser.cpp -o gpt_stream_replay
+// Usage:  ./gpt_stream_replay                    run the built-in checks
+//         ./gpt_stream_replay capture.sse [n]    replay a capture in n byte pieces
+//         curl -sN <mock>/v1/chat/completions ... | ./gpt_stream_replay - [n]
+//
+// A capture is the raw `stream: true` response body, as saved with
+// `curl -N -o capture.sse` from the API or a local mock server. Replays
+// print every command, sentence and the end state; the checks feed fixed
+// captures at every piece size from 1 byte up, so chunk boundaries land
+// inside lines, escapes and commands, and exit non-zero on a mismatch.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "core/Communication/GptStreamParser.h"
+
+using Communication::GptStreamParser;
+
+struct Result {
+    std::vector<std::string> commands;
+    std::vector<std::string> sentences;
+    std::string error;
+    bool done;
+};
+
+static Result run(const std::string& body, size_t piece) {
+    Result result;
+    GptStreamParser parser;
+    parser.onCommand([&result](const char* command, size_t length) {
+        result.commands.emplace_back(command, length);
+    });
+    parser.onSentence([&result](const char* sentence, size_t length) {
+        result.sentences.emplace_back(sentence, length);
+    });
+
+    for (size_t pos = 0; pos < body.size(); pos += piece) {
+        size_t length = body.size() - pos < piece ? body.size() - pos : piece;
+        parser.feed(body.data() + pos, length);
+    }
+    parser.finish();
+
+    result.error = parser.getError();
+    result.done = parser.isDone();
+    return result;
+}
+
+static std::string event(const char* content) {
+    return std::string("data: {\"id\":\"c1\",\"choices\":[{\"index\":0,\"delta\":{\"content\":\"") +
+           content + "\"},\"finish_reason\":null}]}\n\n";
+}
+
+struct Case {
+    const char* name;
+    std::string body;
+    std::vector<std::string> commands;
+    std::vector<std::string> sentences;
+    const char* error;
+    bool done;
+};
+
+static bool check(const Case& test) {
+    for (size_t piece = 1; piece <= test.body.size(); piece++) {
+        Result result = run(test.body, piece);
+        bool ok = result.commands == test.commands && result.sentences == test.sentences &&
+                  result.error == test.error && result.done == test.done;
+        if (!ok) {
+            printf("FAIL %s (pieces of %zu bytes)\n", test.name, piece);
+            for (const std::string& command : result.commands) printf("  command  %s\n", command.c_str());
+            for (const std::string& sentence : result.sentences) printf("  sentence %s\n", sentence.c_str());
+            printf("  error '%s' done %d\n", result.error.c_str(), result.done);
+            return false;
+        }
+    }
+    printf("ok   %s\n", test.name);
+    return true;
+}
+
+static int selfTest() {
+    std::string role = "data: {\"choices\":[{\"delta\":{\"role\":\"assistant\",\"content\":\"\"}}]}\n\n";
+    std::string finish = "data: {\"choices\":[{\"delta\":{},\"finish_reason\":\"stop\"}]}\n\n";
+    std::string done = "data: [DONE]\n\n";
+
+    std::vector<Case> cases = {
+        {
+            "commands and sentences",
+            role + event("[FACE_HAP") + event("PY][MOVE_FORWARD=2s] *Hello") + event(" there! How are") +
+                event(" you?* [LOOK_LEFT]") + finish + done,
+            { "[FACE_HAPPY]", "[MOVE_FORWARD=2s]", "[LOOK_LEFT]" },
+            { "Hello there!", "How are you?" },
+            "", true
+        },
+        {
+            "decimals and brackets in speech",
+            event("It is 3.5 cm away [sic]. Done!") + done,
+            {},
+            { "It is 3.5 cm away [sic].", "Done!" },
+            "", true
+        },
+        {
+            "unicode escapes",
+            event("Caf\\u00e9 \\\"ok\\\"\\n\\ud83d\\ude00 fun.") + done,
+            {},
+            { "Caf\xc3\xa9 \"ok\"", "\xf0\x9f\x98\x80 fun." },
+            "", true
+        },
+        {
+            "CRLF lines and comments",
+            ": keep-alive\r\n\r\n" + std::string("event: message\r\n") +
+                "data: {\"choices\":[{\"delta\":{\"content\":\"[HEAD_UP] Hi.\"}}]}\r\n\r\n" + "data: [DONE]\r\n\r\n",
+            { "[HEAD_UP]" },
+            { "Hi." },
+            "", true
+        },
+        {
+            "no [DONE], last line unterminated",
+            event("Bye") + "data: {\"choices\":[{\"delta\":{\"content\":\" now\"}}]}",
+            {},
+            { "Bye now" },
+            "", false
+        },
+        {
+            "error event",
+            "data: {\"error\":{\"message\":\"Rate limit \\u0026 quota\",\"type\":\"requests\"}}\n\n",
+            {},
+            {},
+            "Rate limit & quota", false
+        },
+    };
+
+    int failures = 0;
+    for (const Case& test : cases) {
+        failures += check(test) ? 0 : 1;
+    }
+    printf("%d of %zu checks failed\n", failures, cases.size());
+    return failures == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        return selfTest();
+    }
+
+    FILE* file = strcmp(argv[1], "-") == 0 ? stdin : fopen(argv[1], "rb");
+    if (!file) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    std::string body;
+    char buffer[4096];
+    size_t bytesRead;
+    while ((bytesRead = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        body.append(buffer, bytesRead);
+    }
+    if (file != stdin) {
+        fclose(file);
+    }
+
+    size_t piece = argc >= 3 ? strtoul(argv[2], nullptr, 10) : 1460;
+    if (piece == 0) {
+        piece = 1;
+    }
+
+    Result result = run(body, piece);
+    for (const std::string& command : result.commands) printf("command  %s\n", command.c_str());
+    for (const std::string& sentence : result.sentences) printf("sentence %s\n", sentence.c_str());
+    printf("%zu bytes in %zu byte pieces, %zu commands, %zu sentences, done %s%s%s\n",
+           body.size(), piece, result.commands.size(), result.sentences.size(), result.done ? "yes" : "no",
+           result.error.empty() ? "" : ", error: ", result.error.c_str());
+    return result.error.empty() ? 0 : 2;
+}
@@ -0,0 +1,99 @@
+// Replay a recorded IMU log through the attitude filter on the host.
+//
+// Build:  g++ -O2 -std=c++17 -Iapp tools/imu_replay.cpp app/core/Logic/Attitude/MahonyFilter.cpp -o imu_replay
+// Usage:  ./imu_replay log.csv [kp] [ki]
+//
+// The log is CSV with one sample per line:
+//   timestamp_us,gyro_x,gyro_y,gyro_z,accel_x,accel_y,accel_z
+// in the raw sensor frame (deg/s and g), as published by
+// OrientationSensor::getSamplesSince(). Lines starting with '#' are skipped.
+//
+// Prints the final attitude, how far yaw moved while the sensor was still,
+// the estimated gyro bias and the average cost of one update.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "core/Logic/Attitude/MahonyFilter.h"
+
+struct Row {
+    long long timestamp;
+    float gx, gy, gz, ax, ay, az;
+};
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s log.csv [kp] [ki]\n", argv[0]);
+        return 1;
+    }
+
+    FILE* file = fopen(argv[1], "r");
+    if (!file) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    std::vector<Row> rows;
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        if (line[0] == '#' || line[0] == '\n') {
+            continue;
+        }
+        Row row;
+        if (sscanf(line, "%lld,%f,%f,%f,%f,%f,%f", &row.timestamp,
+                   &row.gx, &row.gy, &row.gz, &row.ax, &row.ay, &row.az) == 7) {
+            rows.push_back(row);
+        }
+    }
+    fclose(file);
+
+    if (rows.size() < 2) {
+        fprintf(stderr, "not enough samples\n");
+        return 1;
+    }
+
+    Logic::MahonyFilter filter;
+    if (argc >= 4) {
+        filter.setGains(atof(argv[2]), atof(argv[3]));
+    }
+
+    // Drift is yaw movement while the filter believes the sensor is still
+    float stillDrift = 0;
+    double stillSeconds = 0;
+    float previousYaw = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 1; i < rows.size(); i++) {
+        const Row& row = rows[i];
+        float dt = (row.timestamp - rows[i - 1].timestamp) / 1e6f;
+        bool wasStill = filter.isStationary();
+        filter.update(row.gx, row.gy, row.gz, row.ax, row.ay, row.az, dt);
+
+        if (wasStill && filter.isStationary()) {
+            float delta = filter.getYaw() - previousYaw;
+            while (delta > 180.0f) delta -= 360.0f;
+            while (delta < -180.0f) delta += 360.0f;
+            stillDrift += delta;
+            stillSeconds += dt;
+        }
+        previousYaw = filter.getYaw();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    double nsPerUpdate = std::chrono::duration<double, std::nano>(elapsed).count() / (rows.size() - 1);
+
+    double seconds = (rows.back().timestamp - rows.front().timestamp) / 1e6;
+    printf("samples        %zu over %.1f s\n", rows.size(), seconds);
+    printf("attitude       roll %.2f pitch %.2f yaw %.2f deg\n",
+           filter.getRoll(), filter.getPitch(), filter.getYaw());
+    printf("bias           x %.3f y %.3f z %.3f deg/s\n",
+           filter.getBiasX(), filter.getBiasY(), filter.getBiasZ());
+    if (stillSeconds > 0) {
+        printf("yaw drift      %.2f deg over %.1f s still (%.3f deg/min)\n",
+               stillDrift, stillSeconds, stillDrift * 60.0 / stillSeconds);
+    } else {
+        printf("yaw drift      n/a (never stationary)\n");
+    }
+    printf("update cost    %.0f ns/sample (host)\n", nsPerUpdate);
+    return 0;
+}